@@ -47,6 +47,14 @@ void resizeFromCapacities( benchmark::State & state )
   kernels.resizeFromCapacities();
 }
 
+template< typename POLICY >
+void transpose( benchmark::State & state )
+{
+  CALI_CXX_MARK_PRETTY_FUNCTION;
+  NodeToElemMapConstruction< POLICY > kernels( state, __PRETTY_FUNCTION__ );
+  kernels.transpose();
+}
+
 INDEX_TYPE const NX = 200;
 INDEX_TYPE const NY = 200;
 INDEX_TYPE const NZ = 200;
@@ -66,6 +74,7 @@ void registerBenchmarks()
 
     REGISTER_BENCHMARK_TEMPLATE( WRAP( { nx, ny, nz } ), overAllocation, POLICY );
     REGISTER_BENCHMARK_TEMPLATE( WRAP( { nx, ny, nz } ), resizeFromCapacities, POLICY );
+    REGISTER_BENCHMARK_TEMPLATE( WRAP( { nx, ny, nz } ), transpose, POLICY );
   }, std::make_tuple( NX, NY, NZ, serialPolicy {} )
   #if defined(RAJA_ENABLE_OPENMP)
                                 , std::make_tuple( NX, NY, NZ, parallelHostPolicy {} )
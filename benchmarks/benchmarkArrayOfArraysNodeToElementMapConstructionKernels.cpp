@@ -124,6 +124,18 @@ resizeFromCapacities( ArrayView< INDEX_TYPE const, 2, 1, INDEX_TYPE, DEFAULT_BUF
 }
 // Sphinx end before resizeFromCapacities
 
+// Sphinx start after transpose
+template< typename POLICY >
+void NodeToElemMapConstruction< POLICY >::
+transpose( ArrayView< INDEX_TYPE const, 2, 1, INDEX_TYPE, DEFAULT_BUFFER > const & elementToNodeMap,
+           ArrayOfArrays< INDEX_TYPE, INDEX_TYPE, DEFAULT_BUFFER > & nodeToElementMap,
+           INDEX_TYPE const numNodes )
+{
+  // Count, allocate and fill in parallel, the elements of each node come out sorted.
+  sparseMatrixOps::transpose< POLICY >( elementToNodeMap, numNodes, nodeToElementMap );
+}
+// Sphinx end before transpose
+
 // Explicit instantiation of NodeToElemMapConstruction.
 template class NodeToElemMapConstruction< serialPolicy >;
 
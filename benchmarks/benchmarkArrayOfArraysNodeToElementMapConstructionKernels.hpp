@@ -9,6 +9,7 @@
 
 // Source includes
 #include "benchmarkHelpers.hpp"
+#include "sparseMatrixOps.hpp"
 
 // TPL includes
 #include <benchmark/benchmark.h>
@@ -174,6 +175,12 @@ public:
                  resizeFromCapacities( m_elementToNodeMap.toViewConst(), m_nodeToElementMap, m_numNodes ) );
   }
 
+  void transpose()
+  {
+    TIMING_LOOP( m_nodeToElementMap = ArrayOfArraysT< INDEX_TYPE >(),
+                 transpose( m_elementToNodeMap.toViewConst(), m_nodeToElementMap, m_numNodes ) );
+  }
+
 private:
 
   static void overAllocation( ArrayViewT< INDEX_TYPE const, RAJA::PERM_IJ > const & elementToNodeMap,
@@ -185,6 +192,10 @@ private:
                                     ArrayOfArraysT< INDEX_TYPE > & nodeToElementMap,
                                     INDEX_TYPE const numNodes );
 
+  static void transpose( ArrayViewT< INDEX_TYPE const, RAJA::PERM_IJ > const & elementToNodeMap,
+                         ArrayOfArraysT< INDEX_TYPE > & nodeToElementMap,
+                         INDEX_TYPE const numNodes );
+
 };
 
 #undef TIMING_LOOP
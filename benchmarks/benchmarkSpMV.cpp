@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC and LvArray contributors.
+ * All rights reserved.
+ * See the LICENSE file for details.
+ * SPDX-License-Identifier: (BSD-3-Clause)
+ */
+
+// Source includes
+#include "benchmarkSpMVKernels.hpp"
+
+// TPL includes
+#include <benchmark/benchmark.h>
+
+// System includes
+#include <utility>
+
+namespace LvArray
+{
+namespace benchmarking
+{
+
+ResultsMap< ENTRY_TYPE, 1 > resultsMap;
+
+#define TIMING_LOOP( KERNEL ) \
+  for( auto _ : state ) \
+  { \
+    LVARRAY_UNUSED_VARIABLE( _ ); \
+    KERNEL; \
+    ::benchmark::ClobberMemory(); \
+  } \
+
+template< typename POLICY >
+void crs( benchmark::State & state )
+{
+  CALI_CXX_MARK_PRETTY_FUNCTION;
+  SpMV< POLICY > const kernels( state, __PRETTY_FUNCTION__, resultsMap );
+  TIMING_LOOP( kernels.crs() );
+}
+
+template< typename POLICY >
+void sell( benchmark::State & state )
+{
+  CALI_CXX_MARK_PRETTY_FUNCTION;
+  SpMV< POLICY > const kernels( state, __PRETTY_FUNCTION__, resultsMap );
+  TIMING_LOOP( kernels.sell() );
+}
+
+template< typename POLICY >
+void symmetric( benchmark::State & state )
+{
+  CALI_CXX_MARK_PRETTY_FUNCTION;
+  SpMV< POLICY > const kernels( state, __PRETTY_FUNCTION__, resultsMap );
+  TIMING_LOOP( kernels.symmetric() );
+}
+
+int const SERIAL_SIZE = 40;
+
+#if defined(RAJA_ENABLE_OPENMP)
+int const OMP_SIZE = 64;
+#endif
+
+#if defined(LVARRAY_USE_CUDA) && defined(LVARRAY_USE_CHAI)
+int const CUDA_SIZE = 64;
+#endif
+
+void registerBenchmarks()
+{
+  typeManipulation::forEachArg( []( auto tuple )
+  {
+    INDEX_TYPE const size = std::get< 0 >( tuple );
+    using POLICY = std::tuple_element_t< 1, decltype( tuple ) >;
+
+    // The sigma of the CRS benchmark is unused, it is only there so the results line up.
+    REGISTER_BENCHMARK_TEMPLATE( WRAP( { size, 1 } ), crs, POLICY );
+    REGISTER_BENCHMARK_TEMPLATE( WRAP( { size, 1 } ), symmetric, POLICY );
+    REGISTER_BENCHMARK_TEMPLATE( WRAP( { size, 1 } ), sell, POLICY );
+    REGISTER_BENCHMARK_TEMPLATE( WRAP( { size, CHUNK_SIZE } ), sell, POLICY );
+    REGISTER_BENCHMARK_TEMPLATE( WRAP( { size, 32 * CHUNK_SIZE } ), sell, POLICY );
+  },
+                                std::make_tuple( SERIAL_SIZE, serialPolicy {} )
+  #if defined(RAJA_ENABLE_OPENMP)
+                                , std::make_tuple( OMP_SIZE, parallelHostPolicy {} )
+  #endif
+  #if defined(LVARRAY_USE_CUDA) && defined(LVARRAY_USE_CHAI)
+                                , std::make_tuple( CUDA_SIZE, parallelDevicePolicy< THREADS_PER_BLOCK > {} )
+  #endif
+                                );
+}
+
+} // namespace benchmarking
+} // namespace LvArray
+
+int main( int argc, char * * argv )
+{
+  LvArray::benchmarking::registerBenchmarks();
+  ::benchmark::Initialize( &argc, argv );
+  if( ::benchmark::ReportUnrecognizedArguments( argc, argv ) )
+  {
+    return 1;
+  }
+
+  LVARRAY_LOG( "ENTRY_TYPE = " << LvArray::system::demangleType< LvArray::benchmarking::ENTRY_TYPE >() );
+  LVARRAY_LOG( "COLUMN_TYPE = " << LvArray::system::demangleType< LvArray::benchmarking::COLUMN_TYPE >() );
+  LVARRAY_LOG( "INDEX_TYPE = " << LvArray::system::demangleType< LvArray::benchmarking::INDEX_TYPE >() );
+  LVARRAY_LOG( "CHUNK_SIZE = " << LvArray::benchmarking::CHUNK_SIZE );
+
+  LvArray::benchmarking::INDEX_TYPE size = LvArray::benchmarking::NDIM * std::pow( LvArray::benchmarking::SERIAL_SIZE, 3 );
+  LVARRAY_LOG( "Serial problems of size ( " << size << " )." );
+
+#if defined(RAJA_ENABLE_OPENMP)
+  size = LvArray::benchmarking::NDIM * std::pow( LvArray::benchmarking::OMP_SIZE, 3 );
+  LVARRAY_LOG( "OMP problems of size ( " << size << " )." );
+#endif
+
+#if defined(LVARRAY_USE_CUDA) && defined(LVARRAY_USE_CHAI)
+  size = LvArray::benchmarking::NDIM * std::pow( LvArray::benchmarking::CUDA_SIZE, 3 );
+  LVARRAY_LOG( "CUDA problems of size ( " << size << " )." );
+#endif
+
+  ::benchmark::RunSpecifiedBenchmarks();
+
+  return LvArray::benchmarking::verifyResults( LvArray::benchmarking::resultsMap );
+}
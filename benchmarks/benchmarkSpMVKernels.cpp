@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC and LvArray contributors.
+ * All rights reserved.
+ * See the LICENSE file for details.
+ * SPDX-License-Identifier: (BSD-3-Clause)
+ */
+
+// Source includes
+#include "benchmarkSpMVKernels.hpp"
+
+// TPL includes
+#include <benchmark/benchmark.h>
+
+namespace LvArray
+{
+namespace benchmarking
+{
+
+template< typename POLICY >
+SpMV< POLICY >::SpMV( ::benchmark::State & state,
+                      char const * const callingFunction,
+                      ResultsMap< ENTRY_TYPE, 1 > & results ):
+  m_state( state ),
+  m_callingFunction( callingFunction ),
+  m_results( results ),
+  m_numNodesPerSide( state.range( 0 ) ),
+  m_matrix(),
+  m_upper(),
+  m_sell(),
+  m_x(),
+  m_y()
+{
+  CALI_CXX_MARK_SCOPE( "SpMV constructor" );
+
+  INDEX_TYPE const n = m_numNodesPerSide;
+  INDEX_TYPE const numNodes = n * n * n;
+  INDEX_TYPE const numDofs = NDIM * numNodes;
+
+  std::vector< INDEX_TYPE > rowCapacities( numDofs, 27 * NDIM );
+  m_matrix.resizeFromRowCapacities< serialPolicy >( numDofs, numDofs, rowCapacities.data() );
+
+  COLUMN_TYPE columns[ 27 * NDIM ];
+  ENTRY_TYPE entries[ 27 * NDIM ];
+  for( INDEX_TYPE k = 0; k < n; ++k )
+  {
+    for( INDEX_TYPE j = 0; j < n; ++j )
+    {
+      for( INDEX_TYPE i = 0; i < n; ++i )
+      {
+        INDEX_TYPE const nodeID = i + n * j + n * n * k;
+
+        int numColumns = 0;
+        for( INDEX_TYPE dk = -1; dk < 2; ++dk )
+        {
+          if( k + dk < 0 || k + dk >= n ) continue;
+          for( INDEX_TYPE dj = -1; dj < 2; ++dj )
+          {
+            if( j + dj < 0 || j + dj >= n ) continue;
+            for( INDEX_TYPE di = -1; di < 2; ++di )
+            {
+              if( i + di < 0 || i + di >= n ) continue;
+
+              INDEX_TYPE const neighborID = ( i + di ) + n * ( j + dj ) + n * n * ( k + dk );
+              for( int dim = 0; dim < NDIM; ++dim )
+              { columns[ numColumns++ ] = NDIM * neighborID + dim; }
+            }
+          }
+        }
+
+        for( int dim = 0; dim < NDIM; ++dim )
+        {
+          INDEX_TYPE const row = NDIM * nodeID + dim;
+          for( int c = 0; c < numColumns; ++c )
+          { entries[ c ] = columns[ c ] == row ? numColumns : -1.0 / ( 1 + ( row + columns[ c ] ) % 7 ); }
+
+          m_matrix.insertNonZeros( row, columns, entries, numColumns );
+        }
+      }
+    }
+  }
+
+  m_sell.setFrom< serialPolicy >( m_matrix.toViewConst(), state.range( 1 ) );
+  sparseMatrixOps::upperTriangle< serialPolicy >( m_matrix.toViewConst(), m_upper );
+
+  m_x.resize( numDofs );
+  for( INDEX_TYPE i = 0; i < numDofs; ++i )
+  { m_x[ i ] = ( i % 13 ) - 6; }
+
+  m_y.resize( numDofs );
+
+  m_matrix.move( RAJAHelper< POLICY >::space, false );
+  m_upper.move( RAJAHelper< POLICY >::space, false );
+  m_sell.move( RAJAHelper< POLICY >::space, false );
+  m_x.move( RAJAHelper< POLICY >::space, false );
+}
+
+template< typename POLICY >
+SpMV< POLICY >::~SpMV()
+{
+  CALI_CXX_MARK_SCOPE( "~SpMV" );
+
+  m_y.move( MemorySpace::host, false );
+
+  ENTRY_TYPE sum = 0;
+  for( INDEX_TYPE i = 0; i < m_y.size(); ++i )
+  { sum += m_y[ i ]; }
+
+  registerResult( m_results, { m_numNodesPerSide }, sum, m_callingFunction );
+
+  m_state.counters[ "Stored entries" ] = m_sell.numStoredEntries();
+  m_state.counters[ "Non zeros" ] = m_matrix.numNonZeros();
+  m_state.counters[ "OPS" ] = ::benchmark::Counter( 2 * m_matrix.numNonZeros(),
+                                                    ::benchmark::Counter::kIsIterationInvariantRate,
+                                                    ::benchmark::Counter::OneK::kIs1000 );
+}
+
+template< typename POLICY >
+void SpMV< POLICY >::crsKernel( CRSMatrixViewConstT const & matrix,
+                                ArrayViewT< ENTRY_TYPE const, RAJA::PERM_I > const & x,
+                                ArrayViewT< ENTRY_TYPE, RAJA::PERM_I > const & y )
+{
+  CALI_CXX_MARK_SCOPE( "crsKernel" );
+
+  forall< POLICY >( matrix.numRows(), [matrix, x, y] LVARRAY_HOST_DEVICE ( INDEX_TYPE const row )
+      {
+        COLUMN_TYPE const * const columns = matrix.getColumns( row );
+        ENTRY_TYPE const * const entries = matrix.getEntries( row );
+        INDEX_TYPE const numNonZeros = matrix.numNonZeros( row );
+
+        ENTRY_TYPE sum = 0;
+        for( INDEX_TYPE i = 0; i < numNonZeros; ++i )
+        { sum += entries[ i ] * x[ columns[ i ] ]; }
+
+        y[ row ] = sum;
+      } );
+}
+
+// Explicit instantiation of SpMV.
+template class SpMV< serialPolicy >;
+
+#if defined(RAJA_ENABLE_OPENMP)
+template class SpMV< parallelHostPolicy >;
+#endif
+
+#if defined(LVARRAY_USE_CUDA) && defined(LVARRAY_USE_CHAI)
+template class SpMV< parallelDevicePolicy< THREADS_PER_BLOCK > >;
+#endif
+
+} // namespace benchmarking
+} // namespace LvArray
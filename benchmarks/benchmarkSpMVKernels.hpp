@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC and LvArray contributors.
+ * All rights reserved.
+ * See the LICENSE file for details.
+ * SPDX-License-Identifier: (BSD-3-Clause)
+ */
+
+#pragma once
+
+// Source includes
+#include "benchmarkHelpers.hpp"
+#include "CRSMatrix.hpp"
+#include "SlicedEllMatrix.hpp"
+#include "sparseMatrixOps.hpp"
+
+// TPL includes
+#include <benchmark/benchmark.h>
+
+namespace LvArray
+{
+namespace benchmarking
+{
+
+using COLUMN_TYPE = std::ptrdiff_t;
+using ENTRY_TYPE = double;
+constexpr unsigned long THREADS_PER_BLOCK = 256;
+
+#if defined(LVARRAY_USE_CUDA)
+constexpr int CHUNK_SIZE = 32;
+#else
+constexpr int CHUNK_SIZE = 8;
+#endif
+
+constexpr int NDIM = 3;
+
+using CRSMatrixT = CRSMatrix< ENTRY_TYPE, COLUMN_TYPE, INDEX_TYPE, DEFAULT_BUFFER >;
+
+using CRSMatrixViewConstT = CRSMatrixView< ENTRY_TYPE const, COLUMN_TYPE const, INDEX_TYPE const, DEFAULT_BUFFER >;
+
+using SlicedEllMatrixT = SlicedEllMatrix< ENTRY_TYPE, COLUMN_TYPE, INDEX_TYPE, DEFAULT_BUFFER, CHUNK_SIZE >;
+
+template< typename POLICY >
+class SpMV
+{
+public:
+
+  /**
+   * @brief Construct the operator of a vector valued problem on a structured ( N x N x N ) grid
+   *   with a 27 point stencil. The rows of the boundary nodes are shorter than the interior ones.
+   * @param state The benchmark state, range( 0 ) is N and range( 1 ) is sigma.
+   * @param callingFunction The name of the benchmark.
+   * @param results The results map used to check that all the kernels agree.
+   */
+  SpMV( ::benchmark::State & state,
+        char const * const callingFunction,
+        ResultsMap< ENTRY_TYPE, 1 > & results );
+
+  ~SpMV();
+
+  void crs() const
+  { crsKernel( m_matrix.toViewConst(), m_x.toViewConst(), m_y.toView() ); }
+
+  void sell() const
+  { m_sell.multiply< POLICY >( m_x.toViewConst(), m_y.toView() ); }
+
+  void symmetric() const
+  {
+    sparseMatrixOps::multiplySymmetric< POLICY, typename RAJAHelper< POLICY >::AtomicPolicy >( m_upper.toViewConst(),
+                                                                                               m_x.toViewConst(),
+                                                                                               m_y.toView() );
+  }
+
+  // Note this should be protected but cuda won't let you put an extended lambda in a protected or private method.
+  static void crsKernel( CRSMatrixViewConstT const & matrix,
+                         ArrayViewT< ENTRY_TYPE const, RAJA::PERM_I > const & x,
+                         ArrayViewT< ENTRY_TYPE, RAJA::PERM_I > const & y );
+
+private:
+  ::benchmark::State & m_state;
+  std::string const m_callingFunction;
+  ResultsMap< ENTRY_TYPE, 1 > & m_results;
+
+  INDEX_TYPE const m_numNodesPerSide;
+  CRSMatrixT m_matrix;
+  CRSMatrixT m_upper;
+  SlicedEllMatrixT m_sell;
+  ArrayT< ENTRY_TYPE, RAJA::PERM_I > m_x;
+  ArrayT< ENTRY_TYPE, RAJA::PERM_I > m_y;
+};
+
+} // namespace benchmarking
+} // namespace LvArray
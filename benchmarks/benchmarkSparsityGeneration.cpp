@@ -70,6 +70,14 @@ void nodeLoopPreallocatedRAJA( benchmark::State & state )
   TIMING_LOOP( kernels.resize( MAX_COLUMNS_PER_ROW ); kernels.generateNodeLoop() );
 }
 
+template< typename POLICY >
+void fromConnectivityRAJA( benchmark::State & state )
+{
+  CALI_CXX_MARK_PRETTY_FUNCTION;
+  SparsityGenerationRAJA< POLICY > kernels( state );
+  TIMING_LOOP( kernels.fromConnectivity() );
+}
+
 template< typename POLICY >
 void addToRow( benchmark::State & state )
 {
@@ -78,8 +86,51 @@ void addToRow( benchmark::State & state )
   TIMING_LOOP( kernels.add() );
 }
 
+template< typename POLICY >
+void addToRowColored( benchmark::State & state )
+{
+  CALI_CXX_MARK_PRETTY_FUNCTION;
+  CRSMatrixAddToRow< POLICY > kernels( state );
+  TIMING_LOOP( kernels.addColored() );
+}
+
+template< typename POLICY >
+void addToRowAdaptive( benchmark::State & state )
+{
+  CALI_CXX_MARK_PRETTY_FUNCTION;
+  CRSMatrixRowLookup< POLICY > kernels( state );
+  TIMING_LOOP( kernels.add( RowLookup::adaptive ) );
+}
+
+template< typename POLICY >
+void addToRowBinarySearch( benchmark::State & state )
+{
+  CALI_CXX_MARK_PRETTY_FUNCTION;
+  CRSMatrixRowLookup< POLICY > kernels( state );
+  TIMING_LOOP( kernels.add( RowLookup::binarySearch ) );
+}
+
+template< typename POLICY >
+void addToRowLinearSearch( benchmark::State & state )
+{
+  CALI_CXX_MARK_PRETTY_FUNCTION;
+  CRSMatrixRowLookup< POLICY > kernels( state );
+  TIMING_LOOP( kernels.add( RowLookup::linearSearch ) );
+}
+
+template< typename POLICY >
+void addToRowColumnIndex( benchmark::State & state )
+{
+  CALI_CXX_MARK_PRETTY_FUNCTION;
+  CRSMatrixRowLookup< POLICY > kernels( state );
+  TIMING_LOOP( kernels.add( RowLookup::columnIndex ) );
+}
+
 int const SERIAL_SIZE = 100;
 
+// The number of rows in the row lookup benchmarks.
+int const ROW_LOOKUP_NUM_ROWS = 4000;
+
 #if defined(RAJA_ENABLE_OPENMP)
 int const OMP_SIZE = 100;
 #endif
@@ -103,6 +154,7 @@ void registerBenchmarks()
     using POLICY = std::tuple_element_t< 1, decltype( tuple ) >;
     REGISTER_BENCHMARK_TEMPLATE( WRAP( { size, size, size } ), nodeLoopExactAllocationRAJA, POLICY );
     REGISTER_BENCHMARK_TEMPLATE( WRAP( { size, size, size } ), nodeLoopPreallocatedRAJA, POLICY );
+    REGISTER_BENCHMARK_TEMPLATE( WRAP( { size, size, size } ), fromConnectivityRAJA, POLICY );
   },
                                 std::make_tuple( SERIAL_SIZE, serialPolicy {} )
   #if defined(RAJA_ENABLE_OPENMP)
@@ -119,6 +171,20 @@ void registerBenchmarks()
     INDEX_TYPE const size = std::get< 0 >( tuple );
     using POLICY = std::tuple_element_t< 1, decltype( tuple ) >;
     REGISTER_BENCHMARK_TEMPLATE( WRAP( { size, size, size } ), addToRow, POLICY );
+    REGISTER_BENCHMARK_TEMPLATE( WRAP( { size, size, size } ), addToRowColored, POLICY );
+
+    // Compare the ways of finding the columns in a row for varying row and batch lengths, these
+    // are used to calibrate LVARRAY_ADD_TO_ROW_BINARY_SEARCH_MIN_ROW_LENGTH and LVARRAY_ADD_TO_ROW_BINARY_SEARCH_RATIO.
+    for( INDEX_TYPE const rowLength : { 16, 64, 256, 1024 } )
+    {
+      for( INDEX_TYPE batchSize = 1; batchSize <= rowLength; batchSize *= 4 )
+      {
+        REGISTER_BENCHMARK_TEMPLATE( WRAP( { ROW_LOOKUP_NUM_ROWS, rowLength, batchSize } ), addToRowAdaptive, POLICY );
+        REGISTER_BENCHMARK_TEMPLATE( WRAP( { ROW_LOOKUP_NUM_ROWS, rowLength, batchSize } ), addToRowBinarySearch, POLICY );
+        REGISTER_BENCHMARK_TEMPLATE( WRAP( { ROW_LOOKUP_NUM_ROWS, rowLength, batchSize } ), addToRowLinearSearch, POLICY );
+        REGISTER_BENCHMARK_TEMPLATE( WRAP( { ROW_LOOKUP_NUM_ROWS, rowLength, batchSize } ), addToRowColumnIndex, POLICY );
+      }
+    }
   },
                                 std::make_tuple( SERIAL_SIZE, serialPolicy {} )
   #if defined(RAJA_ENABLE_OPENMP)
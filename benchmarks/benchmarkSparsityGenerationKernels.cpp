@@ -12,6 +12,7 @@
 #include <benchmark/benchmark.h>
 
 // System includes
+#include <algorithm>
 #include <utility>
 
 namespace LvArray
@@ -161,6 +162,21 @@ resizeExact()
   resizeFromNNZPerRow< RESIZE_POLICY >( nnzPerRow );
 }
 
+template< typename POLICY >
+void SparsityGenerationRAJA< POLICY >::
+fromConnectivity()
+{
+  CALI_CXX_MARK_SCOPE( "fromConnectivity" );
+
+  #if defined(RAJA_ENABLE_OPENMP)
+  using BUILD_POLICY = std::conditional_t< std::is_same< serialPolicy, POLICY >::value, serialPolicy, parallelHostPolicy >;
+  #else
+  using BUILD_POLICY = serialPolicy;
+  #endif
+
+  m_sparsity.fromConnectivity< BUILD_POLICY >( m_elemToNodeMap.toViewConst(), m_nodeToElemMap.toViewConst(), NDIM );
+}
+
 // Note this shoule be protected but cuda won't let you put an extended lambda in a protected or private method.
 template< typename POLICY >
 void SparsityGenerationRAJA< POLICY >::
@@ -190,6 +206,43 @@ generateNodeLoop( SparsityPatternViewT const & sparsity,
       } );
 }
 
+template< typename ATOMIC_POLICY >
+LVARRAY_HOST_DEVICE inline
+void addElementContribution( CRSMatrixViewConstSizesT const & matrix,
+                             ArrayViewT< INDEX_TYPE const, ELEM_TO_NODE_PERM > const & elemToNodeMap,
+                             INDEX_TYPE const elemID )
+{
+  COLUMN_TYPE dofNumbers[ NODES_PER_ELEM * NDIM ];
+  ENTRY_TYPE additions[ NODES_PER_ELEM * NDIM ][ NODES_PER_ELEM * NDIM ];
+  for( INDEX_TYPE localNode0 = 0; localNode0 < NODES_PER_ELEM; ++localNode0 )
+  {
+    for( int dim0 = 0; dim0 < NDIM; ++dim0 )
+    {
+      INDEX_TYPE const dof0 = NDIM * elemToNodeMap( elemID, localNode0 ) + dim0;
+      dofNumbers[ NDIM * localNode0 + dim0 ] = dof0;
+
+      for( INDEX_TYPE localNode1 = 0; localNode1 < NODES_PER_ELEM; ++localNode1 )
+      {
+        for( int dim1 = 0; dim1 < NDIM; ++dim1 )
+        {
+          INDEX_TYPE const dof1 = NDIM * elemToNodeMap( elemID, localNode1 ) + dim1;
+          additions[ NDIM * localNode0 + dim0][ NDIM * localNode1 + dim1 ] = dof0 - dof1;
+        }
+      }
+
+    }
+  }
+
+  for( int localNode = 0; localNode < NODES_PER_ELEM; ++localNode )
+  {
+    for( int dim = 0; dim < NDIM; ++dim )
+    {
+      matrix.addToRowBinarySearchUnsorted< ATOMIC_POLICY >( dofNumbers[ NDIM * localNode + dim ], dofNumbers,
+                                                            additions[ NDIM * localNode + dim ], NODES_PER_ELEM * NDIM );
+    }
+  }
+}
+
 template< typename POLICY >
 void CRSMatrixAddToRow< POLICY >::
 addKernel( CRSMatrixViewConstSizesT const & matrix,
@@ -199,50 +252,142 @@ addKernel( CRSMatrixViewConstSizesT const & matrix,
 
   forall< POLICY >( elemToNodeMap.size( 0 ), [matrix, elemToNodeMap] LVARRAY_HOST_DEVICE ( INDEX_TYPE const elemID )
       {
-        COLUMN_TYPE dofNumbers[ NODES_PER_ELEM * NDIM ];
-        ENTRY_TYPE additions[ NODES_PER_ELEM * NDIM ][ NODES_PER_ELEM * NDIM ];
-        for( INDEX_TYPE localNode0 = 0; localNode0 < NODES_PER_ELEM; ++localNode0 )
-        {
-          for( int dim0 = 0; dim0 < NDIM; ++dim0 )
-          {
-            INDEX_TYPE const dof0 = NDIM * elemToNodeMap( elemID, localNode0 ) + dim0;
-            dofNumbers[ NDIM * localNode0 + dim0 ] = dof0;
-
-            for( INDEX_TYPE localNode1 = 0; localNode1 < NODES_PER_ELEM; ++localNode1 )
-            {
-              for( int dim1 = 0; dim1 < NDIM; ++dim1 )
-              {
-                INDEX_TYPE const dof1 = NDIM * elemToNodeMap( elemID, localNode1 ) + dim1;
-                additions[ NDIM * localNode0 + dim0][ NDIM * localNode1 + dim1 ] = dof0 - dof1;
-              }
-            }
-
-          }
-        }
+        addElementContribution< typename RAJAHelper< POLICY >::AtomicPolicy >( matrix, elemToNodeMap, elemID );
+      } );
+}
 
-        for( int localNode = 0; localNode < NODES_PER_ELEM; ++localNode )
-        {
-          for( int dim = 0; dim < NDIM; ++dim )
-          {
-            matrix.addToRowBinarySearchUnsorted< typename RAJAHelper< POLICY >::AtomicPolicy >( dofNumbers[ NDIM * localNode + dim ], dofNumbers,
-                                                                                                additions[ NDIM * localNode + dim ], NODES_PER_ELEM * NDIM );
-          }
-        }
+template< typename POLICY >
+void CRSMatrixAddToRow< POLICY >::
+addColoredKernel( CRSMatrixViewConstSizesT const & matrix,
+                  ArrayViewT< INDEX_TYPE const, ELEM_TO_NODE_PERM > const & elemToNodeMap,
+                  ArrayOfArraysViewT< INDEX_TYPE const, true > const & colorToElems )
+{
+  CALI_CXX_MARK_SCOPE( "addColoredKernel" );
+
+  // The elements of a color don't share any rows so no atomics are needed.
+  sparseMatrixOps::forAllByColor< POLICY >( colorToElems, [matrix, elemToNodeMap] LVARRAY_HOST_DEVICE ( INDEX_TYPE const elemID )
+      {
+        addElementContribution< RAJA::seq_atomic >( matrix, elemToNodeMap, elemID );
+      } );
+}
+
+template< typename POLICY >
+CRSMatrixRowLookup< POLICY >::
+CRSMatrixRowLookup( ::benchmark::State & state ):
+  m_state( state ),
+  m_numRows( state.range( 0 ) ),
+  m_rowLength( state.range( 1 ) ),
+  m_batchSize( state.range( 2 ) ),
+  m_matrix( m_numRows, m_numRows, m_rowLength ),
+  m_cols( m_numRows, m_batchSize ),
+  m_vals( m_numRows, m_batchSize )
+{
+  CALI_CXX_MARK_SCOPE( "CRSMatrixRowLookup constructor" );
+
+  LVARRAY_ERROR_IF_GT( m_rowLength, m_numRows );
+  LVARRAY_ERROR_IF_GT( m_batchSize, m_rowLength );
+
+  std::mt19937_64 gen;
+  std::uniform_int_distribution< COLUMN_TYPE > colDist( 0, m_numRows - 1 );
+  std::vector< COLUMN_TYPE > columns;
+  std::vector< ENTRY_TYPE > const zeros( m_rowLength );
+  for( INDEX_TYPE row = 0; row < m_numRows; ++row )
+  {
+    columns.clear();
+    while( INDEX_TYPE( columns.size() ) < m_rowLength )
+    {
+      columns.push_back( colDist( gen ) );
+      if( INDEX_TYPE( columns.size() ) == m_rowLength )
+      { columns.resize( sortedArrayManipulation::makeSortedUnique( columns.begin(), columns.end() ) ); }
+    }
+
+    m_matrix.insertNonZeros( row, columns.data(), zeros.data(), m_rowLength );
+
+    // Add to a sorted random subset of the row.
+    std::shuffle( columns.begin(), columns.end(), gen );
+    sortedArrayManipulation::makeSorted( columns.begin(), columns.begin() + m_batchSize );
+    for( INDEX_TYPE i = 0; i < m_batchSize; ++i )
+    {
+      m_cols( row, i ) = columns[ i ];
+      m_vals( row, i ) = 1;
+    }
+  }
+
+  #if defined(RAJA_ENABLE_OPENMP)
+  using EXEC_POLICY = parallelHostPolicy;
+  #else
+  using EXEC_POLICY = serialPolicy;
+  #endif
+
+  m_index.setFrom< EXEC_POLICY >( m_matrix );
+
+  m_matrix.toViewConstSizes().move( RAJAHelper< POLICY >::space );
+  m_cols.move( RAJAHelper< POLICY >::space, false );
+  m_vals.move( RAJAHelper< POLICY >::space, false );
+}
+
+template< typename POLICY >
+CRSMatrixRowLookup< POLICY >::
+~CRSMatrixRowLookup()
+{
+  CALI_CXX_MARK_SCOPE( "~CRSMatrixRowLookup" );
+
+  m_matrix.move( MemorySpace::host, false );
+
+  ENTRY_TYPE total = 0;
+  for( INDEX_TYPE row = 0; row < m_numRows; ++row )
+  {
+    for( ENTRY_TYPE const & entry : m_matrix.getEntries( row ) )
+    { total += entry; }
+  }
+
+  LVARRAY_ERROR_IF_NE( total, ENTRY_TYPE( m_numRows * m_batchSize * m_state.iterations() ) );
+
+  m_state.counters[ "Additions"] = ::benchmark::Counter( m_numRows * m_batchSize,
+                                                         benchmark::Counter::kIsIterationInvariantRate,
+                                                         benchmark::Counter::OneK::kIs1000 );
+}
+
+template< typename POLICY >
+void CRSMatrixRowLookup< POLICY >::
+addKernel( CRSMatrixViewConstSizesT const & matrix,
+           ColumnIndexT::ViewType const & index,
+           ArrayViewT< COLUMN_TYPE const, RAJA::PERM_IJ > const & cols,
+           ArrayViewT< ENTRY_TYPE const, RAJA::PERM_IJ > const & vals,
+           RowLookup const lookup )
+{
+  CALI_CXX_MARK_SCOPE( "addKernel" );
+
+  using AtomicPolicy = typename RAJAHelper< POLICY >::AtomicPolicy;
+  forall< POLICY >( cols.size( 0 ), [matrix, index, cols, vals, lookup] LVARRAY_HOST_DEVICE ( INDEX_TYPE const row )
+      {
+        INDEX_TYPE const batchSize = cols.size( 1 );
+        if( lookup == RowLookup::adaptive )
+        { matrix.addToRow< AtomicPolicy >( row, cols[ row ], vals[ row ], batchSize ); }
+        else if( lookup == RowLookup::binarySearch )
+        { matrix.addToRowBinarySearch< AtomicPolicy >( row, cols[ row ], vals[ row ], batchSize ); }
+        else if( lookup == RowLookup::linearSearch )
+        { matrix.addToRowLinearSearch< AtomicPolicy >( row, cols[ row ], vals[ row ], batchSize ); }
+        else
+        { index.addToRow< AtomicPolicy >( matrix, row, cols[ row ], vals[ row ], batchSize ); }
       } );
 }
 
 // Explicit instantiation of SparsityGenerationRAJA.
 template class SparsityGenerationRAJA< serialPolicy >;
 template class CRSMatrixAddToRow< serialPolicy >;
+template class CRSMatrixRowLookup< serialPolicy >;
 
 #if defined(RAJA_ENABLE_OPENMP)
 template class SparsityGenerationRAJA< parallelHostPolicy >;
 template class CRSMatrixAddToRow< parallelHostPolicy >;
+template class CRSMatrixRowLookup< parallelHostPolicy >;
 #endif
 
 #if defined(LVARRAY_USE_CUDA) && defined(LVARRAY_USE_CHAI)
 template class SparsityGenerationRAJA< parallelDevicePolicy< THREADS_PER_BLOCK > >;
 template class CRSMatrixAddToRow< parallelDevicePolicy< THREADS_PER_BLOCK > >;
+template class CRSMatrixRowLookup< parallelDevicePolicy< THREADS_PER_BLOCK > >;
 #endif
 
 } // namespace benchmarking
@@ -9,6 +9,8 @@
 #include "benchmarkHelpers.hpp"
 #include "SparsityPattern.hpp"
 #include "CRSMatrix.hpp"
+#include "ColumnIndex.hpp"
+#include "sparseMatrixOps.hpp"
 #include "ArrayOfArrays.hpp"
 #include "system.hpp"
 
@@ -41,6 +43,8 @@ using CRSMatrixT = CRSMatrix< ENTRY_TYPE, COLUMN_TYPE, INDEX_TYPE, DEFAULT_BUFFE
 
 using CRSMatrixViewConstSizesT = CRSMatrixView< ENTRY_TYPE, COLUMN_TYPE const, INDEX_TYPE const, DEFAULT_BUFFER >;
 
+using ColumnIndexT = ColumnIndex< COLUMN_TYPE, INDEX_TYPE, DEFAULT_BUFFER >;
+
 constexpr int NDIM = 3;
 constexpr int NODES_PER_ELEM = 8;
 constexpr int MAX_ELEMS_PER_NODE = 8;
@@ -217,6 +221,8 @@ public:
 
   void resizeExact();
 
+  void fromConnectivity();
+
   // Note this shoule be protected but cuda won't let you put an extended lambda in a protected or private method.
   static void generateNodeLoop( SparsityPatternViewT const & sparsity,
                                 ArrayViewT< INDEX_TYPE const, ELEM_TO_NODE_PERM > const & elemToNodeMap,
@@ -246,6 +252,10 @@ public:
 
     m_matrix.assimilate< EXEC_POLICY >( std::move( this->m_sparsity ) );
     m_matrix.toViewConstSizes().move( RAJAHelper< POLICY >::space );
+
+    // Elements that share a node write to the same rows.
+    sparseMatrixOps::colorElements( this->m_elemToNodeMap.toViewConst(), this->m_numNodes, m_colorToElems );
+    m_colorToElems.move( RAJAHelper< POLICY >::space, false );
   }
 
   ~CRSMatrixAddToRow()
@@ -333,12 +343,61 @@ public:
   void add() const
   { addKernel( m_matrix.toViewConstSizes(), this->m_elemToNodeMap.toViewConst() ); }
 
+  void addColored() const
+  { addColoredKernel( m_matrix.toViewConstSizes(), this->m_elemToNodeMap.toViewConst(), m_colorToElems.toViewConst() ); }
+
   // Note this shoule be protected but cuda won't let you put an extended lambda in a protected or private method.
   static void addKernel( CRSMatrixViewConstSizesT const & matrix,
                          ArrayViewT< INDEX_TYPE const, ELEM_TO_NODE_PERM > const & elemToNodeMap );
 
+  // Note this shoule be protected but cuda won't let you put an extended lambda in a protected or private method.
+  static void addColoredKernel( CRSMatrixViewConstSizesT const & matrix,
+                                ArrayViewT< INDEX_TYPE const, ELEM_TO_NODE_PERM > const & elemToNodeMap,
+                                ArrayOfArraysViewT< INDEX_TYPE const, true > const & colorToElems );
+
 private:
   CRSMatrixT m_matrix;
+  ArrayOfArraysT< INDEX_TYPE > m_colorToElems;
+};
+
+/**
+ * @brief The ways CRSMatrixRowLookup can find the columns to add to in a row.
+ */
+enum class RowLookup
+{
+  adaptive,
+  binarySearch,
+  linearSearch,
+  columnIndex
+};
+
+template< typename POLICY >
+class CRSMatrixRowLookup
+{
+public:
+  CRSMatrixRowLookup( ::benchmark::State & state );
+
+  ~CRSMatrixRowLookup();
+
+  void add( RowLookup const lookup ) const
+  { addKernel( m_matrix.toViewConstSizes(), m_index.toView( m_matrix ), m_cols.toViewConst(), m_vals.toViewConst(), lookup ); }
+
+  // Note this shoule be protected but cuda won't let you put an extended lambda in a protected or private method.
+  static void addKernel( CRSMatrixViewConstSizesT const & matrix,
+                         ColumnIndexT::ViewType const & index,
+                         ArrayViewT< COLUMN_TYPE const, RAJA::PERM_IJ > const & cols,
+                         ArrayViewT< ENTRY_TYPE const, RAJA::PERM_IJ > const & vals,
+                         RowLookup const lookup );
+
+private:
+  ::benchmark::State & m_state;
+  INDEX_TYPE const m_numRows;
+  INDEX_TYPE const m_rowLength;
+  INDEX_TYPE const m_batchSize;
+  CRSMatrixT m_matrix;
+  ColumnIndexT m_index;
+  ArrayT< COLUMN_TYPE, RAJA::PERM_IJ > m_cols;
+  ArrayT< ENTRY_TYPE, RAJA::PERM_IJ > m_vals;
 };
 
 } // namespace benchmarking
@@ -18,7 +18,7 @@ namespace LvArray
 {
 
 // Forward declaration of the ArrayOfSets class so that we can define the assimilate method.
-template< typename T, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+template< typename T, typename INDEX_TYPE, template< typename > class BUFFER_TYPE, typename OFFSET_TYPE >
 class ArrayOfSets;
 
 /**
@@ -26,18 +26,22 @@ class ArrayOfSets;
  * @brief This class implements an array of arrays like object with contiguous storage.
  * @tparam T the type stored in the arrays.
  * @tparam INDEX_TYPE the integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @tparam OFFSET_TYPE the integer used for the offsets, it may be wider than INDEX_TYPE.
  */
 template< typename T,
           typename INDEX_TYPE,
-          template< typename > class BUFFER_TYPE >
-class ArrayOfArrays : protected ArrayOfArraysView< T, INDEX_TYPE, false, BUFFER_TYPE >
+          template< typename > class BUFFER_TYPE,
+          typename OFFSET_TYPE=INDEX_TYPE >
+class ArrayOfArrays : protected ArrayOfArraysView< T, INDEX_TYPE, false, BUFFER_TYPE, OFFSET_TYPE >
 {
   /// An alias for the parent class.
-  using ParentClass = ArrayOfArraysView< T, INDEX_TYPE, false, BUFFER_TYPE >;
+  using ParentClass = ArrayOfArraysView< T, INDEX_TYPE, false, BUFFER_TYPE, OFFSET_TYPE >;
 
 public:
   using typename ParentClass::ValueType;
   using typename ParentClass::IndexType;
+  using typename ParentClass::OffsetType;
   using typename ParentClass::value_type;
   using typename ParentClass::size_type;
 
@@ -94,7 +98,7 @@ public:
    *   IS_VALID_EXPRESSION and this fails with NVCC.
    */
   constexpr inline
-  ArrayOfArraysView< T, INDEX_TYPE const, false, BUFFER_TYPE >
+  ArrayOfArraysView< T, INDEX_TYPE const, false, BUFFER_TYPE, OFFSET_TYPE >
   toView() const &
   { return ParentClass::toView(); }
 
@@ -106,7 +110,7 @@ public:
    *   This overload prevents that from happening.
    */
   constexpr inline
-  ArrayOfArraysView< T, INDEX_TYPE const, false, BUFFER_TYPE >
+  ArrayOfArraysView< T, INDEX_TYPE const, false, BUFFER_TYPE, OFFSET_TYPE >
   toView() const && = delete;
 
   /**
@@ -116,7 +120,7 @@ public:
    *   IS_VALID_EXPRESSION and this fails with NVCC.
    */
   constexpr inline
-  ArrayOfArraysView< T, INDEX_TYPE const, true, BUFFER_TYPE >
+  ArrayOfArraysView< T, INDEX_TYPE const, true, BUFFER_TYPE, OFFSET_TYPE >
   toViewConstSizes() const &
   { return ParentClass::toViewConstSizes(); }
 
@@ -128,7 +132,7 @@ public:
    *   This overload prevents that from happening.
    */
   constexpr inline
-  ArrayOfArraysView< T, INDEX_TYPE const, true, BUFFER_TYPE >
+  ArrayOfArraysView< T, INDEX_TYPE const, true, BUFFER_TYPE, OFFSET_TYPE >
   toViewConstSizes() const && = delete;
 
   /**
@@ -138,7 +142,7 @@ public:
    *   IS_VALID_EXPRESSION and this fails with NVCC.
    */
   constexpr inline
-  ArrayOfArraysView< T const, INDEX_TYPE const, true, BUFFER_TYPE >
+  ArrayOfArraysView< T const, INDEX_TYPE const, true, BUFFER_TYPE, OFFSET_TYPE >
   toViewConst() const &
   { return ParentClass::toViewConst(); }
 
@@ -150,7 +154,7 @@ public:
    *   This overload prevents that from happening.
    */
   constexpr inline
-  ArrayOfArraysView< T const, INDEX_TYPE const, true, BUFFER_TYPE >
+  ArrayOfArraysView< T const, INDEX_TYPE const, true, BUFFER_TYPE, OFFSET_TYPE >
   toViewConst() const && = delete;
 
   ///@}
@@ -194,7 +198,7 @@ public:
    * @param src the ArrayOfSets to convert.
    */
   inline
-  void assimilate( ArrayOfSets< T, INDEX_TYPE, BUFFER_TYPE > && src )
+  void assimilate( ArrayOfSets< T, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE > && src )
   {
     ParentClass::free();
     ParentClass::assimilate( reinterpret_cast< ParentClass && >( src ) );
@@ -256,6 +260,18 @@ public:
 
   using ParentClass::compress;
 
+  /**
+   * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+   * @brief Compress the arrays in parallel so that the values of each array are contiguous with no extra
+   *   capacity in between, see ArrayOfArraysView::compressParallel.
+   * @param outOfPlace If true the values are moved into a new allocation of exactly the compressed size
+   *   and the old one is freed, this temporarily needs memory for a second copy of the values.
+   *   Otherwise they are moved in place and no memory is freed.
+   */
+  template< typename POLICY >
+  void compress( bool const outOfPlace=false )
+  { ParentClass::template compressParallel< POLICY >( outOfPlace ); }
+
   ///@}
 
   /**
@@ -271,7 +287,7 @@ public:
   {
     LVARRAY_ASSERT( arrayManipulation::isPositive( n ) );
 
-    INDEX_TYPE const maxOffset = this->m_offsets[ this->m_numArrays ];
+    OFFSET_TYPE const maxOffset = this->m_offsets[ this->m_numArrays ];
     bufferManipulation::emplaceBack( this->m_offsets, this->m_numArrays + 1, maxOffset );
     bufferManipulation::emplaceBack( this->m_sizes, this->m_numArrays, 0 );
     ++this->m_numArrays;
@@ -288,7 +304,7 @@ public:
   template< typename ITER >
   void appendArray( ITER const first, ITER const last )
   {
-    INDEX_TYPE const maxOffset = this->m_offsets[ this->m_numArrays ];
+    OFFSET_TYPE const maxOffset = this->m_offsets[ this->m_numArrays ];
     bufferManipulation::emplaceBack( this->m_offsets, this->m_numArrays + 1, maxOffset );
     bufferManipulation::emplaceBack( this->m_sizes, this->m_numArrays, 0 );
     ++this->m_numArrays;
@@ -309,7 +325,7 @@ public:
     ARRAYOFARRAYS_CHECK_INSERT_BOUNDS( i );
 
     // Insert an array of capacity zero at the given location
-    INDEX_TYPE const offset = this->m_offsets[ i ];
+    OFFSET_TYPE const offset = this->m_offsets[ i ];
     bufferManipulation::emplace( this->m_offsets, this->m_numArrays + 1, i + 1, offset );
     bufferManipulation::emplace( this->m_sizes, this->m_numArrays, i, 0 );
     ++this->m_numArrays;
@@ -401,6 +417,9 @@ public:
 
   using ParentClass::eraseFromArray;
 
+  using ParentClass::sortEachArray;
+  using ParentClass::sortAndUniqueEachArray;
+
   /**
    * @brief Set the number of values in an array.
    * @tparam ARGS variadic template parameter of the types used to initialize any new values with.
@@ -25,7 +25,25 @@
 #include <RAJA/RAJA.hpp>
 
 // System includes
+#include <algorithm>
 #include <cstring>
+#include <vector>
+
+/**
+ * @brief ArrayOfArraysView::sortEachArray uses an insertion sort on arrays with at most this many values.
+ * @note This can be overridden at compile time.
+ */
+#if !defined(LVARRAY_SORT_EACH_ARRAY_INSERTION_SORT_MAX_SIZE)
+  #define LVARRAY_SORT_EACH_ARRAY_INSERTION_SORT_MAX_SIZE 16
+#endif
+
+/**
+ * @brief ArrayOfArraysView::sortEachArray uses a radix sort on arrays of integers with at least this many values.
+ * @note This can be overridden at compile time.
+ */
+#if !defined(LVARRAY_SORT_EACH_ARRAY_RADIX_SORT_MIN_SIZE)
+  #define LVARRAY_SORT_EACH_ARRAY_RADIX_SORT_MIN_SIZE 128
+#endif
 
 #ifdef LVARRAY_BOUNDS_CHECK
 
@@ -156,6 +174,9 @@ namespace LvArray
  * @tparam T the type stored in the arrays.
  * @tparam INDEX_TYPE the integer to use for indexing.
  * @tparam CONST_SIZES true iff the size of each array is constant.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @tparam OFFSET_TYPE the integer used for the offsets into the values, it may be wider than INDEX_TYPE
+ *   so that the total number of values can exceed the range of INDEX_TYPE.
  *
  * When INDEX_TYPE is const m_offsets is not copied between memory spaces.
  * When accessing this class directly (not through an ArrayOfArrays object)
@@ -166,7 +187,8 @@ namespace LvArray
 template< typename T,
           typename INDEX_TYPE,
           bool CONST_SIZES,
-          template< typename > class BUFFER_TYPE >
+          template< typename > class BUFFER_TYPE,
+          typename OFFSET_TYPE=std::remove_const_t< INDEX_TYPE > >
 class ArrayOfArraysView
 {
 protected:
@@ -176,10 +198,16 @@ protected:
   /// The type contained by the m_sizes buffer.
   using SIZE_TYPE = std::conditional_t< CONST_SIZES, INDEX_TYPE const, INDEX_TYPE_NC >;
 
+  /// The type contained by the m_offsets buffer, it is const when INDEX_TYPE is const.
+  using OFFSETS_TYPE = std::conditional_t< std::is_const< INDEX_TYPE >::value, OFFSET_TYPE const, OFFSET_TYPE >;
+
 public:
   static_assert( !std::is_const< T >::value || (std::is_const< INDEX_TYPE >::value && CONST_SIZES),
                  "When T is const INDEX_TYPE must also be const and CONST_SIZES must be true" );
   static_assert( std::is_integral< INDEX_TYPE >::value, "INDEX_TYPE must be integral." );
+  static_assert( std::is_integral< OFFSET_TYPE >::value && !std::is_const< OFFSET_TYPE >::value,
+                 "OFFSET_TYPE must be a non const integral type." );
+  static_assert( sizeof( OFFSET_TYPE ) >= sizeof( INDEX_TYPE ), "OFFSET_TYPE must be at least as wide as INDEX_TYPE." );
 
   /// An alias for the type contained in the inner arrays.
   using ValueType = T;
@@ -187,6 +215,9 @@ public:
   /// The integer type used for indexing.
   using IndexType = INDEX_TYPE;
 
+  /// The integer type used for the offsets into the values.
+  using OffsetType = OFFSET_TYPE;
+
   /// An alias for the type contained in the inner arrays, here for stl compatability.
   using value_type = T;
 
@@ -231,7 +262,7 @@ public:
    */
   LVARRAY_HOST_DEVICE constexpr inline
   ArrayOfArraysView( INDEX_TYPE const numArrays,
-                     BUFFER_TYPE< INDEX_TYPE > const & offsets,
+                     BUFFER_TYPE< OFFSETS_TYPE > const & offsets,
                      BUFFER_TYPE< SIZE_TYPE > const & sizes,
                      BUFFER_TYPE< T > const & values ):
     m_numArrays( numArrays ),
@@ -274,39 +305,39 @@ public:
    * @return Return a new ArrayOfArraysView<T, INDEX_TYPE const, CONST_SIZES>.
    */
   LVARRAY_HOST_DEVICE constexpr inline
-  ArrayOfArraysView< T, INDEX_TYPE const, CONST_SIZES, BUFFER_TYPE >
+  ArrayOfArraysView< T, INDEX_TYPE const, CONST_SIZES, BUFFER_TYPE, OFFSET_TYPE >
   toView() const
   {
-    return ArrayOfArraysView< T, INDEX_TYPE const, CONST_SIZES, BUFFER_TYPE >( size(),
-                                                                               this->m_offsets,
-                                                                               this->m_sizes,
-                                                                               this->m_values );
+    return ArrayOfArraysView< T, INDEX_TYPE const, CONST_SIZES, BUFFER_TYPE, OFFSET_TYPE >( size(),
+                                                                                            this->m_offsets,
+                                                                                            this->m_sizes,
+                                                                                            this->m_values );
   }
 
   /**
    * @return Return a new ArrayOfArraysView<T, INDEX_TYPE const, true>.
    */
   LVARRAY_HOST_DEVICE constexpr inline
-  ArrayOfArraysView< T, INDEX_TYPE const, true, BUFFER_TYPE >
+  ArrayOfArraysView< T, INDEX_TYPE const, true, BUFFER_TYPE, OFFSET_TYPE >
   toViewConstSizes() const
   {
-    return ArrayOfArraysView< T, INDEX_TYPE const, true, BUFFER_TYPE >( size(),
-                                                                        this->m_offsets,
-                                                                        this->m_sizes,
-                                                                        this->m_values );
+    return ArrayOfArraysView< T, INDEX_TYPE const, true, BUFFER_TYPE, OFFSET_TYPE >( size(),
+                                                                                     this->m_offsets,
+                                                                                     this->m_sizes,
+                                                                                     this->m_values );
   }
 
   /**
    * @return Return a new ArrayOfArraysView<T const, INDEX_TYPE const, true>.
    */
   LVARRAY_HOST_DEVICE constexpr inline
-  ArrayOfArraysView< T const, INDEX_TYPE const, true, BUFFER_TYPE >
+  ArrayOfArraysView< T const, INDEX_TYPE const, true, BUFFER_TYPE, OFFSET_TYPE >
   toViewConst() const
   {
-    return ArrayOfArraysView< T const, INDEX_TYPE const, true, BUFFER_TYPE >( size(),
-                                                                              this->m_offsets,
-                                                                              this->m_sizes,
-                                                                              this->m_values );
+    return ArrayOfArraysView< T const, INDEX_TYPE const, true, BUFFER_TYPE, OFFSET_TYPE >( size(),
+                                                                                           this->m_offsets,
+                                                                                           this->m_sizes,
+                                                                                           this->m_values );
   }
 
   ///@}
@@ -349,7 +380,7 @@ public:
    *   with an entry for the end of the values.
    */
   LVARRAY_HOST_DEVICE constexpr inline
-  INDEX_TYPE const * getOffsets() const
+  OFFSET_TYPE const * getOffsets() const
   {
     return m_offsets.data();
   }
@@ -390,7 +421,7 @@ public:
    * @return Return the total number values that can be stored before reallocation.
    */
   LVARRAY_HOST_DEVICE constexpr inline
-  INDEX_TYPE_NC valueCapacity() const
+  OFFSET_TYPE valueCapacity() const
   { return m_values.capacity(); }
 
   ///@}
@@ -558,6 +589,54 @@ public:
 
   ///@}
 
+  /**
+   * @name Methods that sort the arrays
+   */
+  ///@{
+
+  /**
+   * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+   * @brief Sort the values of every array in ascending order.
+   * @details The arrays are split into blocks that hold about the same number of values and the blocks
+   *   are sorted in parallel, so a few long arrays don't hold up the rest. Arrays with at most
+   *   LVARRAY_SORT_EACH_ARRAY_INSERTION_SORT_MAX_SIZE values are insertion sorted, arrays of integers with
+   *   at least LVARRAY_SORT_EACH_ARRAY_RADIX_SORT_MIN_SIZE values are radix sorted and the rest are sorted
+   *   with sortedArrayManipulation::makeSorted.
+   */
+  template< typename POLICY >
+  void sortEachArray() const
+  {
+    forEachArrayBalanced< POLICY >( [this] ( INDEX_TYPE const i, std::vector< T > & scratch )
+    {
+      sortValues( m_values.data() + m_offsets[ i ], sizeOfArray( i ), scratch,
+                  std::integral_constant< bool, std::is_integral< T >::value && !std::is_same< T, bool >::value >() );
+    } );
+  }
+
+  /**
+   * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+   * @brief Sort the values of every array in ascending order and remove the duplicates.
+   * @details This works like sortEachArray and the size of each array is updated in place. The capacity
+   *   of the arrays is unchanged, to give the freed space back call compress afterwards.
+   */
+  template< typename POLICY >
+  void sortAndUniqueEachArray() const
+  {
+    forEachArrayBalanced< POLICY >( [this] ( INDEX_TYPE const i, std::vector< T > & scratch )
+    {
+      T * const values = m_values.data() + m_offsets[ i ];
+      INDEX_TYPE const arraySize = sizeOfArray( i );
+      sortValues( values, arraySize, scratch,
+                  std::integral_constant< bool, std::is_integral< T >::value && !std::is_same< T, bool >::value >() );
+
+      INDEX_TYPE const numUnique = sortedArrayManipulation::removeDuplicates( values, values + arraySize );
+      arrayManipulation::resize( values, arraySize, numUnique );
+      m_sizes[ i ] = numUnique;
+    } );
+  }
+
+  ///@}
+
   /**
    * @name Methods dealing with memory spaces
    */
@@ -645,9 +724,9 @@ protected:
    *        similarly to m_values.
    */
   template< class ... BUFFERS >
-  void reserveValues( INDEX_TYPE const newValueCapacity, BUFFERS & ... buffers )
+  void reserveValues( OFFSET_TYPE const newValueCapacity, BUFFERS & ... buffers )
   {
-    INDEX_TYPE const maxOffset = m_offsets[ m_numArrays ];
+    OFFSET_TYPE const maxOffset = m_offsets[ m_numArrays ];
     typeManipulation::forEachArg( [newValueCapacity, maxOffset] ( auto & buffer )
     {
       bufferManipulation::reserve( buffer, maxOffset, MemorySpace::host, newValueCapacity );
@@ -668,8 +747,8 @@ protected:
 
     for( INDEX_TYPE i = 0; i < m_numArrays - 1; ++i )
     {
-      INDEX_TYPE const nextOffset = m_offsets[ i + 1 ];
-      INDEX_TYPE const shiftAmount = nextOffset - m_offsets[ i ] - sizeOfArray( i );
+      OFFSET_TYPE const nextOffset = m_offsets[ i + 1 ];
+      OFFSET_TYPE const shiftAmount = nextOffset - m_offsets[ i ] - sizeOfArray( i );
       INDEX_TYPE const sizeOfNextArray = sizeOfArray( i + 1 );
 
       // Shift the values in the next array down.
@@ -687,6 +766,131 @@ protected:
     m_offsets[ m_numArrays ] = m_offsets[ m_numArrays - 1 ] + sizeOfArray( m_numArrays - 1 );
   }
 
+  /**
+   * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+   * @tparam BUFFERS variadic template where each type is a BUFFER_TYPE.
+   * @brief Compress the arrays in parallel so that the values of each array are contiguous with no
+   *   extra capacity in between.
+   * @param outOfPlace If true the values are moved into new buffers of exactly the compressed size
+   *   and the old buffers are freed. This temporarily needs memory for a second copy of the values.
+   *   Otherwise the values are moved down in place and no memory is freed.
+   * @param buffers variadic parameter pack where each argument is a BUFFER_TYPE that should be treated
+   *   similarly to m_values.
+   * @details The new offsets are an exclusive scan of the sizes. In place, once the arrays before
+   *   @c i have been moved, array @c i can be moved concurrently with every following array whose new
+   *   position ends before the current start of array @c i. The arrays are moved in rounds of such blocks.
+   *   The leading arrays which are already in place are skipped. After those a block grows with the
+   *   extra capacity in front of it, so when there is little extra capacity compared to the size of the
+   *   arrays the blocks contain a single array and this does the same work as compress.
+   */
+  template< typename POLICY, class ... BUFFERS >
+  void compressParallel( bool const outOfPlace, BUFFERS & ... buffers )
+  {
+    if( m_numArrays == 0 ) return;
+
+    INDEX_TYPE const numArrays = m_numArrays;
+    OFFSET_TYPE * const offsets = m_offsets.data();
+    INDEX_TYPE const * const sizes = m_sizes.data();
+
+    BUFFER_TYPE< OFFSET_TYPE > newOffsetsBuffer( true );
+    newOffsetsBuffer.reallocate( 0, MemorySpace::host, numArrays + 1 );
+    OFFSET_TYPE * const newOffsets = newOffsetsBuffer.data();
+
+    newOffsets[ 0 ] = 0;
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numArrays ),
+                            [newOffsets, sizes] ( INDEX_TYPE const i )
+      { newOffsets[ i + 1 ] = sizes[ i ]; } );
+
+    RAJA::inclusive_scan_inplace< POLICY >( RAJA::make_span< OFFSET_TYPE * >( newOffsets + 1, numArrays ) );
+
+    if( outOfPlace )
+    { relocateArrays< POLICY >( newOffsets, buffers ... ); }
+    else
+    {
+      BUFFER_TYPE< T > & values = m_values;
+      auto const moveArray = [offsets, sizes, newOffsets, &values, &buffers ...] ( INDEX_TYPE const i )
+      {
+        typeManipulation::forEachArg( [offsets, sizes, newOffsets, i] ( auto & buffer )
+        {
+          arrayManipulation::uninitializedShiftDown( buffer.data() + offsets[ i ], sizes[ i ], offsets[ i ] - newOffsets[ i ] );
+        }, values, buffers ... );
+      };
+
+      // The shift of each array never decreases, so the arrays already in place form a prefix.
+      // Skip it so that compressing a compressed or nearly compressed object does no rounds.
+      INDEX_TYPE begin = 0;
+      while( begin < numArrays && offsets[ begin ] == newOffsets[ begin ] )
+      { ++begin; }
+
+      while( begin < numArrays )
+      {
+        // The number of arrays, starting at begin, whose new position ends at or before offsets[ begin ].
+        OFFSET_TYPE const * const firstEnd = newOffsets + begin + 1;
+        OFFSET_TYPE const * const lastEnd = newOffsets + numArrays + 1;
+        INDEX_TYPE const numSafe = std::upper_bound( firstEnd, lastEnd, offsets[ begin ] ) - firstEnd;
+        INDEX_TYPE const end = begin + math::max( numSafe, INDEX_TYPE( 1 ) );
+
+        if( end - begin == 1 )
+        { moveArray( begin ); }
+        else
+        {
+          RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( begin, end ), moveArray );
+        }
+
+        begin = end;
+      }
+
+      RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numArrays + 1 ),
+                              [offsets, newOffsets] ( INDEX_TYPE const i )
+        { offsets[ i ] = newOffsets[ i ]; } );
+    }
+
+    newOffsetsBuffer.free();
+  }
+
+  /**
+   * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+   * @tparam BUFFERS variadic template where each type is a BUFFER_TYPE.
+   * @brief Move the values of every array into new buffers with the given offsets and free the old buffers.
+   * @param newOffsets The new offset of each array, of length size() + 1. The capacity of each array
+   *   given by @p newOffsets must be at least its size.
+   * @param buffers variadic parameter pack where each argument is a BUFFER_TYPE that should be treated
+   *   similarly to m_values.
+   */
+  template< typename POLICY, class ... BUFFERS >
+  void relocateArrays( OFFSET_TYPE const * const newOffsets, BUFFERS & ... buffers )
+  {
+    INDEX_TYPE const numArrays = m_numArrays;
+    OFFSET_TYPE * const offsets = m_offsets.data();
+    INDEX_TYPE const * const sizes = m_sizes.data();
+    OFFSET_TYPE const newCapacity = newOffsets[ numArrays ];
+
+    typeManipulation::forEachArg( [numArrays, offsets, sizes, newOffsets, newCapacity] ( auto & buffer )
+    {
+      using BufferType = std::remove_reference_t< decltype( buffer ) >;
+      using ValueType = std::remove_reference_t< decltype( buffer[ 0 ] ) >;
+
+      BufferType newBuffer( true );
+      newBuffer.reallocate( 0, MemorySpace::host, newCapacity );
+
+      ValueType * const oldValues = buffer.data();
+      ValueType * const newValues = newBuffer.data();
+      RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numArrays ),
+                              [offsets, sizes, newOffsets, oldValues, newValues] ( INDEX_TYPE const i )
+        {
+          arrayManipulation::uninitializedMove( newValues + newOffsets[ i ], sizes[ i ], oldValues + offsets[ i ] );
+          arrayManipulation::destroy( oldValues + offsets[ i ], sizes[ i ] );
+        } );
+
+      buffer.free();
+      buffer = std::move( newBuffer );
+    }, m_values, buffers ... );
+
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numArrays + 1 ),
+                            [offsets, newOffsets] ( INDEX_TYPE const i )
+      { offsets[ i ] = newOffsets[ i ]; } );
+  }
+
   /**
    * @brief Clears the array and creates a new array with the given number of sub-arrays.
    * @param numSubArrays The new number of arrays.
@@ -696,7 +900,7 @@ protected:
    */
   template< typename ... BUFFERS >
   void resizeFromOffsets( INDEX_TYPE const numSubArrays,
-                          INDEX_TYPE const * const offsets,
+                          OFFSET_TYPE const * const offsets,
                           BUFFERS & ... buffers )
   {
     auto const fillOffsets = [&]()
@@ -724,13 +928,15 @@ protected:
   {
     auto const fillOffsets = [&]()
     {
-      m_offsets[ 0 ] = 0;
-//      RAJA::inclusive_scan< POLICY >( capacities,
-//                                      capacities + numSubArrays,
-//                                      m_offsets.data() + 1 );
+      OFFSET_TYPE * const offsets = m_offsets.data();
+      offsets[ 0 ] = 0;
+
+      // The capacities are widened into the offsets first so that the scan is done in OFFSET_TYPE.
+      RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numSubArrays ),
+                              [offsets, capacities] ( INDEX_TYPE const i )
+        { offsets[ i + 1 ] = capacities[ i ]; } );
 
-      RAJA::inclusive_scan< POLICY >( RAJA::make_span< INDEX_TYPE const * >( capacities, numSubArrays ),
-                                      RAJA::make_span< INDEX_TYPE * >( m_offsets.data()+1, numSubArrays ) );
+      RAJA::inclusive_scan_inplace< POLICY >( RAJA::make_span< OFFSET_TYPE * >( offsets + 1, numSubArrays ) );
     };
     resizeFromOffsetsImpl( numSubArrays, fillOffsets, buffers ... );
   }
@@ -746,7 +952,7 @@ protected:
    * @brief Steal the resources of @p src, clearing it in the process.
    * @param src The ArrayOfArraysView to steal from.
    */
-  void assimilate( ArrayOfArraysView< T, INDEX_TYPE, CONST_SIZES, BUFFER_TYPE > && src )
+  void assimilate( ArrayOfArraysView< T, INDEX_TYPE, CONST_SIZES, BUFFER_TYPE, OFFSET_TYPE > && src )
   { *this = std::move( src ); }
 
   /**
@@ -772,7 +978,7 @@ protected:
     {
       // The ternary here accounts for the case where m_offsets hasn't been allocated yet (when calling from a
       // constructor).
-      INDEX_TYPE const originalOffset = (m_numArrays == 0) ? 0 : m_offsets[m_numArrays];
+      OFFSET_TYPE const originalOffset = (m_numArrays == 0) ? 0 : m_offsets[m_numArrays];
       bufferManipulation::resize( m_offsets, offsetsSize, newSize + 1, originalOffset );
       bufferManipulation::resize( m_sizes, m_numArrays, newSize, 0 );
 
@@ -780,12 +986,12 @@ protected:
       {
         for( INDEX_TYPE i = 1; i < newSize + 1 - m_numArrays; ++i )
         {
-          m_offsets[ m_numArrays + i ] = originalOffset + i * defaultArrayCapacity;
+          m_offsets[ m_numArrays + i ] = originalOffset + OFFSET_TYPE( i ) * defaultArrayCapacity;
         }
 
-        INDEX_TYPE const totalSize = m_offsets[ newSize ];
+        OFFSET_TYPE const totalSize = m_offsets[ newSize ];
 
-        INDEX_TYPE const maxOffset = m_offsets[ m_numArrays ];
+        OFFSET_TYPE const maxOffset = m_offsets[ m_numArrays ];
         typeManipulation::forEachArg( [totalSize, maxOffset]( auto & buffer )
         {
           bufferManipulation::reserve( buffer, maxOffset, MemorySpace::host, totalSize );
@@ -828,8 +1034,8 @@ protected:
    */
   template< class ... PAIRS_OF_BUFFERS >
   void setEqualTo( INDEX_TYPE const srcNumArrays,
-                   INDEX_TYPE const srcMaxOffset,
-                   BUFFER_TYPE< INDEX_TYPE > const & srcOffsets,
+                   OFFSET_TYPE const srcMaxOffset,
+                   BUFFER_TYPE< OFFSET_TYPE > const & srcOffsets,
                    BUFFER_TYPE< INDEX_TYPE > const & srcSizes,
                    BUFFER_TYPE< T > const & srcValues,
                    PAIRS_OF_BUFFERS && ... pairs )
@@ -841,7 +1047,7 @@ protected:
     bufferManipulation::copyInto( m_offsets, offsetsSize, srcOffsets, srcNumArrays + 1 );
     bufferManipulation::copyInto( m_sizes, m_numArrays, srcSizes, srcNumArrays );
 
-    INDEX_TYPE const maxOffset = m_offsets[ m_numArrays ];
+    OFFSET_TYPE const maxOffset = m_offsets[ m_numArrays ];
     typeManipulation::forEachArg( [maxOffset, srcMaxOffset]( auto & dstBuffer )
     {
       bufferManipulation::reserve( dstBuffer, maxOffset, MemorySpace::host, srcMaxOffset );
@@ -856,7 +1062,7 @@ protected:
 
       for( INDEX_TYPE_NC i = 0; i < m_numArrays; ++i )
       {
-        INDEX_TYPE const offset = m_offsets[ i ];
+        OFFSET_TYPE const offset = m_offsets[ i ];
         INDEX_TYPE const arraySize = sizeOfArray( i );
         arrayManipulation::uninitializedCopy( &srcBuffer[ offset ],
                                               &srcBuffer[ offset ] + arraySize,
@@ -885,7 +1091,7 @@ protected:
 
     if( capacityIncrease > 0 )
     {
-      INDEX_TYPE const maxOffset = m_offsets[ m_numArrays ];
+      OFFSET_TYPE const maxOffset = m_offsets[ m_numArrays ];
       typeManipulation::forEachArg(
         [this, i, maxOffset, capacityIncrease]( auto & buffer )
       {
@@ -896,7 +1102,7 @@ protected:
         for( INDEX_TYPE array = m_numArrays - 1; array > i; --array )
         {
           INDEX_TYPE const curArraySize = sizeOfArray( array );
-          INDEX_TYPE const curArrayOffset = m_offsets[ array ];
+          OFFSET_TYPE const curArrayOffset = m_offsets[ array ];
           arrayManipulation::uninitializedShiftUp( &buffer[ curArrayOffset ], curArraySize, capacityIncrease );
         }
       },
@@ -905,7 +1111,7 @@ protected:
     }
     else
     {
-      INDEX_TYPE const arrayOffset = m_offsets[ i ];
+      OFFSET_TYPE const arrayOffset = m_offsets[ i ];
       INDEX_TYPE const capacityDecrease = -capacityIncrease;
 
       INDEX_TYPE const prevArraySize = sizeOfArray( i );
@@ -922,7 +1128,7 @@ protected:
         for( INDEX_TYPE array = i + 1; array < m_numArrays; ++array )
         {
           INDEX_TYPE const curArraySize = sizeOfArray( array );
-          INDEX_TYPE const curArrayOffset = m_offsets[array];
+          OFFSET_TYPE const curArrayOffset = m_offsets[array];
           arrayManipulation::uninitializedShiftDown( &buffer[ curArrayOffset ], curArraySize, capacityDecrease );
         }
       },
@@ -962,7 +1168,7 @@ protected:
 
   /// Holds the offset of each array, of length m_numArrays + 1. Array i begins at
   /// m_offsets[ i ] and has capacity m_offsets[i+1] - m_offsets[ i ].
-  BUFFER_TYPE< INDEX_TYPE > m_offsets;
+  BUFFER_TYPE< OFFSETS_TYPE > m_offsets;
 
   /// Holds the size of each array.
   BUFFER_TYPE< SIZE_TYPE > m_sizes;
@@ -973,6 +1179,85 @@ protected:
 
 private:
 
+  /**
+   * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+   * @tparam LAMBDA The type of the function to call on each array.
+   * @brief Call @p body on every array, with the arrays split into blocks of about the same amount of work.
+   * @param body The function to call, it is called as @code body( i, scratch ) @endcode where @c scratch
+   *   is a std::vector private to the block that contains array @c i.
+   * @details The cost of an array is its size plus one and the arrays of a block are visited serially.
+   */
+  template< typename POLICY, typename LAMBDA >
+  void forEachArrayBalanced( LAMBDA && body ) const
+  {
+    if( m_numArrays == 0 ) return;
+
+    INDEX_TYPE const numArrays = m_numArrays;
+    INDEX_TYPE const * const sizes = m_sizes.data();
+
+    // costs[ i ] is the cost of the arrays before array i.
+    BUFFER_TYPE< OFFSET_TYPE > costsBuffer( true );
+    costsBuffer.reallocate( 0, MemorySpace::host, numArrays + 1 );
+    OFFSET_TYPE * const costs = costsBuffer.data();
+
+    costs[ 0 ] = 0;
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numArrays ),
+                            [costs, sizes] ( INDEX_TYPE const i )
+      { costs[ i + 1 ] = sizes[ i ] + 1; } );
+
+    RAJA::inclusive_scan_inplace< POLICY >( RAJA::make_span< OFFSET_TYPE * >( costs + 1, numArrays ) );
+
+    // Block b starts at the first array whose cost begins at or after b * totalCost / numBlocks.
+    OFFSET_TYPE const totalCost = costs[ numArrays ];
+    INDEX_TYPE const numBlocks = math::min( numArrays, INDEX_TYPE( 1024 ) );
+    auto const blockBegin = [costs, numArrays, numBlocks, totalCost] ( INDEX_TYPE const block ) -> INDEX_TYPE
+    {
+      OFFSET_TYPE const target = totalCost / numBlocks * block + totalCost % numBlocks * block / numBlocks;
+      return std::lower_bound( costs, costs + numArrays, target ) - costs;
+    };
+
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numBlocks ),
+                            [&body, &blockBegin] ( INDEX_TYPE const block )
+      {
+        INDEX_TYPE const end = blockBegin( block + 1 );
+        std::vector< T > scratch;
+        for( INDEX_TYPE i = blockBegin( block ); i < end; ++i )
+        { body( i, scratch ); }
+      } );
+
+    costsBuffer.free();
+  }
+
+  /**
+   * @brief Sort an array of integers, @p scratch is used by the radix sort.
+   * @param values The values of the array.
+   * @param arraySize The size of the array.
+   * @param scratch The scratch space for the radix sort, it is grown as needed.
+   */
+  static void sortValues( T * const values, INDEX_TYPE const arraySize, std::vector< T > & scratch, std::true_type )
+  {
+    if( arraySize < LVARRAY_SORT_EACH_ARRAY_RADIX_SORT_MIN_SIZE )
+    { return sortValues( values, arraySize, scratch, std::false_type() ); }
+
+    if( scratch.size() < std::size_t( arraySize ) )
+    { scratch.resize( arraySize ); }
+
+    sortedArrayManipulation::radixSort( values, arraySize, scratch.data() );
+  }
+
+  /**
+   * @brief Sort an array of values that can't be radix sorted.
+   * @param values The values of the array.
+   * @param arraySize The size of the array.
+   */
+  static void sortValues( T * const values, INDEX_TYPE const arraySize, std::vector< T > &, std::false_type )
+  {
+    if( arraySize <= LVARRAY_SORT_EACH_ARRAY_INSERTION_SORT_MAX_SIZE )
+    { sortedArrayManipulation::internal::insertionSort( values, arraySize, sortedArrayManipulation::less< T >() ); }
+    else
+    { sortedArrayManipulation::makeSorted( values, values + arraySize ); }
+  }
+
   /**
    * @brief Destroy the values in arrays in the range [begin, end).
    * @tparam BUFFERS variadic template where each type is a BUFFER_TYPE.
@@ -1002,7 +1287,7 @@ private:
         buffer.move( MemorySpace::host, true );
         for( INDEX_TYPE i = begin; i < end; ++i )
         {
-          INDEX_TYPE const offset = m_offsets[ i ];
+          OFFSET_TYPE const offset = m_offsets[ i ];
           INDEX_TYPE const arraySize = sizeOfArray( i );
           arrayManipulation::destroy( &buffer[ offset ], arraySize );
         }
@@ -1037,7 +1322,7 @@ private:
     LVARRAY_ASSERT( sortedArrayManipulation::isSorted( m_offsets.data(), m_offsets.data() + numSubArrays + 1 ) );
 
     m_numArrays = numSubArrays;
-    INDEX_TYPE const maxOffset = m_offsets[ m_numArrays ];
+    OFFSET_TYPE const maxOffset = m_offsets[ m_numArrays ];
     typeManipulation::forEachArg( [ maxOffset ] ( auto & buffer )
     {
       bufferManipulation::reserve( buffer, 0, MemorySpace::host, maxOffset );
@@ -13,12 +13,14 @@
 #pragma once
 
 #include "ArrayOfSetsView.hpp"
+#include "Array.hpp"
+#include "sparseMatrixOpsHelpers.hpp"
 
 namespace LvArray
 {
 
 // Forward declaration of the ArrayOfArrays class so that we can define the assimilate method.
-template< typename T, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+template< typename T, typename INDEX_TYPE, template< typename > class BUFFER_TYPE, typename OFFSET_TYPE >
 class ArrayOfArrays;
 
 
@@ -27,19 +29,23 @@ class ArrayOfArrays;
  * @brief This class implements an array of sets like object with contiguous storage.
  * @tparam T the type stored in the sets.
  * @tparam INDEX_TYPE the integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @tparam OFFSET_TYPE the integer used for the offsets, it may be wider than INDEX_TYPE.
  */
 template< typename T,
           typename INDEX_TYPE,
-          template< typename > class BUFFER_TYPE >
-class ArrayOfSets : protected ArrayOfSetsView< T, INDEX_TYPE, BUFFER_TYPE >
+          template< typename > class BUFFER_TYPE,
+          typename OFFSET_TYPE=INDEX_TYPE >
+class ArrayOfSets : protected ArrayOfSetsView< T, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE >
 {
 
   /// An alias for the parent class.
-  using ParentClass = ArrayOfSetsView< T, INDEX_TYPE, BUFFER_TYPE >;
+  using ParentClass = ArrayOfSetsView< T, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE >;
 
 public:
   using typename ParentClass::ValueType;
   using typename ParentClass::IndexType;
+  using typename ParentClass::OffsetType;
   using typename ParentClass::value_type;
   using typename ParentClass::size_type;
 
@@ -127,59 +133,87 @@ public:
    */
   template< typename POLICY >
   inline
-  void assimilate( ArrayOfArrays< T, INDEX_TYPE, BUFFER_TYPE > && src,
+  void assimilate( ArrayOfArrays< T, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE > && src,
                    sortedArrayManipulation::Description const desc )
   {
     ParentClass::free();
     ParentClass::assimilate( reinterpret_cast< ParentClass && >( src ) );
 
-    INDEX_TYPE const numSets = size();
-    ArrayOfArraysView< T, INDEX_TYPE const, true, BUFFER_TYPE > const view =
-      ArrayOfArraysView< T, INDEX_TYPE const, true, BUFFER_TYPE >( numSets,
-                                                                   this->m_offsets,
-                                                                   this->m_sizes,
-                                                                   this->m_values );
-    BUFFER_TYPE< INDEX_TYPE > const sizes = this->m_sizes;
-
-    if( desc == sortedArrayManipulation::UNSORTED_NO_DUPLICATES )
-    {
-      RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numSets ),
-                              [view] LVARRAY_HOST_DEVICE ( INDEX_TYPE const i )
-        {
-          ArraySlice< T, 1, 0, INDEX_TYPE > const setValues = view[i];
-          sortedArrayManipulation::makeSorted( setValues.begin(), setValues.end() );
-        } );
-    }
-    else if( desc == sortedArrayManipulation::SORTED_WITH_DUPLICATES )
-    {
-      RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numSets ),
-                              [view, sizes] LVARRAY_HOST_DEVICE ( INDEX_TYPE const i )
-        {
-          ArraySlice< T, 1, 0, INDEX_TYPE > const setValues = view[i];
-          INDEX_TYPE const numUniqueValues = sortedArrayManipulation::removeDuplicates( setValues.begin(), setValues.end() );
-          arrayManipulation::resize< T >( setValues, setValues.size(), numUniqueValues );
-          sizes[ i ] = numUniqueValues;
-        } );
-    }
-    else if( desc == sortedArrayManipulation::UNSORTED_WITH_DUPLICATES )
-    {
-      RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numSets ),
-                              [view, sizes] LVARRAY_HOST_DEVICE ( INDEX_TYPE const i )
-        {
-          ArraySlice< T, 1, 0, INDEX_TYPE > const setValues = view[ i ];
-          INDEX_TYPE const numUniqueValues = sortedArrayManipulation::makeSortedUnique( setValues.begin(), setValues.end() );
-          arrayManipulation::resize< T >( setValues, setValues.size(), numUniqueValues );
-          sizes[ i ] = numUniqueValues;
-        } );
-    }
-
-#ifdef ARRAY_BOUNDS_CHECK
-    consistencyCheck();
-#endif
+    ParentClass::template makeSetsSortedUnique< POLICY >( desc );
   }
 
   using ParentClass::resizeFromCapacities;
 
+  /**
+   * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+   * @brief Clear the ArrayOfSets and fill it with the intersection of each pair of sets.
+   * @param a The sets the first of each pair is taken from.
+   * @param b The sets the second of each pair is taken from, it may be the same as @p a.
+   * @param pairs The pairs of sets, of size numPairs x 2. Set @c k is the intersection of set
+   *   @c pairs( k, 0 ) of @p a and set @c pairs( k, 1 ) of @p b.
+   * @details The size of each result is computed in parallel, the sets are allocated once with exactly
+   *   that capacity and then filled in parallel.
+   * @pre Neither @p a nor @p b may be a view of this ArrayOfSets.
+   */
+  template< typename POLICY >
+  void setToIntersections( ArrayOfSetsView< T const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE > const & a,
+                           ArrayOfSetsView< T const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE > const & b,
+                           ArrayView< INDEX_TYPE const, 2, 1, INDEX_TYPE, BUFFER_TYPE > const & pairs )
+  {
+    setToPairwise< POLICY >( a, b, pairs,
+                             [] ( INDEX_TYPE, INDEX_TYPE, INDEX_TYPE const intersectionSize )
+      { return intersectionSize; },
+                             [] ( T const * const first, INDEX_TYPE const firstSize,
+                                  T const * const second, INDEX_TYPE const secondSize,
+                                  T * const output )
+      { return sortedArrayManipulation::setIntersection( first, firstSize, second, secondSize, output ); } );
+  }
+
+  /**
+   * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+   * @brief Clear the ArrayOfSets and fill it with the union of each pair of sets.
+   * @param a The sets the first of each pair is taken from.
+   * @param b The sets the second of each pair is taken from, it may be the same as @p a.
+   * @param pairs The pairs of sets, see setToIntersections.
+   * @pre Neither @p a nor @p b may be a view of this ArrayOfSets.
+   */
+  template< typename POLICY >
+  void setToUnions( ArrayOfSetsView< T const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE > const & a,
+                    ArrayOfSetsView< T const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE > const & b,
+                    ArrayView< INDEX_TYPE const, 2, 1, INDEX_TYPE, BUFFER_TYPE > const & pairs )
+  {
+    setToPairwise< POLICY >( a, b, pairs,
+                             [] ( INDEX_TYPE const firstSize, INDEX_TYPE const secondSize, INDEX_TYPE const intersectionSize )
+      { return firstSize + secondSize - intersectionSize; },
+                             [] ( T const * const first, INDEX_TYPE const firstSize,
+                                  T const * const second, INDEX_TYPE const secondSize,
+                                  T * const output )
+      { return sortedArrayManipulation::setUnion( first, firstSize, second, secondSize, output ); } );
+  }
+
+  /**
+   * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+   * @brief Clear the ArrayOfSets and fill it with the difference of each pair of sets.
+   * @param a The sets the first of each pair is taken from.
+   * @param b The sets the second of each pair is taken from, it may be the same as @p a.
+   * @param pairs The pairs of sets, see setToIntersections. Set @c k holds the values of the first set
+   *   of the pair that aren't in the second.
+   * @pre Neither @p a nor @p b may be a view of this ArrayOfSets.
+   */
+  template< typename POLICY >
+  void setToDifferences( ArrayOfSetsView< T const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE > const & a,
+                         ArrayOfSetsView< T const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE > const & b,
+                         ArrayView< INDEX_TYPE const, 2, 1, INDEX_TYPE, BUFFER_TYPE > const & pairs )
+  {
+    setToPairwise< POLICY >( a, b, pairs,
+                             [] ( INDEX_TYPE const firstSize, INDEX_TYPE, INDEX_TYPE const intersectionSize )
+      { return firstSize - intersectionSize; },
+                             [] ( T const * const first, INDEX_TYPE const firstSize,
+                                  T const * const second, INDEX_TYPE const secondSize,
+                                  T * const output )
+      { return sortedArrayManipulation::setDifference( first, firstSize, second, secondSize, output ); } );
+  }
+
   ///@}
 
   /**
@@ -194,7 +228,7 @@ public:
    *   IS_VALID_EXPRESSION and this fails with NVCC.
    */
   constexpr inline
-  ArrayOfSetsView< T, INDEX_TYPE const, BUFFER_TYPE >
+  ArrayOfSetsView< T, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
   toView() const &
   { return ParentClass::toView(); }
 
@@ -206,7 +240,7 @@ public:
    *   This overload prevents that from happening.
    */
   constexpr inline
-  ArrayOfSetsView< T, INDEX_TYPE const, BUFFER_TYPE >
+  ArrayOfSetsView< T, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
   toView() const && = delete;
 
   /**
@@ -216,7 +250,7 @@ public:
    *   IS_VALID_EXPRESSION and this fails with NVCC.
    */
   constexpr inline
-  ArrayOfSetsView< T const, INDEX_TYPE const, BUFFER_TYPE >
+  ArrayOfSetsView< T const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
   toViewConst() const &
   { return ParentClass::toViewConst(); }
 
@@ -228,7 +262,7 @@ public:
    *   This overload prevents that from happening.
    */
   constexpr inline
-  ArrayOfSetsView< T const, INDEX_TYPE const, BUFFER_TYPE >
+  ArrayOfSetsView< T const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
   toViewConst() const && = delete;
 
   /**
@@ -238,7 +272,7 @@ public:
    *   IS_VALID_EXPRESSION and this fails with NVCC.
    */
   constexpr inline
-  ArrayOfArraysView< T const, INDEX_TYPE const, true, BUFFER_TYPE >
+  ArrayOfArraysView< T const, INDEX_TYPE const, true, BUFFER_TYPE, OFFSET_TYPE >
   toArrayOfArraysView() const &
   { return ParentClass::toArrayOfArraysView(); }
 
@@ -250,7 +284,7 @@ public:
    *   This overload prevents that from happening.
    */
   constexpr inline
-  ArrayOfArraysView< T const, INDEX_TYPE const, true, BUFFER_TYPE >
+  ArrayOfArraysView< T const, INDEX_TYPE const, true, BUFFER_TYPE, OFFSET_TYPE >
   toArrayOfArraysView() const && = delete;
 
   ///@}
@@ -275,6 +309,7 @@ public:
   using ParentClass::capacityOfSet;
   using ParentClass::valueCapacity;
   using ParentClass::contains;
+  using ParentClass::intersectionSizes;
   using ParentClass::consistencyCheck;
 
   ///@}
@@ -309,6 +344,18 @@ public:
 
   using ParentClass::compress;
 
+  /**
+   * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+   * @brief Compress the sets in parallel so that the values of each set are contiguous with no extra
+   *   capacity in between, see ArrayOfArraysView::compressParallel.
+   * @param outOfPlace If true the values are moved into a new allocation of exactly the compressed size
+   *   and the old one is freed, this temporarily needs memory for a second copy of the values.
+   *   Otherwise they are moved in place and no memory is freed.
+   */
+  template< typename POLICY >
+  void compress( bool const outOfPlace=false )
+  { ParentClass::template compressParallel< POLICY >( outOfPlace ); }
+
   ///@}
 
   /**
@@ -323,7 +370,7 @@ public:
   inline
   void appendSet( INDEX_TYPE const setCapacity=0 )
   {
-    INDEX_TYPE const maxOffset = this->m_offsets[ this->m_numArrays ];
+    OFFSET_TYPE const maxOffset = this->m_offsets[ this->m_numArrays ];
     bufferManipulation::emplaceBack( this->m_offsets, this->m_numArrays + 1, maxOffset );
     bufferManipulation::emplaceBack( this->m_sizes, this->m_numArrays, 0 );
     ++this->m_numArrays;
@@ -343,7 +390,7 @@ public:
     LVARRAY_ASSERT( arrayManipulation::isPositive( setCapacity ) );
 
     // Insert an set of capacity zero at the given location
-    INDEX_TYPE const offset = this->m_offsets[i];
+    OFFSET_TYPE const offset = this->m_offsets[i];
     bufferManipulation::emplace( this->m_offsets, this->m_numArrays + 1, i + 1, offset );
     bufferManipulation::emplace( this->m_sizes, this->m_numArrays, i, 0 );
     ++this->m_numArrays;
@@ -398,6 +445,126 @@ public:
   INDEX_TYPE insertIntoSet( INDEX_TYPE const i, ITER const first, ITER const last )
   { return ParentClass::insertIntoSetImpl( i, first, last, CallBacks( *this, i ) ); }
 
+  using ParentClass::insertIntoSetAtomic;
+
+  /**
+   * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+   * @brief Insert many values into many sets at once.
+   * @param sets The set to insert each value into, every set must be less than size().
+   * @param values The values to insert, they don't need to be in any order and may contain duplicates.
+   * @param numBlocks The number of blocks the pairs are split into, this does not change the result.
+   * @details The ( set, value ) pairs are grouped by set with a parallel counting sort. Then in parallel
+   *   the values of each set are sorted, the duplicates and the values already in the set are removed,
+   *   which gives the new size of each set. If any set is too small every set is moved once into a new
+   *   allocation where the sets that grow have exactly the capacity they need. Finally the new values
+   *   of each set are merged into it in parallel. This is much faster than calling insertIntoSet for each
+   *   value since the capacity is only increased once.
+   */
+  template< typename POLICY >
+  void insertIntoSets( ArrayView< INDEX_TYPE const, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & sets,
+                       ArrayView< T const, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & values,
+                       INDEX_TYPE const numBlocks=sparseMatrixOps::internal::defaultNumTransposeBlocks( POLICY {} ) )
+  {
+    LVARRAY_ERROR_IF_NE_MSG( values.size(), sets.size(), "There must be a value for every set." );
+
+    move( MemorySpace::host, true );
+
+    // Group the values by set, each block holds a contiguous range of the pairs.
+    INDEX_TYPE const numPairs = sets.size();
+    INDEX_TYPE const numSets = size();
+    INDEX_TYPE const nBlocks = math::max( INDEX_TYPE( 1 ), math::min( numBlocks, numPairs ) );
+    auto const getSets = [sets, numPairs, nBlocks] ( INDEX_TYPE const block )
+    {
+      INDEX_TYPE const begin = sparseMatrixOps::internal::blockBegin( numPairs, nBlocks, block );
+      INDEX_TYPE const end = sparseMatrixOps::internal::blockBegin( numPairs, nBlocks, block + 1 );
+      return RAJA::make_span( sets.data() + begin, end - begin );
+    };
+    sparseMatrixOps::internal::Transposer< POLICY, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE > transposer( nBlocks, numSets, nBlocks, getSets );
+
+    Array< T, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > newValues( numPairs );
+    ArrayView< T, 1, 0, INDEX_TYPE, BUFFER_TYPE > const newValuesView = newValues.toView();
+    transposer.fill( getSets,
+                     [values, numPairs, nBlocks, newValuesView]
+                       ( INDEX_TYPE const block, INDEX_TYPE const i, INDEX_TYPE, OFFSET_TYPE const pos )
+      { newValuesView[ pos ] = values[ sparseMatrixOps::internal::blockBegin( numPairs, nBlocks, block ) + i ]; } );
+
+    // Sort each group and keep only the values that aren't already in the set.
+    OFFSET_TYPE const * const groupOffsets = transposer.getOffsets();
+    Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > numNew;
+    numNew.resizeWithoutInitializationOrDestruction( numSets );
+    ArrayView< INDEX_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const numNewView = numNew.toView();
+
+    OFFSET_TYPE * const offsets = this->m_offsets.data();
+    INDEX_TYPE * const sizes = this->m_sizes.data();
+    T const * const oldValues = this->m_values.data();
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numSets ),
+                            [groupOffsets, newValuesView, numNewView, offsets, sizes, oldValues] ( INDEX_TYPE const set )
+      {
+        T * const group = newValuesView.data() + groupOffsets[ set ];
+        INDEX_TYPE const groupSize = sortedArrayManipulation::makeSortedUnique( group, group + groupOffsets[ set + 1 ] - groupOffsets[ set ] );
+
+        // Both are sorted so this is a merge.
+        T const * const setValues = oldValues + offsets[ set ];
+        INDEX_TYPE const setSize = sizes[ set ];
+        INDEX_TYPE numKept = 0;
+        INDEX_TYPE j = 0;
+        for( INDEX_TYPE i = 0; i < groupSize; ++i )
+        {
+          while( j < setSize && setValues[ j ] < group[ i ] )
+          { ++j; }
+
+          if( j == setSize || group[ i ] < setValues[ j ] )
+          {
+            if( numKept != i )
+            { group[ numKept ] = std::move( group[ i ] ); }
+            ++numKept;
+          }
+        }
+
+        numNewView[ set ] = numKept;
+      } );
+
+    // A set only grows if it is too small, so if the total capacity is unchanged every set is large enough.
+    Array< OFFSET_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > newOffsets( numSets + 1 );
+    OFFSET_TYPE * const newOffsetsPtr = newOffsets.data();
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numSets ),
+                            [numNewView, offsets, sizes, newOffsetsPtr] ( INDEX_TYPE const set )
+      {
+        newOffsetsPtr[ set + 1 ] = math::max( OFFSET_TYPE( offsets[ set + 1 ] - offsets[ set ] ),
+                                              OFFSET_TYPE( sizes[ set ] + numNewView[ set ] ) );
+      } );
+
+    RAJA::inclusive_scan_inplace< POLICY >( RAJA::make_span< OFFSET_TYPE * >( newOffsetsPtr + 1, numSets ) );
+
+    if( newOffsetsPtr[ numSets ] != offsets[ numSets ] )
+    { ParentClass::template relocateArrays< POLICY >( newOffsetsPtr ); }
+
+    // Merge the new values into each set from the back, the slots past the old size are uninitialized.
+    T * const setsValues = this->m_values.data();
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numSets ),
+                            [groupOffsets, newValuesView, numNewView, offsets, sizes, setsValues] ( INDEX_TYPE const set )
+      {
+        T * const group = newValuesView.data() + groupOffsets[ set ];
+        T * const setValues = setsValues + offsets[ set ];
+        INDEX_TYPE const oldSize = sizes[ set ];
+        // i and j are the number of old and new values left to place, k is one past the next slot.
+        INDEX_TYPE i = oldSize;
+        INDEX_TYPE j = numNewView[ set ];
+        INDEX_TYPE k = oldSize + j;
+        while( j > 0 )
+        {
+          --k;
+          T & src = ( i > 0 && group[ j - 1 ] < setValues[ i - 1 ] ) ? setValues[ --i ] : group[ --j ];
+          if( k >= oldSize )
+          { new ( setValues + k ) T( std::move( src ) ); }
+          else
+          { setValues[ k ] = std::move( src ); }
+        }
+
+        sizes[ set ] = oldSize + numNewView[ set ];
+      } );
+  }
+
   /**
    * @copydoc ParentClass::removeFromSet
    * @note This is not brought in with a @c using statement because it breaks doxygen.
@@ -486,6 +653,50 @@ private:
 
   using ParentClass::getSetValues;
 
+  /**
+   * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+   * @tparam SIZE The type of @p getSize.
+   * @tparam FILL The type of @p fill.
+   * @brief Clear the ArrayOfSets and fill set @c k with the result of a set operation on pair @c k.
+   * @param a The sets the first of each pair is taken from.
+   * @param b The sets the second of each pair is taken from.
+   * @param pairs The pairs of sets, of size numPairs x 2.
+   * @param getSize Returns the size of a result from the sizes of the two sets and of their intersection.
+   * @param fill Constructs the result in uninitialized memory and returns its size.
+   */
+  template< typename POLICY, typename SIZE, typename FILL >
+  void setToPairwise( ArrayOfSetsView< T const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE > const & a,
+                      ArrayOfSetsView< T const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE > const & b,
+                      ArrayView< INDEX_TYPE const, 2, 1, INDEX_TYPE, BUFFER_TYPE > const & pairs,
+                      SIZE && getSize,
+                      FILL && fill )
+  {
+    INDEX_TYPE const numPairs = pairs.size( 0 );
+    Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > capacities;
+    capacities.resizeWithoutInitializationOrDestruction( numPairs );
+    ArrayView< INDEX_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const capacitiesView = capacities.toView();
+    a.template intersectionSizes< POLICY >( b, pairs, capacitiesView );
+
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numPairs ),
+                            [a, b, pairs, capacitiesView, getSize] ( INDEX_TYPE const k )
+      { capacitiesView[ k ] = getSize( a.sizeOfSet( pairs( k, 0 ) ), b.sizeOfSet( pairs( k, 1 ) ), capacitiesView[ k ] ); } );
+
+    this->template resizeFromCapacities< POLICY >( numPairs, capacities.data() );
+
+    T * const values = this->m_values.data();
+    OFFSET_TYPE const * const offsets = this->m_offsets.data();
+    INDEX_TYPE * const sizes = this->m_sizes.data();
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numPairs ),
+                            [a, b, pairs, fill, values, offsets, sizes] ( INDEX_TYPE const k )
+      {
+        INDEX_TYPE const i = pairs( k, 0 );
+        INDEX_TYPE const j = pairs( k, 1 );
+        T const * const first = a[ i ];
+        T const * const second = b[ j ];
+        sizes[ k ] = fill( first, a.sizeOfSet( i ), second, b.sizeOfSet( j ), values + offsets[ k ] );
+      } );
+  }
+
   /**
    * @class CallBacks
    * @brief This class provides the callbacks for the sortedArrayManipulation routines.
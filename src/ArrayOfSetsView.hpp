@@ -17,16 +17,33 @@
 #include "arrayManipulation.hpp"
 #include "sortedArrayManipulation.hpp"
 #include "ArraySlice.hpp"
+#include "ArrayView.hpp"
 #include "typeManipulation.hpp"
 
+// System includes
+#include <atomic>
+
 namespace LvArray
 {
 
+/**
+ * @enum AtomicInsertResult
+ * @brief The result of ArrayOfSetsView::insertIntoSetAtomic.
+ */
+enum class AtomicInsertResult
+{
+  present, ///< The set already contained the value.
+  inserted, ///< The value was inserted.
+  overflow ///< The set was full and the value was not inserted.
+};
+
 /**
  * @class ArrayOfSetsView
  * @brief This class provides a view into an array of sets like object.
  * @tparam T the type stored in the arrays.
  * @tparam INDEX_TYPE the integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @tparam OFFSET_TYPE the integer used for the offsets, it may be wider than INDEX_TYPE.
  *
  * When INDEX_TYPE is const m_offsets is not touched when copied between memory spaces.
  * INDEX_TYPE should always be const since ArrayOfSetsview is not allowed to modify the offsets.
@@ -36,21 +53,25 @@ namespace LvArray
  */
 template< typename T,
           typename INDEX_TYPE,
-          template< typename > class BUFFER_TYPE >
-class ArrayOfSetsView : protected ArrayOfArraysView< T, INDEX_TYPE, std::is_const< T >::value, BUFFER_TYPE >
+          template< typename > class BUFFER_TYPE,
+          typename OFFSET_TYPE=std::remove_const_t< INDEX_TYPE > >
+class ArrayOfSetsView : protected ArrayOfArraysView< T, INDEX_TYPE, std::is_const< T >::value, BUFFER_TYPE, OFFSET_TYPE >
 {
 protected:
   /// Alias for the parent class
-  using ParentClass = ArrayOfArraysView< T, INDEX_TYPE, std::is_const< T >::value, BUFFER_TYPE >;
+  using ParentClass = ArrayOfArraysView< T, INDEX_TYPE, std::is_const< T >::value, BUFFER_TYPE, OFFSET_TYPE >;
 
   /// Since INDEX_TYPE should always be const we need an alias for the non const version.
   using INDEX_TYPE_NC = typename ParentClass::INDEX_TYPE_NC;
 
   using typename ParentClass::SIZE_TYPE;
 
+  using typename ParentClass::OFFSETS_TYPE;
+
 public:
   using typename ParentClass::ValueType;
   using typename ParentClass::IndexType;
+  using typename ParentClass::OffsetType;
   using typename ParentClass::value_type;
   using typename ParentClass::size_type;
 
@@ -88,7 +109,7 @@ public:
    */
   LVARRAY_HOST_DEVICE constexpr inline
   ArrayOfSetsView( INDEX_TYPE const numArrays,
-                   BUFFER_TYPE< INDEX_TYPE > const & offsets,
+                   BUFFER_TYPE< OFFSETS_TYPE > const & offsets,
                    BUFFER_TYPE< SIZE_TYPE > const & sizes,
                    BUFFER_TYPE< T > const & values ):
     ParentClass( numArrays, offsets, sizes, values )
@@ -119,39 +140,39 @@ public:
    * @return Return a new ArrayOfSetsView< T, INDEX_TYPE const >.
    */
   LVARRAY_HOST_DEVICE constexpr inline
-  ArrayOfSetsView< T, INDEX_TYPE const, BUFFER_TYPE >
+  ArrayOfSetsView< T, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
   toView() const
   {
-    return ArrayOfSetsView< T, INDEX_TYPE const, BUFFER_TYPE >( size(),
-                                                                this->m_offsets,
-                                                                this->m_sizes,
-                                                                this->m_values );
+    return ArrayOfSetsView< T, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >( size(),
+                                                                             this->m_offsets,
+                                                                             this->m_sizes,
+                                                                             this->m_values );
   }
 
   /**
    * @return Return a new ArrayOfSetsView< T const, INDEX_TYPE const >.
    */
   LVARRAY_HOST_DEVICE constexpr inline
-  ArrayOfSetsView< T const, INDEX_TYPE const, BUFFER_TYPE >
+  ArrayOfSetsView< T const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
   toViewConst() const
   {
-    return ArrayOfSetsView< T const, INDEX_TYPE const, BUFFER_TYPE >( size(),
-                                                                      this->m_offsets,
-                                                                      this->m_sizes,
-                                                                      this->m_values );
+    return ArrayOfSetsView< T const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >( size(),
+                                                                                   this->m_offsets,
+                                                                                   this->m_sizes,
+                                                                                   this->m_values );
   }
 
   /**
    * @return Return a new ArrayOfArraysView< T const, INDEX_TYPE const, true >.
    */
   LVARRAY_HOST_DEVICE constexpr inline
-  ArrayOfArraysView< T const, INDEX_TYPE const, true, BUFFER_TYPE >
+  ArrayOfArraysView< T const, INDEX_TYPE const, true, BUFFER_TYPE, OFFSET_TYPE >
   toArrayOfArraysView() const
   {
-    return ArrayOfArraysView< T const, INDEX_TYPE const, true, BUFFER_TYPE >( size(),
-                                                                              this->m_offsets,
-                                                                              this->m_sizes,
-                                                                              this->m_values );
+    return ArrayOfArraysView< T const, INDEX_TYPE const, true, BUFFER_TYPE, OFFSET_TYPE >( size(),
+                                                                                           this->m_offsets,
+                                                                                           this->m_sizes,
+                                                                                           this->m_values );
   }
 
   ///@}
@@ -199,6 +220,35 @@ public:
     return sortedArrayManipulation::contains( setValues, setSize, value );
   }
 
+  /**
+   * @tparam POLICY The RAJA policy to use.
+   * @brief Compute the size of the intersection of many pairs of sets in parallel.
+   * @param other The sets the second of each pair is taken from, it may be a view of this.
+   * @param pairs The pairs of sets, of size numPairs x 2. Pair @c k is set @c pairs( k, 0 ) of this
+   *   and set @c pairs( k, 1 ) of @p other.
+   * @param sizes The size of the intersection of each pair, of length numPairs.
+   * @note The sizes of the union and the difference follow from these, see sortedArrayManipulation::setUnion.
+   */
+  template< typename POLICY >
+  void intersectionSizes( ArrayOfSetsView< T const, INDEX_TYPE_NC const, BUFFER_TYPE, OFFSET_TYPE > const & other,
+                          ArrayView< INDEX_TYPE_NC const, 2, 1, INDEX_TYPE_NC, BUFFER_TYPE > const & pairs,
+                          ArrayView< INDEX_TYPE_NC, 1, 0, INDEX_TYPE_NC, BUFFER_TYPE > const & sizes ) const
+  {
+    LVARRAY_ERROR_IF_NE( pairs.size( 1 ), 2 );
+    LVARRAY_ERROR_IF_NE( sizes.size(), pairs.size( 0 ) );
+
+    ArrayOfSetsView< T const, INDEX_TYPE_NC const, BUFFER_TYPE, OFFSET_TYPE > const self = toViewConst();
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE_NC >( 0, pairs.size( 0 ) ),
+                            [self, other, pairs, sizes] LVARRAY_HOST_DEVICE ( INDEX_TYPE_NC const k )
+      {
+        INDEX_TYPE_NC const i = pairs( k, 0 );
+        INDEX_TYPE_NC const j = pairs( k, 1 );
+        T const * const first = self[ i ];
+        T const * const second = other[ j ];
+        sizes[ k ] = sortedArrayManipulation::setIntersectionSize( first, self.sizeOfSet( i ), second, other.sizeOfSet( j ) );
+      } );
+  }
+
   /**
    * @brief Verify that the capacity of each set is greater than or equal to the
    *   size and that each set is sorted unique.
@@ -277,6 +327,73 @@ public:
   INDEX_TYPE_NC insertIntoSet( INDEX_TYPE const i, ITER const first, ITER const last ) const
   { return insertIntoSetImpl( i, first, last, CallBacks( *this, i ) ); }
 
+  /**
+   * @tparam POLICY The RAJA atomic policy to use.
+   * @brief Insert a value into the given set in a thread safe manner.
+   * @param i The set to insert into.
+   * @param value The value to insert.
+   * @return AtomicInsertResult::inserted if the value was inserted, AtomicInsertResult::present if
+   *   the set already contained it and AtomicInsertResult::overflow if the set is full. In the last
+   *   case the set is unchanged, it is up to the caller to record the value, grow the capacity of
+   *   the set outside of the parallel region and try again.
+   * @details Each set is protected by a spin lock stored in an unused high bit of its size, so no
+   *   extra memory is needed. Threads only contend when inserting into the same set.
+   * @note While any thread may be inserting, this is the only method that may be called on the sets.
+   * @note On devices without independent thread scheduling a spin lock can deadlock if two threads
+   *   of a warp insert into the same set.
+   */
+  template< typename POLICY >
+  LVARRAY_HOST_DEVICE inline
+  AtomicInsertResult insertIntoSetAtomic( INDEX_TYPE const i, T const & value ) const
+  {
+    ARRAYOFARRAYS_CHECK_BOUNDS( i );
+
+    INDEX_TYPE_NC constexpr lockBit = INDEX_TYPE_NC( 1 ) << ( 8 * sizeof( INDEX_TYPE_NC ) - 2 );
+    INDEX_TYPE_NC * const sizePtr = &this->m_sizes[ i ];
+
+    INDEX_TYPE_NC volatile const * const volatileSizePtr = sizePtr;
+
+    INDEX_TYPE_NC setSize = RAJA::atomicOr< POLICY >( sizePtr, lockBit );
+    while( setSize & lockBit )
+    {
+      // Wait with plain reads so that the waiting threads don't keep writing the contended line.
+      while( *volatileSizePtr & lockBit )
+      {}
+
+      setSize = RAJA::atomicOr< POLICY >( sizePtr, lockBit );
+    }
+
+    // The RAJA atomics are relaxed, acquire the lock so the set isn't read before it's taken.
+#if defined(__CUDA_ARCH__) || defined(__HIP_DEVICE_COMPILE__)
+    __threadfence();
+#else
+    std::atomic_thread_fence( std::memory_order_acquire );
+#endif
+
+    T * const setValues = getSetValues( i );
+    INDEX_TYPE_NC const pos = sortedArrayManipulation::find( setValues, setSize, value );
+
+    AtomicInsertResult result = AtomicInsertResult::inserted;
+    if( pos < setSize && setValues[ pos ] == value )
+    { result = AtomicInsertResult::present; }
+    else if( setSize == capacityOfSet( i ) )
+    { result = AtomicInsertResult::overflow; }
+    else
+    {
+      arrayManipulation::emplace( setValues, setSize, pos, value );
+      ++setSize;
+    }
+
+    // Publish the modified set before releasing the lock.
+#if defined(__CUDA_ARCH__) || defined(__HIP_DEVICE_COMPILE__)
+    __threadfence();
+#else
+    std::atomic_thread_fence( std::memory_order_release );
+#endif
+    RAJA::atomicExchange< POLICY >( sizePtr, setSize );
+    return result;
+  }
+
   /**
    * @brief Remove a value from the given set.
    * @param i The set to remove from.
@@ -327,6 +444,61 @@ public:
   using ParentClass::getOffsets;
   using ParentClass::getValues;
 
+  /**
+   * @tparam POLICY a RAJA execution policy to use when sorting/removing duplicates in sub-arrays.
+   * @brief Sort each set and remove any duplicates, for use after the values have been written
+   *   directly, for example by assimilating an ArrayOfArrays.
+   * @param desc describes the type of data in the sets.
+   * @note This should be protected but cuda won't let you put an extended lambda in a protected or private method.
+   */
+  template< typename POLICY >
+  void makeSetsSortedUnique( sortedArrayManipulation::Description const desc )
+  {
+    INDEX_TYPE const numSets = size();
+    ArrayOfArraysView< T, INDEX_TYPE const, true, BUFFER_TYPE, OFFSET_TYPE > const view =
+      ArrayOfArraysView< T, INDEX_TYPE const, true, BUFFER_TYPE, OFFSET_TYPE >( numSets,
+                                                                                this->m_offsets,
+                                                                                this->m_sizes,
+                                                                                this->m_values );
+    BUFFER_TYPE< INDEX_TYPE > const sizes = this->m_sizes;
+
+    if( desc == sortedArrayManipulation::UNSORTED_NO_DUPLICATES )
+    {
+      RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numSets ),
+                              [view] LVARRAY_HOST_DEVICE ( INDEX_TYPE const i )
+        {
+          ArraySlice< T, 1, 0, INDEX_TYPE > const setValues = view[i];
+          sortedArrayManipulation::makeSorted( setValues.begin(), setValues.end() );
+        } );
+    }
+    else if( desc == sortedArrayManipulation::SORTED_WITH_DUPLICATES )
+    {
+      RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numSets ),
+                              [view, sizes] LVARRAY_HOST_DEVICE ( INDEX_TYPE const i )
+        {
+          ArraySlice< T, 1, 0, INDEX_TYPE > const setValues = view[i];
+          INDEX_TYPE const numUniqueValues = sortedArrayManipulation::removeDuplicates( setValues.begin(), setValues.end() );
+          arrayManipulation::resize< T >( setValues, setValues.size(), numUniqueValues );
+          sizes[ i ] = numUniqueValues;
+        } );
+    }
+    else if( desc == sortedArrayManipulation::UNSORTED_WITH_DUPLICATES )
+    {
+      RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numSets ),
+                              [view, sizes] LVARRAY_HOST_DEVICE ( INDEX_TYPE const i )
+        {
+          ArraySlice< T, 1, 0, INDEX_TYPE > const setValues = view[ i ];
+          INDEX_TYPE const numUniqueValues = sortedArrayManipulation::makeSortedUnique( setValues.begin(), setValues.end() );
+          arrayManipulation::resize< T >( setValues, setValues.size(), numUniqueValues );
+          sizes[ i ] = numUniqueValues;
+        } );
+    }
+
+#ifdef ARRAY_BOUNDS_CHECK
+    consistencyCheck();
+#endif
+  }
+
 protected:
 
   /**
@@ -0,0 +1,374 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC and LvArray contributors.
+ * All rights reserved.
+ * See the LICENSE file for details.
+ * SPDX-License-Identifier: (BSD-3-Clause)
+ */
+
+/**
+ * @file BlockCRSMatrix.hpp
+ * @brief Contains the implementation of LvArray::BlockCRSMatrix.
+ */
+
+#pragma once
+
+#include "BlockCRSMatrixView.hpp"
+#include "arrayManipulation.hpp"
+
+namespace LvArray
+{
+
+template< typename COL_TYPE, typename INDEX_TYPE, template< typename > class BUFFER_TYPE, typename OFFSET_TYPE >
+class SparsityPattern;
+
+/**
+ * @tparam T the type of the entries in the matrix.
+ * @tparam BLOCK_SIZE The number of rows and columns in each block.
+ * @tparam COL_TYPE the integer used to enumerate the block columns.
+ * @tparam INDEX_TYPE the integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @class BlockCRSMatrix
+ * @brief This class implements a block compressed row storage matrix.
+ * @details The block structure is built with a SparsityPattern and then assimilated,
+ *   see BlockCRSMatrixView for a description of the storage.
+ */
+template< typename T,
+          int BLOCK_SIZE,
+          typename COL_TYPE,
+          typename INDEX_TYPE,
+          template< typename > class BUFFER_TYPE >
+class BlockCRSMatrix : protected BlockCRSMatrixView< T, BLOCK_SIZE, COL_TYPE, INDEX_TYPE, BUFFER_TYPE >
+{
+
+  /// An alias for the parent class.
+  using ParentClass = BlockCRSMatrixView< T, BLOCK_SIZE, COL_TYPE, INDEX_TYPE, BUFFER_TYPE >;
+
+  using typename ParentClass::BlockStorage;
+
+public:
+
+  using typename ParentClass::EntryType;
+  using typename ParentClass::ColType;
+  using typename ParentClass::IndexType;
+  using typename ParentClass::BlockType;
+  using ParentClass::blockSize;
+
+  /**
+   * @name Constructors and the destructor
+   */
+  ///@{
+
+  /**
+   * @brief Constructor, creates an empty matrix.
+   */
+  BlockCRSMatrix():
+    ParentClass( true )
+  {
+    ParentClass::resize( 0, 0, 0, this->m_entries );
+    setName( "" );
+  }
+
+  /**
+   * @brief Copy constructor, performs a deep copy.
+   * @param src the BlockCRSMatrix to copy.
+   */
+  inline
+  BlockCRSMatrix( BlockCRSMatrix const & src ):
+    ParentClass( true )
+  { *this = src; }
+
+  /**
+   * @brief Default move constructor, performs a shallow copy.
+   */
+  inline
+  BlockCRSMatrix( BlockCRSMatrix && ) = default;
+
+  /**
+   * @brief Destructor, frees the blocks, columns, sizes and offsets Buffers.
+   */
+  ~BlockCRSMatrix()
+  { ParentClass::free( this->m_entries ); }
+
+  ///@}
+
+  /**
+   * @name Methods to construct the matrix from scratch.
+   */
+  ///@{
+
+  /**
+   * @brief Copy assignment operator, performs a deep copy.
+   * @param src the BlockCRSMatrix to copy.
+   * @return *this.
+   */
+  inline
+  BlockCRSMatrix & operator=( BlockCRSMatrix const & src )
+  {
+    this->m_numCols = src.m_numCols;
+    ParentClass::setEqualTo( src.m_numArrays,
+                             src.m_offsets[ src.m_numArrays ],
+                             src.m_offsets,
+                             src.m_sizes,
+                             src.m_values,
+                             typename ParentClass::template PairOfBuffers< BlockStorage >( this->m_entries, src.m_entries ) );
+    return *this;
+  }
+
+  /**
+   * @brief Default move assignment operator, performs a shallow copy.
+   * @param src The BlockCRSMatrix to be moved from.
+   * @return *this.
+   */
+  inline
+  BlockCRSMatrix & operator=( BlockCRSMatrix && src )
+  {
+    ParentClass::free( this->m_entries );
+    ParentClass::operator=( std::move( src ) );
+    return *this;
+  }
+
+  /**
+   * @brief Steal the resources from a SparsityPattern which describes the block structure.
+   * @tparam POLICY The RAJA policy used to initialize the blocks.
+   * @param src the SparsityPattern to convert.
+   * @note All the blocks are zero initialized.
+   */
+  template< typename POLICY >
+  inline
+  void assimilate( SparsityPattern< COL_TYPE, INDEX_TYPE, BUFFER_TYPE, INDEX_TYPE > && src )
+  {
+    // The blocks are trivially destructible so they can just be released.
+    bufferManipulation::reserve( this->m_entries, 0, MemorySpace::host, src.nonZeroCapacity() );
+
+    ParentClass::assimilate( reinterpret_cast< SparsityPatternView< COL_TYPE, INDEX_TYPE, BUFFER_TYPE > && >( src ) );
+
+    BlockCRSMatrixView< T, BLOCK_SIZE, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const view = toViewConstSizes();
+    BUFFER_TYPE< BlockStorage > const entries = this->m_entries;
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numRows() ),
+                            [view, entries] LVARRAY_HOST_DEVICE ( INDEX_TYPE const row )
+      {
+        BlockStorage * const rowBlocks = entries.data() + view.getOffsets()[ row ];
+        for( INDEX_TYPE i = 0; i < view.numNonZeros( row ); ++i )
+        {
+          new ( rowBlocks + i ) BlockStorage();
+        }
+      } );
+
+    setName( "" );
+  }
+
+  ///@}
+
+  /**
+   * @name BlockCRSMatrixView and SparsityPatternView creation methods
+   */
+  ///@{
+
+  /**
+   * @copydoc ParentClass::toViewConstSizes
+   * @note This is just a wrapper around the BlockCRSMatrixView method. The reason
+   *   it isn't pulled in with a @c using statement is that it is detected using
+   *   IS_VALID_EXPRESSION and this fails with NVCC.
+   */
+  LVARRAY_HOST_DEVICE constexpr inline
+  BlockCRSMatrixView< T, BLOCK_SIZE, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >
+  toViewConstSizes() const &
+  { return ParentClass::toViewConstSizes(); }
+
+  /**
+   * @brief Overload for rvalues that is deleted.
+   * @return A null BlockCRSMatrixView.
+   * @note This cannot be called on a rvalue since the @c BlockCRSMatrixView would
+   *   contain the buffers of the current @c BlockCRSMatrix that is about to be destroyed.
+   *   This overload prevents that from happening.
+   */
+  LVARRAY_HOST_DEVICE constexpr inline
+  BlockCRSMatrixView< T, BLOCK_SIZE, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >
+  toViewConstSizes() const && = delete;
+
+  /**
+   * @copydoc ParentClass::toViewConst
+   * @note This is just a wrapper around the BlockCRSMatrixView method. The reason
+   *   it isn't pulled in with a @c using statement is that it is detected using
+   *   IS_VALID_EXPRESSION and this fails with NVCC.
+   */
+  LVARRAY_HOST_DEVICE constexpr inline
+  BlockCRSMatrixView< T const, BLOCK_SIZE, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >
+  toViewConst() const &
+  { return ParentClass::toViewConst(); }
+
+  /**
+   * @brief Overload for rvalues that is deleted.
+   * @return A null BlockCRSMatrixView.
+   * @note This cannot be called on a rvalue since the @c BlockCRSMatrixView would
+   *   contain the buffers of the current @c BlockCRSMatrix that is about to be destroyed.
+   *   This overload prevents that from happening.
+   */
+  LVARRAY_HOST_DEVICE constexpr inline
+  BlockCRSMatrixView< T const, BLOCK_SIZE, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >
+  toViewConst() const && = delete;
+
+  using ParentClass::toSparsityPatternView;
+
+  /**
+   * @brief Overload for rvalues that is deleted.
+   * @return A null SparsityPatternView.
+   * @note This cannot be called on a rvalue since the @c SparsityPatternView would
+   *   contain the buffers of the current @c BlockCRSMatrix that is about to be destroyed.
+   *   This overload prevents that from happening.
+   */
+  LVARRAY_HOST_DEVICE constexpr inline
+  SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >
+  toSparsityPatternView() const && = delete;
+
+  ///@}
+
+  /**
+   * @name Attribute querying methods
+   */
+  ///@{
+
+  using ParentClass::numRows;
+  using ParentClass::numColumns;
+  using ParentClass::numScalarRows;
+  using ParentClass::numScalarColumns;
+  using ParentClass::numNonZeros;
+  using ParentClass::nonZeroCapacity;
+  using ParentClass::empty;
+
+  ///@}
+
+  /**
+   * @name Methods that provide access to the data
+   */
+  ///@{
+
+  using ParentClass::getOffsets;
+  using ParentClass::getColumns;
+  using ParentClass::getBlock;
+
+  ///@}
+
+  /**
+   * @name Methods to change the capacity
+   */
+  ///@{
+
+  /**
+   * @brief Compress the BlockCRSMatrix so that the columns and blocks of each row
+   *        are contiguous with no extra capacity in between.
+   * @note This method doesn't free any memory.
+   */
+  inline
+  void compress()
+  { ParentClass::compress( this->m_entries ); }
+
+  ///@}
+
+  /**
+   * @name Methods that modify the entries of the matrix
+   */
+  ///@{
+
+  /**
+   * @copydoc ParentClass::setValues
+   * @note This is not brought in with a @c using statement because it breaks doxygen.
+   */
+  template< typename POLICY >
+  inline
+  void setValues( T const & value ) const
+  { ParentClass::template setValues< POLICY >( value ); }
+
+  using ParentClass::zero;
+
+  /**
+   * @copydoc ParentClass::addToRow
+   * @note This is not brought in with a @c using statement because it breaks doxygen.
+   */
+  template< typename AtomicPolicy >
+  inline
+  void addToRow( INDEX_TYPE const row,
+                 COL_TYPE const * const LVARRAY_RESTRICT cols,
+                 T const ( *const LVARRAY_RESTRICT blocks )[ BLOCK_SIZE ][ BLOCK_SIZE ],
+                 INDEX_TYPE const nCols ) const
+  { ParentClass::template addToRow< AtomicPolicy >( row, cols, blocks, nCols ); }
+
+  /**
+   * @copydoc ParentClass::addToRowBinarySearch
+   * @note This is not brought in with a @c using statement because it breaks doxygen.
+   */
+  template< typename AtomicPolicy >
+  inline
+  void addToRowBinarySearch( INDEX_TYPE const row,
+                             COL_TYPE const * const LVARRAY_RESTRICT cols,
+                             T const ( *const LVARRAY_RESTRICT blocks )[ BLOCK_SIZE ][ BLOCK_SIZE ],
+                             INDEX_TYPE const nCols ) const
+  { ParentClass::template addToRowBinarySearch< AtomicPolicy >( row, cols, blocks, nCols ); }
+
+  /**
+   * @copydoc ParentClass::addToRowLinearSearch
+   * @note This is not brought in with a @c using statement because it breaks doxygen.
+   */
+  template< typename AtomicPolicy >
+  inline
+  void addToRowLinearSearch( INDEX_TYPE const row,
+                             COL_TYPE const * const LVARRAY_RESTRICT cols,
+                             T const ( *const LVARRAY_RESTRICT blocks )[ BLOCK_SIZE ][ BLOCK_SIZE ],
+                             INDEX_TYPE const nCols ) const
+  { ParentClass::template addToRowLinearSearch< AtomicPolicy >( row, cols, blocks, nCols ); }
+
+  /**
+   * @copydoc ParentClass::addToRowBinarySearchUnsorted
+   * @note This is not brought in with a @c using statement because it breaks doxygen.
+   */
+  template< typename AtomicPolicy >
+  inline
+  void addToRowBinarySearchUnsorted( INDEX_TYPE const row,
+                                     COL_TYPE const * const LVARRAY_RESTRICT cols,
+                                     T const ( *const LVARRAY_RESTRICT blocks )[ BLOCK_SIZE ][ BLOCK_SIZE ],
+                                     INDEX_TYPE const nCols ) const
+  { ParentClass::template addToRowBinarySearchUnsorted< AtomicPolicy >( row, cols, blocks, nCols ); }
+
+  ///@}
+
+  /**
+   * @name Linear algebra methods
+   */
+  ///@{
+
+  /**
+   * @copydoc ParentClass::multiply
+   * @note This is not brought in with a @c using statement because it breaks doxygen.
+   */
+  template< typename POLICY >
+  void multiply( ArrayView< T const, 1, 0, std::remove_const_t< INDEX_TYPE >, BUFFER_TYPE > const & x,
+                 ArrayView< T, 1, 0, std::remove_const_t< INDEX_TYPE >, BUFFER_TYPE > const & y ) const
+  { ParentClass::template multiply< POLICY >( x, y ); }
+
+  ///@}
+
+  /**
+   * @name Methods dealing with memory spaces
+   */
+  ///@{
+
+  /**
+   * @copydoc BlockCRSMatrixView::move
+   * @note This is just a wrapper around the BlockCRSMatrixView method. The reason
+   *   it isn't pulled in with a @c using statement is that it is detected using
+   *   IS_VALID_EXPRESSION and this fails with NVCC.
+   */
+  void move( MemorySpace const space, bool const touch=true ) const
+  { return ParentClass::move( space, touch ); }
+
+  ///@}
+
+  /**
+   * @brief Set the name associated with this BlockCRSMatrix which is used in the chai callback.
+   * @param name the of the BlockCRSMatrix.
+   */
+  void setName( std::string const & name )
+  { ParentClass::template setName< decltype( *this ) >( name ); }
+};
+
+} /* namespace LvArray */
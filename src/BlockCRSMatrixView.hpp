@@ -0,0 +1,561 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC and LvArray contributors.
+ * All rights reserved.
+ * See the LICENSE file for details.
+ * SPDX-License-Identifier: (BSD-3-Clause)
+ */
+
+/**
+ * @file BlockCRSMatrixView.hpp
+ * @brief Contains the implementation of LvArray::BlockCRSMatrixView.
+ */
+
+#pragma once
+
+#include "CRSMatrixView.hpp"
+#include "ArrayView.hpp"
+
+namespace LvArray
+{
+
+namespace internal
+{
+
+/**
+ * @struct DenseBlock
+ * @brief The type stored for each non zero of a BlockCRSMatrix.
+ * @tparam T The type of the entries of the block.
+ * @tparam BLOCK_SIZE The number of rows and columns in the block.
+ * @details This is an aggregate so value initialization zeroes the block, and since it
+ *   is a single object per non zero the ArrayOfArraysView routines that shift, copy and
+ *   compress the columns work on the blocks unchanged.
+ */
+template< typename T, int BLOCK_SIZE >
+struct DenseBlock
+{
+  /// The entries of the block, stored row major.
+  T data[ BLOCK_SIZE ][ BLOCK_SIZE ];
+};
+
+} // namespace internal
+
+/**
+ * @class BlockCRSMatrixView
+ * @brief This class provides a view into a block compressed row storage matrix.
+ * @tparam T The type of the entries of the matrix.
+ * @tparam BLOCK_SIZE The number of rows and columns in each block.
+ * @tparam COL_TYPE The integer used to enumerate the block columns.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @details The sparsity pattern is a SparsityPatternView over the block rows and block columns,
+ *   for each non zero a dense @p BLOCK_SIZE x @p BLOCK_SIZE block is stored. Compared to a
+ *   CRSMatrix with the same scalar entries this stores a factor of @p BLOCK_SIZE squared fewer
+ *   column indices and the rows searched by addToRow are @p BLOCK_SIZE times shorter.
+ *   Unless otherwise noted rows and columns refer to block rows and block columns.
+ * @note When T, COL_TYPE and INDEX_TYPE are const you cannot modify the matrix in any way
+ *   and nothing is copied back from the device.
+ */
+template< typename T,
+          int BLOCK_SIZE,
+          typename COL_TYPE,
+          typename INDEX_TYPE,
+          template< typename > class BUFFER_TYPE >
+class BlockCRSMatrixView : protected SparsityPatternView< COL_TYPE, INDEX_TYPE, BUFFER_TYPE >
+{
+protected:
+
+  /// An alias for the parent class.
+  using ParentClass = SparsityPatternView< COL_TYPE, INDEX_TYPE, BUFFER_TYPE >;
+
+  /// An alias for the non const index type.
+  using typename ParentClass::INDEX_TYPE_NC;
+
+  using typename ParentClass::SIZE_TYPE;
+
+  /// The type stored in the entries buffer, const if T is const.
+  using BlockStorage = std::conditional_t< std::is_const< T >::value,
+                                           internal::DenseBlock< std::remove_const_t< T >, BLOCK_SIZE > const,
+                                           internal::DenseBlock< T, BLOCK_SIZE > >;
+
+public:
+  static_assert( BLOCK_SIZE > 0, "BLOCK_SIZE must be positive." );
+  static_assert( !std::is_const< T >::value ||
+                 (std::is_const< COL_TYPE >::value && std::is_const< INDEX_TYPE >::value),
+                 "When T is const COL_TYPE and INDEX_TYPE must also be const." );
+
+  /// The type of the entries in the matrix.
+  using EntryType = T;
+  using typename ParentClass::ColType;
+  using typename ParentClass::IndexType;
+
+  /// The type of a single block, a reference to which can be passed to the tensorOps functions.
+  using BlockType = T[ BLOCK_SIZE ][ BLOCK_SIZE ];
+
+  /// The number of rows and columns in each block.
+  static constexpr int blockSize = BLOCK_SIZE;
+
+  /**
+   * @name Constructors, destructor and assignment operators
+   */
+  ///@{
+
+  /**
+   * @brief A constructor to create an uninitialized BlockCRSMatrixView.
+   * @note An uninitialized BlockCRSMatrixView should not be used until it is assigned to.
+   */
+  BlockCRSMatrixView() = default;
+
+  /**
+   * @brief Default copy constructor.
+   */
+  BlockCRSMatrixView( BlockCRSMatrixView const & ) = default;
+
+  /**
+   * @brief Default move constructor.
+   */
+  inline
+  BlockCRSMatrixView( BlockCRSMatrixView && ) = default;
+
+  /**
+   * @brief Construct a new BlockCRSMatrixView from the given buffers.
+   * @param nRows The number of block rows.
+   * @param nCols The number of block columns
+   * @param offsets The offsets buffer, of size @p nRows + 1.
+   * @param nnz The buffer containing the number of non zero blocks in each row, of size @p nRows.
+   * @param columns The columns buffer, of size @p offsets[ nRows ].
+   * @param blocks The blocks buffer, of size @p offsets[ nRows ].
+   */
+  LVARRAY_HOST_DEVICE constexpr inline
+  BlockCRSMatrixView( INDEX_TYPE const nRows,
+                      INDEX_TYPE const nCols,
+                      BUFFER_TYPE< INDEX_TYPE > const & offsets,
+                      BUFFER_TYPE< SIZE_TYPE > const & nnz,
+                      BUFFER_TYPE< COL_TYPE > const & columns,
+                      BUFFER_TYPE< BlockStorage > const & blocks ):
+    ParentClass( nRows, nCols, offsets, nnz, columns ),
+    m_entries( blocks )
+  {}
+
+  /**
+   * @brief Default copy assignment operator.
+   * @return *this.
+   */
+  inline
+  BlockCRSMatrixView & operator=( BlockCRSMatrixView const & ) = default;
+
+  /**
+   * @brief Default move assignment operator.
+   * @return *this.
+   */
+  inline
+  BlockCRSMatrixView & operator=( BlockCRSMatrixView && ) = default;
+
+  ///@}
+
+  /**
+   * @name BlockCRSMatrixView and SparsityPatternView creation methods
+   */
+  ///@{
+
+  /**
+   * @return A new BlockCRSMatrixView< T, BLOCK_SIZE, COL_TYPE const, INDEX_TYPE const >.
+   * @note Since the blocks can't be created or destroyed through a view there is no
+   *   equivalent of CRSMatrixView::toView.
+   */
+  LVARRAY_HOST_DEVICE constexpr inline
+  BlockCRSMatrixView< T, BLOCK_SIZE, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >
+  toViewConstSizes() const
+  {
+    return BlockCRSMatrixView< T, BLOCK_SIZE, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >( numRows(),
+                                                                                               numColumns(),
+                                                                                               this->m_offsets,
+                                                                                               this->m_sizes,
+                                                                                               this->m_values,
+                                                                                               this->m_entries );
+  }
+
+  /**
+   * @return A new BlockCRSMatrixView< T const, BLOCK_SIZE, COL_TYPE const, INDEX_TYPE const >.
+   */
+  LVARRAY_HOST_DEVICE constexpr inline
+  BlockCRSMatrixView< T const, BLOCK_SIZE, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >
+  toViewConst() const
+  {
+    return BlockCRSMatrixView< T const, BLOCK_SIZE, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >( numRows(),
+                                                                                                     numColumns(),
+                                                                                                     this->m_offsets,
+                                                                                                     this->m_sizes,
+                                                                                                     this->m_values,
+                                                                                                     this->m_entries );
+  }
+
+  /**
+   * @return A new SparsityPatternView< COL_TYPE const, INDEX_TYPE const > of the block structure.
+   */
+  LVARRAY_HOST_DEVICE constexpr inline
+  SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >
+  toSparsityPatternView() const &
+  {
+    return SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >( numRows(),
+                                                                                 numColumns(),
+                                                                                 this->m_offsets,
+                                                                                 this->m_sizes,
+                                                                                 this->m_values );
+  }
+
+  ///@}
+
+  /**
+   * @name Attribute querying methods
+   */
+  ///@{
+
+  using ParentClass::numRows;
+  using ParentClass::numColumns;
+  using ParentClass::numNonZeros;
+  using ParentClass::nonZeroCapacity;
+  using ParentClass::empty;
+
+  /**
+   * @return The number of scalar rows in the matrix, numRows() * BLOCK_SIZE.
+   */
+  LVARRAY_HOST_DEVICE constexpr inline
+  INDEX_TYPE_NC numScalarRows() const
+  { return numRows() * BLOCK_SIZE; }
+
+  /**
+   * @return The number of scalar columns in the matrix, numColumns() * BLOCK_SIZE.
+   */
+  LVARRAY_HOST_DEVICE constexpr inline
+  INDEX_TYPE_NC numScalarColumns() const
+  { return numColumns() * BLOCK_SIZE; }
+
+  ///@}
+
+  /**
+   * @name Methods that provide access to the data
+   */
+  ///@{
+
+  /**
+   * @return A reference to the block of the @p i th non zero of @p row.
+   * @param row The row to access.
+   * @param i The index of the non zero in the row, the column of the block is getColumns( row )[ i ].
+   */
+  LVARRAY_HOST_DEVICE inline
+  BlockType & getBlock( INDEX_TYPE const row, INDEX_TYPE const i ) const
+  {
+    ARRAYOFARRAYS_CHECK_BOUNDS2( row, i );
+    return m_entries[ this->m_offsets[ row ] + i ].data;
+  }
+
+  using ParentClass::getColumns;
+  using ParentClass::getOffsets;
+  using ParentClass::getSizes;
+
+  ///@}
+
+  /**
+   * @name Methods that modify the entires of the matrix
+   */
+  ///@{
+
+  /**
+   * @brief Set all the entries in the matrix to the given value.
+   * @tparam POLICY The kernel launch policy to use.
+   * @param value The value to set entries in the matrix to.
+   */
+  template< typename POLICY >
+  inline void setValues( T const & value ) const
+  {
+    BlockCRSMatrixView< T, BLOCK_SIZE, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const view = toViewConstSizes();
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numRows() ),
+                            [view, value] LVARRAY_HOST_DEVICE ( INDEX_TYPE const row )
+      {
+        INDEX_TYPE const nnz = view.numNonZeros( row );
+        for( INDEX_TYPE_NC i = 0; i < nnz; ++i )
+        {
+          BlockType & block = view.getBlock( row, i );
+          for( int a = 0; a < BLOCK_SIZE; ++a )
+          {
+            for( int b = 0; b < BLOCK_SIZE; ++b )
+            { block[ a ][ b ] = value; }
+          }
+        }
+      } );
+  }
+
+  /**
+   * @brief Use memset to set all the values in the matrix to 0.
+   * @details This has the same behavior as CRSMatrixView::zero.
+   */
+  inline void zero() const
+  {
+  #if !defined( LVARRAY_USE_UMPIRE )
+    LVARRAY_ERROR_IF_NE_MSG( m_entries.getPreviousSpace(), MemorySpace::host, "Without Umpire only host memory is supported." );
+  #endif
+
+    if( m_entries.capacity() > 0 )
+    {
+      ParentClass::move( m_entries.getPreviousSpace(), false );
+      m_entries.move( m_entries.getPreviousSpace(), true );
+
+      size_t const numBytes = m_entries.capacity() * sizeof( BlockStorage );
+      umpireInterface::memset( m_entries.data(), 0, numBytes );
+    }
+  }
+
+  /**
+   * @brief Add to the given blocks, the blocks must already exist in the matrix.
+   * @tparam AtomicPolicy the policy to use when adding to the values.
+   * @param row The row to access.
+   * @param cols The columns to add to, must be sorted, unique and of length nCols.
+   * @param blocks The blocks to add, of length nCols.
+   * @param nCols The number of columns to add to.
+   * @pre The range [ @p cols, @p cols + @p ncols ) must be sorted and contain no duplicates.
+   * @note This uses the same heuristic as CRSMatrixView::addToRow, see
+   *   LVARRAY_ADD_TO_ROW_BINARY_SEARCH_MIN_ROW_LENGTH and LVARRAY_ADD_TO_ROW_BINARY_SEARCH_RATIO.
+   */
+  template< typename AtomicPolicy >
+  LVARRAY_HOST_DEVICE inline
+  void addToRow( INDEX_TYPE const row,
+                 COL_TYPE const * const LVARRAY_RESTRICT cols,
+                 std::remove_const_t< T > const ( *const LVARRAY_RESTRICT blocks )[ BLOCK_SIZE ][ BLOCK_SIZE ],
+                 INDEX_TYPE const nCols ) const
+  {
+    INDEX_TYPE const nnz = numNonZeros( row );
+    if( nnz >= LVARRAY_ADD_TO_ROW_BINARY_SEARCH_MIN_ROW_LENGTH &&
+        nCols * LVARRAY_ADD_TO_ROW_BINARY_SEARCH_RATIO <= nnz )
+    {
+      addToRowBinarySearch< AtomicPolicy >( row, cols, blocks, nCols );
+    }
+    else
+    {
+      addToRowLinearSearch< AtomicPolicy >( row, cols, blocks, nCols );
+    }
+  }
+
+  /**
+   * @brief Add to the given blocks, the blocks must already exist in the matrix.
+   * @details This method uses a binary search to find the blocks in the row to add to,
+   *   see CRSMatrixView::addToRowBinarySearch.
+   * @tparam AtomicPolicy the policy to use when adding to the values.
+   * @param row The row to access.
+   * @param cols The columns to add to, must be sorted, unique and of length @p nCols.
+   * @param blocks The blocks to add, of length @p nCols.
+   * @param nCols The number of columns to add to.
+   * @pre The range [ @p cols, @p cols + @p ncols ) must be sorted and contain no duplicates.
+   */
+  template< typename AtomicPolicy >
+  LVARRAY_HOST_DEVICE inline
+  void addToRowBinarySearch( INDEX_TYPE const row,
+                             COL_TYPE const * const LVARRAY_RESTRICT cols,
+                             std::remove_const_t< T > const ( *const LVARRAY_RESTRICT blocks )[ BLOCK_SIZE ][ BLOCK_SIZE ],
+                             INDEX_TYPE const nCols ) const
+  {
+    LVARRAY_ASSERT( sortedArrayManipulation::isSortedUnique( cols, cols + nCols ) );
+
+    INDEX_TYPE const nnz = numNonZeros( row );
+    COL_TYPE const * const columns = getColumns( row );
+
+    INDEX_TYPE_NC curPos = 0;
+    for( INDEX_TYPE_NC i = 0; i < nCols; ++i )
+    {
+      INDEX_TYPE const pos = sortedArrayManipulation::find( columns + curPos, nnz - curPos, cols[ i ] ) + curPos;
+      LVARRAY_ASSERT_GT( nnz, pos );
+      LVARRAY_ASSERT_EQ( columns[ pos ], cols[ i ] );
+
+      addToBlock( AtomicPolicy{}, getBlock( row, pos ), blocks[ i ] );
+      curPos = pos + 1;
+    }
+  }
+
+  /**
+   * @brief Add to the given blocks, the blocks must already exist in the matrix.
+   * @details This method uses a linear search to find the blocks in the row to add to,
+   *   see CRSMatrixView::addToRowLinearSearch.
+   * @tparam AtomicPolicy the policy to use when adding to the values.
+   * @param row The row to access.
+   * @param cols The columns to add to, must be sorted, unique and of length @p nCols.
+   * @param blocks The blocks to add, of length @p nCols.
+   * @param nCols The number of columns to add to.
+   * @pre The range [ @p cols, @p cols + @p ncols ) must be sorted and contain no duplicates.
+   */
+  template< typename AtomicPolicy >
+  LVARRAY_HOST_DEVICE inline
+  void addToRowLinearSearch( INDEX_TYPE const row,
+                             COL_TYPE const * const LVARRAY_RESTRICT cols,
+                             std::remove_const_t< T > const ( *const LVARRAY_RESTRICT blocks )[ BLOCK_SIZE ][ BLOCK_SIZE ],
+                             INDEX_TYPE const nCols ) const
+  {
+    LVARRAY_ASSERT( sortedArrayManipulation::isSortedUnique( cols, cols + nCols ) );
+
+    INDEX_TYPE const nnz = numNonZeros( row );
+    COL_TYPE const * const columns = getColumns( row );
+
+    INDEX_TYPE_NC curPos = 0;
+    for( INDEX_TYPE_NC i = 0; i < nCols; ++i )
+    {
+      for( INDEX_TYPE_NC j = curPos; j < nnz; ++j )
+      {
+        if( columns[ j ] == cols[ i ] )
+        {
+          curPos = j;
+          break;
+        }
+      }
+      LVARRAY_ASSERT_EQ( columns[ curPos ], cols[ i ] );
+      addToBlock( AtomicPolicy{}, getBlock( row, curPos ), blocks[ i ] );
+      ++curPos;
+    }
+  }
+
+  /**
+   * @brief Add to the given blocks, the blocks must already exist in the matrix.
+   * @details This method uses a binary search to find the blocks in the row to add to,
+   *   see CRSMatrixView::addToRowBinarySearchUnsorted.
+   * @tparam AtomicPolicy the policy to use when adding to the values.
+   * @param row The row to access.
+   * @param cols The columns to add to, unsorted, of length @p nCols.
+   * @param blocks The blocks to add, of length @p nCols.
+   * @param nCols The number of columns to add to.
+   */
+  template< typename AtomicPolicy >
+  LVARRAY_HOST_DEVICE inline
+  void addToRowBinarySearchUnsorted( INDEX_TYPE const row,
+                                     COL_TYPE const * const LVARRAY_RESTRICT cols,
+                                     std::remove_const_t< T > const ( *const LVARRAY_RESTRICT blocks )[ BLOCK_SIZE ][ BLOCK_SIZE ],
+                                     INDEX_TYPE const nCols ) const
+  {
+    INDEX_TYPE const nnz = numNonZeros( row );
+    COL_TYPE const * const columns = getColumns( row );
+
+    for( INDEX_TYPE_NC i = 0; i < nCols; ++i )
+    {
+      INDEX_TYPE const pos = sortedArrayManipulation::find( columns, nnz, cols[ i ] );
+      LVARRAY_ASSERT_GT( nnz, pos );
+      LVARRAY_ASSERT_EQ( columns[ pos ], cols[ i ] );
+
+      addToBlock( AtomicPolicy{}, getBlock( row, pos ), blocks[ i ] );
+    }
+  }
+
+  ///@}
+
+  /**
+   * @name Linear algebra methods
+   */
+  ///@{
+
+  /**
+   * @brief Compute @code y = A x @endcode.
+   * @tparam POLICY The RAJA policy to use.
+   * @param x The vector to multiply, of length numScalarColumns().
+   * @param y The result vector, of length numScalarRows(). It is overwritten.
+   * @details Each block row is processed by a single iteration which accumulates
+   *   @p BLOCK_SIZE results in registers, each column index loaded feeds
+   *   @p BLOCK_SIZE squared multiply adds.
+   */
+  template< typename POLICY >
+  void multiply( ArrayView< std::remove_const_t< T > const, 1, 0, INDEX_TYPE_NC, BUFFER_TYPE > const & x,
+                 ArrayView< std::remove_const_t< T >, 1, 0, INDEX_TYPE_NC, BUFFER_TYPE > const & y ) const
+  {
+    using T_NC = std::remove_const_t< T >;
+
+    LVARRAY_ERROR_IF_NE( x.size(), numScalarColumns() );
+    LVARRAY_ERROR_IF_NE( y.size(), numScalarRows() );
+
+    BlockCRSMatrixView< T const, BLOCK_SIZE, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const view = toViewConst();
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE_NC >( 0, numRows() ),
+                            [view, x, y] LVARRAY_HOST_DEVICE ( INDEX_TYPE_NC const row )
+      {
+        COL_TYPE const * const columns = view.getColumns( row );
+        INDEX_TYPE const nnz = view.numNonZeros( row );
+
+        T_NC sums[ BLOCK_SIZE ] = {};
+        for( INDEX_TYPE_NC i = 0; i < nnz; ++i )
+        {
+          T_NC const ( &block )[ BLOCK_SIZE ][ BLOCK_SIZE ] = view.getBlock( row, i );
+          T_NC const * const xBlock = &x[ BLOCK_SIZE * columns[ i ] ];
+          for( int a = 0; a < BLOCK_SIZE; ++a )
+          {
+            for( int b = 0; b < BLOCK_SIZE; ++b )
+            { sums[ a ] += block[ a ][ b ] * xBlock[ b ]; }
+          }
+        }
+
+        for( int a = 0; a < BLOCK_SIZE; ++a )
+        { y[ BLOCK_SIZE * row + a ] = sums[ a ]; }
+      } );
+  }
+
+  ///@}
+
+  /**
+   * @name Methods dealing with memory spaces
+   */
+  ///@{
+
+  /**
+   * @brief Move this matrix to the given memory space and touch the values, sizes and offsets.
+   * @param space the memory space to move to.
+   * @param touch If true touch the values, sizes and offsets in the new space.
+   * @note  When moving to the GPU since the offsets can't be modified on device they are not touched.
+   */
+  void move( MemorySpace const space, bool const touch=true ) const
+  {
+    ParentClass::move( space, touch );
+    m_entries.move( space, touch );
+  }
+
+  ///@}
+
+protected:
+
+  /**
+   * @brief Protected constructor to be used by the BlockCRSMatrix class.
+   * @note The unused boolean parameter is to distinguish this from the default constructor.
+   */
+  BlockCRSMatrixView( bool ):
+    ParentClass( true ),
+    m_entries( true )
+  {}
+
+  /**
+   * @tparam U The type of the owning object.
+   * @brief Set the name to be displayed whenever the underlying Buffer's user call back is called.
+   * @param name the name to display.
+   */
+  template< typename U >
+  void setName( std::string const & name )
+  {
+    ParentClass::template setName< U >( name );
+    m_entries.template setName< U >( name + "/blocks" );
+  }
+
+  /// Holds the blocks of the matrix, one for each column.
+  BUFFER_TYPE< BlockStorage > m_entries;
+
+private:
+
+  /**
+   * @brief Add @p src to @p dst.
+   * @tparam AtomicPolicy the policy to use when adding to the values.
+   * @param dst The block to add to.
+   * @param src The block to add.
+   */
+  template< typename AtomicPolicy >
+  LVARRAY_HOST_DEVICE static inline
+  void addToBlock( AtomicPolicy,
+                   BlockType & dst,
+                   std::remove_const_t< T > const ( &src )[ BLOCK_SIZE ][ BLOCK_SIZE ] )
+  {
+    for( int a = 0; a < BLOCK_SIZE; ++a )
+    {
+      for( int b = 0; b < BLOCK_SIZE; ++b )
+      { internal::atomicAdd( AtomicPolicy{}, &dst[ a ][ b ], src[ a ][ b ] ); }
+    }
+  }
+};
+
+} /* namespace LvArray */
@@ -13,36 +13,51 @@
 #pragma once
 
 #include "CRSMatrixView.hpp"
+#include "Array.hpp"
 #include "arrayManipulation.hpp"
+#include "sparseMatrixOpsHelpers.hpp"
+
+// System includes
+#include <atomic>
 
 namespace LvArray
 {
 
-template< typename COL_TYPE, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+template< typename COL_TYPE, typename INDEX_TYPE, template< typename > class BUFFER_TYPE, typename OFFSET_TYPE >
 class SparsityPattern;
 
 /**
  * @tparam T the type of the entries in the matrix.
  * @tparam COL_TYPE the integer used to enumerate the columns.
  * @tparam INDEX_TYPE the integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @tparam OFFSET_TYPE the integer used for the offsets, it may be wider than INDEX_TYPE.
  * @class CRSMatrix
  * @brief This class implements a compressed row storage matrix.
+ * @details Every time the sparsity pattern of a CRSMatrix changes it is given a new structure ID,
+ *   see getStructureID. This lets objects that cache information about the pattern, such as
+ *   ScatterPositions, detect that they are out of date. Only changes made through the CRSMatrix
+ *   itself are tracked. Assembly into a fixed pattern should use toViewConstSizes, which can't change
+ *   the pattern, and after inserting or removing entries through a view from toView the matrix
+ *   must be told with markStructureModified.
  */
 template< typename T,
           typename COL_TYPE,
           typename INDEX_TYPE,
-          template< typename > class BUFFER_TYPE >
-class CRSMatrix : protected CRSMatrixView< T, COL_TYPE, INDEX_TYPE, BUFFER_TYPE >
+          template< typename > class BUFFER_TYPE,
+          typename OFFSET_TYPE=INDEX_TYPE >
+class CRSMatrix : protected CRSMatrixView< T, COL_TYPE, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE >
 {
 
   /// An alias for the parent class.
-  using ParentClass = CRSMatrixView< T, COL_TYPE, INDEX_TYPE, BUFFER_TYPE >;
+  using ParentClass = CRSMatrixView< T, COL_TYPE, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE >;
 
 public:
 
   using typename ParentClass::EntryType;
   using typename ParentClass::ColType;
   using typename ParentClass::IndexType;
+  using typename ParentClass::OffsetType;
 
   /**
    * @name Constructors and the destructor
@@ -58,7 +73,8 @@ public:
   CRSMatrix( INDEX_TYPE const nrows=0,
              INDEX_TYPE const ncols=0,
              INDEX_TYPE const initialRowCapacity=0 ):
-    ParentClass( true )
+    ParentClass( true ),
+    m_structureID( newStructureID() )
   {
     resize( nrows, ncols, initialRowCapacity );
     setName( "" );
@@ -70,14 +86,19 @@ public:
    */
   inline
   CRSMatrix( CRSMatrix const & src ):
-    ParentClass( true )
+    ParentClass( true ),
+    m_structureID( newStructureID() )
   { *this = src; }
 
   /**
-   * @brief Default move constructor, performs a shallow copy.
+   * @brief Move constructor, performs a shallow copy.
+   * @param src the CRSMatrix to be moved from, it is given a new structure ID.
    */
   inline
-  CRSMatrix( CRSMatrix && ) = default;
+  CRSMatrix( CRSMatrix && src ):
+    ParentClass( std::move( src ) ),
+    m_structureID( src.m_structureID )
+  { src.m_structureID = newStructureID(); }
 
   /**
    * @brief Destructor, frees the entries, values (columns), sizes and offsets Buffers.
@@ -107,6 +128,7 @@ public:
                              src.m_sizes,
                              src.m_values,
                              typename ParentClass::template PairOfBuffers< T >( this->m_entries, src.m_entries ) );
+    m_structureID = newStructureID();
     return *this;
   }
 
@@ -120,6 +142,8 @@ public:
   {
     ParentClass::free( this->m_entries );
     ParentClass::operator=( std::move( src ) );
+    m_structureID = src.m_structureID;
+    src.m_structureID = newStructureID();
     return *this;
   }
 
@@ -130,12 +154,12 @@ public:
    */
   template< typename POLICY >
   inline
-  void assimilate( SparsityPattern< COL_TYPE, INDEX_TYPE, BUFFER_TYPE > && src )
+  void assimilate( SparsityPattern< COL_TYPE, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE > && src )
   {
     // Destroy the current entries.
     if( !std::is_trivially_destructible< T >::value )
     {
-      CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const view = toViewConstSizes();
+      CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE > const view = toViewConstSizes();
       RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numRows() ),
                               [view] LVARRAY_HOST_DEVICE ( INDEX_TYPE const row )
         {
@@ -148,9 +172,9 @@ public:
     // Reallocate to the appropriate length
     bufferManipulation::reserve( this->m_entries, 0, MemorySpace::host, src.nonZeroCapacity() );
 
-    ParentClass::assimilate( reinterpret_cast< SparsityPatternView< COL_TYPE, INDEX_TYPE, BUFFER_TYPE > && >( src ) );
+    ParentClass::assimilate( reinterpret_cast< SparsityPatternView< COL_TYPE, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE > && >( src ) );
 
-    CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const view = toViewConstSizes();
+    CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE > const view = toViewConstSizes();
     RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numRows() ),
                             [view] LVARRAY_HOST_DEVICE ( INDEX_TYPE const row )
       {
@@ -161,6 +185,7 @@ public:
         }
       } );
 
+    m_structureID = newStructureID();
     setName( "" );
   }
 
@@ -182,6 +207,119 @@ public:
 
     this->m_numCols = nCols;
     ParentClass::template resizeFromCapacities< POLICY >( nRows, rowCapacities, this->m_entries );
+    m_structureID = newStructureID();
+  }
+
+  /**
+   * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+   * @brief Clears the matrix and fills it from ( row, column, value ) triplets.
+   * @param nRows The new number of rows.
+   * @param nCols The new number of columns.
+   * @param rows The row of each triplet, every row must be less than @p nRows.
+   * @param cols The column of each triplet, every column must be less than @p nCols.
+   * @param vals The value of each triplet, the values of duplicate triplets are summed.
+   * @param numBlocks The number of blocks the triplets are split into, this does not change the result.
+   * @details The triplets don't need to be in any order. They are sorted with two parallel counting
+   *   sorts, first by column and then by row, each of which preserves the relative order of equal keys.
+   *   So each row ends up sorted by column with the duplicates in their original order, they are then
+   *   summed in that order. This gives the exact length of every row so the matrix is allocated once
+   *   and is compressed. The result is independent of the policy and @p numBlocks.
+   */
+  template< typename POLICY >
+  void fromTriplets( INDEX_TYPE const nRows,
+                     INDEX_TYPE const nCols,
+                     ArrayView< INDEX_TYPE const, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & rows,
+                     ArrayView< COL_TYPE const, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & cols,
+                     ArrayView< T const, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & vals,
+                     INDEX_TYPE const numBlocks=sparseMatrixOps::internal::defaultNumTransposeBlocks( POLICY {} ) )
+  {
+    LVARRAY_ERROR_IF_NE_MSG( cols.size(), rows.size(), "There must be a column for every row." );
+    LVARRAY_ERROR_IF_NE_MSG( vals.size(), rows.size(), "There must be a value for every row." );
+
+    // Each block holds a contiguous range of the triplets.
+    INDEX_TYPE const numTriplets = rows.size();
+    INDEX_TYPE const nBlocks = math::max( INDEX_TYPE( 1 ), math::min( numBlocks, numTriplets ) );
+    auto const blockRange = [numTriplets, nBlocks] ( auto const * const values, INDEX_TYPE const block )
+    {
+      INDEX_TYPE const begin = sparseMatrixOps::internal::blockBegin( numTriplets, nBlocks, block );
+      INDEX_TYPE const end = sparseMatrixOps::internal::blockBegin( numTriplets, nBlocks, block + 1 );
+      return RAJA::make_span( values + begin, end - begin );
+    };
+
+    // Sort the triplets by column, byColumn[ i ] is the index of the i-th triplet and rowsByColumn[ i ] its row.
+    Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > byColumn;
+    Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > rowsByColumn;
+    byColumn.resizeWithoutInitializationOrDestruction( numTriplets );
+    rowsByColumn.resizeWithoutInitializationOrDestruction( numTriplets );
+    ArrayView< INDEX_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const byColumnView = byColumn.toView();
+    ArrayView< INDEX_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const rowsByColumnView = rowsByColumn.toView();
+    {
+      auto const getColumns = [cols, blockRange] ( INDEX_TYPE const block ) { return blockRange( cols.data(), block ); };
+      sparseMatrixOps::internal::Transposer< POLICY, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE > transposer( nBlocks, nCols, nBlocks, getColumns );
+      transposer.fill( getColumns,
+                       [rows, numTriplets, nBlocks, byColumnView, rowsByColumnView]
+                         ( INDEX_TYPE const block, INDEX_TYPE const i, INDEX_TYPE, OFFSET_TYPE const pos )
+        {
+          INDEX_TYPE const triplet = sparseMatrixOps::internal::blockBegin( numTriplets, nBlocks, block ) + i;
+          byColumnView[ pos ] = triplet;
+          rowsByColumnView[ pos ] = rows[ triplet ];
+        } );
+    }
+
+    // Then by row, this keeps each row sorted by column.
+    auto const getRows = [rowsByColumnView, blockRange] ( INDEX_TYPE const block )
+    { return blockRange( rowsByColumnView.data(), block ); };
+    sparseMatrixOps::internal::Transposer< POLICY, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE > transposer( nBlocks, nRows, nBlocks, getRows );
+
+    Array< COL_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > scratchColumns;
+    scratchColumns.resizeWithoutInitializationOrDestruction( numTriplets );
+    Array< T, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > scratchValues( numTriplets );
+    ArrayView< COL_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const scratchColumnsView = scratchColumns.toView();
+    ArrayView< T, 1, 0, INDEX_TYPE, BUFFER_TYPE > const scratchValuesView = scratchValues.toView();
+    transposer.fill( getRows,
+                     [cols, vals, numTriplets, nBlocks, byColumnView, scratchColumnsView, scratchValuesView]
+                       ( INDEX_TYPE const block, INDEX_TYPE const i, INDEX_TYPE, OFFSET_TYPE const pos )
+      {
+        INDEX_TYPE const triplet = byColumnView[ sparseMatrixOps::internal::blockBegin( numTriplets, nBlocks, block ) + i ];
+        scratchColumnsView[ pos ] = cols[ triplet ];
+        scratchValuesView[ pos ] = vals[ triplet ];
+      } );
+
+    // Sum the duplicates in each row, which gives the exact row lengths.
+    OFFSET_TYPE const * const scratchOffsets = transposer.getOffsets();
+    Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > rowCapacities;
+    rowCapacities.resizeWithoutInitializationOrDestruction( nRows );
+    ArrayView< INDEX_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const rowCapacitiesView = rowCapacities.toView();
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, nRows ),
+                            [scratchOffsets, scratchColumnsView, scratchValuesView, rowCapacitiesView] ( INDEX_TYPE const row )
+      {
+        OFFSET_TYPE const offset = scratchOffsets[ row ];
+        rowCapacitiesView[ row ] = sparseMatrixOps::internal::sumDuplicates( scratchColumnsView.data() + offset,
+                                                                            scratchValuesView.data() + offset,
+                                                                            scratchOffsets[ row + 1 ] - offset );
+      } );
+
+    resizeFromRowCapacities< POLICY >( nRows, nCols, rowCapacities.data() );
+
+    // Every row has exactly its capacity so the entries are written directly into place.
+    COL_TYPE * const columns = this->m_values.data();
+    T * const entries = this->m_entries.data();
+    OFFSET_TYPE const * const offsets = this->m_offsets.data();
+    INDEX_TYPE * const sizes = this->m_sizes.data();
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, nRows ),
+                            [scratchOffsets, scratchColumnsView, scratchValuesView, rowCapacitiesView,
+                             columns, entries, offsets, sizes] ( INDEX_TYPE const row )
+      {
+        OFFSET_TYPE const scratchOffset = scratchOffsets[ row ];
+        INDEX_TYPE const nnz = rowCapacitiesView[ row ];
+        for( INDEX_TYPE i = 0; i < nnz; ++i )
+        {
+          columns[ offsets[ row ] + i ] = scratchColumnsView[ scratchOffset + i ];
+          new ( entries + offsets[ row ] + i ) T( scratchValuesView[ scratchOffset + i ] );
+        }
+
+        sizes[ row ] = nnz;
+      } );
   }
 
   ///@}
@@ -196,9 +334,11 @@ public:
    * @note This is just a wrapper around the CRSMatrixView method. The reason
    *   it isn't pulled in with a @c using statement is that it is detected using
    *   IS_VALID_EXPRESSION and this fails with NVCC.
+   * @note Entries inserted or removed through the view are not tracked by getStructureID,
+   *   call markStructureModified afterwards.
    */
   constexpr inline
-  CRSMatrixView< T, COL_TYPE, INDEX_TYPE const, BUFFER_TYPE >
+  CRSMatrixView< T, COL_TYPE, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
   toView() const &
   { return ParentClass::toView(); }
 
@@ -210,7 +350,7 @@ public:
    *   This overload prevents that from happening.
    */
   constexpr inline
-  CRSMatrixView< T, COL_TYPE, INDEX_TYPE const, BUFFER_TYPE >
+  CRSMatrixView< T, COL_TYPE, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
   toView() const && = delete;
 
   /**
@@ -218,9 +358,11 @@ public:
    * @note This is just a wrapper around the CRSMatrixView method. The reason
    *   it isn't pulled in with a @c using statement is that it is detected using
    *   IS_VALID_EXPRESSION and this fails with NVCC.
+   * @note This is the view to assemble into a fixed sparsity pattern with, it can't change the
+   *   pattern so any ScatterPositions, ColumnIndex or LevelSchedule built from the matrix stays valid.
    */
   LVARRAY_HOST_DEVICE constexpr inline
-  CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >
+  CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
   toViewConstSizes() const &
   { return ParentClass::toViewConstSizes(); }
 
@@ -232,7 +374,7 @@ public:
    *   This overload prevents that from happening.
    */
   LVARRAY_HOST_DEVICE constexpr inline
-  CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >
+  CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
   toViewConstSizes() const && = delete;
 
   /**
@@ -242,7 +384,7 @@ public:
    *   IS_VALID_EXPRESSION and this fails with NVCC.
    */
   LVARRAY_HOST_DEVICE constexpr inline
-  CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >
+  CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
   toViewConst() const &
   { return ParentClass::toViewConst(); }
 
@@ -254,7 +396,7 @@ public:
    *   This overload prevents that from happening.
    */
   LVARRAY_HOST_DEVICE constexpr inline
-  CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >
+  CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
   toViewConst() const && = delete;
 
   using ParentClass::toSparsityPatternView;
@@ -267,7 +409,7 @@ public:
    *   This overload prevents that from happening.
    */
   LVARRAY_HOST_DEVICE constexpr inline
-  SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >
+  SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
   toSparsityPatternView() const && = delete;
 
   ///@}
@@ -283,6 +425,24 @@ public:
   using ParentClass::nonZeroCapacity;
   using ParentClass::empty;
 
+  /**
+   * @return An identifier for the current sparsity pattern of the matrix. It is unique among all the
+   *   CRSMatrix objects of this type and changes every time the pattern, or the capacity of a row, changes
+   *   through the CRSMatrix or markStructureModified is called.
+   */
+  inline
+  std::size_t getStructureID() const
+  { return m_structureID; }
+
+  /**
+   * @brief Give the matrix a new structure ID, see getStructureID.
+   * @details Call this after inserting or removing entries through a view from toView, so that
+   *   objects caching the sparsity pattern know they are out of date.
+   */
+  inline
+  void markStructureModified()
+  { m_structureID = newStructureID(); }
+
   ///@}
 
   /**
@@ -307,7 +467,10 @@ public:
    */
   inline
   void reserveNonZeros( INDEX_TYPE const nnz )
-  { ParentClass::reserveValues( nnz, this->m_entries ); }
+  {
+    ParentClass::reserveValues( nnz, this->m_entries );
+    m_structureID = newStructureID();
+  }
 
   /**
    * @brief Reserve space to hold at least the given number of non zero entries in the given row.
@@ -336,6 +499,7 @@ public:
   {
     if( newCapacity > numColumns() ) newCapacity = numColumns();
     ParentClass::setCapacityOfArray( row, newCapacity, this->m_entries );
+    m_structureID = newStructureID();
   }
 
   /**
@@ -349,7 +513,10 @@ public:
    *   If you will be constructing the matrix from scratch it is reccomended to clear it first.
    */
   void resize( INDEX_TYPE const nRows, INDEX_TYPE const nCols, INDEX_TYPE const initialRowCapacity )
-  { ParentClass::resize( nRows, nCols, initialRowCapacity, this->m_entries ); }
+  {
+    ParentClass::resize( nRows, nCols, initialRowCapacity, this->m_entries );
+    m_structureID = newStructureID();
+  }
 
   /**
    * @brief Compress the CRSMatrix so that the non-zeros and values of each row
@@ -358,7 +525,25 @@ public:
    */
   inline
   void compress()
-  { ParentClass::compress( this->m_entries ); }
+  {
+    ParentClass::compress( this->m_entries );
+    m_structureID = newStructureID();
+  }
+
+  /**
+   * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+   * @brief Compress the CRSMatrix in parallel so that the non-zeros and values of each row
+   *        are contiguous with no extra capacity in between, see ArrayOfArraysView::compressParallel.
+   * @param outOfPlace If true the columns and entries are moved into new allocations of exactly the
+   *   compressed size and the old ones are freed, this temporarily needs memory for a second copy of them.
+   *   Otherwise they are moved in place and no memory is freed.
+   */
+  template< typename POLICY >
+  void compress( bool const outOfPlace=false )
+  {
+    ParentClass::template compressParallel< POLICY >( outOfPlace, this->m_entries );
+    m_structureID = newStructureID();
+  }
 
   ///@}
 
@@ -376,7 +561,13 @@ public:
    */
   inline
   bool insertNonZero( INDEX_TYPE const row, COL_TYPE const col, T const & entry )
-  { return ParentClass::insertIntoSetImpl( row, col, CallBacks( *this, row, &entry ) ); }
+  {
+    bool const inserted = ParentClass::insertIntoSetImpl( row, col, CallBacks( *this, row, &entry ) );
+    if( inserted )
+    { m_structureID = newStructureID(); }
+
+    return inserted;
+  }
 
   /**
    * @brief Insert a non-zero entries into the given row.
@@ -393,10 +584,43 @@ public:
                              COL_TYPE const * const cols,
                              T const * const entriesToInsert,
                              INDEX_TYPE const ncols )
-  { return ParentClass::insertIntoSetImpl( row, cols, cols + ncols, CallBacks( *this, row, entriesToInsert ) ); }
+  {
+    INDEX_TYPE const nInserted = ParentClass::insertIntoSetImpl( row, cols, cols + ncols, CallBacks( *this, row, entriesToInsert ) );
+    if( nInserted != 0 )
+    { m_structureID = newStructureID(); }
+
+    return nInserted;
+  }
+
+  /**
+   * @copydoc ParentClass::removeNonZero
+   * @note This is not brought in with a @c using statement because it needs to update the structure ID.
+   */
+  inline
+  bool removeNonZero( INDEX_TYPE const row, COL_TYPE const col )
+  {
+    bool const removed = ParentClass::removeNonZero( row, col );
+    if( removed )
+    { m_structureID = newStructureID(); }
+
+    return removed;
+  }
+
+  /**
+   * @copydoc ParentClass::removeNonZeros
+   * @note This is not brought in with a @c using statement because it needs to update the structure ID.
+   */
+  inline
+  INDEX_TYPE removeNonZeros( INDEX_TYPE const row,
+                             COL_TYPE const * const LVARRAY_RESTRICT cols,
+                             INDEX_TYPE const ncols )
+  {
+    INDEX_TYPE const nRemoved = ParentClass::removeNonZeros( row, cols, ncols );
+    if( nRemoved != 0 )
+    { m_structureID = newStructureID(); }
 
-  using ParentClass::removeNonZero;
-  using ParentClass::removeNonZeros;
+    return nRemoved;
+  }
 
   ///@}
 
@@ -420,49 +644,60 @@ public:
    * @copydoc ParentClass::addToRow
    * @note This is not brought in with a @c using statement because it breaks doxygen.
    */
-  template< typename AtomicPolicy >
+  template< typename AtomicPolicy, typename U=T >
   inline
   void addToRow( INDEX_TYPE const row,
                  COL_TYPE const * const LVARRAY_RESTRICT cols,
-                 T const * const LVARRAY_RESTRICT vals,
+                 std::enable_if_t< std::is_convertible< U, T >::value, U > const * const LVARRAY_RESTRICT vals,
                  INDEX_TYPE const nCols ) const
-  { ParentClass::template addToRow< AtomicPolicy >( row, cols, vals, nCols ); }
+  { ParentClass::template addToRow< AtomicPolicy, U >( row, cols, vals, nCols ); }
 
   /**
    * @copydoc ParentClass::addToRowBinarySearch
    * @note This is not brought in with a @c using statement because it breaks doxygen.
    */
-  template< typename AtomicPolicy >
+  template< typename AtomicPolicy, typename U=T >
   inline
   void addToRowBinarySearch( INDEX_TYPE const row,
                              COL_TYPE const * const LVARRAY_RESTRICT cols,
-                             T const * const LVARRAY_RESTRICT vals,
+                             std::enable_if_t< std::is_convertible< U, T >::value, U > const * const LVARRAY_RESTRICT vals,
                              INDEX_TYPE const nCols ) const
-  { ParentClass::template addToRowBinarySearch< AtomicPolicy >( row, cols, vals, nCols ); }
+  { ParentClass::template addToRowBinarySearch< AtomicPolicy, U >( row, cols, vals, nCols ); }
 
   /**
    * @copydoc ParentClass::addToRowLinearSearch
    * @note This is not brought in with a @c using statement because it breaks doxygen.
    */
-  template< typename AtomicPolicy >
+  template< typename AtomicPolicy, typename U=T >
   inline
   void addToRowLinearSearch( INDEX_TYPE const row,
                              COL_TYPE const * const LVARRAY_RESTRICT cols,
-                             T const * const LVARRAY_RESTRICT vals,
+                             std::enable_if_t< std::is_convertible< U, T >::value, U > const * const LVARRAY_RESTRICT vals,
                              INDEX_TYPE const nCols ) const
-  { ParentClass::template addToRowLinearSearch< AtomicPolicy >( row, cols, vals, nCols ); }
+  { ParentClass::template addToRowLinearSearch< AtomicPolicy, U >( row, cols, vals, nCols ); }
 
   /**
    * @copydoc ParentClass::addToRowBinarySearchUnsorted
    * @note This is not brought in with a @c using statement because it breaks doxygen.
    */
-  template< typename AtomicPolicy >
+  template< typename AtomicPolicy, typename U=T >
   inline
   void addToRowBinarySearchUnsorted( INDEX_TYPE const row,
                                      COL_TYPE const * const LVARRAY_RESTRICT cols,
-                                     T const * const LVARRAY_RESTRICT vals,
+                                     std::enable_if_t< std::is_convertible< U, T >::value, U > const * const LVARRAY_RESTRICT vals,
                                      INDEX_TYPE const nCols ) const
-  { ParentClass::template addToRowBinarySearchUnsorted< AtomicPolicy >( row, cols, vals, nCols ); }
+  { ParentClass::template addToRowBinarySearchUnsorted< AtomicPolicy, U >( row, cols, vals, nCols ); }
+
+  /**
+   * @copydoc ParentClass::addToEntries
+   * @note This is not brought in with a @c using statement because it breaks doxygen.
+   */
+  template< typename AtomicPolicy >
+  inline
+  void addToEntries( OFFSET_TYPE const * const LVARRAY_RESTRICT positions,
+                     T const * const LVARRAY_RESTRICT vals,
+                     INDEX_TYPE const nEntries ) const
+  { ParentClass::template addToEntries< AtomicPolicy >( positions, vals, nEntries ); }
 
   ///@}
 
@@ -491,6 +726,15 @@ public:
 
 private:
 
+  /**
+   * @return A structure ID that has not been given out before.
+   */
+  static std::size_t newStructureID()
+  {
+    static std::atomic< std::size_t > nextStructureID( 1 );
+    return nextStructureID++;
+  }
+
   /**
    * @brief Increase the capacity of a row to accommodate at least the given number of
    *        non zero entries.
@@ -607,6 +851,9 @@ private:
     /// A pointer to the entries to insert.
     T const * const m_entriesToInsert;
   };
+
+  /// The identifier of the current sparsity pattern, see getStructureID.
+  std::size_t m_structureID;
 };
 
 } /* namespace LvArray */
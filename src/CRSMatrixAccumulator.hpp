@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC and LvArray contributors.
+ * All rights reserved.
+ * See the LICENSE file for details.
+ * SPDX-License-Identifier: (BSD-3-Clause)
+ */
+
+/**
+ * @file CRSMatrixAccumulator.hpp
+ * @brief Contains the implementation of LvArray::CRSMatrixAccumulator.
+ */
+
+#pragma once
+
+// Source includes
+#include "sparseMatrixOps.hpp"
+#include "CRSMatrix.hpp"
+#include "SparsityPattern.hpp"
+#include "Array.hpp"
+#include "sortedArrayManipulation.hpp"
+
+// TPL includes
+#include <RAJA/RAJA.hpp>
+
+// System includes
+#include <vector>
+
+namespace LvArray
+{
+
+/**
+ * @tparam T the type of the entries in the matrix.
+ * @tparam COL_TYPE the integer used to enumerate the columns.
+ * @tparam INDEX_TYPE the integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @tparam OFFSET_TYPE the integer used for the offsets, it may be wider than INDEX_TYPE.
+ * @class CRSMatrixAccumulator
+ * @brief Assembles a CRSMatrix without atomics by having each block of iterations append its
+ *   contributions to a private buffer which are then merged in parallel.
+ * @details The iterations are split into contiguous blocks and each block appends the
+ *   ( row, column, value ) triplets it produces to its own buffer. The buffers are then bucketed by
+ *   row, in order of block and then of insertion, so each row sees its contributions in the same
+ *   order as a serial loop over the iterations would have produced them. Each row is then sorted
+ *   by column and the duplicates are summed. The result is therefore independent of both the
+ *   number of blocks and the number of threads.
+ *   @code
+ *   CRSMatrixAccumulator< double, int, int, MallocBuffer > accumulator;
+ *   accumulator.forAll< POLICY >( numElems, [&] ( int const elem, auto & block )
+ *   {
+ *     for( int i = 0; i < numDofs; ++i )
+ *     { block.addToRow( elemToDof( elem, i ), elemToDof[ elem ], localMatrix[ elem ][ i ], numDofs ); }
+ *   } );
+ *   accumulator.addTo< POLICY >( matrix.toViewConstSizes() );
+ *   @endcode
+ *   The buffers are kept between assemblies so their memory is reused. Everything is done on the host.
+ */
+template< typename T,
+          typename COL_TYPE,
+          typename INDEX_TYPE,
+          template< typename > class BUFFER_TYPE,
+          typename OFFSET_TYPE=INDEX_TYPE >
+class CRSMatrixAccumulator
+{
+public:
+
+  /**
+   * @class Block
+   * @brief The private buffer of a block of iterations.
+   */
+  class Block
+  {
+public:
+
+    /**
+     * @brief Add a value to an entry.
+     * @param row The row of the entry.
+     * @param col The column of the entry.
+     * @param value The value to add.
+     */
+    void add( INDEX_TYPE const row, COL_TYPE const col, T const & value )
+    {
+      m_rows.emplace_back( row );
+      m_columns.emplace_back( col );
+      m_values.emplace_back( value );
+    }
+
+    /**
+     * @brief Add values to a row.
+     * @param row The row to add to.
+     * @param cols The columns to add to, they can be unsorted and contain duplicates.
+     * @param vals The values to add, of length @p nCols.
+     * @param nCols The number of values to add.
+     */
+    void addToRow( INDEX_TYPE const row,
+                   COL_TYPE const * const cols,
+                   T const * const vals,
+                   INDEX_TYPE const nCols )
+    {
+      for( INDEX_TYPE i = 0; i < nCols; ++i )
+      { add( row, cols[ i ], vals[ i ] ); }
+    }
+
+    /**
+     * @return The number of values added since the last call to forAll.
+     */
+    OFFSET_TYPE size() const
+    { return m_rows.size(); }
+
+private:
+    friend class CRSMatrixAccumulator;
+
+    /// The row of each value.
+    Array< INDEX_TYPE, 1, RAJA::PERM_I, OFFSET_TYPE, BUFFER_TYPE > m_rows;
+
+    /// The column of each value.
+    Array< COL_TYPE, 1, RAJA::PERM_I, OFFSET_TYPE, BUFFER_TYPE > m_columns;
+
+    /// The values.
+    Array< T, 1, RAJA::PERM_I, OFFSET_TYPE, BUFFER_TYPE > m_values;
+  };
+
+  /**
+   * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+   * @tparam LAMBDA The type of @p body.
+   * @brief Clear the buffers and call @p body for every iteration.
+   * @param numIterations The number of iterations.
+   * @param body The function to call, it is called as @code body( i, block ) @endcode where @c block
+   *   is the Block that iteration @c i should add its contributions to.
+   * @param numBlocks The number of blocks the iterations are split into, this does not change the result.
+   * @details Each block is processed by a single thread in order of increasing iteration.
+   */
+  template< typename POLICY, typename LAMBDA >
+  void forAll( INDEX_TYPE const numIterations,
+               LAMBDA && body,
+               INDEX_TYPE const numBlocks=sparseMatrixOps::internal::defaultNumTransposeBlocks( POLICY {} ) )
+  {
+    INDEX_TYPE const nBlocks = math::max( INDEX_TYPE( 1 ), numBlocks );
+    if( INDEX_TYPE( m_blocks.size() ) < nBlocks )
+    { m_blocks.resize( nBlocks ); }
+
+    m_numBlocks = nBlocks;
+    Block * const blocks = m_blocks.data();
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, nBlocks ),
+                            [numIterations, nBlocks, blocks, &body] ( INDEX_TYPE const b )
+      {
+        Block & block = blocks[ b ];
+        block.m_rows.clear();
+        block.m_columns.clear();
+        block.m_values.clear();
+
+        INDEX_TYPE const end = sparseMatrixOps::internal::blockBegin( numIterations, nBlocks, b + 1 );
+        for( INDEX_TYPE i = sparseMatrixOps::internal::blockBegin( numIterations, nBlocks, b ); i < end; ++i )
+        { body( i, block ); }
+      } );
+  }
+
+  /**
+   * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+   * @brief Add the accumulated values to the entries of @p matrix.
+   * @param matrix The matrix to add to, it must contain every entry that was added to.
+   * @details Each row is added to by a single iteration so no atomics are used.
+   */
+  template< typename POLICY >
+  void addTo( CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE > const & matrix )
+  {
+    merge< POLICY >( matrix.numRows() );
+
+    ArrayView< OFFSET_TYPE const, 1, 0, INDEX_TYPE, BUFFER_TYPE > const rowOffsets = m_rowOffsets.toViewConst();
+    ArrayView< INDEX_TYPE const, 1, 0, INDEX_TYPE, BUFFER_TYPE > const rowSizes = m_rowSizes.toViewConst();
+    ArrayView< COL_TYPE const, 1, 0, OFFSET_TYPE, BUFFER_TYPE > const columns = m_columns.toViewConst();
+    ArrayView< T const, 1, 0, OFFSET_TYPE, BUFFER_TYPE > const values = m_values.toViewConst();
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, matrix.numRows() ),
+                            [matrix, rowOffsets, rowSizes, columns, values] ( INDEX_TYPE const row )
+      {
+        OFFSET_TYPE const offset = rowOffsets[ row ];
+        matrix.template addToRow< RAJA::seq_atomic >( row, columns.data() + offset, values.data() + offset, rowSizes[ row ] );
+      } );
+  }
+
+  /**
+   * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+   * @brief Build a matrix from the accumulated values.
+   * @param numRows The number of rows of the matrix.
+   * @param numColumns The number of columns of the matrix.
+   * @param matrix The resulting matrix, it is compressed and contains exactly the entries that were added to.
+   */
+  template< typename POLICY >
+  void buildMatrix( INDEX_TYPE const numRows,
+                    INDEX_TYPE const numColumns,
+                    CRSMatrix< T, COL_TYPE, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE > & matrix )
+  {
+    merge< POLICY >( numRows );
+
+    SparsityPattern< COL_TYPE, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE > pattern;
+    pattern.template resizeFromRowCapacities< POLICY >( numRows, numColumns, m_rowSizes.data() );
+
+    SparsityPatternView< COL_TYPE, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE > const patternView = pattern.toView();
+    ArrayView< OFFSET_TYPE const, 1, 0, INDEX_TYPE, BUFFER_TYPE > const rowOffsets = m_rowOffsets.toViewConst();
+    ArrayView< INDEX_TYPE const, 1, 0, INDEX_TYPE, BUFFER_TYPE > const rowSizes = m_rowSizes.toViewConst();
+    ArrayView< COL_TYPE const, 1, 0, OFFSET_TYPE, BUFFER_TYPE > const columns = m_columns.toViewConst();
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numRows ),
+                            [patternView, rowOffsets, rowSizes, columns] ( INDEX_TYPE const row )
+      {
+        COL_TYPE const * const rowColumns = columns.data() + rowOffsets[ row ];
+        patternView.insertNonZeros( row, rowColumns, rowColumns + rowSizes[ row ] );
+      } );
+
+    matrix.template assimilate< POLICY >( std::move( pattern ) );
+
+    CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE > const matrixView = matrix.toViewConstSizes();
+    ArrayView< T const, 1, 0, OFFSET_TYPE, BUFFER_TYPE > const values = m_values.toViewConst();
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numRows ),
+                            [matrixView, rowOffsets, values] ( INDEX_TYPE const row )
+      {
+        T const * const rowValues = values.data() + rowOffsets[ row ];
+        T * const entries = matrixView.getEntries( row );
+        for( INDEX_TYPE i = 0; i < matrixView.numNonZeros( row ); ++i )
+        { entries[ i ] = rowValues[ i ]; }
+      } );
+  }
+
+  /**
+   * @return The number of values added by the last call to forAll, counting duplicates.
+   */
+  OFFSET_TYPE numValues() const
+  {
+    OFFSET_TYPE total = 0;
+    for( INDEX_TYPE b = 0; b < m_numBlocks; ++b )
+    { total += m_blocks[ b ].size(); }
+
+    return total;
+  }
+
+private:
+
+  /**
+   * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+   * @brief Bucket the values of every block by row and sum the duplicates in each row.
+   * @param numRows The number of rows, every row added to must be less than this.
+   * @details Afterwards the sorted unique columns of row @c r and their summed values begin at
+   *   @c m_rowOffsets[ r ] and there are @c m_rowSizes[ r ] of them.
+   */
+  template< typename POLICY >
+  void merge( INDEX_TYPE const numRows )
+  {
+    // Bucket the values by row, treating block b as row b of a matrix whose columns are the rows added to.
+    Block const * const blocks = m_blocks.data();
+    auto const getRows = [blocks] ( INDEX_TYPE const b ) { return blocks[ b ].m_rows.toSliceConst(); };
+    sparseMatrixOps::internal::Transposer< POLICY, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE > transposer( m_numBlocks, numRows, m_numBlocks, getRows );
+
+    m_columns.resizeWithoutInitializationOrDestruction( transposer.numEntries() );
+    m_values.resize( transposer.numEntries() );
+    ArrayView< COL_TYPE, 1, 0, OFFSET_TYPE, BUFFER_TYPE > const columns = m_columns.toView();
+    ArrayView< T, 1, 0, OFFSET_TYPE, BUFFER_TYPE > const values = m_values.toView();
+    transposer.fill( getRows,
+                     [blocks, columns, values] ( INDEX_TYPE const b, OFFSET_TYPE const i, INDEX_TYPE, OFFSET_TYPE const pos )
+      {
+        columns[ pos ] = blocks[ b ].m_columns[ i ];
+        values[ pos ] = blocks[ b ].m_values[ i ];
+      } );
+
+    m_rowOffsets.resizeWithoutInitializationOrDestruction( numRows + 1 );
+    m_rowSizes.resizeWithoutInitializationOrDestruction( numRows );
+    ArrayView< OFFSET_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const rowOffsets = m_rowOffsets.toView();
+    ArrayView< INDEX_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const rowSizes = m_rowSizes.toView();
+    OFFSET_TYPE const * const offsets = transposer.getOffsets();
+    rowOffsets[ numRows ] = offsets[ numRows ];
+
+    // Sort each row by column and sum the duplicates, the sort only depends on the order of the
+    // values in the row so the result is deterministic.
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numRows ),
+                            [offsets, rowOffsets, rowSizes, columns, values] ( INDEX_TYPE const row )
+      {
+        OFFSET_TYPE const offset = offsets[ row ];
+        OFFSET_TYPE const length = offsets[ row + 1 ] - offset;
+        COL_TYPE * const rowColumns = columns.data() + offset;
+        T * const rowValues = values.data() + offset;
+        sortedArrayManipulation::dualSort( rowColumns, rowColumns + length, rowValues );
+
+        rowOffsets[ row ] = offset;
+        rowSizes[ row ] = sparseMatrixOps::internal::sumDuplicates( rowColumns, rowValues, length );
+      } );
+  }
+
+  /// The buffers of the blocks, there may be more than m_numBlocks.
+  std::vector< Block > m_blocks;
+
+  /// The number of blocks used by the last call to forAll.
+  INDEX_TYPE m_numBlocks = 0;
+
+  /// The offset of each row in m_columns and m_values after merging.
+  Array< OFFSET_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > m_rowOffsets;
+
+  /// The number of unique columns in each row after merging.
+  Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > m_rowSizes;
+
+  /// The columns bucketed by row.
+  Array< COL_TYPE, 1, RAJA::PERM_I, OFFSET_TYPE, BUFFER_TYPE > m_columns;
+
+  /// The values bucketed by row.
+  Array< T, 1, RAJA::PERM_I, OFFSET_TYPE, BUFFER_TYPE > m_values;
+};
+
+} /* namespace LvArray */
@@ -17,6 +17,25 @@
 #include "ArraySlice.hpp"
 #include "umpireInterface.hpp"
 
+/**
+ * @brief CRSMatrixView::addToRow only uses a binary search on rows with at least this many non zeros.
+ * @note This can be overridden at compile time, the addToRow benchmarks in benchmarkSparsityGeneration
+ *   can be used to calibrate it.
+ */
+#if !defined(LVARRAY_ADD_TO_ROW_BINARY_SEARCH_MIN_ROW_LENGTH)
+  #define LVARRAY_ADD_TO_ROW_BINARY_SEARCH_MIN_ROW_LENGTH 256
+#endif
+
+/**
+ * @brief CRSMatrixView::addToRow only uses a binary search when the row has at least this many
+ *   times as many non zeros as the number of columns to add to.
+ * @note This can be overridden at compile time, the addToRow benchmarks in benchmarkSparsityGeneration
+ *   can be used to calibrate it.
+ */
+#if !defined(LVARRAY_ADD_TO_ROW_BINARY_SEARCH_RATIO)
+  #define LVARRAY_ADD_TO_ROW_BINARY_SEARCH_RATIO 64
+#endif
+
 namespace LvArray
 {
 
@@ -58,6 +77,8 @@ void atomicAdd( RAJA::seq_atomic, T * acc, T const & val )
  * @tparam T the type of the entries of the matrix.
  * @tparam COL_TYPE the integer used to enumerate the columns.
  * @tparam INDEX_TYPE the integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @tparam OFFSET_TYPE the integer used for the offsets, it may be wider than INDEX_TYPE.
  *
  * @note When INDEX_TYPE is const m_offsets is not copied back from the device. INDEX_TYPE should always be const
  *       since CRSMatrixView is not allowed to modify the offsets.
@@ -69,19 +90,22 @@ void atomicAdd( RAJA::seq_atomic, T * acc, T const & val )
 template< typename T,
           typename COL_TYPE,
           typename INDEX_TYPE,
-          template< typename > class BUFFER_TYPE
+          template< typename > class BUFFER_TYPE,
+          typename OFFSET_TYPE=std::remove_const_t< INDEX_TYPE >
           >
-class CRSMatrixView : protected SparsityPatternView< COL_TYPE, INDEX_TYPE, BUFFER_TYPE >
+class CRSMatrixView : protected SparsityPatternView< COL_TYPE, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE >
 {
 
   /// An alias for the parent class.
-  using ParentClass = SparsityPatternView< COL_TYPE, INDEX_TYPE, BUFFER_TYPE >;
+  using ParentClass = SparsityPatternView< COL_TYPE, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE >;
 
   /// An alias for the non const index type.
   using typename ParentClass::INDEX_TYPE_NC;
 
   using typename ParentClass::SIZE_TYPE;
 
+  using typename ParentClass::OFFSETS_TYPE;
+
 public:
   static_assert( !std::is_const< T >::value ||
                  (std::is_const< COL_TYPE >::value && std::is_const< INDEX_TYPE >::value),
@@ -91,6 +115,7 @@ public:
   using EntryType = T;
   using typename ParentClass::ColType;
   using typename ParentClass::IndexType;
+  using typename ParentClass::OffsetType;
 
   /**
    * @name Constructors, destructor and assignment operators
@@ -126,7 +151,7 @@ public:
   LVARRAY_HOST_DEVICE constexpr inline
   CRSMatrixView( INDEX_TYPE const nRows,
                  INDEX_TYPE const nCols,
-                 BUFFER_TYPE< INDEX_TYPE > const & offsets,
+                 BUFFER_TYPE< OFFSETS_TYPE > const & offsets,
                  BUFFER_TYPE< SIZE_TYPE > const & nnz,
                  BUFFER_TYPE< COL_TYPE > const & columns,
                  BUFFER_TYPE< T > const & entries ):
@@ -157,59 +182,59 @@ public:
    * @return A new CRSMatrixView< T, COL_TYPE, INDEX_TYPE const >.
    */
   LVARRAY_HOST_DEVICE constexpr inline
-  CRSMatrixView< T, COL_TYPE, INDEX_TYPE const, BUFFER_TYPE >
+  CRSMatrixView< T, COL_TYPE, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
   toView() const
   {
-    return CRSMatrixView< T, COL_TYPE, INDEX_TYPE const, BUFFER_TYPE >( numRows(),
-                                                                        numColumns(),
-                                                                        this->m_offsets,
-                                                                        this->m_sizes,
-                                                                        this->m_values,
-                                                                        this->m_entries );
+    return CRSMatrixView< T, COL_TYPE, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >( numRows(),
+                                                                                     numColumns(),
+                                                                                     this->m_offsets,
+                                                                                     this->m_sizes,
+                                                                                     this->m_values,
+                                                                                     this->m_entries );
   }
 
   /**
    * @return A new CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const >.
    */
   LVARRAY_HOST_DEVICE constexpr inline
-  CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >
+  CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
   toViewConstSizes() const
   {
-    return CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >( numRows(),
-                                                                              numColumns(),
-                                                                              this->m_offsets,
-                                                                              this->m_sizes,
-                                                                              this->m_values,
-                                                                              this->m_entries );
+    return CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >( numRows(),
+                                                                                           numColumns(),
+                                                                                           this->m_offsets,
+                                                                                           this->m_sizes,
+                                                                                           this->m_values,
+                                                                                           this->m_entries );
   }
 
   /**
    * @return A new CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const >.
    */
   LVARRAY_HOST_DEVICE constexpr inline
-  CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >
+  CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
   toViewConst() const
   {
-    return CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >( numRows(),
-                                                                                    numColumns(),
-                                                                                    this->m_offsets,
-                                                                                    this->m_sizes,
-                                                                                    this->m_values,
-                                                                                    this->m_entries );
+    return CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >( numRows(),
+                                                                                                 numColumns(),
+                                                                                                 this->m_offsets,
+                                                                                                 this->m_sizes,
+                                                                                                 this->m_values,
+                                                                                                 this->m_entries );
   }
 
   /**
    * @return A reference to *this reinterpreted as a SparsityPatternView< COL_TYPE const, INDEX_TYPE const >.
    */
   LVARRAY_HOST_DEVICE constexpr inline
-  SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >
+  SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
   toSparsityPatternView() const &
   {
-    return SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >( numRows(),
-                                                                                 numColumns(),
-                                                                                 this->m_offsets,
-                                                                                 this->m_sizes,
-                                                                                 this->m_values );
+    return SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >( numRows(),
+                                                                                              numColumns(),
+                                                                                              this->m_offsets,
+                                                                                              this->m_sizes,
+                                                                                              this->m_values );
   }
 
   ///@}
@@ -344,7 +369,7 @@ public:
   template< typename POLICY >
   inline void setValues( T const & value ) const
   {
-    CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const view = toViewConstSizes();
+    CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE > const view = toViewConstSizes();
     RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numRows() ),
                             [view, value] LVARRAY_HOST_DEVICE ( INDEX_TYPE const row )
       {
@@ -387,30 +412,37 @@ public:
   /**
    * @brief Add to the given entries, the entries must already exist in the matrix.
    *   The columns must be sorted.
+   * @details The strategy is chosen on each call from the length of the row and the number of
+   *   columns to add to. Usually the row and the columns are merged with addToRowLinearSearch,
+   *   which is O( numNonZeros( @p row ) + @p nCols ). Only when the row is long and @p nCols is small,
+   *   see LVARRAY_ADD_TO_ROW_BINARY_SEARCH_MIN_ROW_LENGTH and LVARRAY_ADD_TO_ROW_BINARY_SEARCH_RATIO,
+   *   is addToRowBinarySearch used.
    * @tparam AtomicPolicy the policy to use when adding to the values.
+   * @tparam U The type of the values to add, each value is converted to @c T before it is added.
+   *   It is not deduced so that anything convertible to a pointer to @c T can still be passed, to add
+   *   values of another type it must be given explicitly, for example @code addToRow< AtomicPolicy, double > @endcode.
    * @param row The row to access.
    * @param cols The columns to add to, must be sorted, unique and of length nCols.
    * @param vals The values to add, of length nCols.
    * @param nCols The number of columns to add to.
    * @pre The range [ @p cols, @p cols + @p ncols ) must be sorted and contain no duplicates.
-   * TODO: Use benchmarks of addToRowBinarySearch and addToRowLinearSearch
-   *   to develop a better heuristic.
    */
-  template< typename AtomicPolicy >
+  template< typename AtomicPolicy, typename U=T >
   LVARRAY_HOST_DEVICE inline
   void addToRow( INDEX_TYPE const row,
                  COL_TYPE const * const LVARRAY_RESTRICT cols,
-                 T const * const LVARRAY_RESTRICT vals,
+                 std::enable_if_t< std::is_convertible< U, T >::value, U > const * const LVARRAY_RESTRICT vals,
                  INDEX_TYPE const nCols ) const
   {
     INDEX_TYPE const nnz = numNonZeros( row );
-    if( nCols < nnz / 4 && nnz > 64 )
+    if( nnz >= LVARRAY_ADD_TO_ROW_BINARY_SEARCH_MIN_ROW_LENGTH &&
+        nCols * LVARRAY_ADD_TO_ROW_BINARY_SEARCH_RATIO <= nnz )
     {
-      addToRowBinarySearch< AtomicPolicy >( row, cols, vals, nCols );
+      addToRowBinarySearch< AtomicPolicy, U >( row, cols, vals, nCols );
     }
     else
     {
-      addToRowLinearSearch< AtomicPolicy >( row, cols, vals, nCols );
+      addToRowLinearSearch< AtomicPolicy, U >( row, cols, vals, nCols );
     }
   }
 
@@ -420,17 +452,18 @@ public:
    *   This makes the method O( nCols * log( numNonZeros( @p row ) ) ) and is therefore best
    *   to use when @p nCols is much less than numNonZeros( @p row ).
    * @tparam AtomicPolicy the policy to use when adding to the values.
+   * @tparam U The type of the values to add, see addToRow.
    * @param row The row to access.
    * @param cols The columns to add to, must be sorted, unique and of length @p nCols.
    * @param vals The values to add, of length @p nCols.
    * @param nCols The number of columns to add to.
    * @pre The range [ @p cols, @p cols + @p ncols ) must be sorted and contain no duplicates.
    */
-  template< typename AtomicPolicy >
+  template< typename AtomicPolicy, typename U=T >
   LVARRAY_HOST_DEVICE inline
   void addToRowBinarySearch( INDEX_TYPE const row,
                              COL_TYPE const * const LVARRAY_RESTRICT cols,
-                             T const * const LVARRAY_RESTRICT vals,
+                             std::enable_if_t< std::is_convertible< U, T >::value, U > const * const LVARRAY_RESTRICT vals,
                              INDEX_TYPE const nCols ) const
   {
     LVARRAY_ASSERT( sortedArrayManipulation::isSortedUnique( cols, cols + nCols ) );
@@ -446,28 +479,29 @@ public:
       LVARRAY_ASSERT_GT( nnz, pos );
       LVARRAY_ASSERT_EQ( columns[ pos ], cols[ i ] );
 
-      internal::atomicAdd( AtomicPolicy{}, entries + pos, vals[ i ] );
+      internal::atomicAdd( AtomicPolicy{}, entries + pos, T( vals[ i ] ) );
       curPos = pos + 1;
     }
   }
 
   /**
    * @brief Add to the given entries, the entries must already exist in the matrix.
-   * @brief This method uses a linear search to find the entries in the row to add to.
-   *   This makes the method O( numNonZeros( @p row ) ) and is therefore best to use when
-   *   @p nCols is similar to numNonZeros( @p row ).
+   * @details This method merges the sorted columns with the row to find the entries to add to.
+   *   This makes the method O( numNonZeros( @p row ) + @p nCols ) and is therefore best to use when
+   *   @p nCols is not much less than numNonZeros( @p row ).
    * @tparam AtomicPolicy the policy to use when adding to the values.
+   * @tparam U The type of the values to add, see addToRow.
    * @param row The row to access.
    * @param cols The columns to add to, must be sorted, unique and of length @p nCols.
    * @param vals The values to add, of length @p nCols.
    * @param nCols The number of columns to add to.
    * @pre The range [ @p cols, @p cols + @p ncols ) must be sorted and contain no duplicates.
    */
-  template< typename AtomicPolicy >
+  template< typename AtomicPolicy, typename U=T >
   LVARRAY_HOST_DEVICE inline
   void addToRowLinearSearch( INDEX_TYPE const row,
                              COL_TYPE const * const LVARRAY_RESTRICT cols,
-                             T const * const LVARRAY_RESTRICT vals,
+                             std::enable_if_t< std::is_convertible< U, T >::value, U > const * const LVARRAY_RESTRICT vals,
                              INDEX_TYPE const nCols ) const
   {
     LVARRAY_ASSERT( sortedArrayManipulation::isSortedUnique( cols, cols + nCols ) );
@@ -488,7 +522,7 @@ public:
         }
       }
       LVARRAY_ASSERT_EQ( columns[ curPos ], cols[ i ] );
-      internal::atomicAdd( AtomicPolicy{}, entries + curPos, vals[ i ] );
+      internal::atomicAdd( AtomicPolicy{}, entries + curPos, T( vals[ i ] ) );
       ++curPos;
     }
   }
@@ -499,16 +533,17 @@ public:
    *   This makes the method O( nCols * log( numNonZeros( @p row ) ) ) and is therefore best
    *   to use when @p nCols is much less than numNonZeros( @p row ).
    * @tparam AtomicPolicy the policy to use when adding to the values.
+   * @tparam U The type of the values to add, see addToRow.
    * @param row The row to access.
    * @param cols The columns to add to, unsorted, of length @p nCols.
    * @param vals The values to add, of length @p nCols.
    * @param nCols The number of columns to add to.
    */
-  template< typename AtomicPolicy >
+  template< typename AtomicPolicy, typename U=T >
   LVARRAY_HOST_DEVICE inline
   void addToRowBinarySearchUnsorted( INDEX_TYPE const row,
                                      COL_TYPE const * const LVARRAY_RESTRICT cols,
-                                     T const * const LVARRAY_RESTRICT vals,
+                                     std::enable_if_t< std::is_convertible< U, T >::value, U > const * const LVARRAY_RESTRICT vals,
                                      INDEX_TYPE const nCols ) const
   {
     INDEX_TYPE const nnz = numNonZeros( row );
@@ -521,7 +556,32 @@ public:
       LVARRAY_ASSERT_GT( nnz, pos );
       LVARRAY_ASSERT_EQ( columns[ pos ], cols[ i ] );
 
-      internal::atomicAdd( AtomicPolicy{}, entries + pos, vals[ i ] );
+      internal::atomicAdd( AtomicPolicy{}, entries + pos, T( vals[ i ] ) );
+    }
+  }
+
+  /**
+   * @brief Add to the entries at the given positions, the entries must already exist in the matrix.
+   * @details The position of the entry in column @code getColumns( row )[ i ] @endcode is
+   *   @code getOffsets()[ row ] + i @endcode. Since no searching is done this is the fastest way
+   *   to repeatedly add to a matrix whose sparsity pattern doesn't change, see ScatterPositions.
+   * @tparam AtomicPolicy the policy to use when adding to the values.
+   * @param positions The positions of the entries to add to, of length @p nEntries.
+   * @param vals The values to add, of length @p nEntries.
+   * @param nEntries The number of entries to add to.
+   */
+  template< typename AtomicPolicy >
+  LVARRAY_HOST_DEVICE inline
+  void addToEntries( OFFSET_TYPE const * const LVARRAY_RESTRICT positions,
+                     T const * const LVARRAY_RESTRICT vals,
+                     INDEX_TYPE const nEntries ) const
+  {
+    T * const entries = m_entries.data();
+
+    for( INDEX_TYPE_NC i = 0; i < nEntries; ++i )
+    {
+      LVARRAY_ASSERT_GT( this->m_offsets[ this->m_numArrays ], positions[ i ] );
+      internal::atomicAdd( AtomicPolicy{}, entries + positions[ i ], vals[ i ] );
     }
   }
 
@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC and LvArray contributors.
+ * All rights reserved.
+ * See the LICENSE file for details.
+ * SPDX-License-Identifier: (BSD-3-Clause)
+ */
+
+/**
+ * @file ColumnIndex.hpp
+ * @brief Contains the implementation of LvArray::ColumnIndex and LvArray::ColumnIndexView.
+ */
+
+#pragma once
+
+// Source includes
+#include "CRSMatrix.hpp"
+#include "Array.hpp"
+
+// TPL includes
+#include <RAJA/RAJA.hpp>
+
+// System includes
+#include <cstdint>
+
+/**
+ * @brief Rows of a ColumnIndex with fewer non zeros than this are searched linearly instead of hashed.
+ * @note This can be overridden at compile time.
+ */
+#if !defined(LVARRAY_COLUMN_INDEX_MIN_ROW_LENGTH)
+  #define LVARRAY_COLUMN_INDEX_MIN_ROW_LENGTH 16
+#endif
+
+namespace LvArray
+{
+
+/**
+ * @tparam COL_TYPE the integer used to enumerate the columns.
+ * @tparam INDEX_TYPE the integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @tparam OFFSET_TYPE the integer used for the offsets of the matrix.
+ * @class ColumnIndexView
+ * @brief A view of a ColumnIndex, it can be captured by value in a kernel.
+ */
+template< typename COL_TYPE,
+          typename INDEX_TYPE,
+          template< typename > class BUFFER_TYPE,
+          typename OFFSET_TYPE=INDEX_TYPE >
+class ColumnIndexView
+{
+public:
+
+  /**
+   * @brief Constructor.
+   * @param tableOffsets The offset of the hash table of each row, of length numRows + 1.
+   * @param table The hash tables of every row.
+   */
+  ColumnIndexView( ArrayView< OFFSET_TYPE const, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & tableOffsets,
+                   ArrayView< INDEX_TYPE const, 1, 0, OFFSET_TYPE, BUFFER_TYPE > const & table ):
+    m_tableOffsets( tableOffsets ),
+    m_table( table )
+  {}
+
+  /**
+   * @return The slot of @p col in a table with 2^( 64 - @p shift ) slots.
+   * @param col The column to hash.
+   * @param shift 64 minus the base two logarithm of the size of the table, see hashShift.
+   * @note This is Fibonacci hashing, the slot comes from the high bits of the product and so depends on
+   *   every bit of @p col. The low bits would only depend on @p col modulo the table size, and the
+   *   columns of a structured stencil whose strides are a multiple of the table size would all collide.
+   */
+  LVARRAY_HOST_DEVICE static constexpr inline
+  std::size_t hash( COL_TYPE const col, int const shift )
+  { return static_cast< std::size_t >( ( static_cast< std::uint64_t >( col ) * std::uint64_t( 0x9E3779B97F4A7C15 ) ) >> shift ); }
+
+  /**
+   * @return The shift to pass to hash for a table of size @p tableSize.
+   * @param tableSize The size of the table, must be a power of two greater than one.
+   */
+  LVARRAY_HOST_DEVICE static inline
+  int hashShift( INDEX_TYPE const tableSize )
+  {
+    LVARRAY_ASSERT_GT( tableSize, 1 );
+
+    // For a power of two 64 - log2( tableSize ) is one more than the number of leading zeros.
+#if defined(__CUDA_ARCH__)
+    return 1 + __clzll( static_cast< long long >( tableSize ) );
+#else
+    return 1 + __builtin_clzll( static_cast< unsigned long long >( tableSize ) );
+#endif
+  }
+
+  /**
+   * @return The position of @p col in @p columns, or @p nnz if it isn't there.
+   * @param row The row to search.
+   * @param columns The columns of @p row, must be the columns the index was built from.
+   * @param nnz The number of non zeros in @p row.
+   * @param col The column to find.
+   */
+  LVARRAY_HOST_DEVICE inline
+  INDEX_TYPE find( INDEX_TYPE const row,
+                   COL_TYPE const * const LVARRAY_RESTRICT columns,
+                   INDEX_TYPE const nnz,
+                   COL_TYPE const col ) const
+  {
+    OFFSET_TYPE const tableOffset = m_tableOffsets[ row ];
+    INDEX_TYPE const tableSize = m_tableOffsets[ row + 1 ] - tableOffset;
+
+    if( tableSize == 0 )
+    {
+      for( INDEX_TYPE i = 0; i < nnz; ++i )
+      {
+        if( columns[ i ] == col )
+        { return i; }
+      }
+
+      return nnz;
+    }
+
+    // Linear probing, the table is at most half full so this always terminates.
+    std::size_t const mask = tableSize - 1;
+    std::size_t slot = hash( col, hashShift( tableSize ) );
+    INDEX_TYPE const * const LVARRAY_RESTRICT table = m_table.data() + tableOffset;
+    while( true )
+    {
+      INDEX_TYPE const entry = table[ slot ];
+      if( entry == 0 || columns[ entry - 1 ] == col )
+      { return entry == 0 ? nnz : entry - 1; }
+
+      slot = ( slot + 1 ) & mask;
+    }
+  }
+
+  /**
+   * @brief Add to the given entries of @p matrix, the entries must already exist in the matrix.
+   * @details Each column is found in O( 1 ) expected time, independent of the length of the row.
+   * @tparam AtomicPolicy the policy to use when adding to the values.
+   * @tparam T The type of the entries in the matrix.
+   * @param matrix The matrix to add to, it must have the sparsity pattern the index was built from.
+   * @param row The row to add to.
+   * @param cols The columns to add to, unsorted, of length @p nCols.
+   * @param vals The values to add, of length @p nCols.
+   * @param nCols The number of columns to add to.
+   */
+  template< typename AtomicPolicy, typename T >
+  LVARRAY_HOST_DEVICE inline
+  void addToRow( CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE > const & matrix,
+                 INDEX_TYPE const row,
+                 COL_TYPE const * const LVARRAY_RESTRICT cols,
+                 std::remove_const_t< T > const * const LVARRAY_RESTRICT vals,
+                 INDEX_TYPE const nCols ) const
+  {
+    INDEX_TYPE const nnz = matrix.numNonZeros( row );
+    COL_TYPE const * const columns = matrix.getColumns( row );
+    T * const entries = matrix.getEntries( row );
+
+    for( INDEX_TYPE i = 0; i < nCols; ++i )
+    {
+      INDEX_TYPE const pos = find( row, columns, nnz, cols[ i ] );
+      LVARRAY_ASSERT_GT( nnz, pos );
+
+      internal::atomicAdd( AtomicPolicy{}, entries + pos, vals[ i ] );
+    }
+  }
+
+private:
+  /// The offset of the hash table of each row, a row with a table of size zero is searched linearly.
+  ArrayView< OFFSET_TYPE const, 1, 0, INDEX_TYPE, BUFFER_TYPE > m_tableOffsets;
+
+  /// The hash tables, each entry is one plus the position of the column in the row, or zero if empty.
+  ArrayView< INDEX_TYPE const, 1, 0, OFFSET_TYPE, BUFFER_TYPE > m_table;
+};
+
+/**
+ * @tparam COL_TYPE the integer used to enumerate the columns.
+ * @tparam INDEX_TYPE the integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @tparam OFFSET_TYPE the integer used for the offsets of the matrix.
+ * @class ColumnIndex
+ * @brief An open addressing hash table for each row of a CRSMatrix that maps a column to its position in the row.
+ * @details This is meant for matrices whose sparsity pattern is frozen but which are assembled from
+ *   contributions that can't be precomputed with ScatterPositions, for example contact terms. Each row
+ *   with at least LVARRAY_COLUMN_INDEX_MIN_ROW_LENGTH non zeros gets a table whose size is the smallest
+ *   power of two that is at least twice its length, shorter rows are searched linearly.
+ *   The index records the structure ID of the matrix it was built from, see CRSMatrix::getStructureID,
+ *   and toView aborts if the sparsity pattern has changed since.
+ */
+template< typename COL_TYPE,
+          typename INDEX_TYPE,
+          template< typename > class BUFFER_TYPE,
+          typename OFFSET_TYPE=INDEX_TYPE >
+class ColumnIndex
+{
+public:
+
+  /// The type of the view.
+  using ViewType = ColumnIndexView< COL_TYPE, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE >;
+
+  /**
+   * @brief Build the index for every row of @p matrix.
+   * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+   * @tparam T The type of the entries in @p matrix.
+   * @param matrix The matrix to build the index for.
+   */
+  template< typename POLICY, typename T >
+  void setFrom( CRSMatrix< T, COL_TYPE, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE > const & matrix )
+  {
+    INDEX_TYPE const numRows = matrix.numRows();
+    m_tableOffsets.resizeWithoutInitializationOrDestruction( numRows + 1 );
+
+    CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE > const matrixView = matrix.toViewConst();
+    ArrayView< OFFSET_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const tableOffsets = m_tableOffsets.toView();
+    tableOffsets[ 0 ] = 0;
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numRows ),
+                            [matrixView, tableOffsets] ( INDEX_TYPE const row )
+      {
+        INDEX_TYPE const nnz = matrixView.numNonZeros( row );
+        INDEX_TYPE tableSize = 0;
+        if( nnz >= LVARRAY_COLUMN_INDEX_MIN_ROW_LENGTH )
+        {
+          tableSize = 2;
+          while( tableSize < 2 * nnz )
+          { tableSize *= 2; }
+        }
+
+        tableOffsets[ row + 1 ] = tableSize;
+      } );
+
+    RAJA::inclusive_scan_inplace< POLICY >( RAJA::make_span< OFFSET_TYPE * >( tableOffsets.data() + 1, numRows ) );
+
+    m_table.clear();
+    m_table.resize( tableOffsets[ numRows ] );
+
+    ArrayView< INDEX_TYPE, 1, 0, OFFSET_TYPE, BUFFER_TYPE > const table = m_table.toView();
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numRows ),
+                            [matrixView, tableOffsets, table] ( INDEX_TYPE const row )
+      {
+        OFFSET_TYPE const tableOffset = tableOffsets[ row ];
+        INDEX_TYPE const tableSize = tableOffsets[ row + 1 ] - tableOffset;
+        if( tableSize == 0 )
+        { return; }
+
+        std::size_t const mask = tableSize - 1;
+        int const shift = ViewType::hashShift( tableSize );
+        INDEX_TYPE const nnz = matrixView.numNonZeros( row );
+        COL_TYPE const * const columns = matrixView.getColumns( row );
+        for( INDEX_TYPE i = 0; i < nnz; ++i )
+        {
+          std::size_t slot = ViewType::hash( columns[ i ], shift );
+          while( table[ tableOffset + slot ] != 0 )
+          { slot = ( slot + 1 ) & mask; }
+
+          table[ tableOffset + slot ] = i + 1;
+        }
+      } );
+
+    m_structureID = matrix.getStructureID();
+  }
+
+  /**
+   * @return True iff the index was built from @p matrix and its sparsity pattern hasn't changed since.
+   * @tparam T The type of the entries in @p matrix.
+   * @param matrix The matrix to check against.
+   */
+  template< typename T >
+  bool isValidFor( CRSMatrix< T, COL_TYPE, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE > const & matrix ) const
+  { return m_structureID == matrix.getStructureID(); }
+
+  /**
+   * @return A view of the index.
+   * @tparam T The type of the entries in @p matrix.
+   * @param matrix The matrix the index will be used with.
+   * @note Aborts if the index is not valid for @p matrix, see isValidFor.
+   */
+  template< typename T >
+  ViewType toView( CRSMatrix< T, COL_TYPE, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE > const & matrix ) const
+  {
+    LVARRAY_ERROR_IF( !isValidFor( matrix ),
+                      "The sparsity pattern of the matrix has changed since the column index was built." );
+    return ViewType( m_tableOffsets.toViewConst(), m_table.toViewConst() );
+  }
+
+  /**
+   * @return The total size of the hash tables.
+   */
+  OFFSET_TYPE tableSize() const
+  { return m_table.size(); }
+
+private:
+  /// The offset of the hash table of each row.
+  Array< OFFSET_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > m_tableOffsets;
+
+  /// The hash tables of every row, indexed by the table offsets.
+  Array< INDEX_TYPE, 1, RAJA::PERM_I, OFFSET_TYPE, BUFFER_TYPE > m_table;
+
+  /// The structure ID of the matrix the index was built from, zero is never a valid ID.
+  std::size_t m_structureID = 0;
+};
+
+} /* namespace LvArray */
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC and LvArray contributors.
+ * All rights reserved.
+ * See the LICENSE file for details.
+ * SPDX-License-Identifier: (BSD-3-Clause)
+ */
+
+/**
+ * @file LevelSchedule.hpp
+ * @brief Contains the implementation of LvArray::LevelSchedule.
+ */
+
+#pragma once
+
+// Source includes
+#include "CRSMatrix.hpp"
+#include "ArrayOfArrays.hpp"
+#include "Array.hpp"
+#include "sortedArrayManipulation.hpp"
+
+// TPL includes
+#include <RAJA/RAJA.hpp>
+
+namespace LvArray
+{
+
+/**
+ * @tparam COL_TYPE the integer used to enumerate the columns.
+ * @tparam INDEX_TYPE the integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @tparam OFFSET_TYPE the integer used for the offsets of the matrix.
+ * @class LevelSchedule
+ * @brief A level schedule of the rows of a square CRSMatrix for parallel triangular sweeps.
+ * @details Row @c i is placed in a level greater than that of every row @c j < i for which either
+ *   a_ij or a_ji is a non zero. The levels are processed one after another and the rows of a level
+ *   in parallel, in order for a forward sweep and in reverse for a backward sweep. When a row is
+ *   processed every row it depends on has been processed and every row that depends on it hasn't,
+ *   so the sweeps give the same result as a serial loop over the rows. For a structurally symmetric
+ *   matrix these are the usual level sets of the lower triangle.
+ *
+ *   Computing the schedule is a serial pass over the matrix on the host. Like ColumnIndex it
+ *   records the structure ID of the matrix, see CRSMatrix::getStructureID, so it can be kept and
+ *   reused as long as the sparsity pattern doesn't change. The kernels abort if it has.
+ *   Every row of the matrix must contain its diagonal.
+ */
+template< typename COL_TYPE,
+          typename INDEX_TYPE,
+          template< typename > class BUFFER_TYPE,
+          typename OFFSET_TYPE=INDEX_TYPE >
+class LevelSchedule
+{
+public:
+
+  /// The type of the matrices the schedule can be used with.
+  template< typename T >
+  using MatrixType = CRSMatrix< T, COL_TYPE, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE >;
+
+  /**
+   * @brief Compute the schedule of @p matrix.
+   * @tparam T The type of the entries in @p matrix.
+   * @param matrix The matrix to compute the schedule for, it must be square and contain every diagonal entry.
+   */
+  template< typename T >
+  void setFrom( MatrixType< T > const & matrix )
+  {
+    LVARRAY_ERROR_IF_NE( matrix.numRows(), matrix.numColumns() );
+    matrix.move( MemorySpace::host, false );
+
+    INDEX_TYPE const numRows = matrix.numRows();
+    Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > rowLevels( numRows );
+    Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > levelSizes;
+
+    // When row is reached every row before it has pushed its level to rowLevels[ row ],
+    // so its level is final once its own lower triangle has been taken into account.
+    for( INDEX_TYPE row = 0; row < numRows; ++row )
+    {
+      COL_TYPE const * const columns = matrix.getColumns( row );
+      INDEX_TYPE const nnz = matrix.numNonZeros( row );
+
+      INDEX_TYPE level = rowLevels[ row ];
+      bool hasDiagonal = false;
+      for( INDEX_TYPE i = 0; i < nnz; ++i )
+      {
+        if( columns[ i ] < row )
+        { level = math::max( level, rowLevels[ columns[ i ] ] + 1 ); }
+        hasDiagonal = hasDiagonal || columns[ i ] == row;
+      }
+
+      LVARRAY_ERROR_IF( !hasDiagonal, "Row " << row << " does not contain its diagonal." );
+
+      for( INDEX_TYPE i = 0; i < nnz; ++i )
+      {
+        if( columns[ i ] > row )
+        { rowLevels[ columns[ i ] ] = math::max( rowLevels[ columns[ i ] ], level + 1 ); }
+      }
+
+      rowLevels[ row ] = level;
+      if( level == levelSizes.size() )
+      { levelSizes.emplace_back( 0 ); }
+
+      ++levelSizes[ level ];
+    }
+
+    m_levelToRows.template resizeFromCapacities< RAJA::loop_exec >( levelSizes.size(), levelSizes.data() );
+    for( INDEX_TYPE row = 0; row < numRows; ++row )
+    { m_levelToRows.emplaceBack( rowLevels[ row ], row ); }
+
+    m_structureID = matrix.getStructureID();
+  }
+
+  /**
+   * @return True iff the schedule was computed from @p matrix and its sparsity pattern hasn't changed since.
+   * @tparam T The type of the entries in @p matrix.
+   * @param matrix The matrix to check against.
+   */
+  template< typename T >
+  bool isValidFor( MatrixType< T > const & matrix ) const
+  { return m_structureID == matrix.getStructureID(); }
+
+  /**
+   * @return The number of levels.
+   */
+  INDEX_TYPE numLevels() const
+  { return m_levelToRows.size(); }
+
+  /**
+   * @return The rows of each level, array @c l contains the sorted rows of level @c l.
+   */
+  ArrayOfArraysView< INDEX_TYPE const, INDEX_TYPE const, true, BUFFER_TYPE > levelToRows() const &
+  { return m_levelToRows.toViewConst(); }
+
+  /**
+   * @brief Overload for rvalues that is deleted.
+   * @return A null ArrayOfArraysView.
+   * @note This cannot be called on a rvalue since the view would contain
+   *   the buffers of the schedule that is about to be destroyed.
+   */
+  ArrayOfArraysView< INDEX_TYPE const, INDEX_TYPE const, true, BUFFER_TYPE > levelToRows() const && = delete;
+
+  /**
+   * @tparam POLICY The RAJA policy to use.
+   * @tparam T The type of the entries in @p matrix.
+   * @brief Do a forward Gauss-Seidel sweep, for each row in order
+   *   @code x_i = ( b_i - sum_{j != i} a_ij x_j ) / a_ii @endcode.
+   * @param matrix The matrix.
+   * @param b The right hand side, of length @c matrix.numRows().
+   * @param x The current iterate, it is updated in place.
+   */
+  template< typename POLICY, typename T >
+  void gaussSeidelForward( MatrixType< T > const & matrix,
+                           ArrayView< T const, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & b,
+                           ArrayView< T, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & x ) const
+  { gaussSeidel< POLICY >( matrix, b, x, false ); }
+
+  /**
+   * @tparam POLICY The RAJA policy to use.
+   * @tparam T The type of the entries in @p matrix.
+   * @brief Do a backward Gauss-Seidel sweep, the rows are updated from last to first.
+   * @param matrix The matrix.
+   * @param b The right hand side, of length @c matrix.numRows().
+   * @param x The current iterate, it is updated in place.
+   * @note A forward sweep followed by a backward sweep is a symmetric Gauss-Seidel iteration.
+   */
+  template< typename POLICY, typename T >
+  void gaussSeidelBackward( MatrixType< T > const & matrix,
+                            ArrayView< T const, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & b,
+                            ArrayView< T, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & x ) const
+  { gaussSeidel< POLICY >( matrix, b, x, true ); }
+
+  /**
+   * @tparam POLICY The RAJA policy to use.
+   * @tparam T The type of the entries in @p matrix.
+   * @brief Compute the incomplete LU factorization with zero fill in, ILU(0), of @p matrix in place.
+   * @param matrix The matrix to factor. Afterwards its strict lower triangle holds L, whose diagonal
+   *   is one and isn't stored, and its upper triangle, including the diagonal, holds U. Each entry of
+   *   L U that is in the sparsity pattern of the matrix equals the original entry.
+   * @details Row @c i is computed from the already factored rows @c k < i with a_ik non zero,
+   *   the entries of row @c k that aren't in row @c i are dropped. Both rows are sorted so they are
+   *   merged. Only the entries are modified so the schedule stays valid for the factored matrix.
+   */
+  template< typename POLICY, typename T >
+  void factorILU0( MatrixType< T > & matrix ) const
+  {
+    checkValidity( matrix );
+
+    CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE > const lu = matrix.toViewConstSizes();
+    forAllRows< POLICY >( false, [lu] LVARRAY_HOST_DEVICE ( INDEX_TYPE const row )
+    {
+      COL_TYPE const * const columns = lu.getColumns( row );
+      T * const entries = lu.getEntries( row );
+      INDEX_TYPE const nnz = lu.numNonZeros( row );
+
+      for( INDEX_TYPE i = 0; i < nnz && columns[ i ] < row; ++i )
+      {
+        INDEX_TYPE const k = columns[ i ];
+        COL_TYPE const * const kColumns = lu.getColumns( k );
+        T const * const kEntries = lu.getEntries( k );
+        INDEX_TYPE const kNNZ = lu.numNonZeros( k );
+
+        INDEX_TYPE j = sortedArrayManipulation::find( kColumns, kNNZ, COL_TYPE( k ) );
+        LVARRAY_ASSERT_GT( kNNZ, j );
+
+        entries[ i ] /= kEntries[ j ];
+        ++j;
+
+        for( INDEX_TYPE m = i + 1; m < nnz; ++m )
+        {
+          while( j < kNNZ && kColumns[ j ] < columns[ m ] )
+          { ++j; }
+
+          if( j == kNNZ )
+          { break; }
+
+          if( kColumns[ j ] == columns[ m ] )
+          { entries[ m ] -= entries[ i ] * kEntries[ j ]; }
+        }
+      }
+    } );
+  }
+
+  /**
+   * @tparam POLICY The RAJA policy to use.
+   * @tparam T The type of the entries in @p lu.
+   * @brief Solve @code L U x = b @endcode with a forward and a backward triangular solve.
+   * @param lu The matrix factored with factorILU0.
+   * @param b The right hand side, of length @c lu.numRows().
+   * @param x The solution, of length @c lu.numRows(). It is also used for the intermediate solution.
+   */
+  template< typename POLICY, typename T >
+  void solveILU0( MatrixType< T > const & lu,
+                  ArrayView< T const, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & b,
+                  ArrayView< T, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & x ) const
+  {
+    checkValidity( lu );
+    LVARRAY_ERROR_IF_NE( b.size(), lu.numRows() );
+    LVARRAY_ERROR_IF_NE( x.size(), lu.numRows() );
+
+    CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE > const luView = lu.toViewConst();
+    forAllRows< POLICY >( false, [luView, b, x] LVARRAY_HOST_DEVICE ( INDEX_TYPE const row )
+    {
+      COL_TYPE const * const columns = luView.getColumns( row );
+      T const * const entries = luView.getEntries( row );
+
+      T sum = b[ row ];
+      for( INDEX_TYPE i = 0; columns[ i ] < row; ++i )
+      { sum -= entries[ i ] * x[ columns[ i ] ]; }
+
+      x[ row ] = sum;
+    } );
+
+    forAllRows< POLICY >( true, [luView, x] LVARRAY_HOST_DEVICE ( INDEX_TYPE const row )
+    {
+      COL_TYPE const * const columns = luView.getColumns( row );
+      T const * const entries = luView.getEntries( row );
+      INDEX_TYPE const nnz = luView.numNonZeros( row );
+
+      INDEX_TYPE const diagonal = sortedArrayManipulation::find( columns, nnz, COL_TYPE( row ) );
+      T sum = x[ row ];
+      for( INDEX_TYPE i = diagonal + 1; i < nnz; ++i )
+      { sum -= entries[ i ] * x[ columns[ i ] ]; }
+
+      x[ row ] = sum / entries[ diagonal ];
+    } );
+  }
+
+  /**
+   * @tparam POLICY The RAJA policy to use.
+   * @tparam LAMBDA The type of @p body.
+   * @brief Call @p body on every row, one level at a time and the rows of a level in parallel.
+   * @param reverse If true the levels are processed from last to first.
+   * @param body The function to call, it is called as @code body( row ) @endcode.
+   * @note This should be private but cuda won't let you put an extended lambda in a protected or private method.
+   */
+  template< typename POLICY, typename LAMBDA >
+  void forAllRows( bool const reverse, LAMBDA && body ) const
+  {
+    ArrayOfArraysView< INDEX_TYPE const, INDEX_TYPE const, true, BUFFER_TYPE > const levelToRows = m_levelToRows.toViewConst();
+    for( INDEX_TYPE i = 0; i < numLevels(); ++i )
+    {
+      INDEX_TYPE const level = reverse ? numLevels() - 1 - i : i;
+      RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, levelToRows.sizeOfArray( level ) ),
+                              [levelToRows, level, body] LVARRAY_HOST_DEVICE ( INDEX_TYPE const j )
+        { body( levelToRows( level, j ) ); } );
+    }
+  }
+
+  /**
+   * @tparam POLICY The RAJA policy to use.
+   * @tparam T The type of the entries in @p matrix.
+   * @brief Do a Gauss-Seidel sweep.
+   * @param matrix The matrix.
+   * @param b The right hand side.
+   * @param x The current iterate, it is updated in place.
+   * @param reverse If true do a backward sweep.
+   * @note This should be private but cuda won't let you put an extended lambda in a protected or private method.
+   */
+  template< typename POLICY, typename T >
+  void gaussSeidel( MatrixType< T > const & matrix,
+                    ArrayView< T const, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & b,
+                    ArrayView< T, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & x,
+                    bool const reverse ) const
+  {
+    checkValidity( matrix );
+    LVARRAY_ERROR_IF_NE( b.size(), matrix.numRows() );
+    LVARRAY_ERROR_IF_NE( x.size(), matrix.numRows() );
+
+    CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE > const a = matrix.toViewConst();
+    forAllRows< POLICY >( reverse, [a, b, x] LVARRAY_HOST_DEVICE ( INDEX_TYPE const row )
+    {
+      COL_TYPE const * const columns = a.getColumns( row );
+      T const * const entries = a.getEntries( row );
+      INDEX_TYPE const nnz = a.numNonZeros( row );
+
+      T sum = b[ row ];
+      T diagonal = 0;
+      for( INDEX_TYPE i = 0; i < nnz; ++i )
+      {
+        if( columns[ i ] == row )
+        { diagonal = entries[ i ]; }
+        else
+        { sum -= entries[ i ] * x[ columns[ i ] ]; }
+      }
+
+      x[ row ] = sum / diagonal;
+    } );
+  }
+
+private:
+
+  /**
+   * @brief Abort if the schedule is not valid for @p matrix, see isValidFor.
+   * @tparam T The type of the entries in @p matrix.
+   * @param matrix The matrix to check against.
+   */
+  template< typename T >
+  void checkValidity( MatrixType< T > const & matrix ) const
+  {
+    LVARRAY_ERROR_IF( !isValidFor( matrix ),
+                      "The sparsity pattern of the matrix has changed since the level schedule was computed." );
+  }
+
+  /// The rows of each level.
+  ArrayOfArrays< INDEX_TYPE, INDEX_TYPE, BUFFER_TYPE > m_levelToRows;
+
+  /// The structure ID of the matrix the schedule was computed from, zero is never a valid ID.
+  std::size_t m_structureID = 0;
+};
+
+} /* namespace LvArray */
@@ -578,6 +578,22 @@
   #endif
 #endif
 
+#if defined(__CUDA_ARCH__) || !( defined(__GNUC__) || defined(__clang__) )
+/**
+ * @brief Hint that the memory at @p ADDRESS will be read soon.
+ * @param ADDRESS The address to prefetch.
+ * @note This does nothing on device or with compilers that don't support @c __builtin_prefetch.
+ */
+#define LVARRAY_PREFETCH( ADDRESS )
+#else
+/**
+ * @brief Hint that the memory at @p ADDRESS will be read soon.
+ * @param ADDRESS The address to prefetch.
+ * @note This does nothing on device or with compilers that don't support @c __builtin_prefetch.
+ */
+#define LVARRAY_PREFETCH( ADDRESS ) __builtin_prefetch( ADDRESS )
+#endif
+
 #if !defined(LVARRAY_BOUNDS_CHECK)
 /**
  * @brief Expands to constexpr when array bound checking is disabled.
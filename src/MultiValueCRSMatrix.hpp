@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC and LvArray contributors.
+ * All rights reserved.
+ * See the LICENSE file for details.
+ * SPDX-License-Identifier: (BSD-3-Clause)
+ */
+
+/**
+ * @file MultiValueCRSMatrix.hpp
+ * @brief Contains the implementation of LvArray::MultiValueCRSMatrix.
+ */
+
+#pragma once
+
+// Source includes
+#include "SparsityPattern.hpp"
+#include "CRSMatrixView.hpp"
+#include "Array.hpp"
+
+// TPL includes
+#include <RAJA/RAJA.hpp>
+
+// System includes
+#include <vector>
+
+namespace LvArray
+{
+
+/**
+ * @tparam T the type of the entries in the matrices.
+ * @tparam COL_TYPE the integer used to enumerate the columns.
+ * @tparam INDEX_TYPE the integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @tparam OFFSET_TYPE the integer used for the offsets, it may be wider than INDEX_TYPE.
+ * @class MultiValueCRSMatrix
+ * @brief A set of matrices that share a single sparsity pattern, each with its own entries.
+ * @details This is meant for matrices that always have the same structure, for example a Jacobian
+ *   and a mass matrix, and it stores the offsets, sizes and columns only once. Each value set can
+ *   be viewed as a regular CRSMatrixView. These views have constant sizes and columns so the
+ *   structure can't be changed through them, instead it is changed with modifySparsityPattern
+ *   which carries the entries of every value set over to the new structure.
+ */
+template< typename T,
+          typename COL_TYPE,
+          typename INDEX_TYPE,
+          template< typename > class BUFFER_TYPE,
+          typename OFFSET_TYPE=INDEX_TYPE >
+class MultiValueCRSMatrix : protected SparsityPattern< COL_TYPE, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE >
+{
+
+  /// An alias for the parent class.
+  using ParentClass = SparsityPattern< COL_TYPE, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE >;
+
+  /// The type of the array holding the entries of a value set, it is indexed by the offsets.
+  using ValuesType = Array< T, 1, RAJA::PERM_I, OFFSET_TYPE, BUFFER_TYPE >;
+
+public:
+
+  /// The type of the entries in the matrices.
+  using EntryType = T;
+  using typename ParentClass::ColType;
+  using typename ParentClass::IndexType;
+  using typename ParentClass::OffsetType;
+
+  /// The type of the view of a single value set.
+  using ViewTypeConstSizes = CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >;
+
+  /// The type of the view of a single value set with constant entries.
+  using ViewTypeConst = CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >;
+
+  /**
+   * @brief Default constructor, creates an empty matrix without any value sets.
+   */
+  MultiValueCRSMatrix() = default;
+
+  /**
+   * @brief Constructor.
+   * @param pattern The sparsity pattern to copy.
+   * @param numValueSets The number of value sets, every entry is value initialized.
+   */
+  MultiValueCRSMatrix( ParentClass const & pattern, INDEX_TYPE const numValueSets ):
+    ParentClass( pattern )
+  { setNumValueSets( numValueSets ); }
+
+  /**
+   * @return The number of value sets.
+   */
+  INDEX_TYPE numValueSets() const
+  { return m_valueSets.size(); }
+
+  /**
+   * @brief Set the number of value sets, the entries of any new value sets are value initialized.
+   * @param numValueSets The new number of value sets.
+   */
+  void setNumValueSets( INDEX_TYPE const numValueSets )
+  {
+    LVARRAY_ERROR_IF_GT( 0, numValueSets );
+    m_valueSets.resize( numValueSets );
+    for( ValuesType & values : m_valueSets )
+    {
+      if( values.size() != this->nonZeroCapacity() )
+      { values.resize( this->nonZeroCapacity() ); }
+    }
+  }
+
+  /**
+   * @return A view of the given value set.
+   * @param valueSet The value set to view.
+   */
+  ViewTypeConstSizes toViewConstSizes( INDEX_TYPE const valueSet ) const &
+  {
+    return ViewTypeConstSizes( numRows(),
+                               numColumns(),
+                               this->m_offsets,
+                               this->m_sizes,
+                               this->m_values,
+                               getValueSet( valueSet ).dataBuffer() );
+  }
+
+  /**
+   * @brief Overload for rvalues that is deleted.
+   * @param valueSet Not used.
+   * @return A null CRSMatrixView.
+   * @note This cannot be called on a rvalue since the view would contain
+   *   the buffers of the matrix that is about to be destroyed.
+   */
+  ViewTypeConstSizes toViewConstSizes( INDEX_TYPE const valueSet ) const && = delete;
+
+  /**
+   * @return A view of the given value set with constant entries.
+   * @param valueSet The value set to view.
+   */
+  ViewTypeConst toViewConst( INDEX_TYPE const valueSet ) const &
+  {
+    return ViewTypeConst( numRows(),
+                          numColumns(),
+                          this->m_offsets,
+                          this->m_sizes,
+                          this->m_values,
+                          getValueSet( valueSet ).dataBuffer() );
+  }
+
+  /**
+   * @brief Overload for rvalues that is deleted.
+   * @param valueSet Not used.
+   * @return A null CRSMatrixView.
+   * @note This cannot be called on a rvalue since the view would contain
+   *   the buffers of the matrix that is about to be destroyed.
+   */
+  ViewTypeConst toViewConst( INDEX_TYPE const valueSet ) const && = delete;
+
+  /**
+   * @return A view of the shared sparsity pattern.
+   */
+  SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
+  toSparsityPatternView() const &
+  { return ParentClass::toViewConst(); }
+
+  /**
+   * @brief Overload for rvalues that is deleted.
+   * @return A null SparsityPatternView.
+   * @note This cannot be called on a rvalue since the view would contain
+   *   the buffers of the matrix that is about to be destroyed.
+   */
+  SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
+  toSparsityPatternView() const && = delete;
+
+  using ParentClass::numRows;
+  using ParentClass::numColumns;
+  using ParentClass::numNonZeros;
+  using ParentClass::nonZeroCapacity;
+  using ParentClass::getColumns;
+
+  /**
+   * @tparam POLICY The RAJA policy used to copy the entries. Should NOT be a device policy.
+   * @tparam LAMBDA The type of @p modify.
+   * @brief Modify the shared sparsity pattern and carry every value set over to the new pattern.
+   * @param modify The function that modifies the pattern, it is called as
+   *   @code modify( pattern ) @endcode where @c pattern is a reference to the SparsityPattern.
+   * @details An entry that is in both the old and the new pattern keeps its value in every value set,
+   *   the new entries are value initialized. Any modification is allowed, including resizing and
+   *   compressing. This makes a temporary copy of the old pattern and each value set is copied once,
+   *   so it is best to group modifications together.
+   */
+  template< typename POLICY, typename LAMBDA >
+  void modifySparsityPattern( LAMBDA && modify )
+  {
+    move( MemorySpace::host, true );
+
+    ParentClass const oldPattern( *this );
+    modify( static_cast< ParentClass & >( *this ) );
+
+    SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE > const oldView = oldPattern.toViewConst();
+    SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE > const newView = toSparsityPatternView();
+    for( ValuesType & values : m_valueSets )
+    {
+      ValuesType newValues( nonZeroCapacity() );
+      T const * const oldEntries = values.data();
+      T * const newEntries = newValues.data();
+      RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, newView.numRows() ),
+                              [oldView, newView, oldEntries, newEntries] ( INDEX_TYPE const row )
+        {
+          if( row >= oldView.numRows() )
+          { return; }
+
+          // Both rows are sorted so the entries in common are found by a merge.
+          COL_TYPE const * const oldColumns = oldView.getColumns( row );
+          COL_TYPE const * const newColumns = newView.getColumns( row );
+          INDEX_TYPE const oldNNZ = oldView.numNonZeros( row );
+          INDEX_TYPE const newNNZ = newView.numNonZeros( row );
+          OFFSET_TYPE const oldOffset = oldView.getOffsets()[ row ];
+          OFFSET_TYPE const newOffset = newView.getOffsets()[ row ];
+
+          INDEX_TYPE j = 0;
+          for( INDEX_TYPE i = 0; i < newNNZ; ++i )
+          {
+            while( j < oldNNZ && oldColumns[ j ] < newColumns[ i ] )
+            { ++j; }
+
+            if( j < oldNNZ && oldColumns[ j ] == newColumns[ i ] )
+            { newEntries[ newOffset + i ] = oldEntries[ oldOffset + j ]; }
+          }
+        } );
+
+      values = std::move( newValues );
+    }
+  }
+
+  /**
+   * @brief Move the sparsity pattern and every value set to the given memory space.
+   * @param space The memory space to move to.
+   * @param touch If true touch the entries in the new space.
+   * @note The sparsity pattern is never touched.
+   */
+  void move( MemorySpace const space, bool const touch=true ) const
+  {
+    ParentClass::move( space, false );
+    for( ValuesType const & values : m_valueSets )
+    { values.move( space, touch ); }
+  }
+
+private:
+
+  /**
+   * @return The entries of the given value set.
+   * @param valueSet The value set to get.
+   */
+  ValuesType const & getValueSet( INDEX_TYPE const valueSet ) const
+  {
+    LVARRAY_ERROR_IF_GE( valueSet, numValueSets() );
+    return m_valueSets[ valueSet ];
+  }
+
+  /// The entries of each value set, each of length nonZeroCapacity().
+  std::vector< ValuesType > m_valueSets;
+};
+
+} /* namespace LvArray */
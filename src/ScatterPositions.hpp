@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC and LvArray contributors.
+ * All rights reserved.
+ * See the LICENSE file for details.
+ * SPDX-License-Identifier: (BSD-3-Clause)
+ */
+
+/**
+ * @file ScatterPositions.hpp
+ * @brief Contains the implementation of LvArray::ScatterPositions.
+ */
+
+#pragma once
+
+// Source includes
+#include "CRSMatrix.hpp"
+#include "Array.hpp"
+#include "sortedArrayManipulation.hpp"
+
+// TPL includes
+#include <RAJA/RAJA.hpp>
+
+namespace LvArray
+{
+
+/**
+ * @tparam T the type of the entries in the matrix.
+ * @tparam COL_TYPE the integer used to enumerate the columns.
+ * @tparam INDEX_TYPE the integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @tparam OFFSET_TYPE the integer used for the offsets of the matrix.
+ * @class ScatterPositions
+ * @brief Caches the positions in the entries of a CRSMatrix that each element of a mesh adds to.
+ * @details Given the degrees of freedom of each element, @c elemToDof, the local matrix of element
+ *   @c e adds entry ( i, j ) to row @c elemToDof( e, i ) and column @c elemToDof( e, j ) of the matrix.
+ *   The position of that entry in the entries of the matrix is computed once and stored in
+ *   @c positions( e, i, j ). Every subsequent assembly into a matrix with the same sparsity pattern
+ *   is then just an indexed add, see CRSMatrixView::addToEntries.
+ *   @code
+ *   ScatterPositions< double, int, int, MallocBuffer > scatter;
+ *   scatter.setFrom< POLICY >( matrix, elemToDof );
+ *   ArrayView< int const, 3, 2, int, MallocBuffer > const positions = scatter.toViewConst( matrix );
+ *   CRSMatrixView< double, int const, int const, MallocBuffer > const view = matrix.toViewConstSizes();
+ *   forall< POLICY >( numElems, [=] ( int const e )
+ *   {
+ *     for( int i = 0; i < numDofs; ++i )
+ *     { view.addToEntries< AtomicPolicy >( positions[ e ][ i ], localMatrix[ e ][ i ], numDofs ); }
+ *   } );
+ *   @endcode
+ *   The positions record the structure ID of the matrix they were computed from, when the sparsity
+ *   pattern of the matrix changes they are no longer valid and toViewConst will abort.
+ */
+template< typename T,
+          typename COL_TYPE,
+          typename INDEX_TYPE,
+          template< typename > class BUFFER_TYPE,
+          typename OFFSET_TYPE=INDEX_TYPE >
+class ScatterPositions
+{
+public:
+
+  /// The type of matrix the positions refer to.
+  using MatrixType = CRSMatrix< T, COL_TYPE, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE >;
+
+  /**
+   * @brief Compute the positions in @p matrix that each element adds to.
+   * @tparam POLICY The RAJA policy to use.
+   * @tparam DOF_TYPE The type of the degrees of freedom.
+   * @tparam USD The unit stride dimension of @p elemToDof.
+   * @param matrix The matrix to compute the positions in.
+   * @param elemToDof The degrees of freedom of each element.
+   * @pre For each element @c e the entry ( @c elemToDof( e, i ), @c elemToDof( e, j ) ) must exist
+   *   in @p matrix for all @c i and @c j.
+   */
+  template< typename POLICY, typename DOF_TYPE, int USD >
+  void setFrom( MatrixType const & matrix,
+                ArrayView< DOF_TYPE const, 2, USD, INDEX_TYPE, BUFFER_TYPE > const & elemToDof )
+  {
+    INDEX_TYPE const numElems = elemToDof.size( 0 );
+    INDEX_TYPE const numDofs = elemToDof.size( 1 );
+    m_positions.resize( numElems, numDofs, numDofs );
+
+    CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE > const matrixView = matrix.toViewConst();
+    ArrayView< OFFSET_TYPE, 3, 2, INDEX_TYPE, BUFFER_TYPE > const positions = m_positions.toView();
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numElems ),
+                            [matrixView, elemToDof, positions, numDofs] LVARRAY_HOST_DEVICE ( INDEX_TYPE const elem )
+      {
+        for( INDEX_TYPE i = 0; i < numDofs; ++i )
+        {
+          INDEX_TYPE const row = elemToDof( elem, i );
+          INDEX_TYPE const nnz = matrixView.numNonZeros( row );
+          COL_TYPE const * const columns = matrixView.getColumns( row );
+          OFFSET_TYPE const rowOffset = matrixView.getOffsets()[ row ];
+
+          for( INDEX_TYPE j = 0; j < numDofs; ++j )
+          {
+            COL_TYPE const col = elemToDof( elem, j );
+            INDEX_TYPE const pos = sortedArrayManipulation::find( columns, nnz, col );
+            LVARRAY_ASSERT_GT( nnz, pos );
+            LVARRAY_ASSERT_EQ( columns[ pos ], col );
+
+            positions( elem, i, j ) = rowOffset + pos;
+          }
+        }
+      } );
+
+    m_structureID = matrix.getStructureID();
+  }
+
+  /**
+   * @return True iff the positions were computed from @p matrix and its sparsity pattern hasn't changed since.
+   * @param matrix The matrix to check against.
+   */
+  bool isValidFor( MatrixType const & matrix ) const
+  { return m_structureID == matrix.getStructureID(); }
+
+  /**
+   * @return A view of the positions, the positions of element @c e are ( e, i, j ).
+   * @param matrix The matrix the positions will be used with.
+   * @note Aborts if the positions are not valid for @p matrix, see isValidFor.
+   */
+  ArrayView< OFFSET_TYPE const, 3, 2, INDEX_TYPE, BUFFER_TYPE > toViewConst( MatrixType const & matrix ) const
+  {
+    LVARRAY_ERROR_IF( m_structureID != matrix.getStructureID(),
+                      "The sparsity pattern of the matrix has changed since the scatter positions were computed." );
+    return m_positions.toViewConst();
+  }
+
+  /**
+   * @brief Set the name associated with the positions, which is used in the chai callback.
+   * @param name The name.
+   */
+  void setName( std::string const & name )
+  { m_positions.setName( name ); }
+
+private:
+  /// The positions, of size ( numElems, numDofs, numDofs ).
+  Array< OFFSET_TYPE, 3, RAJA::PERM_IJK, INDEX_TYPE, BUFFER_TYPE > m_positions;
+
+  /// The structure ID of the matrix the positions were computed from, zero is never a valid ID.
+  std::size_t m_structureID = 0;
+};
+
+} /* namespace LvArray */
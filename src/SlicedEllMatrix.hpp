@@ -0,0 +1,439 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC and LvArray contributors.
+ * All rights reserved.
+ * See the LICENSE file for details.
+ * SPDX-License-Identifier: (BSD-3-Clause)
+ */
+
+/**
+ * @file SlicedEllMatrix.hpp
+ * @brief Contains the implementation of LvArray::SlicedEllMatrix.
+ */
+
+#pragma once
+
+// Source includes
+#include "CRSMatrixView.hpp"
+#include "Array.hpp"
+#include "sortedArrayManipulation.hpp"
+
+// TPL includes
+#include <RAJA/RAJA.hpp>
+
+namespace LvArray
+{
+
+/**
+ * @class SlicedEllMatrix
+ * @brief A read only sparse matrix stored in the SELL-C-sigma (sliced ELLPACK) format.
+ * @tparam T The type of the entries of the matrix.
+ * @tparam COL_TYPE The integer used to enumerate the columns.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @tparam CHUNK_SIZE The number of rows in each chunk, C. This should be a multiple
+ *   of the SIMD width of @p T on the target architecture.
+ * @details The rows of the matrix are grouped into chunks of @p CHUNK_SIZE consecutive
+ *   rows. Each chunk is padded to the length of its longest row and stored column major
+ *   so that the j-th entry of every row in a chunk is contiguous in memory. This lets the
+ *   SpMV process a chunk with unit stride SIMD loads instead of the variable length
+ *   inner loop of a CRS kernel. To reduce the amount of padding the rows are first sorted
+ *   by decreasing length within windows of sigma rows, the resulting permutation is stored
+ *   and applied transparently by multiply.
+ *
+ *   The structure is built once from a CRSMatrixView or SparsityPatternView, afterwards the
+ *   values can be refreshed from any CRSMatrix with the same sparsity pattern using
+ *   setValuesFrom without rebuilding the structure.
+ */
+template< typename T,
+          typename COL_TYPE,
+          typename INDEX_TYPE,
+          template< typename > class BUFFER_TYPE,
+          int CHUNK_SIZE=8 >
+class SlicedEllMatrix
+{
+public:
+  static_assert( CHUNK_SIZE > 0, "CHUNK_SIZE must be positive." );
+  static_assert( std::is_integral< COL_TYPE >::value, "COL_TYPE must be integral." );
+  static_assert( std::is_integral< INDEX_TYPE >::value, "INDEX_TYPE must be integral." );
+
+  /// The type of the entries in the matrix.
+  using EntryType = T;
+
+  /// The integer type used to enumerate the columns.
+  using ColType = COL_TYPE;
+
+  /// The integer type used for indexing.
+  using IndexType = INDEX_TYPE;
+
+  /// The number of rows in each chunk.
+  static constexpr int chunkSize = CHUNK_SIZE;
+
+  /// The type of the views used to access the one dimensional arrays.
+  template< typename U >
+  using ArrayView1d = ArrayView< U, 1, 0, INDEX_TYPE, BUFFER_TYPE >;
+
+  /// The type of the CRSMatrixView the structure and values can be taken from.
+  using CRSMatrixViewConst = CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >;
+
+  /// The type of the SparsityPatternView the structure can be taken from.
+  using SparsityPatternViewConst = SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >;
+
+  /**
+   * @name Constructors and the destructor
+   */
+  ///@{
+
+  /**
+   * @brief Create an empty matrix.
+   */
+  SlicedEllMatrix()
+  { setName( "" ); }
+
+  ///@}
+
+  /**
+   * @name Methods to construct the matrix from scratch.
+   */
+  ///@{
+
+  /**
+   * @tparam POLICY The RAJA policy used to build the structure. Should NOT be a device policy.
+   * @brief Clear the matrix and build it from the structure and values of @p matrix.
+   * @param matrix The matrix to convert.
+   * @param sigma The size of the windows in which the rows are sorted by length. A value of 1
+   *   disables the sorting, a value of at least numRows() sorts all the rows. Values which are a
+   *   multiple of @p CHUNK_SIZE give the best results.
+   */
+  template< typename POLICY >
+  void setFrom( CRSMatrixViewConst const & matrix, INDEX_TYPE const sigma )
+  {
+    setFrom< POLICY >( matrix.toSparsityPatternView(), sigma );
+    setValuesFrom< POLICY >( matrix );
+  }
+
+  /**
+   * @tparam POLICY The RAJA policy used to build the structure. Should NOT be a device policy.
+   * @brief Clear the matrix and build it from the given sparsity pattern, all entries are zero.
+   * @param pattern The sparsity pattern to use.
+   * @param sigma The size of the windows in which the rows are sorted by length, see the other overload.
+   */
+  template< typename POLICY >
+  void setFrom( SparsityPatternViewConst const & pattern, INDEX_TYPE const sigma )
+  {
+    LVARRAY_ERROR_IF( sigma < 1, "sigma must be at least 1, sigma = " << sigma );
+
+    m_numRows = pattern.numRows();
+    m_numCols = pattern.numColumns();
+    m_sigma = sigma;
+
+    INDEX_TYPE const numRows = m_numRows;
+    INDEX_TYPE const nChunks = ( numRows + CHUNK_SIZE - 1 ) / CHUNK_SIZE;
+
+    m_slotToRow.resizeWithoutInitializationOrDestruction( nChunks * CHUNK_SIZE );
+    m_rowToSlot.resizeWithoutInitializationOrDestruction( numRows );
+    m_chunkOffsets.resizeWithoutInitializationOrDestruction( nChunks + 1 );
+
+    // Sort the rows in each window by decreasing length, ties are broken by the row number
+    // so the result is independent of the policy.
+    ArrayView1d< INDEX_TYPE > const slotToRow = m_slotToRow.toView();
+    INDEX_TYPE const nWindows = ( numRows + sigma - 1 ) / sigma;
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, nWindows ),
+                            [slotToRow, pattern, sigma, numRows] ( INDEX_TYPE const window )
+      {
+        INDEX_TYPE const begin = window * sigma;
+        INDEX_TYPE const end = math::min( begin + sigma, numRows );
+        for( INDEX_TYPE slot = begin; slot < end; ++slot )
+        { slotToRow[ slot ] = slot; }
+
+        if( sigma > 1 )
+        {
+          sortedArrayManipulation::makeSorted( slotToRow.data() + begin, slotToRow.data() + end,
+                                               [pattern] ( INDEX_TYPE const lhs, INDEX_TYPE const rhs )
+          {
+            INDEX_TYPE const lhsLength = pattern.numNonZeros( lhs );
+            INDEX_TYPE const rhsLength = pattern.numNonZeros( rhs );
+            return lhsLength > rhsLength || ( lhsLength == rhsLength && lhs < rhs );
+          } );
+        }
+      } );
+
+    // The padding slots in the last chunk don't correspond to any row.
+    for( INDEX_TYPE slot = numRows; slot < nChunks * CHUNK_SIZE; ++slot )
+    { slotToRow[ slot ] = numRows; }
+
+    // Compute the inverse permutation and the width of each chunk.
+    ArrayView1d< INDEX_TYPE > const rowToSlot = m_rowToSlot.toView();
+    ArrayView1d< INDEX_TYPE > const chunkOffsets = m_chunkOffsets.toView();
+    chunkOffsets[ 0 ] = 0;
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, nChunks ),
+                            [slotToRow, rowToSlot, chunkOffsets, pattern, numRows] ( INDEX_TYPE const chunk )
+      {
+        INDEX_TYPE width = 0;
+        for( INDEX_TYPE lane = 0; lane < CHUNK_SIZE; ++lane )
+        {
+          INDEX_TYPE const slot = chunk * CHUNK_SIZE + lane;
+          INDEX_TYPE const row = slotToRow[ slot ];
+          if( row < numRows )
+          {
+            rowToSlot[ row ] = slot;
+            width = math::max( width, pattern.numNonZeros( row ) );
+          }
+        }
+
+        chunkOffsets[ chunk + 1 ] = CHUNK_SIZE * width;
+      } );
+
+    RAJA::inclusive_scan_inplace< POLICY >( RAJA::make_span< INDEX_TYPE * >( chunkOffsets.data() + 1, nChunks ) );
+
+    // Fill in the columns, padding each row with its last column so that the padding never reads
+    // outside of the rows footprint in the vector.
+    INDEX_TYPE const numStored = chunkOffsets[ nChunks ];
+    m_columns.resizeWithoutInitializationOrDestruction( numStored );
+
+    // Clear the entries first so that no values from a previous structure survive the resize.
+    m_entries.clear();
+    m_entries.resize( numStored );
+
+    ArrayView1d< COL_TYPE > const columns = m_columns.toView();
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, nChunks ),
+                            [slotToRow, chunkOffsets, columns, pattern, numRows] ( INDEX_TYPE const chunk )
+      {
+        INDEX_TYPE const offset = chunkOffsets[ chunk ];
+        INDEX_TYPE const width = ( chunkOffsets[ chunk + 1 ] - offset ) / CHUNK_SIZE;
+        for( INDEX_TYPE lane = 0; lane < CHUNK_SIZE; ++lane )
+        {
+          INDEX_TYPE const row = slotToRow[ chunk * CHUNK_SIZE + lane ];
+          INDEX_TYPE const nnz = ( row < numRows ) ? pattern.numNonZeros( row ) : 0;
+          COL_TYPE const * const rowColumns = ( row < numRows ) ? pattern.getColumns( row ).dataIfContiguous() : nullptr;
+          COL_TYPE const padColumn = ( nnz > 0 ) ? rowColumns[ nnz - 1 ] : 0;
+
+          for( INDEX_TYPE j = 0; j < width; ++j )
+          { columns[ offset + j * CHUNK_SIZE + lane ] = ( j < nnz ) ? rowColumns[ j ] : padColumn; }
+        }
+      } );
+  }
+
+  /**
+   * @tparam POLICY The RAJA policy to use.
+   * @brief Copy the values of @p matrix into this matrix without modifying the structure.
+   * @param matrix The source matrix, it must have the same sparsity pattern that this matrix was built from.
+   * @note The padding entries are left untouched and so remain zero.
+   */
+  template< typename POLICY >
+  void setValuesFrom( CRSMatrixViewConst const & matrix )
+  {
+    LVARRAY_ERROR_IF_NE( matrix.numRows(), m_numRows );
+    LVARRAY_ERROR_IF_NE( matrix.numColumns(), m_numCols );
+
+    ArrayView1d< INDEX_TYPE const > const rowToSlot = m_rowToSlot.toViewConst();
+    ArrayView1d< INDEX_TYPE const > const chunkOffsets = m_chunkOffsets.toViewConst();
+    ArrayView1d< COL_TYPE const > const columns = m_columns.toViewConst();
+    ArrayView1d< T > const entries = m_entries.toView();
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, m_numRows ),
+                            [matrix, rowToSlot, chunkOffsets, columns, entries] LVARRAY_HOST_DEVICE ( INDEX_TYPE const row )
+      {
+        INDEX_TYPE const slot = rowToSlot[ row ];
+        INDEX_TYPE const chunk = slot / CHUNK_SIZE;
+        INDEX_TYPE const offset = chunkOffsets[ chunk ] + slot - chunk * CHUNK_SIZE;
+
+        INDEX_TYPE const nnz = matrix.numNonZeros( row );
+        LVARRAY_ASSERT_GE( ( chunkOffsets[ chunk + 1 ] - chunkOffsets[ chunk ] ) / CHUNK_SIZE, nnz );
+
+        T const * const rowEntries = matrix.getEntries( row );
+        for( INDEX_TYPE j = 0; j < nnz; ++j )
+        {
+          LVARRAY_ASSERT_EQ( columns[ offset + j * CHUNK_SIZE ], matrix.getColumns( row )[ j ] );
+          entries[ offset + j * CHUNK_SIZE ] = rowEntries[ j ];
+        }
+      } );
+  }
+
+  ///@}
+
+  /**
+   * @name Attribute querying methods
+   */
+  ///@{
+
+  /**
+   * @return The number of rows in the matrix.
+   */
+  INDEX_TYPE numRows() const
+  { return m_numRows; }
+
+  /**
+   * @return The number of columns in the matrix.
+   */
+  INDEX_TYPE numColumns() const
+  { return m_numCols; }
+
+  /**
+   * @return The number of chunks.
+   */
+  INDEX_TYPE numChunks() const
+  { return m_chunkOffsets.size() == 0 ? 0 : m_chunkOffsets.size() - 1; }
+
+  /**
+   * @return The width of the given chunk, this is the length of the longest row in the chunk.
+   * @param chunk The chunk to query.
+   */
+  INDEX_TYPE chunkWidth( INDEX_TYPE const chunk ) const
+  { return ( m_chunkOffsets[ chunk + 1 ] - m_chunkOffsets[ chunk ] ) / CHUNK_SIZE; }
+
+  /**
+   * @return The number of entries stored including the padding.
+   */
+  INDEX_TYPE numStoredEntries() const
+  { return m_columns.size(); }
+
+  /**
+   * @return The size of the windows the rows are sorted in.
+   */
+  INDEX_TYPE sigma() const
+  { return m_sigma; }
+
+  ///@}
+
+  /**
+   * @name Methods that provide access to the data
+   */
+  ///@{
+
+  /**
+   * @return A view of the permutation from the storage order to the rows of the matrix.
+   *   Entry @c s is the row stored in lane @c s % CHUNK_SIZE of chunk @c s / CHUNK_SIZE,
+   *   padding slots are assigned the row numRows().
+   */
+  ArrayView1d< INDEX_TYPE const > getSlotToRow() const
+  { return m_slotToRow.toViewConst(); }
+
+  /**
+   * @return A view of the permutation from the rows of the matrix to the storage order.
+   */
+  ArrayView1d< INDEX_TYPE const > getRowToSlot() const
+  { return m_rowToSlot.toViewConst(); }
+
+  ///@}
+
+  /**
+   * @name Computation methods
+   */
+  ///@{
+
+  /**
+   * @tparam POLICY The RAJA policy to use.
+   * @brief Compute @code y = A x @endcode.
+   * @param x The vector to multiply, of length numColumns().
+   * @param y The result, of length numRows().
+   * @details Each chunk is processed by a single iteration of the kernel. The inner loop is over
+   *   the @p CHUNK_SIZE lanes of the chunk which are contiguous in memory and independent so it
+   *   vectorizes into SIMD loads of the entries and columns and a gather from @p x.
+   */
+  template< typename POLICY >
+  void multiply( ArrayView1d< T const > const & x, ArrayView1d< T > const & y ) const
+  {
+    LVARRAY_ERROR_IF_NE( x.size(), m_numCols );
+    LVARRAY_ERROR_IF_NE( y.size(), m_numRows );
+
+    INDEX_TYPE const numRows = m_numRows;
+    ArrayView1d< INDEX_TYPE const > const slotToRow = m_slotToRow.toViewConst();
+    ArrayView1d< INDEX_TYPE const > const chunkOffsets = m_chunkOffsets.toViewConst();
+    ArrayView1d< COL_TYPE const > const columns = m_columns.toViewConst();
+    ArrayView1d< T const > const entries = m_entries.toViewConst();
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numChunks() ),
+                            [x, y, slotToRow, chunkOffsets, columns, entries, numRows] LVARRAY_HOST_DEVICE ( INDEX_TYPE const chunk )
+      {
+        INDEX_TYPE const offset = chunkOffsets[ chunk ];
+        INDEX_TYPE const width = ( chunkOffsets[ chunk + 1 ] - offset ) / CHUNK_SIZE;
+        COL_TYPE const * const LVARRAY_RESTRICT chunkColumns = columns.data() + offset;
+        T const * const LVARRAY_RESTRICT chunkEntries = entries.data() + offset;
+        T const * const LVARRAY_RESTRICT xData = x.data();
+
+        T sums[ CHUNK_SIZE ];
+        for( int lane = 0; lane < CHUNK_SIZE; ++lane )
+        { sums[ lane ] = 0; }
+
+        for( INDEX_TYPE j = 0; j < width; ++j )
+        {
+          for( int lane = 0; lane < CHUNK_SIZE; ++lane )
+          { sums[ lane ] += chunkEntries[ j * CHUNK_SIZE + lane ] * xData[ chunkColumns[ j * CHUNK_SIZE + lane ] ]; }
+        }
+
+        for( int lane = 0; lane < CHUNK_SIZE; ++lane )
+        {
+          INDEX_TYPE const row = slotToRow[ chunk * CHUNK_SIZE + lane ];
+          if( row < numRows )
+          { y[ row ] = sums[ lane ]; }
+        }
+      } );
+  }
+
+  ///@}
+
+  /**
+   * @name Methods dealing with memory spaces
+   */
+  ///@{
+
+  /**
+   * @brief Move the matrix to the given memory space.
+   * @param space The memory space to move to.
+   * @param touch If true touch the entries in the new space.
+   * @note The structure of the matrix is read only and so is never touched.
+   */
+  void move( MemorySpace const space, bool const touch=true ) const
+  {
+    m_slotToRow.move( space, false );
+    m_rowToSlot.move( space, false );
+    m_chunkOffsets.move( space, false );
+    m_columns.move( space, false );
+    m_entries.move( space, touch );
+  }
+
+  ///@}
+
+  /**
+   * @brief Set the name associated with this SlicedEllMatrix which is used in the chai callback.
+   * @param name the of the SlicedEllMatrix.
+   */
+  void setName( std::string const & name )
+  {
+    m_slotToRow.setName( name + "/slotToRow" );
+    m_rowToSlot.setName( name + "/rowToSlot" );
+    m_chunkOffsets.setName( name + "/chunkOffsets" );
+    m_columns.setName( name + "/columns" );
+    m_entries.setName( name + "/entries" );
+  }
+
+private:
+
+  /// The type of the one dimensional arrays.
+  template< typename U >
+  using Array1d = Array< U, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE >;
+
+  /// The number of rows in the matrix.
+  INDEX_TYPE m_numRows = 0;
+
+  /// The number of columns in the matrix.
+  INDEX_TYPE m_numCols = 0;
+
+  /// The size of the windows the rows are sorted in.
+  INDEX_TYPE m_sigma = 1;
+
+  /// The row stored in each slot, of length numChunks() * CHUNK_SIZE.
+  Array1d< INDEX_TYPE > m_slotToRow;
+
+  /// The slot each row is stored in, of length numRows().
+  Array1d< INDEX_TYPE > m_rowToSlot;
+
+  /// The offset of each chunk into m_columns and m_entries, of length numChunks() + 1.
+  Array1d< INDEX_TYPE > m_chunkOffsets;
+
+  /// The columns of each chunk, stored column major within the chunk.
+  Array1d< COL_TYPE > m_columns;
+
+  /// The entries of each chunk, stored column major within the chunk.
+  Array1d< T > m_entries;
+};
+
+} // namespace LvArray
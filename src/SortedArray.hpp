@@ -291,6 +291,51 @@ public:
     return nRemoved;
   }
 
+  /**
+   * @brief Replace the values in the array with the intersection of @p a and @p b.
+   * @param a The first set, it may be a view of this SortedArray.
+   * @param b The second set, it may be a view of this SortedArray.
+   */
+  void setToIntersection( SortedArrayView< T const, INDEX_TYPE, BUFFER_TYPE > const & a,
+                          SortedArrayView< T const, INDEX_TYPE, BUFFER_TYPE > const & b )
+  {
+    setFrom( a, b, a.size() < b.size() ? a.size() : b.size(),
+             [] ( T const * const first, INDEX_TYPE const firstSize,
+                  T const * const second, INDEX_TYPE const secondSize,
+                  T * const output )
+    { return sortedArrayManipulation::setIntersection( first, firstSize, second, secondSize, output ); } );
+  }
+
+  /**
+   * @brief Replace the values in the array with the union of @p a and @p b.
+   * @param a The first set, it may be a view of this SortedArray.
+   * @param b The second set, it may be a view of this SortedArray.
+   */
+  void setToUnion( SortedArrayView< T const, INDEX_TYPE, BUFFER_TYPE > const & a,
+                   SortedArrayView< T const, INDEX_TYPE, BUFFER_TYPE > const & b )
+  {
+    setFrom( a, b, a.size() + b.size(),
+             [] ( T const * const first, INDEX_TYPE const firstSize,
+                  T const * const second, INDEX_TYPE const secondSize,
+                  T * const output )
+    { return sortedArrayManipulation::setUnion( first, firstSize, second, secondSize, output ); } );
+  }
+
+  /**
+   * @brief Replace the values in the array with the values of @p a that aren't in @p b.
+   * @param a The first set, it may be a view of this SortedArray.
+   * @param b The second set, it may be a view of this SortedArray.
+   */
+  void setToDifference( SortedArrayView< T const, INDEX_TYPE, BUFFER_TYPE > const & a,
+                        SortedArrayView< T const, INDEX_TYPE, BUFFER_TYPE > const & b )
+  {
+    setFrom( a, b, a.size(),
+             [] ( T const * const first, INDEX_TYPE const firstSize,
+                  T const * const second, INDEX_TYPE const secondSize,
+                  T * const output )
+    { return sortedArrayManipulation::setDifference( first, firstSize, second, secondSize, output ); } );
+  }
+
   ///@}
 
   /**
@@ -344,6 +389,34 @@ public:
 
 private:
 
+  /**
+   * @tparam FILL The type of @p fill.
+   * @brief Replace the values in the array with the result of a set operation on @p a and @p b.
+   * @param a The first set.
+   * @param b The second set.
+   * @param maxSize An upper bound on the size of the result.
+   * @param fill Constructs the result in uninitialized memory and returns its size.
+   */
+  template< typename FILL >
+  void setFrom( SortedArrayView< T const, INDEX_TYPE, BUFFER_TYPE > const & a,
+                SortedArrayView< T const, INDEX_TYPE, BUFFER_TYPE > const & b,
+                INDEX_TYPE const maxSize,
+                FILL && fill )
+  {
+    // If either input is this array the result is built separately and then copied in.
+    if( a.data() == data() || b.data() == data() )
+    {
+      SortedArray result;
+      result.setFrom( a, b, maxSize, fill );
+      *this = result;
+      return;
+    }
+
+    clear();
+    reserve( maxSize );
+    this->m_size = fill( a.data(), a.size(), b.data(), b.size(), this->m_values.data() );
+  }
+
   /**
    * @class CallBacks
    * @brief This class provides the callbacks for the sortedArrayManipulation sorted routines.
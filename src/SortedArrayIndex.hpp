@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC and LvArray contributors.
+ * All rights reserved.
+ * See the LICENSE file for details.
+ * SPDX-License-Identifier: (BSD-3-Clause)
+ */
+
+/**
+ * @file SortedArrayIndex.hpp
+ * @brief Contains the implementation of LvArray::SortedArrayIndex and LvArray::SortedArrayIndexView.
+ */
+
+#pragma once
+
+// Source includes
+#include "SortedArrayView.hpp"
+#include "Array.hpp"
+
+namespace LvArray
+{
+
+/**
+ * @tparam T The type of the values.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @class SortedArrayIndexView
+ * @brief A read only view of a SortedArrayIndex that can be captured in a kernel.
+ */
+template< typename T,
+          typename INDEX_TYPE,
+          template< typename > class BUFFER_TYPE >
+class SortedArrayIndexView
+{
+public:
+
+  /**
+   * @brief Constructor.
+   * @param values The values in the Eytzinger layout, slot zero is unused.
+   * @param positions The position in the sorted array of the value in each slot, slot zero holds the size.
+   */
+  SortedArrayIndexView( ArrayView< T const, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & values,
+                        ArrayView< INDEX_TYPE const, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & positions ):
+    m_values( values ),
+    m_positions( positions )
+  {}
+
+  /**
+   * @return The number of values.
+   */
+  LVARRAY_HOST_DEVICE inline
+  INDEX_TYPE size() const
+  { return m_values.size() - 1; }
+
+  /**
+   * @return The position in the sorted array of the first value not less than @p value,
+   *   or size() if there is no such value. This is the same as sortedArrayManipulation::find.
+   * @param value The value to find.
+   */
+  LVARRAY_HOST_DEVICE inline
+  INDEX_TYPE find( T const & value ) const
+  { return m_positions[ findSlot( value ) ]; }
+
+  /**
+   * @return True iff @p value is in the array.
+   * @param value The value to search for.
+   */
+  LVARRAY_HOST_DEVICE inline
+  bool contains( T const & value ) const
+  {
+    INDEX_TYPE const slot = findSlot( value );
+    return slot != 0 && m_values[ slot ] == value;
+  }
+
+private:
+
+  /**
+   * @return The number of slots apart the descendants of a slot are that fit in one cache line.
+   */
+  LVARRAY_HOST_DEVICE static constexpr inline
+  INDEX_TYPE prefetchStride()
+  {
+    INDEX_TYPE stride = 2;
+    while( 2 * stride * INDEX_TYPE( sizeof( T ) ) <= 64 )
+    { stride *= 2; }
+
+    return stride;
+  }
+
+  /**
+   * @return The slot of the first value not less than @p value, or zero if there is no such value.
+   * @param value The value to find.
+   */
+  LVARRAY_HOST_DEVICE inline
+  INDEX_TYPE findSlot( T const & value ) const
+  {
+    T const * const values = m_values.data();
+    std::ptrdiff_t const n = size();
+
+    // The children of slot k are slots 2k and 2k + 1, the descendants a few levels down
+    // are contiguous so they can be prefetched long before they are needed. The slots are
+    // computed in std::ptrdiff_t since they run past n, which can overflow INDEX_TYPE.
+    std::ptrdiff_t k = 1;
+    while( k <= n )
+    {
+      std::ptrdiff_t const prefetch = k * prefetchStride();
+      if( prefetch <= n )
+      { LVARRAY_PREFETCH( values + prefetch ); }
+
+      k = 2 * k + ( values[ k ] < value );
+    }
+
+    // The search went right once for each trailing one of k after last going left at the answer.
+#if defined(__CUDA_ARCH__)
+    return static_cast< INDEX_TYPE >( k >> __ffsll( static_cast< long long >( ~k ) ) );
+#else
+    return static_cast< INDEX_TYPE >( k >> __builtin_ffsll( static_cast< long long >( ~k ) ) );
+#endif
+  }
+
+  /// The values in the Eytzinger layout.
+  ArrayView< T const, 1, 0, INDEX_TYPE, BUFFER_TYPE > m_values;
+
+  /// The position in the sorted array of the value in each slot.
+  ArrayView< INDEX_TYPE const, 1, 0, INDEX_TYPE, BUFFER_TYPE > m_positions;
+};
+
+/**
+ * @tparam T The type of the values.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @class SortedArrayIndex
+ * @brief A read only copy of a SortedArray in a layout that is faster to search.
+ * @details The values are stored in the Eytzinger layout, the breadth first order of the implicit
+ *   binary search tree, with the children of slot @c k in slots @c 2k and @c 2k+1. The first levels
+ *   of the tree share a few cache lines and the slots visited a few levels further down are
+ *   contiguous, so they can be prefetched. This only pays off for arrays much larger than the last
+ *   level cache, for smaller arrays sortedArrayManipulation::find on the sorted values is as fast or faster.
+ *   The index is a snapshot, after the SortedArray is modified it must be rebuilt with setFrom.
+ *   @code
+ *   SortedArrayIndex< int, int, MallocBuffer > const index( globalIDs.toViewConst() );
+ *   SortedArrayIndexView< int, int, MallocBuffer > const globalToLocal = index.toViewConst();
+ *   forall< POLICY >( n, [=] ( int const i )
+ *   { localIDs[ i ] = globalToLocal.find( queries[ i ] ); } );
+ *   @endcode
+ */
+template< typename T,
+          typename INDEX_TYPE,
+          template< typename > class BUFFER_TYPE >
+class SortedArrayIndex
+{
+public:
+
+  /// The type of the view.
+  using ViewTypeConst = SortedArrayIndexView< T, INDEX_TYPE, BUFFER_TYPE >;
+
+  /**
+   * @brief Default constructor, creates an empty index.
+   */
+  SortedArrayIndex():
+    m_values( 1 ),
+    m_positions( 1 )
+  {}
+
+  /**
+   * @brief Constructor.
+   * @param sorted The sorted values to index.
+   */
+  explicit SortedArrayIndex( SortedArrayView< T const, INDEX_TYPE, BUFFER_TYPE > const & sorted ):
+    SortedArrayIndex()
+  { setFrom( sorted ); }
+
+  /**
+   * @brief Rebuild the index from @p sorted.
+   * @param sorted The sorted values to index.
+   */
+  void setFrom( SortedArrayView< T const, INDEX_TYPE, BUFFER_TYPE > const & sorted )
+  {
+    sorted.move( MemorySpace::host, false );
+    m_values.move( MemorySpace::host );
+    m_positions.move( MemorySpace::host );
+
+    INDEX_TYPE const n = sorted.size();
+    m_values.resize( n + 1 );
+    m_positions.resize( n + 1 );
+    m_positions[ 0 ] = n;
+
+    // Visit the slots in sorted order, an in order traversal of the implicit tree.
+    INDEX_TYPE k = 1;
+    while( 2 * k <= n )
+    { k *= 2; }
+
+    for( INDEX_TYPE i = 0; i < n; ++i )
+    {
+      m_values[ k ] = sorted[ i ];
+      m_positions[ k ] = i;
+
+      if( 2 * k + 1 <= n )
+      {
+        k = 2 * k + 1;
+        while( 2 * k <= n )
+        { k *= 2; }
+      }
+      else
+      {
+        while( k & 1 )
+        { k /= 2; }
+
+        k /= 2;
+      }
+    }
+  }
+
+  /**
+   * @return The number of values.
+   */
+  INDEX_TYPE size() const
+  { return m_values.size() - 1; }
+
+  /**
+   * @return A view of the index.
+   */
+  ViewTypeConst toViewConst() const &
+  { return ViewTypeConst( m_values.toViewConst(), m_positions.toViewConst() ); }
+
+  /**
+   * @brief Overload for rvalues that is deleted.
+   * @return A null SortedArrayIndexView.
+   * @note This cannot be called on a rvalue since the view would contain
+   *   the buffers of the index that is about to be destroyed.
+   */
+  ViewTypeConst toViewConst() const && = delete;
+
+  /**
+   * @brief Move the index to the given memory space, the values are never touched.
+   * @param space The memory space to move to.
+   */
+  void move( MemorySpace const space ) const
+  {
+    m_values.move( space, false );
+    m_positions.move( space, false );
+  }
+
+private:
+
+  /// The values in the Eytzinger layout, slot zero is unused.
+  Array< T, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > m_values;
+
+  /// The position in the sorted array of the value in each slot, slot zero holds the size.
+  Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > m_positions;
+};
+
+} // namespace LvArray
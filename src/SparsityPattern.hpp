@@ -13,6 +13,8 @@
 #pragma once
 
 #include "SparsityPatternView.hpp"
+#include "ArrayOfArrays.hpp"
+#include "Array.hpp"
 
 namespace LvArray
 {
@@ -22,20 +24,24 @@ namespace LvArray
  * @brief This class implements a compressed row storage sparsity pattern.
  * @tparam COL_TYPE the integer used to enumerate the columns.
  * @tparam INDEX_TYPE the integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @tparam OFFSET_TYPE the integer used for the offsets, it may be wider than INDEX_TYPE.
  */
 template< typename COL_TYPE,
           typename INDEX_TYPE,
-          template< typename > class BUFFER_TYPE >
-class SparsityPattern : protected SparsityPatternView< COL_TYPE, INDEX_TYPE, BUFFER_TYPE >
+          template< typename > class BUFFER_TYPE,
+          typename OFFSET_TYPE=INDEX_TYPE >
+class SparsityPattern : protected SparsityPatternView< COL_TYPE, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE >
 {
 
   /// An alias for the parent class.
-  using ParentClass = SparsityPatternView< COL_TYPE, INDEX_TYPE, BUFFER_TYPE >;
+  using ParentClass = SparsityPatternView< COL_TYPE, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE >;
 
 public:
 
   using typename ParentClass::ColType;
   using typename ParentClass::IndexType;
+  using typename ParentClass::OffsetType;
 
   /**
    * @name Constructors and the destructor.
@@ -137,6 +143,129 @@ public:
     ParentClass::template resizeFromCapacities< POLICY >( nRows, rowCapacities );
   }
 
+  /**
+   * @tparam POLICY a RAJA execution policy to use when sorting/removing duplicates in the rows.
+   * @brief Steal the resources from an ArrayOfArrays and convert it to a SparsityPattern.
+   * @param src the ArrayOfArrays to convert, array @c i holds the columns of row @c i.
+   * @param nCols The number of columns of the new sparsity pattern.
+   * @param desc describes the type of data in the source.
+   * @details This allows a pattern with many repeated entries to be built without searching
+   *   the rows on every insertion. The columns are appended to the arrays of @p src, for example in
+   *   parallel with ArrayOfArraysView::emplaceBackAtomic, and each row is then sorted and made
+   *   unique once here. The capacity of the rows is unchanged.
+   */
+  template< typename POLICY >
+  void assimilate( ArrayOfArrays< COL_TYPE, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE > && src,
+                   INDEX_TYPE const nCols,
+                   sortedArrayManipulation::Description const desc )
+  {
+    LVARRAY_ERROR_IF( !arrayManipulation::isPositive( nCols ), "nCols must be positive." );
+    LVARRAY_ERROR_IF( nCols - 1 > std::numeric_limits< COL_TYPE >::max(),
+                      "COL_TYPE must be able to hold the range of columns: [0, " << nCols - 1 << "]." );
+
+    using ArrayOfSetsViewType = ArrayOfSetsView< COL_TYPE, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE >;
+
+    ParentClass::free();
+    ArrayOfSetsViewType::assimilate( reinterpret_cast< ArrayOfSetsViewType && >( src ) );
+    this->m_numCols = nCols;
+    ArrayOfSetsViewType::template makeSetsSortedUnique< POLICY >( desc );
+  }
+
+  /**
+   * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+   * @tparam NODE_TYPE The type of the values in @p elemToNode.
+   * @tparam USD The unit stride dimension of @p elemToNode.
+   * @tparam ELEM_TYPE The type of the values in @p nodeToElem.
+   * @brief Clears the sparsity pattern and creates the pattern of a finite element matrix
+   *   with @p dofsPerNode degrees of freedom on each node.
+   * @param elemToNode The element to node map, row @c e holds the nodes of element @c e.
+   * @param nodeToElem The node to element map, array @c n holds the elements containing node @c n.
+   * @param dofsPerNode The number of degrees of freedom on each node.
+   * @details Row @code dofsPerNode * n + i @endcode is coupled to column @code dofsPerNode * m + j @endcode
+   *   if nodes @c n and @c m share an element. The neighbors of each node are gathered into a scratch
+   *   buffer bounded by the number of nodes in its elements, sorted and made unique, which gives the exact
+   *   length of every row. The pattern is then allocated once and each row is written already sorted,
+   *   so the result is compressed and independent of the policy.
+   */
+  template< typename POLICY, typename NODE_TYPE, int USD, typename ELEM_TYPE >
+  void fromConnectivity( ArrayView< NODE_TYPE const, 2, USD, INDEX_TYPE, BUFFER_TYPE > const & elemToNode,
+                         ArrayOfArraysView< ELEM_TYPE const, INDEX_TYPE const, true, BUFFER_TYPE > const & nodeToElem,
+                         INDEX_TYPE const dofsPerNode )
+  {
+    LVARRAY_ERROR_IF_LE_MSG( dofsPerNode, 0, "dofsPerNode must be positive." );
+
+    INDEX_TYPE const numNodes = nodeToElem.size();
+    INDEX_TYPE const numRows = dofsPerNode * numNodes;
+    INDEX_TYPE const nodesPerElem = elemToNode.size( 1 );
+
+    // Bound the number of neighbors of each node by the number of nodes in its elements.
+    Array< OFFSET_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > scratchOffsets( numNodes + 1 );
+    ArrayView< OFFSET_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const scratchOffsetsView = scratchOffsets.toView();
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numNodes ),
+                            [nodeToElem, nodesPerElem, scratchOffsetsView] ( INDEX_TYPE const node )
+      { scratchOffsetsView[ node + 1 ] = OFFSET_TYPE( nodesPerElem ) * nodeToElem.sizeOfArray( node ); } );
+
+    RAJA::inclusive_scan_inplace< POLICY >( RAJA::make_span< OFFSET_TYPE * >( scratchOffsets.data() + 1, numNodes ) );
+
+    // Gather the neighbors of each node and use them to compute the exact row capacities.
+    Array< COL_TYPE, 1, RAJA::PERM_I, OFFSET_TYPE, BUFFER_TYPE > neighbors;
+    neighbors.resizeWithoutInitializationOrDestruction( scratchOffsets[ numNodes ] );
+    ArrayView< COL_TYPE, 1, 0, OFFSET_TYPE, BUFFER_TYPE > const neighborsView = neighbors.toView();
+
+    Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > numNeighbors;
+    numNeighbors.resizeWithoutInitializationOrDestruction( numNodes );
+    ArrayView< INDEX_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const numNeighborsView = numNeighbors.toView();
+
+    Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > rowCapacities;
+    rowCapacities.resizeWithoutInitializationOrDestruction( numRows );
+    ArrayView< INDEX_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const rowCapacitiesView = rowCapacities.toView();
+
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numNodes ),
+                            [elemToNode, nodeToElem, nodesPerElem, dofsPerNode, scratchOffsetsView,
+                             neighborsView, numNeighborsView, rowCapacitiesView] ( INDEX_TYPE const node )
+      {
+        COL_TYPE * const nodeNeighbors = neighborsView.data() + scratchOffsetsView[ node ];
+        INDEX_TYPE count = 0;
+        for( INDEX_TYPE i = 0; i < nodeToElem.sizeOfArray( node ); ++i )
+        {
+          ELEM_TYPE const elem = nodeToElem( node, i );
+          for( INDEX_TYPE j = 0; j < nodesPerElem; ++j )
+          { nodeNeighbors[ count++ ] = COL_TYPE( elemToNode( elem, j ) ); }
+        }
+
+        count = sortedArrayManipulation::makeSortedUnique( nodeNeighbors, nodeNeighbors + count );
+        numNeighborsView[ node ] = count;
+        for( INDEX_TYPE dof = 0; dof < dofsPerNode; ++dof )
+        { rowCapacitiesView[ dofsPerNode * node + dof ] = dofsPerNode * count; }
+      } );
+
+    resizeFromRowCapacities< POLICY >( numRows, numRows, rowCapacities.data() );
+
+    // Every row has exactly its capacity so the columns are written directly into place.
+    COL_TYPE * const columns = this->m_values.data();
+    OFFSET_TYPE const * const offsets = this->m_offsets.data();
+    INDEX_TYPE * const sizes = this->m_sizes.data();
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numNodes ),
+                            [dofsPerNode, scratchOffsetsView, neighborsView, numNeighborsView,
+                             columns, offsets, sizes] ( INDEX_TYPE const node )
+      {
+        COL_TYPE const * const nodeNeighbors = neighborsView.data() + scratchOffsetsView[ node ];
+        INDEX_TYPE const count = numNeighborsView[ node ];
+        for( INDEX_TYPE dof = 0; dof < dofsPerNode; ++dof )
+        {
+          INDEX_TYPE const row = dofsPerNode * node + dof;
+          COL_TYPE * const rowColumns = columns + offsets[ row ];
+          for( INDEX_TYPE i = 0; i < count; ++i )
+          {
+            for( INDEX_TYPE j = 0; j < dofsPerNode; ++j )
+            { rowColumns[ dofsPerNode * i + j ] = COL_TYPE( dofsPerNode ) * nodeNeighbors[ i ] + COL_TYPE( j ); }
+          }
+
+          sizes[ row ] = dofsPerNode * count;
+        }
+      } );
+  }
+
   ///@}
 
   /**
@@ -151,7 +280,7 @@ public:
    *   IS_VALID_EXPRESSION and this fails with NVCC.
    */
   constexpr inline
-  SparsityPatternView< COL_TYPE, INDEX_TYPE const, BUFFER_TYPE >
+  SparsityPatternView< COL_TYPE, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
   toView() const &
   { return ParentClass::toView(); }
 
@@ -163,7 +292,7 @@ public:
    *   This overload prevents that from happening.
    */
   constexpr inline
-  SparsityPatternView< COL_TYPE, INDEX_TYPE const, BUFFER_TYPE >
+  SparsityPatternView< COL_TYPE, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
   toView() const && = delete;
 
   /**
@@ -173,7 +302,7 @@ public:
    *   IS_VALID_EXPRESSION and this fails with NVCC.
    */
   LVARRAY_HOST_DEVICE constexpr inline
-  SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >
+  SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
   toViewConst() const &
   { return ParentClass::toViewConst(); }
 
@@ -185,7 +314,7 @@ public:
    *   This overload prevents that from happening.
    */
   LVARRAY_HOST_DEVICE constexpr inline
-  SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >
+  SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
   toViewConst() const && = delete;
 
   ///@}
@@ -273,6 +402,18 @@ public:
   void compress()
   { ParentClass::compress(); }
 
+  /**
+   * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+   * @brief Compress the SparsityPattern in parallel so that the non-zeros of each row
+   *        are contiguous with no extra capacity in between, see ArrayOfArraysView::compressParallel.
+   * @param outOfPlace If true the columns are moved into a new allocation of exactly the compressed size
+   *   and the old one is freed, this temporarily needs memory for a second copy of the columns.
+   *   Otherwise they are moved in place and no memory is freed.
+   */
+  template< typename POLICY >
+  void compress( bool const outOfPlace=false )
+  { ParentClass::template compressParallel< POLICY >( outOfPlace ); }
+
   ///@}
 
   /**
@@ -301,7 +442,7 @@ public:
   inline
   void appendRow( INDEX_TYPE const nzCapacity=0 )
   {
-    INDEX_TYPE const maxOffset = this->m_offsets[ this->m_numArrays ];
+    OFFSET_TYPE const maxOffset = this->m_offsets[ this->m_numArrays ];
     bufferManipulation::emplaceBack( this->m_offsets, this->m_numArrays + 1, maxOffset );
     bufferManipulation::emplaceBack( this->m_sizes, this->m_numArrays, 0 );
     ++this->m_numArrays;
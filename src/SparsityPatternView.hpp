@@ -48,6 +48,8 @@ namespace LvArray
  * @brief This class provides a view into a compressed row storage sparsity pattern.
  * @tparam COL_TYPE the integer used to enumerate the columns.
  * @tparam INDEX_TYPE the integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @tparam OFFSET_TYPE the integer used for the offsets, it may be wider than INDEX_TYPE.
  *
  * When INDEX_TYPE is const m_offsets is not copied between memory spaces. INDEX_TYPE should always be const
  * since SparsityPatternView is not allowed to modify the offsets.
@@ -57,18 +59,21 @@ namespace LvArray
  */
 template< typename COL_TYPE,
           typename INDEX_TYPE,
-          template< typename > class BUFFER_TYPE >
-class SparsityPatternView : protected ArrayOfSetsView< COL_TYPE, INDEX_TYPE, BUFFER_TYPE >
+          template< typename > class BUFFER_TYPE,
+          typename OFFSET_TYPE=std::remove_const_t< INDEX_TYPE > >
+class SparsityPatternView : protected ArrayOfSetsView< COL_TYPE, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE >
 {
 protected:
   /// An alias for the parent class.
-  using ParentClass = ArrayOfSetsView< COL_TYPE, INDEX_TYPE, BUFFER_TYPE >;
+  using ParentClass = ArrayOfSetsView< COL_TYPE, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE >;
 
   /// An alias for the non const index type.
   using typename ParentClass::INDEX_TYPE_NC;
 
   using typename ParentClass::SIZE_TYPE;
 
+  using typename ParentClass::OFFSETS_TYPE;
+
 public:
   static_assert( std::is_integral< COL_TYPE >::value, "COL_TYPE must be integral." );
   static_assert( std::is_integral< INDEX_TYPE >::value, "INDEX_TYPE must be integral." );
@@ -76,6 +81,7 @@ public:
   /// The integer type used to enumerate the columns.
   using ColType = COL_TYPE;
   using typename ParentClass::IndexType;
+  using typename ParentClass::OffsetType;
 
   /**
    * @name Constructors, destructor and assignment operators
@@ -116,7 +122,7 @@ public:
   LVARRAY_HOST_DEVICE constexpr inline
   SparsityPatternView( INDEX_TYPE const nRows,
                        INDEX_TYPE const nCols,
-                       BUFFER_TYPE< INDEX_TYPE > const & offsets,
+                       BUFFER_TYPE< OFFSETS_TYPE > const & offsets,
                        BUFFER_TYPE< SIZE_TYPE > const & nnz,
                        BUFFER_TYPE< COL_TYPE > const & columns ):
     ParentClass( nRows, offsets, nnz, columns ),
@@ -156,28 +162,28 @@ public:
    * @return A new SparsityPatternView< COL_TYPE, INDEX_TYPE const >.
    */
   LVARRAY_HOST_DEVICE constexpr inline
-  SparsityPatternView< COL_TYPE, INDEX_TYPE const, BUFFER_TYPE >
+  SparsityPatternView< COL_TYPE, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
   toView() const
   {
-    return SparsityPatternView< COL_TYPE, INDEX_TYPE const, BUFFER_TYPE >( numRows(),
-                                                                           numColumns(),
-                                                                           this->m_offsets,
-                                                                           this->m_sizes,
-                                                                           this->m_values );
+    return SparsityPatternView< COL_TYPE, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >( numRows(),
+                                                                                        numColumns(),
+                                                                                        this->m_offsets,
+                                                                                        this->m_sizes,
+                                                                                        this->m_values );
   }
 
   /**
    * @return A new SparsityPatternView< COL_TYPE const, INDEX_TYPE const >.
    */
   LVARRAY_HOST_DEVICE constexpr inline
-  SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >
+  SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >
   toViewConst() const
   {
-    return SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE >( numRows(),
-                                                                                 numColumns(),
-                                                                                 this->m_offsets,
-                                                                                 this->m_sizes,
-                                                                                 this->m_values );
+    return SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE >( numRows(),
+                                                                                              numColumns(),
+                                                                                              this->m_offsets,
+                                                                                              this->m_sizes,
+                                                                                              this->m_values );
   }
 
   ///@}
@@ -205,9 +211,9 @@ public:
    * @return Return the total number of non zero entries in the matrix.
    */
   LVARRAY_HOST_DEVICE inline
-  INDEX_TYPE_NC numNonZeros() const
+  OFFSET_TYPE numNonZeros() const
   {
-    INDEX_TYPE_NC nnz = 0;
+    OFFSET_TYPE nnz = 0;
     for( INDEX_TYPE_NC row = 0; row < numRows(); ++row )
     {
       nnz += numNonZeros( row );
@@ -228,7 +234,7 @@ public:
    * @return Return the total number of non zero entries able to be stored without a reallocation.
    */
   LVARRAY_HOST_DEVICE constexpr inline
-  INDEX_TYPE_NC nonZeroCapacity() const
+  OFFSET_TYPE nonZeroCapacity() const
   { return ParentClass::valueCapacity(); }
 
   /**
@@ -283,7 +289,7 @@ public:
    * @return Return a pointer to the array of offsets, this array has length numRows() + 1.
    */
   LVARRAY_HOST_DEVICE constexpr inline
-  INDEX_TYPE const * getOffsets() const
+  OFFSET_TYPE const * getOffsets() const
   { return this->m_offsets.data(); }
 
   /**
@@ -142,9 +142,9 @@ std::ostream & operator<< ( std::ostream & stream,
  * @param view The ArrayOfArraysView to output.
  * @return @p stream .
  */
-template< typename T, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+template< typename T, typename INDEX_TYPE, template< typename > class BUFFER_TYPE, typename OFFSET_TYPE >
 std::ostream & operator<< ( std::ostream & stream,
-                            ArrayOfArraysView< T const, INDEX_TYPE const, true, BUFFER_TYPE > const & view )
+                            ArrayOfArraysView< T const, INDEX_TYPE const, true, BUFFER_TYPE, OFFSET_TYPE > const & view )
 {
   stream << "{" << std::endl;
 
@@ -171,9 +171,9 @@ std::ostream & operator<< ( std::ostream & stream,
  * @param array The ArrayOfArrays to output.
  * @return @p stream .
  */
-template< typename T, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+template< typename T, typename INDEX_TYPE, template< typename > class BUFFER_TYPE, typename OFFSET_TYPE >
 std::ostream & operator<< ( std::ostream & stream,
-                            ArrayOfArrays< T, INDEX_TYPE, BUFFER_TYPE > const & array )
+                            ArrayOfArrays< T, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE > const & array )
 { return stream << array.toViewConst(); }
 
 /**
@@ -184,8 +184,9 @@ std::ostream & operator<< ( std::ostream & stream,
  * @param view The ArrayOfArraysView to output.
  * @return @p stream .
  */
-template< typename T, typename COL_TYPE, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
-std::ostream & operator<< ( std::ostream & stream, CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const & view )
+template< typename T, typename COL_TYPE, typename INDEX_TYPE, template< typename > class BUFFER_TYPE, typename OFFSET_TYPE >
+std::ostream & operator<< ( std::ostream & stream,
+                            CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE > const & view )
 {
   stream << "{" << std::endl;
 
@@ -208,10 +209,16 @@ std::ostream & operator<< ( std::ostream & stream, CRSMatrixView< T const, COL_T
  * @tparam T The column type in @p view.
  * @tparam T The index type in @p view.
  * @tparam BUFFER_TYPE The type of buffer used by @p view.
+ * @tparam OFFSET_TYPE The offset type in @p view.
  * @param view The matrix view object to print.
  */
-template< typename POLICY, typename T, typename COL_TYPE, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
-void print( CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const & view )
+template< typename POLICY,
+          typename T,
+          typename COL_TYPE,
+          typename INDEX_TYPE,
+          template< typename > class BUFFER_TYPE,
+          typename OFFSET_TYPE >
+void print( CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE, OFFSET_TYPE > const & view )
 {
   INDEX_TYPE const numRows = view.numRows();
 
@@ -219,7 +226,7 @@ void print( CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYP
   RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, 1 ), [=] LVARRAY_HOST_DEVICE ( INDEX_TYPE const )
     {
       INDEX_TYPE const * const ncols = view.getSizes();
-      INDEX_TYPE const * const row_indexes = view.getOffsets();
+      OFFSET_TYPE const * const row_indexes = view.getOffsets();
       COL_TYPE const * const cols = view.getColumns();
       T const * const values = view.getEntries();
 
@@ -22,6 +22,25 @@
 // System includes
 #include <cstdlib>      // for std::malloc and std::free.
 #include <algorithm>    // for std::sort
+#include <type_traits>
+
+/**
+ * @brief The set operations in sortedArrayManipulation gallop through the larger array instead of
+ *   merging when it is at least this many times larger than the smaller one.
+ * @note This can be overridden at compile time.
+ */
+#if !defined(LVARRAY_SET_GALLOP_RATIO)
+  #define LVARRAY_SET_GALLOP_RATIO 4
+#endif
+
+/**
+ * @brief While the range left to search is at least this long sortedArrayManipulation::find prefetches
+ *   both of the possible next midpoints. Below it the range is likely already in cache.
+ * @note This can be overridden at compile time.
+ */
+#if !defined(LVARRAY_FIND_PREFETCH_MIN_SIZE)
+  #define LVARRAY_FIND_PREFETCH_MIN_SIZE 1024
+#endif
 
 namespace LvArray
 {
@@ -223,6 +242,70 @@ LVARRAY_HOST_DEVICE inline void makeSorted( RandomAccessIterator const first,
 #endif
 }
 
+/**
+ * @tparam T The type of the values to sort, must be an integral type other than bool.
+ * @brief Sort the given values in ascending order using a least significant digit radix sort.
+ * @param values A pointer to the values to sort.
+ * @param size The number of values.
+ * @param scratch A pointer to space for at least @p size values, on return it contains garbage.
+ * @details The values are sorted one byte at a time and a byte where every value has the same digit
+ *   is skipped, so values that span a small range take fewer passes. This is faster than makeSorted
+ *   for long arrays but has a fixed cost per pass, so makeSorted is faster for short arrays.
+ * @note This is only available on the host.
+ */
+template< typename T >
+inline void radixSort( T * const LVARRAY_RESTRICT values,
+                       std::ptrdiff_t const size,
+                       T * const LVARRAY_RESTRICT scratch )
+{
+  static_assert( std::is_integral< T >::value && !std::is_same< T, bool >::value,
+                 "radixSort only supports integral types." );
+
+  using UnsignedType = std::make_unsigned_t< T >;
+  constexpr int NUM_DIGITS = sizeof( T );
+
+  // Flipping the sign bit of a signed type gives unsigned values with the same order.
+  constexpr UnsignedType SIGN_BIT = std::is_signed< T >::value ? UnsignedType( UnsignedType( 1 ) << ( 8 * sizeof( T ) - 1 ) ) : 0;
+  auto const getDigit = [] ( T const value, int const digit ) -> int
+  { return ( UnsignedType( UnsignedType( value ) ^ SIGN_BIT ) >> ( 8 * digit ) ) & 0xFF; };
+
+  if( size < 2 )
+  { return; }
+
+  // Count every digit in a single pass.
+  std::ptrdiff_t counts[ NUM_DIGITS ][ 256 ] = {};
+  for( std::ptrdiff_t i = 0; i < size; ++i )
+  {
+    for( int digit = 0; digit < NUM_DIGITS; ++digit )
+    { ++counts[ digit ][ getDigit( values[ i ], digit ) ]; }
+  }
+
+  T * src = values;
+  T * dst = scratch;
+  for( int digit = 0; digit < NUM_DIGITS; ++digit )
+  {
+    std::ptrdiff_t * const digitCounts = counts[ digit ];
+    if( digitCounts[ getDigit( src[ 0 ], digit ) ] == size )
+    { continue; }
+
+    std::ptrdiff_t offset = 0;
+    for( int bucket = 0; bucket < 256; ++bucket )
+    {
+      std::ptrdiff_t const count = digitCounts[ bucket ];
+      digitCounts[ bucket ] = offset;
+      offset += count;
+    }
+
+    for( std::ptrdiff_t i = 0; i < size; ++i )
+    { dst[ digitCounts[ getDigit( src[ i ], digit ) ]++ ] = src[ i ]; }
+
+    std::swap( src, dst );
+  }
+
+  if( src != values )
+  { std::copy( src, src + size, values ); }
+}
+
 /**
  * @tparam RandomAccessIteratorA an iterator type that provides random access.
  * @tparam RandomAccessIteratorB an iterator type that provides random access.
@@ -403,6 +486,9 @@ bool isSortedUnique( ITER first, ITER const last, Compare && comp=Compare() )
  * @param size The size of the array.
  * @param value The value to find.
  * @param comp The comparison method to use.
+ * @details This is a branchless binary search, for large arrays it also prefetches the
+ *   next midpoints, see LVARRAY_FIND_PREFETCH_MIN_SIZE. For many lookups into a read only
+ *   array much larger than the last level cache SortedArrayIndex is faster.
  * @note Should be equivalent to std::lower_bound(ptr, ptr + size, value, comp).
  */
 DISABLE_HD_WARNING
@@ -417,22 +503,27 @@ std::ptrdiff_t find( T const * const LVARRAY_RESTRICT ptr,
   LVARRAY_ASSERT( arrayManipulation::isPositive( size ) );
   LVARRAY_ASSERT( isSorted( ptr, ptr + size, comp ) );
 
-  std::ptrdiff_t lower = 0;
-  std::ptrdiff_t upper = size;
-  while( lower != upper )
+  // The answer is in [ base, base + length ], each step halves length with a conditional move
+  // instead of a branch that is mispredicted half the time.
+  T const * base = ptr;
+  std::ptrdiff_t length = size;
+  while( length >= LVARRAY_FIND_PREFETCH_MIN_SIZE )
   {
-    std::ptrdiff_t const guess = (lower + upper) / 2;
-    if( comp( ptr[guess], value ) )
-    {
-      lower = guess + 1;
-    }
-    else
-    {
-      upper = guess;
-    }
+    std::ptrdiff_t const half = length / 2;
+    LVARRAY_PREFETCH( base + half / 2 );
+    LVARRAY_PREFETCH( base + half + half / 2 );
+    base = comp( base[ half ], value ) ? base + half : base;
+    length -= half;
+  }
+
+  while( length > 1 )
+  {
+    std::ptrdiff_t const half = length / 2;
+    base = comp( base[ half ], value ) ? base + half : base;
+    length -= half;
   }
 
-  return lower;
+  return ( base - ptr ) + ( size > 0 && comp( *base, value ) );
 }
 
 /**
@@ -757,5 +848,175 @@ std::ptrdiff_t insert( T * const LVARRAY_RESTRICT ptr,
   return nToInsert;
 }
 
+/**
+ * @tparam T The type of the values.
+ * @tparam Compare The type of the comparison function, defaults to less<T>.
+ * @return The number of values in both arrays.
+ * @param a The first array, must be sorted unique under @p comp.
+ * @param sizeA The size of @p a.
+ * @param b The second array, must be sorted unique under @p comp.
+ * @param sizeB The size of @p b.
+ * @param comp The comparison method to use.
+ * @details The arrays are merged unless one is at least LVARRAY_SET_GALLOP_RATIO times larger than the
+ *   other, in which case each value of the smaller array is searched for in the rest of the larger one
+ *   with an exponential search.
+ */
+DISABLE_HD_WARNING
+template< typename T, typename Compare=less< T > >
+LVARRAY_HOST_DEVICE inline
+std::ptrdiff_t setIntersectionSize( T const * const LVARRAY_RESTRICT a,
+                                    std::ptrdiff_t const sizeA,
+                                    T const * const LVARRAY_RESTRICT b,
+                                    std::ptrdiff_t const sizeB,
+                                    Compare comp=Compare() )
+{
+  LVARRAY_ASSERT( isSortedUnique( a, a + sizeA, comp ) );
+  LVARRAY_ASSERT( isSortedUnique( b, b + sizeB, comp ) );
+
+  auto const found = [] ( std::ptrdiff_t, T const & ) {};
+  if( sizeA * LVARRAY_SET_GALLOP_RATIO <= sizeB )
+  { return internal::gallopingIntersection( a, sizeA, b, sizeB, comp, found ); }
+  if( sizeB * LVARRAY_SET_GALLOP_RATIO <= sizeA )
+  { return internal::gallopingIntersection( b, sizeB, a, sizeA, comp, found ); }
+
+  return internal::mergeIntersection( a, sizeA, b, sizeB, comp, found );
+}
+
+/**
+ * @tparam T The type of the values.
+ * @tparam Compare The type of the comparison function, defaults to less<T>.
+ * @brief Construct the values in both arrays in @p output.
+ * @param a The first array, must be sorted unique under @p comp.
+ * @param sizeA The size of @p a.
+ * @param b The second array, must be sorted unique under @p comp.
+ * @param sizeB The size of @p b.
+ * @param output Pointer to uninitialized space for at least min( @p sizeA, @p sizeB ) values.
+ * @param comp The comparison method to use.
+ * @return The number of values constructed in @p output, they are sorted unique.
+ * @details See setIntersectionSize.
+ */
+DISABLE_HD_WARNING
+template< typename T, typename Compare=less< T > >
+LVARRAY_HOST_DEVICE inline
+std::ptrdiff_t setIntersection( T const * const LVARRAY_RESTRICT a,
+                                std::ptrdiff_t const sizeA,
+                                T const * const LVARRAY_RESTRICT b,
+                                std::ptrdiff_t const sizeB,
+                                T * const LVARRAY_RESTRICT output,
+                                Compare comp=Compare() )
+{
+  LVARRAY_ASSERT( isSortedUnique( a, a + sizeA, comp ) );
+  LVARRAY_ASSERT( isSortedUnique( b, b + sizeB, comp ) );
+
+  auto const found = [output] ( std::ptrdiff_t const n, T const & value )
+  { new ( output + n ) T( value ); };
+
+  if( sizeA * LVARRAY_SET_GALLOP_RATIO <= sizeB )
+  { return internal::gallopingIntersection( a, sizeA, b, sizeB, comp, found ); }
+  if( sizeB * LVARRAY_SET_GALLOP_RATIO <= sizeA )
+  { return internal::gallopingIntersection( b, sizeB, a, sizeA, comp, found ); }
+
+  return internal::mergeIntersection( a, sizeA, b, sizeB, comp, found );
+}
+
+/**
+ * @tparam T The type of the values.
+ * @tparam Compare The type of the comparison function, defaults to less<T>.
+ * @brief Construct the values in either array in @p output.
+ * @param a The first array, must be sorted unique under @p comp.
+ * @param sizeA The size of @p a.
+ * @param b The second array, must be sorted unique under @p comp.
+ * @param sizeB The size of @p b.
+ * @param output Pointer to uninitialized space for at least @p sizeA + @p sizeB values.
+ * @param comp The comparison method to use.
+ * @return The number of values constructed in @p output, they are sorted unique.
+ * @note The size of the union is sizeA + sizeB - setIntersectionSize( a, sizeA, b, sizeB ).
+ */
+DISABLE_HD_WARNING
+template< typename T, typename Compare=less< T > >
+LVARRAY_HOST_DEVICE inline
+std::ptrdiff_t setUnion( T const * const LVARRAY_RESTRICT a,
+                         std::ptrdiff_t const sizeA,
+                         T const * const LVARRAY_RESTRICT b,
+                         std::ptrdiff_t const sizeB,
+                         T * const LVARRAY_RESTRICT output,
+                         Compare comp=Compare() )
+{
+  LVARRAY_ASSERT( isSortedUnique( a, a + sizeA, comp ) );
+  LVARRAY_ASSERT( isSortedUnique( b, b + sizeB, comp ) );
+
+  std::ptrdiff_t i = 0;
+  std::ptrdiff_t j = 0;
+  std::ptrdiff_t n = 0;
+  while( i < sizeA && j < sizeB )
+  {
+    bool const aLess = comp( a[ i ], b[ j ] );
+    bool const bLess = comp( b[ j ], a[ i ] );
+    new ( output + n ) T( bLess ? b[ j ] : a[ i ] );
+    ++n;
+    i += !bLess;
+    j += !aLess;
+  }
+
+  for( ; i < sizeA; ++i, ++n )
+  { new ( output + n ) T( a[ i ] ); }
+
+  for( ; j < sizeB; ++j, ++n )
+  { new ( output + n ) T( b[ j ] ); }
+
+  return n;
+}
+
+/**
+ * @tparam T The type of the values.
+ * @tparam Compare The type of the comparison function, defaults to less<T>.
+ * @brief Construct the values in @p a that aren't in @p b in @p output.
+ * @param a The first array, must be sorted unique under @p comp.
+ * @param sizeA The size of @p a.
+ * @param b The second array, must be sorted unique under @p comp.
+ * @param sizeB The size of @p b.
+ * @param output Pointer to uninitialized space for at least @p sizeA values.
+ * @param comp The comparison method to use.
+ * @return The number of values constructed in @p output, they are sorted unique.
+ * @details When @p b is at least LVARRAY_SET_GALLOP_RATIO times larger than @p a each value of @p a
+ *   is searched for in @p b with an exponential search, otherwise the arrays are merged.
+ * @note The size of the difference is sizeA - setIntersectionSize( a, sizeA, b, sizeB ).
+ */
+DISABLE_HD_WARNING
+template< typename T, typename Compare=less< T > >
+LVARRAY_HOST_DEVICE inline
+std::ptrdiff_t setDifference( T const * const LVARRAY_RESTRICT a,
+                              std::ptrdiff_t const sizeA,
+                              T const * const LVARRAY_RESTRICT b,
+                              std::ptrdiff_t const sizeB,
+                              T * const LVARRAY_RESTRICT output,
+                              Compare comp=Compare() )
+{
+  LVARRAY_ASSERT( isSortedUnique( a, a + sizeA, comp ) );
+  LVARRAY_ASSERT( isSortedUnique( b, b + sizeB, comp ) );
+
+  bool const gallop = sizeA * LVARRAY_SET_GALLOP_RATIO <= sizeB;
+  std::ptrdiff_t j = 0;
+  std::ptrdiff_t n = 0;
+  for( std::ptrdiff_t i = 0; i < sizeA; ++i )
+  {
+    if( gallop )
+    { j += internal::gallop( b + j, sizeB - j, a[ i ], comp ); }
+    else
+    {
+      while( j < sizeB && comp( b[ j ], a[ i ] ) )
+      { ++j; }
+    }
+
+    if( j == sizeB || comp( a[ i ], b[ j ] ) )
+    {
+      new ( output + n ) T( a[ i ] );
+      ++n;
+    }
+  }
+
+  return n;
+}
+
 } // namespace sortedArrayManipulation
 } // namespace LvArray
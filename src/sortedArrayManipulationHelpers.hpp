@@ -664,6 +664,140 @@ LVARRAY_HOST_DEVICE inline void introsortLoop( RandomAccessIterator first, Rando
   }
 }
 
+/**
+ * @tparam T The type of the values.
+ * @tparam Compare The type of the comparison method.
+ * @return The index of the first value in the array that compares not less than @p value, or @p size
+ *   if there is no such value.
+ * @param ptr Pointer to the array, must be sorted under comp.
+ * @param size The size of the array.
+ * @param value The value to find.
+ * @param comp The comparison method to use.
+ * @details This is an exponential search from the front followed by a binary search, so it takes
+ *   O( log( i ) ) comparisons where i is the returned index.
+ */
+DISABLE_HD_WARNING
+template< typename T, typename Compare >
+LVARRAY_HOST_DEVICE inline
+std::ptrdiff_t gallop( T const * const LVARRAY_RESTRICT ptr,
+                       std::ptrdiff_t const size,
+                       T const & value,
+                       Compare & comp )
+{
+  if( size == 0 || !comp( ptr[ 0 ], value ) )
+  { return 0; }
+
+  // ptr[ lower ] is less than value and the result is in ( lower, upper ].
+  std::ptrdiff_t lower = 0;
+  std::ptrdiff_t upper = 1;
+  while( upper < size && comp( ptr[ upper ], value ) )
+  {
+    lower = upper;
+    upper = 2 * upper + 1;
+  }
+
+  if( upper > size )
+  { upper = size; }
+
+  while( upper - lower > 1 )
+  {
+    std::ptrdiff_t const middle = lower + ( upper - lower ) / 2;
+    if( comp( ptr[ middle ], value ) )
+    { lower = middle; }
+    else
+    { upper = middle; }
+  }
+
+  return upper;
+}
+
+/**
+ * @tparam T The type of the values.
+ * @tparam Compare The type of the comparison method.
+ * @tparam CALLBACK The type of @p found.
+ * @brief Intersect two sorted unique arrays with a linear merge.
+ * @param a The first array.
+ * @param sizeA The size of @p a.
+ * @param b The second array.
+ * @param sizeB The size of @p b.
+ * @param comp The comparison method to use.
+ * @param found The function called on each value in both arrays as @code found( n, value ) @endcode
+ *   where @c n is the number of values found before it.
+ * @return The size of the intersection.
+ */
+DISABLE_HD_WARNING
+template< typename T, typename Compare, typename CALLBACK >
+LVARRAY_HOST_DEVICE inline
+std::ptrdiff_t mergeIntersection( T const * const LVARRAY_RESTRICT a,
+                                  std::ptrdiff_t const sizeA,
+                                  T const * const LVARRAY_RESTRICT b,
+                                  std::ptrdiff_t const sizeB,
+                                  Compare & comp,
+                                  CALLBACK && found )
+{
+  std::ptrdiff_t i = 0;
+  std::ptrdiff_t j = 0;
+  std::ptrdiff_t n = 0;
+  while( i < sizeA && j < sizeB )
+  {
+    // Advancing the indices without a branch avoids mispredictions on random data.
+    bool const aLess = comp( a[ i ], b[ j ] );
+    bool const bLess = comp( b[ j ], a[ i ] );
+    if( !aLess && !bLess )
+    {
+      found( n, a[ i ] );
+      ++n;
+    }
+
+    i += !bLess;
+    j += !aLess;
+  }
+
+  return n;
+}
+
+/**
+ * @tparam T The type of the values.
+ * @tparam Compare The type of the comparison method.
+ * @tparam CALLBACK The type of @p found.
+ * @brief Intersect a short sorted unique array with a much longer one by galloping through the longer one.
+ * @param small The short array.
+ * @param sizeSmall The size of @p small.
+ * @param large The long array.
+ * @param sizeLarge The size of @p large.
+ * @param comp The comparison method to use.
+ * @param found The function called on each value in both arrays, see mergeIntersection.
+ * @return The size of the intersection.
+ */
+DISABLE_HD_WARNING
+template< typename T, typename Compare, typename CALLBACK >
+LVARRAY_HOST_DEVICE inline
+std::ptrdiff_t gallopingIntersection( T const * const LVARRAY_RESTRICT small,
+                                      std::ptrdiff_t const sizeSmall,
+                                      T const * const LVARRAY_RESTRICT large,
+                                      std::ptrdiff_t const sizeLarge,
+                                      Compare & comp,
+                                      CALLBACK && found )
+{
+  std::ptrdiff_t j = 0;
+  std::ptrdiff_t n = 0;
+  for( std::ptrdiff_t i = 0; i < sizeSmall; ++i )
+  {
+    j += gallop( large + j, sizeLarge - j, small[ i ], comp );
+    if( j == sizeLarge )
+    { break; }
+
+    if( !comp( small[ i ], large[ j ] ) )
+    {
+      found( n, small[ i ] );
+      ++n;
+      ++j;
+    }
+  }
+
+  return n;
+}
+
 } // namespace internal
 } // namespace sortedArrayManipulation
 } // namespace LvArray
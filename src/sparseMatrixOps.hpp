@@ -0,0 +1,1281 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC and LvArray contributors.
+ * All rights reserved.
+ * See the LICENSE file for details.
+ * SPDX-License-Identifier: (BSD-3-Clause)
+ */
+
+/**
+ * @file sparseMatrixOps.hpp
+ * @brief Contains algorithms that operate on whole sparse matrices and sparsity patterns.
+ */
+
+#pragma once
+
+// Source includes
+#include "CRSMatrix.hpp"
+#include "SparsityPattern.hpp"
+#include "ArrayOfArrays.hpp"
+#include "Array.hpp"
+#include "sortedArrayManipulation.hpp"
+#include "sparseMatrixOpsHelpers.hpp"
+
+// TPL includes
+#include <RAJA/RAJA.hpp>
+
+namespace LvArray
+{
+
+/**
+ * @brief Contains algorithms that operate on whole sparse matrices and sparsity patterns.
+ */
+namespace sparseMatrixOps
+{
+
+namespace internal
+{
+
+/**
+ * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+ * @tparam COL_TYPE The integer used to enumerate the columns.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @tparam ROWS_OF_A The type of @p rowOfA.
+ * @tparam ROWS_OF_B The type of @p rowOfB.
+ * @brief Compute the sparsity pattern of the product of two graphs.
+ * @param numRows The number of rows of the left operand.
+ * @param numColumns The number of columns of the right operand.
+ * @param rowOfA A function that returns a one dimensional slice of the columns of a row of the left operand.
+ * @param rowOfB A function that returns a one dimensional slice of the columns of a row of the right operand.
+ * @param c The resulting sparsity pattern.
+ * @details The rows are split into blocks, each with its own RowAccumulator. The distinct columns
+ *   of each row are first gathered to count the non zeros in the row and then gathered again once
+ *   @p c has been allocated, sorted and inserted. Besides the number of non zeros in each row the
+ *   only scratch memory is a hash table per block sized from the longest row of the product.
+ */
+template< typename POLICY,
+          typename COL_TYPE,
+          typename INDEX_TYPE,
+          template< typename > class BUFFER_TYPE,
+          typename ROWS_OF_A,
+          typename ROWS_OF_B >
+void multiplySymbolic( INDEX_TYPE const numRows,
+                       INDEX_TYPE const numColumns,
+                       ROWS_OF_A const & rowOfA,
+                       ROWS_OF_B const & rowOfB,
+                       SparsityPattern< COL_TYPE, INDEX_TYPE, BUFFER_TYPE > & c )
+{
+  // Gather the distinct columns of a row, there are at most as many as there are scalar products.
+  auto const gatherRow = [numColumns, rowOfA, rowOfB] ( INDEX_TYPE const row, RowAccumulator< COL_TYPE > & accumulator )
+  {
+    auto const aRow = rowOfA( row );
+
+    std::ptrdiff_t numProducts = 0;
+    for( INDEX_TYPE i = 0; i < aRow.size(); ++i )
+    { numProducts += rowOfB( aRow[ i ] ).size(); }
+
+    accumulator.clear( math::min( numProducts, std::ptrdiff_t( numColumns ) ) );
+    for( INDEX_TYPE i = 0; i < aRow.size(); ++i )
+    {
+      auto const bRow = rowOfB( aRow[ i ] );
+      for( INDEX_TYPE j = 0; j < bRow.size(); ++j )
+      { accumulator.insert( bRow[ j ] ); }
+    }
+  };
+
+  // Use several blocks per thread since the cost of the rows can vary a lot.
+  INDEX_TYPE const numBlocks = math::max( INDEX_TYPE( 1 ), math::min( numRows, INDEX_TYPE( 16 * defaultNumTransposeBlocks( POLICY {} ) ) ) );
+
+  // Count the non zeros in each row.
+  Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > rowNNZ;
+  rowNNZ.resizeWithoutInitializationOrDestruction( numRows );
+  ArrayView< INDEX_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const rowNNZView = rowNNZ.toView();
+  RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numBlocks ),
+                          [numRows, numBlocks, rowNNZView, gatherRow] ( INDEX_TYPE const block )
+    {
+      RowAccumulator< COL_TYPE > accumulator;
+      INDEX_TYPE const end = blockBegin( numRows, numBlocks, block + 1 );
+      for( INDEX_TYPE row = blockBegin( numRows, numBlocks, block ); row < end; ++row )
+      {
+        gatherRow( row, accumulator );
+        rowNNZView[ row ] = accumulator.size();
+      }
+    } );
+
+  // Allocate exactly enough space and insert the sorted columns.
+  c.template resizeFromRowCapacities< POLICY >( numRows, numColumns, rowNNZ.data() );
+
+  SparsityPatternView< COL_TYPE, INDEX_TYPE const, BUFFER_TYPE > const cView = c.toView();
+  RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numBlocks ),
+                          [numRows, numBlocks, cView, gatherRow] ( INDEX_TYPE const block )
+    {
+      RowAccumulator< COL_TYPE > accumulator;
+      INDEX_TYPE const end = blockBegin( numRows, numBlocks, block + 1 );
+      for( INDEX_TYPE row = blockBegin( numRows, numBlocks, block ); row < end; ++row )
+      {
+        gatherRow( row, accumulator );
+        sortedArrayManipulation::makeSorted( accumulator.data(), accumulator.data() + accumulator.size() );
+        cView.insertNonZeros( row, accumulator.data(), accumulator.data() + accumulator.size() );
+      }
+    } );
+}
+
+/**
+ * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+ * @tparam COL_TYPE The integer used to enumerate the columns.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @tparam FILL The type of @p fill.
+ * @brief Transpose a sparsity pattern.
+ * @param src The sparsity pattern to transpose.
+ * @param dst The transpose, it is cleared and every row is compressed.
+ * @param numBlocks The number of blocks the rows of @p src are split into.
+ * @param fill A function called as @code fill( row, i, pos ) @endcode for each entry of @p src
+ *   where @c pos is the position of the entry in the values of the compressed @p dst.
+ */
+template< typename POLICY, typename COL_TYPE, typename INDEX_TYPE, template< typename > class BUFFER_TYPE, typename FILL >
+void transpose( SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const & src,
+                SparsityPattern< COL_TYPE, INDEX_TYPE, BUFFER_TYPE > & dst,
+                INDEX_TYPE const numBlocks,
+                FILL const & fill )
+{
+  auto const getRow = [src] ( INDEX_TYPE const row ) { return src.getColumns( row ); };
+  Transposer< POLICY, INDEX_TYPE, BUFFER_TYPE > transposer( src.numRows(), src.numColumns(), numBlocks, getRow );
+
+  Array< COL_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > scratch;
+  scratch.resizeWithoutInitializationOrDestruction( transposer.numEntries() );
+  ArrayView< COL_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const scratchView = scratch.toView();
+
+  transposer.fill( getRow,
+                   [scratchView, fill] ( INDEX_TYPE const row, INDEX_TYPE const i, COL_TYPE, INDEX_TYPE const pos )
+    {
+      scratchView[ pos ] = row;
+      fill( row, i, pos );
+    } );
+
+  // The rows of the transpose come out sorted and unique so they can be inserted directly.
+  Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > capacities;
+  capacities.resizeWithoutInitializationOrDestruction( src.numColumns() );
+  ArrayView< INDEX_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const capacitiesView = capacities.toView();
+  INDEX_TYPE const * const offsets = transposer.getOffsets();
+  RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, src.numColumns() ),
+                          [capacitiesView, offsets] ( INDEX_TYPE const row )
+    { capacitiesView[ row ] = offsets[ row + 1 ] - offsets[ row ]; } );
+
+  dst.template resizeFromRowCapacities< POLICY >( src.numColumns(), src.numRows(), capacities.data() );
+
+  SparsityPatternView< COL_TYPE, INDEX_TYPE const, BUFFER_TYPE > const dstView = dst.toView();
+  RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, src.numColumns() ),
+                          [scratchView, dstView] ( INDEX_TYPE const row )
+    {
+      COL_TYPE const * const columns = scratchView.data() + dstView.getOffsets()[ row ];
+      dstView.insertNonZeros( row, columns, columns + dstView.nonZeroCapacity( row ) );
+    } );
+}
+
+/**
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @tparam ROW_GETTER The type of @p getRow.
+ * @brief Compute the reverse Cuthill-McKee ordering of a graph.
+ * @param numNodes The number of nodes in the graph.
+ * @param getRow A function that returns a one dimensional slice of the neighbors of a node.
+ * @param permutation The resulting permutation, @c permutation[ i ] is the new index of node @c i.
+ * @details Each connected component is ordered by a breadth first search from a pseudo peripheral
+ *   node found with the George-Liu algorithm. The neighbors of each node are visited in order of
+ *   increasing degree, ties are broken by index so the ordering is deterministic.
+ */
+template< typename INDEX_TYPE, template< typename > class BUFFER_TYPE, typename ROW_GETTER >
+void reverseCuthillMcKee( INDEX_TYPE const numNodes,
+                          ROW_GETTER const & getRow,
+                          ArrayView< INDEX_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & permutation )
+{
+  LVARRAY_ERROR_IF_NE( permutation.size(), numNodes );
+
+  Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > degree( numNodes );
+  for( INDEX_TYPE node = 0; node < numNodes; ++node )
+  {
+    auto const neighbors = getRow( node );
+    for( INDEX_TYPE i = 0; i < neighbors.size(); ++i )
+    { degree[ node ] += neighbors[ i ] != node; }
+  }
+
+  // A node is ordered once permutation[ node ] is not negative.
+  for( INDEX_TYPE node = 0; node < numNodes; ++node )
+  { permutation[ node ] = -1; }
+
+  Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > order( numNodes );
+  Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > queue( numNodes );
+  Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > visited( numNodes );
+  INDEX_TYPE currentSearch = 0;
+
+  // Compute the level structure rooted at root, return its depth and the bounds of the last level in queue.
+  auto const levelStructure = [&] ( INDEX_TYPE const root, INDEX_TYPE & lastLevelBegin, INDEX_TYPE & lastLevelEnd )
+  {
+    ++currentSearch;
+    visited[ root ] = currentSearch;
+    queue[ 0 ] = root;
+
+    INDEX_TYPE depth = 0;
+    INDEX_TYPE levelBegin = 0;
+    INDEX_TYPE levelEnd = 1;
+    while( true )
+    {
+      INDEX_TYPE nextLevelEnd = levelEnd;
+      for( INDEX_TYPE q = levelBegin; q < levelEnd; ++q )
+      {
+        auto const neighbors = getRow( queue[ q ] );
+        for( INDEX_TYPE i = 0; i < neighbors.size(); ++i )
+        {
+          INDEX_TYPE const neighbor = neighbors[ i ];
+          if( visited[ neighbor ] != currentSearch )
+          {
+            visited[ neighbor ] = currentSearch;
+            queue[ nextLevelEnd++ ] = neighbor;
+          }
+        }
+      }
+
+      if( nextLevelEnd == levelEnd )
+      {
+        lastLevelBegin = levelBegin;
+        lastLevelEnd = levelEnd;
+        return depth;
+      }
+
+      levelBegin = levelEnd;
+      levelEnd = nextLevelEnd;
+      ++depth;
+    }
+  };
+
+  auto const byDegree = [&degree] ( INDEX_TYPE const lhs, INDEX_TYPE const rhs )
+  { return degree[ lhs ] < degree[ rhs ] || ( degree[ lhs ] == degree[ rhs ] && lhs < rhs ); };
+
+  INDEX_TYPE numOrdered = 0;
+  for( INDEX_TYPE start = 0; start < numNodes; ++start )
+  {
+    if( permutation[ start ] >= 0 )
+    { continue; }
+
+    // Find a pseudo peripheral node in the component containing start.
+    INDEX_TYPE root = start;
+    INDEX_TYPE lastLevelBegin;
+    INDEX_TYPE lastLevelEnd;
+    INDEX_TYPE depth = levelStructure( root, lastLevelBegin, lastLevelEnd );
+    while( true )
+    {
+      INDEX_TYPE candidate = queue[ lastLevelBegin ];
+      for( INDEX_TYPE q = lastLevelBegin + 1; q < lastLevelEnd; ++q )
+      {
+        if( byDegree( queue[ q ], candidate ) )
+        { candidate = queue[ q ]; }
+      }
+
+      INDEX_TYPE const candidateDepth = levelStructure( candidate, lastLevelBegin, lastLevelEnd );
+      if( candidateDepth <= depth )
+      { break; }
+
+      root = candidate;
+      depth = candidateDepth;
+    }
+
+    // Breadth first search from root visiting the neighbors in order of increasing degree.
+    permutation[ root ] = numOrdered;
+    order[ numOrdered++ ] = root;
+    for( INDEX_TYPE head = numOrdered - 1; head < numOrdered; ++head )
+    {
+      INDEX_TYPE const levelBegin = numOrdered;
+      auto const neighbors = getRow( order[ head ] );
+      for( INDEX_TYPE i = 0; i < neighbors.size(); ++i )
+      {
+        INDEX_TYPE const neighbor = neighbors[ i ];
+        if( permutation[ neighbor ] < 0 )
+        {
+          permutation[ neighbor ] = numOrdered;
+          order[ numOrdered++ ] = neighbor;
+        }
+      }
+
+      sortedArrayManipulation::makeSorted( order.data() + levelBegin, order.data() + numOrdered, byDegree );
+      for( INDEX_TYPE i = levelBegin; i < numOrdered; ++i )
+      { permutation[ order[ i ] ] = i; }
+    }
+  }
+
+  for( INDEX_TYPE node = 0; node < numNodes; ++node )
+  { permutation[ node ] = numNodes - 1 - permutation[ node ]; }
+}
+
+/**
+ * @tparam T The type used to enumerate the rows.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @tparam ROW_GETTER The type of @p getRows.
+ * @brief Greedily color the elements so that no two elements of the same color share a row.
+ * @param numElems The number of elements.
+ * @param numRows The number of rows.
+ * @param getRows A function that returns a one dimensional slice of the rows an element writes to.
+ * @param colorToElems The elements of each color, it is cleared and array @c c contains
+ *   the sorted elements of color @c c. Each array is filled to capacity.
+ * @details The elements are visited in order and each gets the smallest color not used by any
+ *   element it shares a row with. An element that shares a row with at most @c k other elements
+ *   gets a color less than or equal to @c k.
+ */
+template< typename T, typename INDEX_TYPE, template< typename > class BUFFER_TYPE, typename ROW_GETTER >
+void colorElements( INDEX_TYPE const numElems,
+                    INDEX_TYPE const numRows,
+                    ROW_GETTER const & getRows,
+                    ArrayOfArrays< INDEX_TYPE, INDEX_TYPE, BUFFER_TYPE > & colorToElems )
+{
+  // The elements that write to each row.
+  Transposer< RAJA::loop_exec, INDEX_TYPE, BUFFER_TYPE > transposer( numElems, numRows, 1, getRows );
+  INDEX_TYPE const * const rowOffsets = transposer.getOffsets();
+
+  Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > rowToElems;
+  rowToElems.resizeWithoutInitializationOrDestruction( transposer.numEntries() );
+  ArrayView< INDEX_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const rowToElemsView = rowToElems.toView();
+  transposer.fill( getRows,
+                   [rowToElemsView] ( INDEX_TYPE const elem, INDEX_TYPE, T, INDEX_TYPE const pos )
+    { rowToElemsView[ pos ] = elem; } );
+
+  // An element is colored once elemColors[ elem ] is not negative, color c is used by a
+  // neighbor of elem iff forbidden[ c ] == elem.
+  Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > elemColors( numElems );
+  Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > forbidden;
+  Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > colorSizes;
+  for( INDEX_TYPE elem = 0; elem < numElems; ++elem )
+  { elemColors[ elem ] = -1; }
+
+  for( INDEX_TYPE elem = 0; elem < numElems; ++elem )
+  {
+    auto const rows = getRows( elem );
+    for( INDEX_TYPE i = 0; i < rows.size(); ++i )
+    {
+      INDEX_TYPE const row = rows[ i ];
+      for( INDEX_TYPE j = rowOffsets[ row ]; j < rowOffsets[ row + 1 ]; ++j )
+      {
+        INDEX_TYPE const neighborColor = elemColors[ rowToElems[ j ] ];
+        if( neighborColor >= 0 )
+        { forbidden[ neighborColor ] = elem; }
+      }
+    }
+
+    INDEX_TYPE color = 0;
+    while( color < colorSizes.size() && forbidden[ color ] == elem )
+    { ++color; }
+
+    if( color == colorSizes.size() )
+    {
+      forbidden.emplace_back( -1 );
+      colorSizes.emplace_back( 0 );
+    }
+
+    elemColors[ elem ] = color;
+    ++colorSizes[ color ];
+  }
+
+  colorToElems.template resizeFromCapacities< RAJA::loop_exec >( colorSizes.size(), colorSizes.data() );
+  for( INDEX_TYPE elem = 0; elem < numElems; ++elem )
+  { colorToElems.emplaceBack( elemColors[ elem ], elem ); }
+}
+
+/**
+ * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+ * @tparam T The type of the values in the arrays, used to enumerate the columns.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @tparam ROW_GETTER The type of @p getRow.
+ * @brief Transpose a graph, see the public transpose of an ArrayOfArraysView.
+ * @param numRows The number of rows of the graph.
+ * @param numColumns The number of columns of the graph, which is the number of arrays in @p dst.
+ * @param getRow A function that returns a one dimensional slice of the columns of a row.
+ * @param dst The transpose, it is cleared and each array is sorted and filled to capacity.
+ * @param numBlocks The number of blocks the rows are split into.
+ * @details The Transposer counts the entries of each column per block of rows in parallel and
+ *   scans the counts, these are the offsets of @p dst. The rows of a block are then visited in order
+ *   so each array of @p dst is written sorted without a sort.
+ */
+template< typename POLICY, typename T, typename INDEX_TYPE, template< typename > class BUFFER_TYPE, typename ROW_GETTER >
+void transposeArrays( INDEX_TYPE const numRows,
+                      INDEX_TYPE const numColumns,
+                      ROW_GETTER const & getRow,
+                      ArrayOfArrays< T, INDEX_TYPE, BUFFER_TYPE > & dst,
+                      INDEX_TYPE const numBlocks )
+{
+  Transposer< POLICY, INDEX_TYPE, BUFFER_TYPE > transposer( numRows, numColumns, numBlocks, getRow );
+
+  Array< T, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > scratch;
+  scratch.resizeWithoutInitializationOrDestruction( transposer.numEntries() );
+  ArrayView< T, 1, 0, INDEX_TYPE, BUFFER_TYPE > const scratchView = scratch.toView();
+
+  transposer.fill( getRow,
+                   [scratchView] ( INDEX_TYPE const row, INDEX_TYPE, T, INDEX_TYPE const pos )
+    { scratchView[ pos ] = row; } );
+
+  dst.resizeFromOffsets( numColumns, transposer.getOffsets() );
+
+  ArrayOfArraysView< T, INDEX_TYPE const, false, BUFFER_TYPE > const dstView = dst.toView();
+  RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numColumns ),
+                          [scratchView, dstView] ( INDEX_TYPE const column )
+    {
+      T const * const values = scratchView.data() + dstView.getOffsets()[ column ];
+      dstView.appendToArray( column, values, values + dstView.capacityOfArray( column ) );
+    } );
+}
+
+} // namespace internal
+
+/**
+ * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+ * @tparam COL_TYPE The integer used to enumerate the columns.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @brief Compute the sparsity pattern of @code C = A B @endcode.
+ * @param a The sparsity pattern of the left operand.
+ * @param b The sparsity pattern of the right operand.
+ * @param c The resulting sparsity pattern, it is cleared and every row is sorted and compressed.
+ * @note Besides the number of non zeros in each row of @p c the scratch memory used is a hash table
+ *   per block of rows, each sized from the longest row of the product.
+ */
+template< typename POLICY, typename COL_TYPE, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+void multiplySymbolic( SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const & a,
+                       SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const & b,
+                       SparsityPattern< COL_TYPE, INDEX_TYPE, BUFFER_TYPE > & c )
+{
+  LVARRAY_ERROR_IF_NE_MSG( a.numColumns(), b.numRows(), "The inner dimensions of the product must agree." );
+
+  internal::multiplySymbolic< POLICY >( a.numRows(),
+                                        b.numColumns(),
+                                        [a] ( INDEX_TYPE const row ) { return a.getColumns( row ); },
+                                        [b] ( INDEX_TYPE const row ) { return b.getColumns( row ); },
+                                        c );
+}
+
+/**
+ * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+ * @tparam COL_TYPE The type of the values in the arrays, used to enumerate the columns.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @brief Compute the sparsity pattern of the product of two graphs stored as ArrayOfArrays,
+ *   for example the node to element map times the element to node map.
+ * @param a The left operand, each array holds the columns of a row. The values in an array
+ *   do not need to be sorted or unique.
+ * @param b The right operand, it has @p a.size() rows.
+ * @param numColumns The number of columns of @p b.
+ * @param c The resulting sparsity pattern, it is cleared and every row is sorted and compressed.
+ */
+template< typename POLICY, typename COL_TYPE, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+void multiplySymbolic( ArrayOfArraysView< COL_TYPE const, INDEX_TYPE const, true, BUFFER_TYPE > const & a,
+                       ArrayOfArraysView< COL_TYPE const, INDEX_TYPE const, true, BUFFER_TYPE > const & b,
+                       INDEX_TYPE const numColumns,
+                       SparsityPattern< COL_TYPE, INDEX_TYPE, BUFFER_TYPE > & c )
+{
+  internal::multiplySymbolic< POLICY >( a.size(),
+                                        numColumns,
+                                        [a] ( INDEX_TYPE const row ) { return a[ row ]; },
+                                        [b] ( INDEX_TYPE const row ) { return b[ row ]; },
+                                        c );
+}
+
+/**
+ * @tparam POLICY The RAJA policy to use.
+ * @tparam T The type of the entries in the matrices.
+ * @tparam COL_TYPE The integer used to enumerate the columns.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @brief Compute the values of @code C = A B @endcode where @p c already has the sparsity pattern of the product.
+ * @param a The left operand.
+ * @param b The right operand.
+ * @param c The result, its existing values are overwritten. Its sparsity pattern must contain that of
+ *   the product, for example as computed by multiplySymbolic.
+ * @details Each row of @p c is computed by a single iteration so no atomics are needed and the result
+ *   is independent of the policy. The product a_ik b_kj is located in the row of @p c with a binary
+ *   search which starts after the previous column of row k of @p b. Calling this again after the values
+ *   of @p a or @p b change reuses the symbolic phase.
+ */
+template< typename POLICY, typename T, typename COL_TYPE, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+void multiplyNumeric( CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const & a,
+                      CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const & b,
+                      CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const & c )
+{
+  LVARRAY_ERROR_IF_NE_MSG( a.numColumns(), b.numRows(), "The inner dimensions of the product must agree." );
+  LVARRAY_ERROR_IF_NE( c.numRows(), a.numRows() );
+  LVARRAY_ERROR_IF_NE( c.numColumns(), b.numColumns() );
+
+  RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, a.numRows() ),
+                          [a, b, c] LVARRAY_HOST_DEVICE ( INDEX_TYPE const row )
+    {
+      INDEX_TYPE const cNNZ = c.numNonZeros( row );
+      COL_TYPE const * const cColumns = c.getColumns( row );
+      T * const cEntries = c.getEntries( row );
+
+      for( INDEX_TYPE i = 0; i < cNNZ; ++i )
+      { cEntries[ i ] = T(); }
+
+      INDEX_TYPE const aNNZ = a.numNonZeros( row );
+      COL_TYPE const * const aColumns = a.getColumns( row );
+      T const * const aEntries = a.getEntries( row );
+      for( INDEX_TYPE i = 0; i < aNNZ; ++i )
+      {
+        T const aik = aEntries[ i ];
+        INDEX_TYPE const bNNZ = b.numNonZeros( aColumns[ i ] );
+        COL_TYPE const * const bColumns = b.getColumns( aColumns[ i ] );
+        T const * const bEntries = b.getEntries( aColumns[ i ] );
+
+        INDEX_TYPE curPos = 0;
+        for( INDEX_TYPE j = 0; j < bNNZ; ++j )
+        {
+          INDEX_TYPE const pos = sortedArrayManipulation::find( cColumns + curPos, cNNZ - curPos, bColumns[ j ] ) + curPos;
+          LVARRAY_ASSERT_GT( cNNZ, pos );
+          LVARRAY_ASSERT_EQ( cColumns[ pos ], bColumns[ j ] );
+
+          cEntries[ pos ] += aik * bEntries[ j ];
+          curPos = pos + 1;
+        }
+      }
+    } );
+}
+
+/**
+ * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+ * @tparam T The type of the entries in the matrices.
+ * @tparam COL_TYPE The integer used to enumerate the columns.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @brief Compute @code C = A B @endcode, this is multiplySymbolic followed by multiplyNumeric.
+ * @param a The left operand.
+ * @param b The right operand.
+ * @param c The result, it is cleared and every row is sorted and compressed.
+ */
+template< typename POLICY, typename T, typename COL_TYPE, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+void multiply( CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const & a,
+               CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const & b,
+               CRSMatrix< T, COL_TYPE, INDEX_TYPE, BUFFER_TYPE > & c )
+{
+  SparsityPattern< COL_TYPE, INDEX_TYPE, BUFFER_TYPE > pattern;
+  multiplySymbolic< POLICY >( a.toSparsityPatternView(), b.toSparsityPatternView(), pattern );
+  c.template assimilate< POLICY >( std::move( pattern ) );
+  multiplyNumeric< POLICY >( a, b, c.toViewConstSizes() );
+}
+
+/**
+ * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+ * @tparam T The type of the entries in @p src.
+ * @tparam U The type of the entries in @p dst.
+ * @tparam COL_TYPE The integer used to enumerate the columns.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @brief Copy a matrix into a matrix with a different entry type, for example to store a preconditioner in @c float.
+ * @param src The matrix to convert.
+ * @param dst The converted matrix, it is cleared and given the sparsity pattern of @p src with every row
+ *   compressed. Entry @c i of each row is @code U( src.getEntries( row )[ i ] ) @endcode.
+ */
+template< typename POLICY, typename T, typename U, typename COL_TYPE, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+void convert( CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const & src,
+              CRSMatrix< U, COL_TYPE, INDEX_TYPE, BUFFER_TYPE > & dst )
+{
+  INDEX_TYPE const numRows = src.numRows();
+
+  Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > capacities;
+  capacities.resizeWithoutInitializationOrDestruction( numRows );
+  ArrayView< INDEX_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const capacitiesView = capacities.toView();
+  RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numRows ),
+                          [src, capacitiesView] ( INDEX_TYPE const row )
+    { capacitiesView[ row ] = src.numNonZeros( row ); } );
+
+  SparsityPattern< COL_TYPE, INDEX_TYPE, BUFFER_TYPE > pattern;
+  pattern.template resizeFromRowCapacities< POLICY >( numRows, src.numColumns(), capacities.data() );
+
+  SparsityPatternView< COL_TYPE, INDEX_TYPE const, BUFFER_TYPE > const patternView = pattern.toView();
+  RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numRows ),
+                          [src, patternView] ( INDEX_TYPE const row )
+    { patternView.insertNonZeros( row, src.getColumns( row ).begin(), src.getColumns( row ).end() ); } );
+
+  dst.template assimilate< POLICY >( std::move( pattern ) );
+
+  CRSMatrixView< U, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const dstView = dst.toViewConstSizes();
+  RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numRows ),
+                          [src, dstView] ( INDEX_TYPE const row )
+    {
+      T const * const srcEntries = src.getEntries( row );
+      U * const dstEntries = dstView.getEntries( row );
+      for( INDEX_TYPE i = 0; i < src.numNonZeros( row ); ++i )
+      { dstEntries[ i ] = U( srcEntries[ i ] ); }
+    } );
+}
+
+/**
+ * @tparam POLICY The RAJA policy to use.
+ * @tparam T The type of the entries in the matrix.
+ * @tparam COL_TYPE The integer used to enumerate the columns.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @tparam X The type of the values in @p x.
+ * @tparam Y The type of the values in @p y.
+ * @brief Compute @code y = A x @endcode.
+ * @param a The matrix.
+ * @param x The vector to multiply, of length @code a.numColumns() @endcode.
+ * @param y The result, of length @code a.numRows() @endcode.
+ * @details Each row is summed by a single iteration in @code std::common_type_t< T, X, Y > @endcode.
+ *   This lets the entries of @p a be stored in a narrower type than the vectors, for example a
+ *   @c float matrix applied to @c double vectors reads half the bytes of a @c double matrix
+ *   but still accumulates in @c double.
+ */
+template< typename POLICY,
+          typename T,
+          typename COL_TYPE,
+          typename INDEX_TYPE,
+          template< typename > class BUFFER_TYPE,
+          typename X,
+          typename Y >
+void multiply( CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const & a,
+               ArrayView< X const, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & x,
+               ArrayView< Y, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & y )
+{
+  using AccumulationType = std::common_type_t< T, X, Y >;
+
+  LVARRAY_ERROR_IF_NE( x.size(), a.numColumns() );
+  LVARRAY_ERROR_IF_NE( y.size(), a.numRows() );
+
+  RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, a.numRows() ),
+                          [a, x, y] LVARRAY_HOST_DEVICE ( INDEX_TYPE const row )
+    {
+      INDEX_TYPE const nnz = a.numNonZeros( row );
+      COL_TYPE const * const LVARRAY_RESTRICT columns = a.getColumns( row );
+      T const * const LVARRAY_RESTRICT entries = a.getEntries( row );
+
+      AccumulationType sum = 0;
+      for( INDEX_TYPE i = 0; i < nnz; ++i )
+      { sum += AccumulationType( entries[ i ] ) * AccumulationType( x[ columns[ i ] ] ); }
+
+      y[ row ] = Y( sum );
+    } );
+}
+
+/**
+ * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+ * @tparam T The type of the values in the arrays, used to enumerate the columns.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @brief Transpose a graph stored as an ArrayOfArrays, for example turn an element to node map into a node to element map.
+ * @param src The graph to transpose, the values in an array do not need to be sorted or unique.
+ * @param numColumns The number of columns of @p src, which is the number of arrays in @p dst.
+ * @param dst The transpose, it is cleared and array @c j contains the sorted indices of the arrays
+ *   of @p src that contain @c j, repeated if @c j appears more than once. Each array is filled to capacity.
+ * @param numBlocks The number of blocks the arrays of @p src are split into, this does not change the result.
+ * @details This is deterministic and does not use atomics, it uses
+ *   @code numColumns * numBlocks @endcode indices of scratch space, the number of blocks
+ *   is reduced so that this is at most the number of entries plus the number of columns.
+ */
+template< typename POLICY, typename T, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+void transpose( ArrayOfArraysView< T const, INDEX_TYPE const, true, BUFFER_TYPE > const & src,
+                INDEX_TYPE const numColumns,
+                ArrayOfArrays< T, INDEX_TYPE, BUFFER_TYPE > & dst,
+                INDEX_TYPE const numBlocks=internal::defaultNumTransposeBlocks( POLICY {} ) )
+{
+  static_assert( std::is_integral< T >::value, "The values of the ArrayOfArrays must be integral." );
+  internal::transposeArrays< POLICY >( src.size(),
+                                       numColumns,
+                                       [src] ( INDEX_TYPE const row ) { return src[ row ]; },
+                                       dst,
+                                       numBlocks );
+}
+
+/**
+ * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+ * @tparam T The type of the values in the array, used to enumerate the columns.
+ * @tparam USD The unit stride dimension of @p src.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @brief Transpose a graph stored as a two dimensional array, for example turn an element to node map
+ *   into a node to element map.
+ * @param src The graph to transpose, @c src( i, k ) is the @c k th column of row @c i.
+ * @param numColumns The number of columns of @p src, which is the number of arrays in @p dst.
+ * @param dst The transpose, it is cleared and array @c j contains the sorted indices of the rows
+ *   of @p src that contain @c j, repeated if @c j appears more than once. Each array is filled to capacity.
+ * @param numBlocks The number of blocks the rows of @p src are split into, this does not change the result.
+ * @details This is deterministic and does not use atomics, it uses
+ *   @code numColumns * numBlocks @endcode indices of scratch space, the number of blocks
+ *   is reduced so that this is at most the number of entries plus the number of columns.
+ */
+template< typename POLICY, typename T, int USD, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+void transpose( ArrayView< T const, 2, USD, INDEX_TYPE, BUFFER_TYPE > const & src,
+                INDEX_TYPE const numColumns,
+                ArrayOfArrays< T, INDEX_TYPE, BUFFER_TYPE > & dst,
+                INDEX_TYPE const numBlocks=internal::defaultNumTransposeBlocks( POLICY {} ) )
+{
+  static_assert( std::is_integral< T >::value, "The values of the ArrayView must be integral." );
+  internal::transposeArrays< POLICY >( src.size( 0 ),
+                                       numColumns,
+                                       [src] ( INDEX_TYPE const row ) { return src[ row ]; },
+                                       dst,
+                                       numBlocks );
+}
+
+/**
+ * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+ * @tparam COL_TYPE The integer used to enumerate the columns.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @brief Transpose a sparsity pattern.
+ * @param src The sparsity pattern to transpose.
+ * @param dst The transpose, it is cleared and every row is compressed.
+ * @param numBlocks The number of blocks the rows of @p src are split into, this does not change the result.
+ * @details This is deterministic and does not use atomics, it uses
+ *   @code src.numColumns() * numBlocks @endcode indices of scratch space, the number of blocks
+ *   is reduced so that this is at most the number of entries plus the number of columns.
+ */
+template< typename POLICY, typename COL_TYPE, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+void transpose( SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const & src,
+                SparsityPattern< COL_TYPE, INDEX_TYPE, BUFFER_TYPE > & dst,
+                INDEX_TYPE const numBlocks=internal::defaultNumTransposeBlocks( POLICY {} ) )
+{ internal::transpose< POLICY >( src, dst, numBlocks, [] ( INDEX_TYPE, INDEX_TYPE, INDEX_TYPE ) {} ); }
+
+/**
+ * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+ * @tparam T The type of the entries in the matrix.
+ * @tparam COL_TYPE The integer used to enumerate the columns.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @brief Transpose a matrix.
+ * @param src The matrix to transpose.
+ * @param dst The transpose, it is cleared and every row is compressed.
+ * @param numBlocks The number of blocks the rows of @p src are split into, this does not change the result.
+ * @details This is deterministic and does not use atomics, it uses
+ *   @code src.numColumns() * numBlocks @endcode indices of scratch space, the number of blocks
+ *   is reduced so that this is at most the number of entries plus the number of columns.
+ */
+template< typename POLICY, typename T, typename COL_TYPE, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+void transpose( CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const & src,
+                CRSMatrix< T, COL_TYPE, INDEX_TYPE, BUFFER_TYPE > & dst,
+                INDEX_TYPE const numBlocks=internal::defaultNumTransposeBlocks( POLICY {} ) )
+{
+  Array< T, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > scratch;
+  scratch.resizeWithoutInitializationOrDestruction( src.numNonZeros() );
+  ArrayView< T, 1, 0, INDEX_TYPE, BUFFER_TYPE > const scratchView = scratch.toView();
+
+  SparsityPattern< COL_TYPE, INDEX_TYPE, BUFFER_TYPE > pattern;
+  internal::transpose< POLICY >( src.toSparsityPatternView(), pattern, numBlocks,
+                                 [src, scratchView] ( INDEX_TYPE const row, INDEX_TYPE const i, INDEX_TYPE const pos )
+    { scratchView[ pos ] = src.getEntries( row )[ i ]; } );
+
+  dst.template assimilate< POLICY >( std::move( pattern ) );
+
+  CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const dstView = dst.toViewConstSizes();
+  RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, dstView.numRows() ),
+                          [scratchView, dstView] ( INDEX_TYPE const row )
+    {
+      T const * const values = scratchView.data() + dstView.getOffsets()[ row ];
+      T * const entries = dstView.getEntries( row );
+      for( INDEX_TYPE i = 0; i < dstView.numNonZeros( row ); ++i )
+      { entries[ i ] = values[ i ]; }
+    } );
+}
+
+/**
+ * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+ * @tparam T The type of the entries in the matrix.
+ * @tparam COL_TYPE The integer used to enumerate the columns.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @brief Copy the diagonal and the upper triangle of a symmetric matrix.
+ * @param full The matrix, it must be square. The entries below the diagonal are ignored.
+ * @param upper The diagonal and upper triangle of @p full, it is cleared and every row is compressed.
+ * @details This is the symmetric storage used by addToRowSymmetric, multiplySymmetric and symmetricToFull.
+ *   It is a regular CRSMatrix whose rows only contain the columns not less than the row.
+ */
+template< typename POLICY, typename T, typename COL_TYPE, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+void upperTriangle( CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const & full,
+                    CRSMatrix< T, COL_TYPE, INDEX_TYPE, BUFFER_TYPE > & upper )
+{
+  LVARRAY_ERROR_IF_NE_MSG( full.numRows(), full.numColumns(), "The matrix must be square." );
+  INDEX_TYPE const numRows = full.numRows();
+
+  Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > capacities;
+  capacities.resizeWithoutInitializationOrDestruction( numRows );
+  ArrayView< INDEX_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const capacitiesView = capacities.toView();
+  RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numRows ),
+                          [full, capacitiesView] ( INDEX_TYPE const row )
+    {
+      INDEX_TYPE const nnz = full.numNonZeros( row );
+      capacitiesView[ row ] = nnz - sortedArrayManipulation::find( full.getColumns( row ).dataIfContiguous(), nnz, COL_TYPE( row ) );
+    } );
+
+  SparsityPattern< COL_TYPE, INDEX_TYPE, BUFFER_TYPE > pattern;
+  pattern.template resizeFromRowCapacities< POLICY >( numRows, numRows, capacities.data() );
+
+  SparsityPatternView< COL_TYPE, INDEX_TYPE const, BUFFER_TYPE > const patternView = pattern.toView();
+  RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numRows ),
+                          [full, capacitiesView, patternView] ( INDEX_TYPE const row )
+    {
+      COL_TYPE const * const columns = full.getColumns( row );
+      INDEX_TYPE const nnz = full.numNonZeros( row );
+      patternView.insertNonZeros( row, columns + nnz - capacitiesView[ row ], columns + nnz );
+    } );
+
+  upper.template assimilate< POLICY >( std::move( pattern ) );
+
+  CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const upperView = upper.toViewConstSizes();
+  RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numRows ),
+                          [full, upperView] ( INDEX_TYPE const row )
+    {
+      INDEX_TYPE const nnz = upperView.numNonZeros( row );
+      INDEX_TYPE const first = full.numNonZeros( row ) - nnz;
+      T const * const fullEntries = full.getEntries( row );
+      T * const entries = upperView.getEntries( row );
+      for( INDEX_TYPE i = 0; i < nnz; ++i )
+      { entries[ i ] = fullEntries[ first + i ]; }
+    } );
+}
+
+/**
+ * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+ * @tparam T The type of the entries in the matrix.
+ * @tparam COL_TYPE The integer used to enumerate the columns.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @brief Expand a symmetric matrix stored as its diagonal and upper triangle, see upperTriangle.
+ * @param upper The diagonal and upper triangle of the matrix.
+ * @param full The matrix with both triangles, it is cleared and every row is compressed.
+ * @param numBlocks The number of blocks the rows of @p upper are split into, this does not change the result.
+ * @details The lower triangle is the transpose of the strict upper triangle, which is computed
+ *   with the same deterministic transpose as sparseMatrixOps::transpose.
+ */
+template< typename POLICY, typename T, typename COL_TYPE, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+void symmetricToFull( CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const & upper,
+                      CRSMatrix< T, COL_TYPE, INDEX_TYPE, BUFFER_TYPE > & full,
+                      INDEX_TYPE const numBlocks=internal::defaultNumTransposeBlocks( POLICY {} ) )
+{
+  LVARRAY_ERROR_IF_NE_MSG( upper.numRows(), upper.numColumns(), "The matrix must be square." );
+  INDEX_TYPE const numRows = upper.numRows();
+
+  // The entries above the diagonal, their transpose is the lower triangle.
+  auto const getStrictUpper = [upper] ( INDEX_TYPE const row )
+  {
+    COL_TYPE const * const columns = upper.getColumns( row );
+    INDEX_TYPE const nnz = upper.numNonZeros( row );
+    INDEX_TYPE const first = sortedArrayManipulation::find( columns, nnz, COL_TYPE( row + 1 ) );
+    return RAJA::make_span( columns + first, nnz - first );
+  };
+
+  internal::Transposer< POLICY, INDEX_TYPE, BUFFER_TYPE > transposer( numRows, numRows, numBlocks, getStrictUpper );
+
+  Array< COL_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > lowerColumns;
+  Array< T, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > lowerEntries( transposer.numEntries() );
+  lowerColumns.resizeWithoutInitializationOrDestruction( transposer.numEntries() );
+  ArrayView< COL_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const lowerColumnsView = lowerColumns.toView();
+  ArrayView< T, 1, 0, INDEX_TYPE, BUFFER_TYPE > const lowerEntriesView = lowerEntries.toView();
+  transposer.fill( getStrictUpper,
+                   [upper, getStrictUpper, lowerColumnsView, lowerEntriesView]
+                     ( INDEX_TYPE const row, INDEX_TYPE const i, INDEX_TYPE, INDEX_TYPE const pos )
+    {
+      INDEX_TYPE const first = upper.numNonZeros( row ) - getStrictUpper( row ).size();
+      lowerColumnsView[ pos ] = row;
+      lowerEntriesView[ pos ] = upper.getEntries( row )[ first + i ];
+    } );
+
+  INDEX_TYPE const * const lowerOffsets = transposer.getOffsets();
+  Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > capacities;
+  capacities.resizeWithoutInitializationOrDestruction( numRows );
+  ArrayView< INDEX_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const capacitiesView = capacities.toView();
+  RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numRows ),
+                          [upper, lowerOffsets, capacitiesView] ( INDEX_TYPE const row )
+    { capacitiesView[ row ] = lowerOffsets[ row + 1 ] - lowerOffsets[ row ] + upper.numNonZeros( row ); } );
+
+  SparsityPattern< COL_TYPE, INDEX_TYPE, BUFFER_TYPE > pattern;
+  pattern.template resizeFromRowCapacities< POLICY >( numRows, numRows, capacities.data() );
+
+  // Every column of the lower triangle is less than every column of the upper triangle so both are appended.
+  SparsityPatternView< COL_TYPE, INDEX_TYPE const, BUFFER_TYPE > const patternView = pattern.toView();
+  RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numRows ),
+                          [upper, lowerOffsets, lowerColumnsView, patternView] ( INDEX_TYPE const row )
+    {
+      COL_TYPE const * const columns = lowerColumnsView.data();
+      patternView.insertNonZeros( row, columns + lowerOffsets[ row ], columns + lowerOffsets[ row + 1 ] );
+      patternView.insertNonZeros( row, upper.getColumns( row ).begin(), upper.getColumns( row ).end() );
+    } );
+
+  full.template assimilate< POLICY >( std::move( pattern ) );
+
+  CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const fullView = full.toViewConstSizes();
+  RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numRows ),
+                          [upper, lowerOffsets, lowerEntriesView, fullView] ( INDEX_TYPE const row )
+    {
+      T * const entries = fullView.getEntries( row );
+      INDEX_TYPE const numLower = lowerOffsets[ row + 1 ] - lowerOffsets[ row ];
+      for( INDEX_TYPE i = 0; i < numLower; ++i )
+      { entries[ i ] = lowerEntriesView[ lowerOffsets[ row ] + i ]; }
+
+      for( INDEX_TYPE i = 0; i < upper.numNonZeros( row ); ++i )
+      { entries[ numLower + i ] = upper.getEntries( row )[ i ]; }
+    } );
+}
+
+/**
+ * @tparam AtomicPolicy The policy to use when adding to the values.
+ * @tparam T The type of the entries in the matrix.
+ * @tparam COL_TYPE The integer used to enumerate the columns.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @brief Add to a symmetric matrix stored as its diagonal and upper triangle, see upperTriangle.
+ * @param upper The diagonal and upper triangle of the matrix, the entries must already exist.
+ * @param row The row to add to.
+ * @param cols The columns to add to, unsorted, of length @p nCols.
+ * @param vals The values to add, of length @p nCols.
+ * @param nCols The number of columns to add to.
+ * @details A column less than @p row is added to its transposed entry. Each off diagonal entry of the
+ *   symmetric matrix must only be added to once, so to assemble a symmetric element matrix add
+ *   the diagonal and upper triangle of the element matrix. Depending on the global numbering of the
+ *   element some of these are below the diagonal of @p upper. Each entry is found with a binary search.
+ */
+template< typename AtomicPolicy, typename T, typename COL_TYPE, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+LVARRAY_HOST_DEVICE inline
+void addToRowSymmetric( CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const & upper,
+                        INDEX_TYPE const row,
+                        COL_TYPE const * const LVARRAY_RESTRICT cols,
+                        T const * const LVARRAY_RESTRICT vals,
+                        INDEX_TYPE const nCols )
+{
+  for( INDEX_TYPE i = 0; i < nCols; ++i )
+  {
+    INDEX_TYPE const storedRow = cols[ i ] < row ? cols[ i ] : row;
+    COL_TYPE const storedColumn = cols[ i ] < row ? COL_TYPE( row ) : cols[ i ];
+
+    INDEX_TYPE const nnz = upper.numNonZeros( storedRow );
+    INDEX_TYPE const pos = sortedArrayManipulation::find( upper.getColumns( storedRow ).dataIfContiguous(), nnz, storedColumn );
+    LVARRAY_ASSERT_GT( nnz, pos );
+    LVARRAY_ASSERT_EQ( upper.getColumns( storedRow )[ pos ], storedColumn );
+
+    LvArray::internal::atomicAdd( AtomicPolicy{}, &upper.getEntries( storedRow )[ pos ], vals[ i ] );
+  }
+}
+
+/**
+ * @tparam POLICY The RAJA policy to use.
+ * @tparam AtomicPolicy The policy to use when adding to @p y.
+ * @tparam T The type of the entries in the matrix.
+ * @tparam COL_TYPE The integer used to enumerate the columns.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @tparam X The type of the values in @p x.
+ * @tparam Y The type of the values in @p y.
+ * @brief Compute @code y = A x @endcode where A is a symmetric matrix stored as its diagonal and upper triangle.
+ * @param upper The diagonal and upper triangle of A, see upperTriangle.
+ * @param x The vector to multiply, of length @code upper.numColumns() @endcode.
+ * @param y The result, of length @code upper.numRows() @endcode.
+ * @details Each stored entry is read once and applied as both @c A( i, j ) and @c A( j, i ), so this
+ *   reads about half the matrix data of multiply on the full matrix. The contributions of the lower
+ *   triangle are scattered into @p y, so with a parallel policy they need atomics and the order of
+ *   the floating point additions, and so the result, can vary between runs. On the host atomic adds
+ *   of floating point values are compare and swap loops, so in parallel this can be slower than
+ *   multiply on the full matrix and the savings are mostly in memory.
+ */
+template< typename POLICY,
+          typename AtomicPolicy,
+          typename T,
+          typename COL_TYPE,
+          typename INDEX_TYPE,
+          template< typename > class BUFFER_TYPE,
+          typename X,
+          typename Y >
+void multiplySymmetric( CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const & upper,
+                        ArrayView< X const, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & x,
+                        ArrayView< Y, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & y )
+{
+  using AccumulationType = std::common_type_t< T, X, Y >;
+
+  LVARRAY_ERROR_IF_NE_MSG( upper.numRows(), upper.numColumns(), "The matrix must be square." );
+  LVARRAY_ERROR_IF_NE( x.size(), upper.numColumns() );
+  LVARRAY_ERROR_IF_NE( y.size(), upper.numRows() );
+
+  y.template setValues< POLICY >( Y( 0 ) );
+
+  RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, upper.numRows() ),
+                          [upper, x, y] LVARRAY_HOST_DEVICE ( INDEX_TYPE const row )
+    {
+      INDEX_TYPE const nnz = upper.numNonZeros( row );
+      COL_TYPE const * const LVARRAY_RESTRICT columns = upper.getColumns( row );
+      T const * const LVARRAY_RESTRICT entries = upper.getEntries( row );
+      AccumulationType const xRow = x[ row ];
+
+      AccumulationType sum = 0;
+      for( INDEX_TYPE i = 0; i < nnz; ++i )
+      {
+        AccumulationType const entry = entries[ i ];
+        sum += entry * AccumulationType( x[ columns[ i ] ] );
+
+        if( columns[ i ] != row )
+        { LvArray::internal::atomicAdd( AtomicPolicy{}, &y[ columns[ i ] ], Y( entry * xRow ) ); }
+      }
+
+      LvArray::internal::atomicAdd( AtomicPolicy{}, &y[ row ], Y( sum ) );
+    } );
+}
+
+/**
+ * @tparam COL_TYPE The integer used to enumerate the columns.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @brief Compute the reverse Cuthill-McKee ordering of the graph of a sparsity pattern, this reduces the bandwidth.
+ * @param graph The sparsity pattern, it must be square and structurally symmetric. For a non symmetric
+ *   pattern use the sum of it and its transpose. The diagonal entries are ignored.
+ * @param permutation The resulting permutation, @c permutation[ i ] is the new index of row and column @c i.
+ *   It can be given to permute.
+ * @note This is a serial breadth first search on the host.
+ */
+template< typename COL_TYPE, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+void reverseCuthillMcKee( SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const & graph,
+                          ArrayView< INDEX_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & permutation )
+{
+  LVARRAY_ERROR_IF_NE_MSG( graph.numRows(), graph.numColumns(), "The graph must be square." );
+  internal::reverseCuthillMcKee( graph.numRows(),
+                                 [graph] ( INDEX_TYPE const row ) { return graph.getColumns( row ); },
+                                 permutation );
+}
+
+/**
+ * @tparam T The type of the values in the arrays, used to enumerate the nodes.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @brief Compute the reverse Cuthill-McKee ordering of a graph stored as an ArrayOfArrays, this reduces the bandwidth.
+ * @param graph The adjacency of each node, it must be symmetric. Entries referring to the node itself are ignored.
+ * @param permutation The resulting permutation, @c permutation[ i ] is the new index of node @c i.
+ * @note This is a serial breadth first search on the host.
+ */
+template< typename T, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+void reverseCuthillMcKee( ArrayOfArraysView< T const, INDEX_TYPE const, true, BUFFER_TYPE > const & graph,
+                          ArrayView< INDEX_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & permutation )
+{
+  static_assert( std::is_integral< T >::value, "The values of the ArrayOfArrays must be integral." );
+  internal::reverseCuthillMcKee( graph.size(),
+                                 [graph] ( INDEX_TYPE const row ) { return graph[ row ]; },
+                                 permutation );
+}
+
+/**
+ * @tparam T The type used to enumerate the rows.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @brief Color the elements of a mesh so that elements of the same color can be assembled concurrently.
+ * @param elemToRows The rows each element writes to, for example the element to node map.
+ *   The values in an array do not need to be sorted or unique.
+ * @param numRows The number of rows.
+ * @param colorToElems The elements of each color, it is cleared and array @c c contains
+ *   the sorted elements of color @c c. No two elements of the same color share a row.
+ * @details Within a color the rows of the matrix are written by at most one element so the
+ *   assembly can use RAJA::seq_atomic, see forAllByColor.
+ * @note This is a serial greedy coloring on the host.
+ */
+template< typename T, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+void colorElements( ArrayOfArraysView< T const, INDEX_TYPE const, true, BUFFER_TYPE > const & elemToRows,
+                    INDEX_TYPE const numRows,
+                    ArrayOfArrays< INDEX_TYPE, INDEX_TYPE, BUFFER_TYPE > & colorToElems )
+{
+  static_assert( std::is_integral< T >::value, "The values of the ArrayOfArrays must be integral." );
+  internal::colorElements< T >( elemToRows.size(),
+                                numRows,
+                                [elemToRows] ( INDEX_TYPE const elem ) { return elemToRows[ elem ]; },
+                                colorToElems );
+}
+
+/**
+ * @tparam T The type used to enumerate the rows.
+ * @tparam USD The unit stride dimension of @p elemToRows.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @brief Color the elements of a mesh so that elements of the same color can be assembled concurrently.
+ * @param elemToRows The rows each element writes to, @c elemToRows( e, i ) is the @c i th row of element @c e.
+ * @param numRows The number of rows.
+ * @param colorToElems The elements of each color, it is cleared and array @c c contains
+ *   the sorted elements of color @c c. No two elements of the same color share a row.
+ * @note This is a serial greedy coloring on the host.
+ */
+template< typename T, int USD, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+void colorElements( ArrayView< T const, 2, USD, INDEX_TYPE, BUFFER_TYPE > const & elemToRows,
+                    INDEX_TYPE const numRows,
+                    ArrayOfArrays< INDEX_TYPE, INDEX_TYPE, BUFFER_TYPE > & colorToElems )
+{
+  static_assert( std::is_integral< T >::value, "The values of the ArrayView must be integral." );
+  internal::colorElements< T >( elemToRows.size( 0 ),
+                                numRows,
+                                [elemToRows] ( INDEX_TYPE const elem ) { return elemToRows[ elem ]; },
+                                colorToElems );
+}
+
+/**
+ * @tparam POLICY The RAJA policy to use.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @tparam LAMBDA The type of @p body.
+ * @brief Call @p body on every element, one color at a time.
+ * @param colorToElems The elements of each color, see colorElements.
+ * @param body The function to call, it is called as @code body( elem ) @endcode and must be
+ *   callable on the device when @p POLICY is a device policy.
+ * @details The colors are processed in order and the elements of a color are processed in
+ *   parallel with @p POLICY, so there are as many kernel launches as there are colors.
+ *   @code
+ *   sparseMatrixOps::colorElements( elemToNode, numNodes, colorToElems );
+ *   sparseMatrixOps::forAllByColor< POLICY >( colorToElems.toViewConst(), [=] ( int const elem )
+ *   {
+ *     for( int i = 0; i < numNodesPerElem; ++i )
+ *     { matrix.addToRowBinarySearchUnsorted< RAJA::seq_atomic >( elemToNode( elem, i ), ... ); }
+ *   } );
+ *   @endcode
+ */
+template< typename POLICY, typename INDEX_TYPE, template< typename > class BUFFER_TYPE, typename LAMBDA >
+void forAllByColor( ArrayOfArraysView< INDEX_TYPE const, INDEX_TYPE const, true, BUFFER_TYPE > const & colorToElems,
+                    LAMBDA && body )
+{
+  for( INDEX_TYPE color = 0; color < colorToElems.size(); ++color )
+  {
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, colorToElems.sizeOfArray( color ) ),
+                            [colorToElems, color, body] LVARRAY_HOST_DEVICE ( INDEX_TYPE const i )
+      { body( colorToElems( color, i ) ); } );
+  }
+}
+
+/**
+ * @tparam POLICY The RAJA policy to use.
+ * @tparam T The type of the values in the array.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @brief Permute the values of an array, @code dst[ permutation[ i ] ] = src[ i ] @endcode.
+ * @param src The array to permute.
+ * @param permutation The permutation, @c permutation[ i ] is the new index of value @c i.
+ * @param dst The permuted array, it must be the same size as @p src.
+ */
+template< typename POLICY, typename T, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+void permute( ArrayView< T const, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & src,
+              ArrayView< INDEX_TYPE const, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & permutation,
+              ArrayView< T, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & dst )
+{
+  LVARRAY_ERROR_IF_NE( permutation.size(), src.size() );
+  LVARRAY_ERROR_IF_NE( dst.size(), src.size() );
+
+  RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, src.size() ),
+                          [src, permutation, dst] LVARRAY_HOST_DEVICE ( INDEX_TYPE const i )
+    { dst[ permutation[ i ] ] = src[ i ]; } );
+}
+
+/**
+ * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+ * @tparam T The type of the values in the arrays.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @brief Permute the arrays of an ArrayOfArrays, array @c i of @p src becomes array @c permutation[ i ] of @p dst.
+ * @param src The ArrayOfArrays to permute.
+ * @param permutation The permutation, @c permutation[ i ] is the new index of array @c i.
+ * @param dst The permuted ArrayOfArrays, it is cleared and each array is filled to capacity.
+ * @note The values in the arrays are not modified. For an adjacency use permute on a SparsityPattern
+ *   which also renumbers the columns.
+ */
+template< typename POLICY, typename T, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+void permute( ArrayOfArraysView< T const, INDEX_TYPE const, true, BUFFER_TYPE > const & src,
+              ArrayView< INDEX_TYPE const, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & permutation,
+              ArrayOfArrays< T, INDEX_TYPE, BUFFER_TYPE > & dst )
+{
+  INDEX_TYPE const numArrays = src.size();
+  LVARRAY_ERROR_IF_NE( permutation.size(), numArrays );
+
+  Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > capacities;
+  capacities.resizeWithoutInitializationOrDestruction( numArrays );
+  ArrayView< INDEX_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const capacitiesView = capacities.toView();
+  RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numArrays ),
+                          [src, permutation, capacitiesView] ( INDEX_TYPE const i )
+    { capacitiesView[ permutation[ i ] ] = src.sizeOfArray( i ); } );
+
+  dst.template resizeFromCapacities< POLICY >( numArrays, capacities.data() );
+
+  ArrayOfArraysView< T, INDEX_TYPE const, false, BUFFER_TYPE > const dstView = dst.toView();
+  RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numArrays ),
+                          [src, permutation, dstView] ( INDEX_TYPE const i )
+    { dstView.appendToArray( permutation[ i ], src[ i ].begin(), src[ i ].end() ); } );
+}
+
+/**
+ * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+ * @tparam COL_TYPE The integer used to enumerate the columns.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @brief Apply a symmetric permutation to a sparsity pattern.
+ * @param src The sparsity pattern to permute, it must be square.
+ * @param permutation The permutation, @c permutation[ i ] is the new index of row and column @c i.
+ * @param dst The permuted sparsity pattern, it is cleared and every row is compressed.
+ */
+template< typename POLICY, typename COL_TYPE, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+void permute( SparsityPatternView< COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const & src,
+              ArrayView< INDEX_TYPE const, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & permutation,
+              SparsityPattern< COL_TYPE, INDEX_TYPE, BUFFER_TYPE > & dst )
+{
+  INDEX_TYPE const numRows = src.numRows();
+  LVARRAY_ERROR_IF_NE_MSG( numRows, src.numColumns(), "A symmetric permutation requires a square matrix." );
+  LVARRAY_ERROR_IF_NE( permutation.size(), numRows );
+
+  Array< INDEX_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > capacities;
+  capacities.resizeWithoutInitializationOrDestruction( numRows );
+  ArrayView< INDEX_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const capacitiesView = capacities.toView();
+  RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numRows ),
+                          [src, permutation, capacitiesView] ( INDEX_TYPE const row )
+    { capacitiesView[ permutation[ row ] ] = src.numNonZeros( row ); } );
+
+  dst.template resizeFromRowCapacities< POLICY >( numRows, numRows, capacities.data() );
+
+  // Map the columns of each row into the space reserved for the new row, sort them and insert them.
+  Array< COL_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > scratch;
+  scratch.resizeWithoutInitializationOrDestruction( src.numNonZeros() );
+  ArrayView< COL_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const scratchView = scratch.toView();
+
+  SparsityPatternView< COL_TYPE, INDEX_TYPE const, BUFFER_TYPE > const dstView = dst.toView();
+  RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, numRows ),
+                          [src, permutation, scratchView, dstView] ( INDEX_TYPE const row )
+    {
+      INDEX_TYPE const newRow = permutation[ row ];
+      COL_TYPE * const columns = scratchView.data() + dstView.getOffsets()[ newRow ];
+      INDEX_TYPE const nnz = src.numNonZeros( row );
+      for( INDEX_TYPE i = 0; i < nnz; ++i )
+      { columns[ i ] = permutation[ src.getColumns( row )[ i ] ]; }
+
+      sortedArrayManipulation::makeSorted( columns, columns + nnz );
+      dstView.insertNonZeros( newRow, columns, columns + nnz );
+    } );
+}
+
+/**
+ * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+ * @tparam T The type of the entries in the matrix.
+ * @tparam COL_TYPE The integer used to enumerate the columns.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @brief Apply a symmetric permutation to a matrix, @code dst( p[ i ], p[ j ] ) = src( i, j ) @endcode.
+ * @param src The matrix to permute, it must be square.
+ * @param permutation The permutation, @c permutation[ i ] is the new index of row and column @c i.
+ * @param dst The permuted matrix, it is cleared and every row is compressed.
+ */
+template< typename POLICY, typename T, typename COL_TYPE, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
+void permute( CRSMatrixView< T const, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const & src,
+              ArrayView< INDEX_TYPE const, 1, 0, INDEX_TYPE, BUFFER_TYPE > const & permutation,
+              CRSMatrix< T, COL_TYPE, INDEX_TYPE, BUFFER_TYPE > & dst )
+{
+  SparsityPattern< COL_TYPE, INDEX_TYPE, BUFFER_TYPE > pattern;
+  permute< POLICY >( src.toSparsityPatternView(), permutation, pattern );
+  dst.template assimilate< POLICY >( std::move( pattern ) );
+
+  CRSMatrixView< T, COL_TYPE const, INDEX_TYPE const, BUFFER_TYPE > const dstView = dst.toViewConstSizes();
+  RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, src.numRows() ),
+                          [src, permutation, dstView] ( INDEX_TYPE const row )
+    {
+      INDEX_TYPE const newRow = permutation[ row ];
+      COL_TYPE const * const dstColumns = dstView.getColumns( newRow );
+      T * const dstEntries = dstView.getEntries( newRow );
+      INDEX_TYPE const nnz = src.numNonZeros( row );
+      for( INDEX_TYPE i = 0; i < nnz; ++i )
+      {
+        COL_TYPE const newColumn = permutation[ src.getColumns( row )[ i ] ];
+        dstEntries[ sortedArrayManipulation::find( dstColumns, nnz, newColumn ) ] = src.getEntries( row )[ i ];
+      }
+    } );
+}
+
+} // namespace sparseMatrixOps
+} // namespace LvArray
@@ -0,0 +1,363 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC and LvArray contributors.
+ * All rights reserved.
+ * See the LICENSE file for details.
+ * SPDX-License-Identifier: (BSD-3-Clause)
+ */
+
+/**
+ * @file sparseMatrixOpsHelpers.hpp
+ * @brief Contains helper classes and functions for the sparseMatrixOps routines and CRSMatrix::fromTriplets.
+ */
+
+#pragma once
+
+// Source includes
+#include "Array.hpp"
+#include "math.hpp"
+
+// TPL includes
+#include <RAJA/RAJA.hpp>
+
+// System includes
+#include <cstdint>
+#include <vector>
+
+#if defined(RAJA_ENABLE_OPENMP)
+  #include <omp.h>
+#endif
+
+namespace LvArray
+{
+namespace sparseMatrixOps
+{
+namespace internal
+{
+
+/**
+ * @tparam POLICY The RAJA policy that will be used.
+ * @brief @return The default number of blocks the rows are split into by transpose.
+ */
+template< typename POLICY >
+inline int defaultNumTransposeBlocks( POLICY )
+{ return 1; }
+
+#if defined(RAJA_ENABLE_OPENMP)
+/**
+ * @brief @return The default number of blocks the rows are split into by transpose, one per thread.
+ */
+inline int defaultNumTransposeBlocks( RAJA::omp_parallel_for_exec )
+{ return omp_get_max_threads(); }
+#endif
+
+/**
+ * @tparam COL_TYPE The integer used to enumerate the columns.
+ * @class RowAccumulator
+ * @brief Gathers the distinct columns of a row of a product with an open addressing hash table.
+ * @details The table is sized from an upper bound on the number of distinct columns in the row, so
+ *   the memory used is proportional to the longest row and not to the number of scalar products
+ *   or the number of columns. A single accumulator is reused for every row of a block of rows.
+ */
+template< typename COL_TYPE >
+class RowAccumulator
+{
+public:
+
+  /**
+   * @brief Empty the accumulator and make room for at least @p maxDistinct distinct columns.
+   * @param maxDistinct An upper bound on the number of distinct columns that will be inserted.
+   */
+  void clear( std::ptrdiff_t const maxDistinct )
+  {
+    std::size_t tableSize = 2;
+    m_shift = 63;
+    while( tableSize < std::size_t( 2 * maxDistinct ) )
+    {
+      tableSize *= 2;
+      --m_shift;
+    }
+
+    m_table.assign( tableSize, 0 );
+    m_columns.clear();
+  }
+
+  /**
+   * @brief Insert @p col if it isn't already present.
+   * @param col The column to insert.
+   */
+  void insert( COL_TYPE const col )
+  {
+    // Fibonacci hashing, see ColumnIndexView::hash. The table is at most half full so this terminates.
+    std::size_t const mask = m_table.size() - 1;
+    std::size_t slot = static_cast< std::size_t >( ( static_cast< std::uint64_t >( col ) * std::uint64_t( 0x9E3779B97F4A7C15 ) ) >> m_shift );
+    while( true )
+    {
+      std::size_t const entry = m_table[ slot ];
+      if( entry == 0 )
+      {
+        m_columns.push_back( col );
+        m_table[ slot ] = m_columns.size();
+        return;
+      }
+
+      if( m_columns[ entry - 1 ] == col )
+      { return; }
+
+      slot = ( slot + 1 ) & mask;
+    }
+  }
+
+  /**
+   * @return The number of distinct columns inserted since the last call to clear.
+   */
+  std::ptrdiff_t size() const
+  { return m_columns.size(); }
+
+  /**
+   * @return A pointer to the distinct columns, in the order they were first inserted.
+   */
+  COL_TYPE * data()
+  { return m_columns.data(); }
+
+private:
+  /// The hash table, each entry is one plus the position of the column in m_columns, or zero if empty.
+  std::vector< std::size_t > m_table;
+
+  /// The distinct columns.
+  std::vector< COL_TYPE > m_columns;
+
+  /// 64 minus the base two logarithm of the size of the table.
+  int m_shift = 63;
+};
+
+/**
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @brief @return The first row in block @p block when splitting @p numRows rows into @p numBlocks blocks.
+ * @param numRows The number of rows.
+ * @param numBlocks The number of blocks.
+ * @param block The block.
+ */
+template< typename INDEX_TYPE >
+LVARRAY_HOST_DEVICE inline
+INDEX_TYPE blockBegin( INDEX_TYPE const numRows, INDEX_TYPE const numBlocks, INDEX_TYPE const block )
+{
+  INDEX_TYPE const rowsPerBlock = ( numRows + numBlocks - 1 ) / numBlocks;
+  return math::min( numRows, block * rowsPerBlock );
+}
+
+/**
+ * @class Transposer
+ * @brief Computes where each entry of a matrix goes in its transpose.
+ * @tparam POLICY The RAJA policy to use. Should NOT be a device policy.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @tparam BUFFER_TYPE A class template that implements the buffer interface.
+ * @tparam OFFSET_TYPE The integer used for the counts and offsets, it may be wider than INDEX_TYPE.
+ * @details The rows are split into contiguous blocks. Each block counts how many of its
+ *   entries fall in each column. A scan over these counts gives every (column, block) pair
+ *   its own range in the transpose, so the blocks can be filled in parallel without atomics.
+ *   Since the blocks are ordered by row and each block is traversed in order each row of the
+ *   transpose is sorted and the result does not depend on the number of blocks. The counts take
+ *   @code numColumns * numBlocks @endcode indices, so the number of blocks is capped to keep this
+ *   at most the number of entries plus @c numColumns, otherwise a wide matrix with few entries per
+ *   column would need more scratch space than the matrix itself.
+ */
+template< typename POLICY, typename INDEX_TYPE, template< typename > class BUFFER_TYPE, typename OFFSET_TYPE=INDEX_TYPE >
+class Transposer
+{
+public:
+
+  /**
+   * @tparam ROW_GETTER The type of @p getRow.
+   * @brief Count the entries in each row of the transpose.
+   * @param numRows The number of rows of the matrix.
+   * @param numColumns The number of columns of the matrix.
+   * @param numBlocks The maximum number of blocks to split the rows into.
+   * @param getRow A function that returns a one dimensional slice of the columns of a row.
+   */
+  template< typename ROW_GETTER >
+  Transposer( INDEX_TYPE const numRows,
+              INDEX_TYPE const numColumns,
+              INDEX_TYPE const numBlocks,
+              ROW_GETTER const & getRow ):
+    m_numRows( numRows ),
+    m_numColumns( numColumns ),
+    m_numBlocks( numBlocksToUse( numRows, numColumns, numBlocks, getRow ) ),
+    m_blockOffsets( OFFSET_TYPE( m_numColumns ) * m_numBlocks ),
+    m_offsets( m_numColumns + 1 )
+  {
+    ArrayView< OFFSET_TYPE, 1, 0, OFFSET_TYPE, BUFFER_TYPE > const blockOffsets = m_blockOffsets.toView();
+    ArrayView< OFFSET_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const offsets = m_offsets.toView();
+    INDEX_TYPE const nRows = m_numRows;
+    INDEX_TYPE const nBlocks = m_numBlocks;
+
+    // Count the entries of each block in each column.
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, nBlocks ),
+                            [nRows, nBlocks, blockOffsets, getRow] ( INDEX_TYPE const block )
+      {
+        INDEX_TYPE const end = blockBegin( nRows, nBlocks, block + 1 );
+        for( INDEX_TYPE row = blockBegin( nRows, nBlocks, block ); row < end; ++row )
+        {
+          auto const columns = getRow( row );
+          for( OFFSET_TYPE i = 0; i < columns.size(); ++i )
+          { ++blockOffsets[ OFFSET_TYPE( columns[ i ] ) * nBlocks + block ]; }
+        }
+      } );
+
+    // Turn the counts into offsets within each row of the transpose and then compute the row offsets.
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, m_numColumns ),
+                            [nBlocks, blockOffsets, offsets] ( INDEX_TYPE const column )
+      {
+        OFFSET_TYPE offset = 0;
+        for( INDEX_TYPE block = 0; block < nBlocks; ++block )
+        {
+          OFFSET_TYPE const count = blockOffsets[ OFFSET_TYPE( column ) * nBlocks + block ];
+          blockOffsets[ OFFSET_TYPE( column ) * nBlocks + block ] = offset;
+          offset += count;
+        }
+
+        offsets[ column + 1 ] = offset;
+      } );
+
+    RAJA::inclusive_scan_inplace< POLICY >( RAJA::make_span< OFFSET_TYPE * >( offsets.data() + 1, m_numColumns ) );
+  }
+
+  /**
+   * @return A pointer to the offset of each row of the transpose, with an entry for the end.
+   */
+  OFFSET_TYPE const * getOffsets() const
+  { return m_offsets.data(); }
+
+  /**
+   * @return The number of entries in the transpose.
+   */
+  OFFSET_TYPE numEntries() const
+  { return m_offsets[ m_numColumns ]; }
+
+  /**
+   * @tparam ROW_GETTER The type of @p getRow.
+   * @tparam FILL The type of @p fill.
+   * @brief Call @p fill for every entry of the matrix with its position in the transpose.
+   * @param getRow The same function given to the constructor.
+   * @param fill The function to call, it is called as @code fill( row, i, column, pos ) @endcode where
+   *   @c column is the @c i th column of @c row and @c pos is its position in the transpose when the rows of
+   *   the transpose are stored contiguously, row @c column spans the positions given by getOffsets.
+   * @note This modifies the internal offsets so it can only be called once.
+   */
+  template< typename ROW_GETTER, typename FILL >
+  void fill( ROW_GETTER const & getRow, FILL const & fill )
+  {
+    ArrayView< OFFSET_TYPE, 1, 0, OFFSET_TYPE, BUFFER_TYPE > const blockOffsets = m_blockOffsets.toView();
+    ArrayView< OFFSET_TYPE const, 1, 0, INDEX_TYPE, BUFFER_TYPE > const offsets = m_offsets.toViewConst();
+    INDEX_TYPE const nRows = m_numRows;
+    INDEX_TYPE const nBlocks = m_numBlocks;
+
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, nBlocks ),
+                            [nRows, nBlocks, blockOffsets, offsets, getRow, fill] ( INDEX_TYPE const block )
+      {
+        INDEX_TYPE const end = blockBegin( nRows, nBlocks, block + 1 );
+        for( INDEX_TYPE row = blockBegin( nRows, nBlocks, block ); row < end; ++row )
+        {
+          auto const columns = getRow( row );
+          for( OFFSET_TYPE i = 0; i < columns.size(); ++i )
+          {
+            INDEX_TYPE const column = columns[ i ];
+            fill( row, i, column, offsets[ column ] + blockOffsets[ OFFSET_TYPE( column ) * nBlocks + block ]++ );
+          }
+        }
+      } );
+  }
+
+private:
+
+  /**
+   * @tparam ROW_GETTER The type of @p getRow.
+   * @return The number of blocks to split the rows into, at most @p numBlocks and few enough
+   *   that the block counts take at most the number of entries plus @p numColumns indices.
+   * @param numRows The number of rows of the matrix.
+   * @param numColumns The number of columns of the matrix.
+   * @param numBlocks The maximum number of blocks.
+   * @param getRow A function that returns a one dimensional slice of the columns of a row.
+   */
+  template< typename ROW_GETTER >
+  static INDEX_TYPE numBlocksToUse( INDEX_TYPE const numRows,
+                                    INDEX_TYPE const numColumns,
+                                    INDEX_TYPE const numBlocks,
+                                    ROW_GETTER const & getRow )
+  {
+    INDEX_TYPE const maxBlocks = math::max( INDEX_TYPE( 1 ), math::min( numBlocks, numRows ) );
+    if( maxBlocks == 1 )
+    { return 1; }
+
+    // Count the entries of each of the largest blocks in parallel.
+    Array< OFFSET_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > blockSizes( maxBlocks );
+    ArrayView< OFFSET_TYPE, 1, 0, INDEX_TYPE, BUFFER_TYPE > const blockSizesView = blockSizes.toView();
+    RAJA::forall< POLICY >( RAJA::TypedRangeSegment< INDEX_TYPE >( 0, maxBlocks ),
+                            [numRows, maxBlocks, blockSizesView, getRow] ( INDEX_TYPE const block )
+      {
+        INDEX_TYPE const end = blockBegin( numRows, maxBlocks, block + 1 );
+        for( INDEX_TYPE row = blockBegin( numRows, maxBlocks, block ); row < end; ++row )
+        { blockSizesView[ block ] += getRow( row ).size(); }
+      } );
+
+    OFFSET_TYPE numEntries = 0;
+    for( INDEX_TYPE block = 0; block < maxBlocks; ++block )
+    { numEntries += blockSizes[ block ]; }
+
+    OFFSET_TYPE const blocksForEntries = numEntries / math::max( OFFSET_TYPE( numColumns ), OFFSET_TYPE( 1 ) ) + 1;
+    return INDEX_TYPE( math::min( OFFSET_TYPE( maxBlocks ), blocksForEntries ) );
+  }
+
+  /// The number of rows of the matrix.
+  INDEX_TYPE const m_numRows;
+
+  /// The number of columns of the matrix.
+  INDEX_TYPE const m_numColumns;
+
+  /// The number of blocks the rows are split into.
+  INDEX_TYPE const m_numBlocks;
+
+  /// The offset of each block in each row of the transpose, stored column major.
+  Array< OFFSET_TYPE, 1, RAJA::PERM_I, OFFSET_TYPE, BUFFER_TYPE > m_blockOffsets;
+
+  /// The offset of each row of the transpose.
+  Array< OFFSET_TYPE, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE > m_offsets;
+};
+
+/**
+ * @tparam COL_TYPE The integer used to enumerate the columns.
+ * @tparam T The type of the values.
+ * @tparam INDEX_TYPE The integer to use for indexing.
+ * @brief Sum the values of duplicate columns in a row sorted by column.
+ * @param columns The sorted columns of the row, of length @p length.
+ * @param values The values of the row, of length @p length.
+ * @param length The number of entries in the row.
+ * @return The number of unique columns, the first that many columns and values hold the result.
+ * @details The values of a column are summed in the order they appear.
+ */
+template< typename COL_TYPE, typename T, typename INDEX_TYPE >
+LVARRAY_HOST_DEVICE inline
+INDEX_TYPE sumDuplicates( COL_TYPE * const LVARRAY_RESTRICT columns,
+                          T * const LVARRAY_RESTRICT values,
+                          INDEX_TYPE const length )
+{
+  INDEX_TYPE numUnique = 0;
+  for( INDEX_TYPE i = 0; i < length; ++i )
+  {
+    if( numUnique > 0 && columns[ numUnique - 1 ] == columns[ i ] )
+    {
+      values[ numUnique - 1 ] += values[ i ];
+    }
+    else
+    {
+      columns[ numUnique ] = columns[ i ];
+      values[ numUnique ] = values[ i ];
+      ++numUnique;
+    }
+  }
+
+  return numUnique;
+}
+
+} // namespace internal
+} // namespace sparseMatrixOps
+} // namespace LvArray
@@ -16,6 +16,7 @@
 #include <gtest/gtest.h>
 
 // System includes
+#include <algorithm>
 #include <vector>
 #include <random>
 
@@ -30,6 +31,7 @@ class ArrayOfArraysTest : public ::testing::Test
 public:
   using T = typename ARRAY_OF_ARRAYS::ValueType;
   using IndexType = typename ARRAY_OF_ARRAYS::IndexType;
+  using OffsetType = typename ARRAY_OF_ARRAYS::OffsetType;
 
   using ViewType = typeManipulation::ViewType< ARRAY_OF_ARRAYS >;
   using ViewTypeConstSizes = typeManipulation::ViewTypeConstSizes< ARRAY_OF_ARRAYS >;
@@ -244,9 +246,9 @@ public:
       capacity = rand( 0, maxCapacity );
     }
 
-    std::vector< IndexType > newOffsets( newSize + 1 );
+    std::vector< OffsetType > newOffsets( newSize + 1 );
 
-    IndexType totalOffset = 0;
+    OffsetType totalOffset = 0;
     for( IndexType i = 0; i < newSize; ++i )
     {
       newOffsets[i] = totalOffset;
@@ -491,6 +493,90 @@ public:
     COMPARE_TO_REFERENCE;
   }
 
+  template< typename POLICY >
+  void compressParallel( bool const outOfPlace )
+  {
+    COMPARE_TO_REFERENCE;
+
+    m_array.template compress< POLICY >( outOfPlace );
+    T const * const values = m_array[0];
+
+    IndexType curOffset = 0;
+    for( IndexType i = 0; i < m_array.size(); ++i )
+    {
+      ASSERT_EQ( m_array.sizeOfArray( i ), m_array.capacityOfArray( i ));
+
+      T const * const curValues = m_array[ i ];
+      ASSERT_EQ( values + curOffset, curValues );
+
+      curOffset += m_array.sizeOfArray( i );
+    }
+
+    if( outOfPlace )
+    { EXPECT_EQ( m_array.valueCapacity(), curOffset ); }
+
+    COMPARE_TO_REFERENCE;
+  }
+
+  template< typename POLICY >
+  void compressParallelCompressed()
+  {
+    compressParallel< POLICY >( false );
+
+    // Compressing again must leave every array in place.
+    T const * const values = m_array[ 0 ];
+    compressParallel< POLICY >( false );
+    EXPECT_EQ( m_array[ 0 ], values );
+
+    // Only the last few arrays have extra capacity, the leading arrays don't move.
+    for( IndexType i = m_array.size() - 5; i < m_array.size(); ++i )
+    { m_array.setCapacityOfArray( i, m_array.capacityOfArray( i ) + 3 ); }
+
+    T const * const newValues = m_array[ 0 ];
+    compressParallel< POLICY >( false );
+    EXPECT_EQ( m_array[ 0 ], newValues );
+  }
+
+  template< typename POLICY >
+  void sortEachArray( bool const unique )
+  {
+    COMPARE_TO_REFERENCE;
+
+    // Append arrays whose lengths span every sorting method, half of them have many duplicates.
+    for( IndexType i = 0; i < 60; ++i )
+    {
+      IndexType const arraySize = i % 3 == 0 ? rand( 0, 1000 ) : rand( 0, 20 );
+      IndexType const maxValue = i % 2 == 0 ? LARGE_NUMBER : 10;
+
+      std::vector< T > values;
+      for( IndexType j = 0; j < arraySize; ++j )
+      { values.emplace_back( rand( -maxValue, maxValue ) ); }
+
+      m_array.appendArray( values.begin(), values.end() );
+      m_ref.push_back( values );
+    }
+
+    COMPARE_TO_REFERENCE;
+
+    if( unique )
+    { m_array.template sortAndUniqueEachArray< POLICY >(); }
+    else
+    { m_array.template sortEachArray< POLICY >(); }
+
+    for( std::vector< T > & values : m_ref )
+    {
+      std::sort( values.begin(), values.end() );
+      if( unique )
+      { values.erase( std::unique( values.begin(), values.end() ), values.end() ); }
+    }
+
+    COMPARE_TO_REFERENCE;
+
+    m_array.template compress< POLICY >();
+
+    COMPARE_TO_REFERENCE;
+  }
+
   void fill()
   {
     COMPARE_TO_REFERENCE;
@@ -633,6 +719,7 @@ using ArrayOfArraysTestTypes = ::testing::Types<
   ArrayOfArrays< int, std::ptrdiff_t, MallocBuffer >
   , ArrayOfArrays< Tensor, std::ptrdiff_t, MallocBuffer >
   , ArrayOfArrays< TestString, std::ptrdiff_t, MallocBuffer >
+  , ArrayOfArrays< int, int, MallocBuffer, std::ptrdiff_t >
 #if defined(LVARRAY_USE_CHAI)
   , ArrayOfArrays< int, std::ptrdiff_t, ChaiBuffer >
   , ArrayOfArrays< Tensor, std::ptrdiff_t, ChaiBuffer >
@@ -876,6 +963,47 @@ TYPED_TEST( ArrayOfArraysTest, compress )
   }
 }
 
+TYPED_TEST( ArrayOfArraysTest, compressParallel )
+{
+  // With a large capacity per array the in place compress moves many arrays at once.
+  this->resize( 100, 40 );
+
+  for( int i = 0; i < 4; ++i )
+  {
+    this->appendToArray( 10 );
+    this->template compressParallel< serialPolicy >( i % 2 == 1 );
+#if defined(RAJA_ENABLE_OPENMP)
+    this->appendToArray( 10 );
+    this->template compressParallel< parallelHostPolicy >( i % 2 == 1 );
+#endif
+  }
+}
+
+TYPED_TEST( ArrayOfArraysTest, compressParallelCompressed )
+{
+  this->resize( 100, 10 );
+  this->appendToArray( 10 );
+  this->template compressParallelCompressed< serialPolicy >();
+#if defined(RAJA_ENABLE_OPENMP)
+  this->appendToArray( 10 );
+  this->template compressParallelCompressed< parallelHostPolicy >();
+#endif
+}
+
+TYPED_TEST( ArrayOfArraysTest, sortEachArray )
+{
+  this->resize( 20, 10 );
+  this->appendToArray( 10 );
+
+  for( int i = 0; i < 2; ++i )
+  {
+    this->template sortEachArray< serialPolicy >( i == 1 );
+#if defined(RAJA_ENABLE_OPENMP)
+    this->template sortEachArray< parallelHostPolicy >( i == 1 );
+#endif
+  }
+}
+
 TYPED_TEST( ArrayOfArraysTest, capacity )
 {
   this->resize( 100 );
@@ -917,8 +1045,8 @@ template< typename U, typename T >
 struct ToArray
 {};
 
-template< typename U, typename T, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
-struct ToArray< U, ArrayOfArrays< T, INDEX_TYPE, BUFFER_TYPE > >
+template< typename U, typename T, typename INDEX_TYPE, template< typename > class BUFFER_TYPE, typename OFFSET_TYPE >
+struct ToArray< U, ArrayOfArrays< T, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE > >
 {
   using OneD = Array< U, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE >;
   using OneDView = ArrayView< U, 1, 0, INDEX_TYPE, BUFFER_TYPE >;
@@ -1278,6 +1406,7 @@ using ArrayOfArraysViewTestTypes = ::testing::Types<
   std::pair< ArrayOfArrays< int, std::ptrdiff_t, MallocBuffer >, serialPolicy >
   , std::pair< ArrayOfArrays< Tensor, std::ptrdiff_t, MallocBuffer >, serialPolicy >
   , std::pair< ArrayOfArrays< TestString, std::ptrdiff_t, MallocBuffer >, serialPolicy >
+  , std::pair< ArrayOfArrays< int, int, MallocBuffer, std::ptrdiff_t >, serialPolicy >
 #if defined(LVARRAY_USE_CHAI)
   , std::pair< ArrayOfArrays< int, std::ptrdiff_t, ChaiBuffer >, serialPolicy >
   , std::pair< ArrayOfArrays< Tensor, std::ptrdiff_t, ChaiBuffer >, serialPolicy >
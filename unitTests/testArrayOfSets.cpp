@@ -18,6 +18,8 @@
 // System includes
 #include <vector>
 #include <random>
+#include <algorithm>
+#include <iterator>
 
 namespace LvArray
 {
@@ -28,12 +30,13 @@ template< typename U, typename T >
 struct ToArray
 {};
 
-template< typename U, typename T, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
-struct ToArray< U, ArrayOfSets< T, INDEX_TYPE, BUFFER_TYPE > >
+template< typename U, typename T, typename INDEX_TYPE, template< typename > class BUFFER_TYPE, typename OFFSET_TYPE >
+struct ToArray< U, ArrayOfSets< T, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE > >
 {
   using OneD = Array< U, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE >;
   using OneDView = ArrayView< U, 1, 0, INDEX_TYPE, BUFFER_TYPE >;
-  using AoA = ArrayOfArrays< U, INDEX_TYPE, BUFFER_TYPE >;
+  using TwoD = Array< U, 2, RAJA::PERM_IJ, INDEX_TYPE, BUFFER_TYPE >;
+  using AoA = ArrayOfArrays< U, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE >;
 };
 
 template< class ARRAY_OF_SETS >
@@ -219,6 +222,71 @@ public:
     COMPARE_TO_REFERENCE
   }
 
+  template< typename POLICY >
+  void insertIntoSets( IndexType const maxInserts, IndexType const maxValue )
+  {
+    COMPARE_TO_REFERENCE
+
+    typename ToArray< IndexType, ARRAY_OF_SETS >::OneD sets;
+    typename ToArray< T, ARRAY_OF_SETS >::OneD values;
+
+    IndexType const nSets = m_array.size();
+    IndexType const nValues = rand( 0, maxInserts * nSets );
+    for( IndexType j = 0; j < nValues; ++j )
+    {
+      IndexType const set = rand( 0, nSets - 1 );
+      T const value = T( rand( 0, maxValue ) );
+      sets.emplace_back( set );
+      values.emplace_back( value );
+      m_ref[ set ].insert( value );
+    }
+
+    m_array.template insertIntoSets< POLICY >( sets.toViewConst(), values.toViewConst() );
+
+    COMPARE_TO_REFERENCE
+
+    // Every value is already present so nothing changes.
+    IndexType const valueCapacity = m_array.valueCapacity();
+    m_array.template insertIntoSets< POLICY >( sets.toViewConst(), values.toViewConst() );
+    EXPECT_EQ( m_array.valueCapacity(), valueCapacity );
+
+    COMPARE_TO_REFERENCE
+  }
+
+  template< typename POLICY >
+  void setAlgebra( IndexType const numPairs )
+  {
+    COMPARE_TO_REFERENCE
+
+    typename ToArray< IndexType, ARRAY_OF_SETS >::TwoD pairs( numPairs, 2 );
+    for( IndexType k = 0; k < numPairs; ++k )
+    {
+      pairs( k, 0 ) = rand( 0, m_array.size() - 1 );
+      pairs( k, 1 ) = rand( 0, m_array.size() - 1 );
+    }
+
+    typename ToArray< IndexType, ARRAY_OF_SETS >::OneD sizes( numPairs );
+    m_array.template intersectionSizes< POLICY >( m_array.toViewConst(), pairs.toViewConst(), sizes.toView() );
+
+    ARRAY_OF_SETS result;
+    result.template setToIntersections< POLICY >( m_array.toViewConst(), m_array.toViewConst(), pairs.toViewConst() );
+    checkPairwise( result, pairs, [] ( std::set< T > const & a, std::set< T > const & b, std::vector< T > & output )
+    { std::set_intersection( a.begin(), a.end(), b.begin(), b.end(), std::back_inserter( output ) ); } );
+
+    for( IndexType k = 0; k < numPairs; ++k )
+    { EXPECT_EQ( sizes[ k ], result.sizeOfSet( k ) ); }
+
+    result.template setToUnions< POLICY >( m_array.toViewConst(), m_array.toViewConst(), pairs.toViewConst() );
+    checkPairwise( result, pairs, [] ( std::set< T > const & a, std::set< T > const & b, std::vector< T > & output )
+    { std::set_union( a.begin(), a.end(), b.begin(), b.end(), std::back_inserter( output ) ); } );
+
+    result.template setToDifferences< POLICY >( m_array.toViewConst(), m_array.toViewConst(), pairs.toViewConst() );
+    checkPairwise( result, pairs, [] ( std::set< T > const & a, std::set< T > const & b, std::vector< T > & output )
+    { std::set_difference( a.begin(), a.end(), b.begin(), b.end(), std::back_inserter( output ) ); } );
+
+    COMPARE_TO_REFERENCE
+  }
+
   void insertMultipleIntoSet( IndexType const maxInserts, IndexType const maxValue )
   {
     COMPARE_TO_REFERENCE
@@ -473,6 +541,28 @@ protected:
     ASSERT_EQ( setCapacity, m_array.capacityOfSet( i ));
   }
 
+  /**
+   * @brief Check that set @c k of @p result is @p op applied to the reference sets of pair @c k.
+   */
+  template< typename OP >
+  void checkPairwise( ARRAY_OF_SETS const & result,
+                      typename ToArray< IndexType, ARRAY_OF_SETS >::TwoD const & pairs,
+                      OP && op )
+  {
+    result.toViewConst().consistencyCheck();
+    ASSERT_EQ( result.size(), pairs.size( 0 ) );
+
+    for( IndexType k = 0; k < result.size(); ++k )
+    {
+      std::vector< T > expected;
+      op( m_ref[ pairs( k, 0 ) ], m_ref[ pairs( k, 1 ) ], expected );
+      ASSERT_EQ( result.sizeOfSet( k ), expected.size() );
+      EXPECT_EQ( result.capacityOfSet( k ), result.sizeOfSet( k ) );
+      for( IndexType j = 0; j < result.sizeOfSet( k ); ++j )
+      { EXPECT_EQ( result( k, j ), expected[ j ] ); }
+    }
+  }
+
   IndexType rand( IndexType const min, IndexType const max )
   { return std::uniform_int_distribution< IndexType >( min, max )( m_gen ); }
 
@@ -489,6 +579,7 @@ using ArrayOfSetsTestTypes = ::testing::Types<
   ArrayOfSets< int, std::ptrdiff_t, MallocBuffer >
   , ArrayOfSets< Tensor, std::ptrdiff_t, MallocBuffer >
   , ArrayOfSets< TestString, std::ptrdiff_t, MallocBuffer >
+  , ArrayOfSets< int, int, MallocBuffer, std::ptrdiff_t >
 #if defined(LVARRAY_USE_CHAI)
   , ArrayOfSets< int, std::ptrdiff_t, ChaiBuffer >
   , ArrayOfSets< Tensor, std::ptrdiff_t, ChaiBuffer >
@@ -589,6 +680,29 @@ TYPED_TEST( ArrayOfSetsTest, insertIntoSet )
   }
 }
 
+TYPED_TEST( ArrayOfSetsTest, insertIntoSets )
+{
+  this->resize( 50 );
+  for( int i = 0; i < 2; ++i )
+  {
+    this->insertIntoSet( DEFAULT_MAX_INSERTS, DEFAULT_MAX_VALUE );
+    this->template insertIntoSets< serialPolicy >( DEFAULT_MAX_INSERTS, DEFAULT_MAX_VALUE );
+#if defined(RAJA_ENABLE_OPENMP)
+    this->template insertIntoSets< parallelHostPolicy >( DEFAULT_MAX_INSERTS, DEFAULT_MAX_VALUE );
+#endif
+  }
+}
+
+TYPED_TEST( ArrayOfSetsTest, setAlgebra )
+{
+  this->resize( 50 );
+  this->insertIntoSet( DEFAULT_MAX_INSERTS, DEFAULT_MAX_VALUE );
+  this->template setAlgebra< serialPolicy >( 200 );
+#if defined(RAJA_ENABLE_OPENMP)
+  this->template setAlgebra< parallelHostPolicy >( 200 );
+#endif
+}
+
 TYPED_TEST( ArrayOfSetsTest, insertMultipleIntoSet )
 {
   this->resize( 1 );
@@ -791,6 +905,70 @@ public:
     COMPARE_TO_REFERENCE
   }
 
+  void insertAtomicView( IndexType const maxInserts, IndexType const maxValue )
+  {
+    COMPARE_TO_REFERENCE
+
+    using AtomicPolicy = typename RAJAHelper< POLICY >::AtomicPolicy;
+
+    IndexType const nValues = maxInserts * m_array.size();
+    Array1D< IndexType > sets( nValues );
+    Array1D< T > values( nValues );
+    for( IndexType k = 0; k < nValues; ++k )
+    {
+      sets[ k ] = rand( 0, m_array.size() - 1 );
+      values[ k ] = T( rand( 0, maxValue ) );
+    }
+
+    IndexType sizeBefore = 0;
+    for( IndexType i = 0; i < m_array.size(); ++i )
+    { sizeBefore += m_array.sizeOfSet( i ); }
+
+    // Many threads insert into the same set and some of the sets overflow.
+    Array1D< AtomicInsertResult > results( nValues );
+    ViewType const view = m_array.toView();
+    ArrayView1D< IndexType const > const setsView = sets.toViewConst();
+    ArrayView1D< T const > const valuesView = values.toViewConst();
+    ArrayView1D< AtomicInsertResult > const resultsView = results.toView();
+    forall< POLICY >( nValues, [view, setsView, valuesView, resultsView] LVARRAY_HOST_DEVICE ( IndexType const k )
+        {
+          resultsView[ k ] = view.template insertIntoSetAtomic< AtomicPolicy >( setsView[ k ], valuesView[ k ] );
+        } );
+
+    m_array.move( MemorySpace::host );
+    results.move( MemorySpace::host );
+    m_array.consistencyCheck();
+
+    IndexType sizeAfter = 0;
+    for( IndexType i = 0; i < m_array.size(); ++i )
+    { sizeAfter += m_array.sizeOfSet( i ); }
+
+    // Every value that didn't overflow is in its set, the others are inserted after growing the sets.
+    IndexType numInserted = 0;
+    for( IndexType k = 0; k < nValues; ++k )
+    {
+      m_ref[ sets[ k ] ].insert( values[ k ] );
+      if( results[ k ] == AtomicInsertResult::overflow )
+      {
+        EXPECT_EQ( m_array.sizeOfSet( sets[ k ] ), m_array.capacityOfSet( sets[ k ] ) );
+        continue;
+      }
+
+      EXPECT_TRUE( m_array.contains( sets[ k ], values[ k ] ) );
+      numInserted += results[ k ] == AtomicInsertResult::inserted;
+    }
+
+    EXPECT_EQ( numInserted, sizeAfter - sizeBefore );
+
+    for( IndexType k = 0; k < nValues; ++k )
+    {
+      if( results[ k ] == AtomicInsertResult::overflow )
+      { m_array.insertIntoSet( sets[ k ], values[ k ] ); }
+    }
+
+    COMPARE_TO_REFERENCE
+  }
+
   void removeView()
   {
     COMPARE_TO_REFERENCE
@@ -919,12 +1097,18 @@ using ArrayOfSetsViewTestTypes = ::testing::Types<
   std::pair< ArrayOfSets< int, std::ptrdiff_t, MallocBuffer >, serialPolicy >
   , std::pair< ArrayOfSets< Tensor, std::ptrdiff_t, MallocBuffer >, serialPolicy >
   , std::pair< ArrayOfSets< TestString, std::ptrdiff_t, MallocBuffer >, serialPolicy >
+  , std::pair< ArrayOfSets< int, int, MallocBuffer, std::ptrdiff_t >, serialPolicy >
 #if defined(LVARRAY_USE_CHAI)
   , std::pair< ArrayOfSets< int, std::ptrdiff_t, ChaiBuffer >, serialPolicy >
   , std::pair< ArrayOfSets< Tensor, std::ptrdiff_t, ChaiBuffer >, serialPolicy >
   , std::pair< ArrayOfSets< TestString, std::ptrdiff_t, ChaiBuffer >, serialPolicy >
 #endif
 
+#if defined(RAJA_ENABLE_OPENMP)
+  , std::pair< ArrayOfSets< int, std::ptrdiff_t, MallocBuffer >, parallelHostPolicy >
+  , std::pair< ArrayOfSets< TestString, std::ptrdiff_t, MallocBuffer >, parallelHostPolicy >
+#endif
+
 #if defined(LVARRAY_USE_CUDA) && defined(LVARRAY_USE_CHAI)
   , std::pair< ArrayOfSets< int, std::ptrdiff_t, ChaiBuffer >, parallelDevicePolicy< 32 > >
   , std::pair< ArrayOfSets< Tensor, std::ptrdiff_t, ChaiBuffer >, parallelDevicePolicy< 32 > >
@@ -971,6 +1155,15 @@ TYPED_TEST( ArrayOfSetsViewTest, insertMultiple )
   }
 }
 
+TYPED_TEST( ArrayOfSetsViewTest, insertAtomic )
+{
+  this->resize( 50, 10 );
+  for( int i = 0; i < 2; ++i )
+  {
+    this->insertAtomicView( DEFAULT_MAX_INSERTS, DEFAULT_MAX_VALUE );
+  }
+}
+
 TYPED_TEST( ArrayOfSetsViewTest, remove )
 {
   this->resize( 50, 10 );
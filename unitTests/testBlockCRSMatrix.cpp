@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC and LvArray contributors.
+ * All rights reserved.
+ * See the LICENSE file for details.
+ * SPDX-License-Identifier: (BSD-3-Clause)
+ */
+
+// Source includes
+#include "BlockCRSMatrix.hpp"
+#include "SparsityPattern.hpp"
+#include "ArrayOfArrays.hpp"
+#include "Array.hpp"
+#include "tensorOps.hpp"
+#include "testUtils.hpp"
+#include "MallocBuffer.hpp"
+
+// TPL includes
+#include <gtest/gtest.h>
+
+// System includes
+#include <algorithm>
+#include <array>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace LvArray
+{
+namespace testing
+{
+
+enum class AddType
+{
+  BINARY_SEARCH,
+  LINEAR_SEARCH,
+  HYBRID,
+  UNSORTED_BINARY
+};
+
+template< typename BLOCK_CRS_POLICY_PAIR >
+class BlockCRSMatrixTest : public ::testing::Test
+{
+public:
+  using BLOCK_CRS = typename BLOCK_CRS_POLICY_PAIR::first_type;
+  using POLICY = typename BLOCK_CRS_POLICY_PAIR::second_type;
+
+  using T = typename BLOCK_CRS::EntryType;
+  using ColType = typename BLOCK_CRS::ColType;
+  using IndexType = typename BLOCK_CRS::IndexType;
+
+  static constexpr int BLOCK_SIZE = BLOCK_CRS::blockSize;
+
+  static constexpr std::size_t MAX_COLS_TO_ADD = 32;
+
+  using SparsityPatternT = SparsityPattern< ColType, IndexType, DEFAULT_BUFFER >;
+  using Array1d = Array< T, 1, RAJA::PERM_I, IndexType, DEFAULT_BUFFER >;
+  using Block = std::array< T, BLOCK_SIZE * BLOCK_SIZE >;
+
+  /**
+   * @brief Create a random block structure with @p extraCapacity unused capacity in each row
+   *   and assimilate it.
+   */
+  void createMatrix( IndexType const nRows, IndexType const nCols, IndexType const maxRowLength, IndexType const extraCapacity )
+  {
+    SparsityPatternT sparsity( nRows, nCols, maxRowLength + extraCapacity );
+
+    std::uniform_int_distribution< IndexType > lengthDist( 1, maxRowLength );
+    std::uniform_int_distribution< ColType > colDist( 0, nCols - 1 );
+
+    m_ref.clear();
+    m_ref.resize( nRows );
+    for( IndexType row = 0; row < nRows; ++row )
+    {
+      IndexType const length = lengthDist( m_gen );
+      for( IndexType i = 0; i < length; ++i )
+      {
+        ColType const col = colDist( m_gen );
+        sparsity.insertNonZero( row, col );
+        m_ref[ row ][ col ] = Block{};
+      }
+    }
+
+    m_matrix.template assimilate< serialPolicy >( std::move( sparsity ) );
+    compareToReference();
+  }
+
+  void compareToReference() const
+  {
+    m_matrix.move( MemorySpace::host, false );
+
+    ASSERT_EQ( m_matrix.numRows(), IndexType( m_ref.size() ) );
+    ASSERT_EQ( m_matrix.numScalarRows(), BLOCK_SIZE * m_matrix.numRows() );
+    ASSERT_EQ( m_matrix.numScalarColumns(), BLOCK_SIZE * m_matrix.numColumns() );
+
+    for( IndexType row = 0; row < m_matrix.numRows(); ++row )
+    {
+      ASSERT_EQ( m_matrix.numNonZeros( row ), IndexType( m_ref[ row ].size() ) );
+
+      IndexType i = 0;
+      for( auto const & colAndBlock : m_ref[ row ] )
+      {
+        EXPECT_EQ( m_matrix.getColumns( row )[ i ], colAndBlock.first );
+
+        T const ( &block )[ BLOCK_SIZE ][ BLOCK_SIZE ] = m_matrix.getBlock( row, i );
+        for( int a = 0; a < BLOCK_SIZE; ++a )
+        {
+          for( int b = 0; b < BLOCK_SIZE; ++b )
+          { EXPECT_EQ( block[ a ][ b ], colAndBlock.second[ BLOCK_SIZE * a + b ] ); }
+        }
+
+        ++i;
+      }
+    }
+  }
+
+  /**
+   * @brief Add to every block of the matrix @p nIter times in parallel, each addition
+   *   covers a random subset of the columns of the row.
+   */
+  template< AddType ADD_TYPE >
+  void addToRow( IndexType const nIter )
+  {
+    IndexType const nRows = m_matrix.numRows();
+
+    // Choose the columns to add to on the host.
+    std::vector< std::vector< ColType > > columnsToAddTo( nRows );
+    for( IndexType row = 0; row < nRows; ++row )
+    {
+      for( auto const & colAndBlock : m_ref[ row ] )
+      {
+        if( m_gen() % 2 == 0 && columnsToAddTo[ row ].size() < MAX_COLS_TO_ADD )
+        { columnsToAddTo[ row ].push_back( colAndBlock.first ); }
+      }
+
+      if( ADD_TYPE == AddType::UNSORTED_BINARY )
+      { std::shuffle( columnsToAddTo[ row ].begin(), columnsToAddTo[ row ].end(), m_gen ); }
+
+      for( ColType const col : columnsToAddTo[ row ] )
+      {
+        Block & block = m_ref[ row ][ col ];
+        for( int i = 0; i < BLOCK_SIZE * BLOCK_SIZE; ++i )
+        { block[ i ] += nIter * value( row, col, i ); }
+      }
+    }
+
+    ArrayOfArrays< ColType, IndexType, DEFAULT_BUFFER > columns;
+    for( IndexType row = 0; row < nRows; ++row )
+    { columns.appendArray( columnsToAddTo[ row ].begin(), columnsToAddTo[ row ].end() ); }
+
+    ArrayOfArraysView< ColType const, IndexType const, true, DEFAULT_BUFFER > const columnsView = columns.toViewConst();
+    auto const view = m_matrix.toViewConstSizes();
+    forall< POLICY >( nIter * nRows, [view, columnsView] LVARRAY_HOST_DEVICE ( IndexType const iter )
+        {
+          IndexType const row = iter % columnsView.size();
+          IndexType const nCols = columnsView.sizeOfArray( row );
+          ColType const * const cols = columnsView[ row ];
+
+          T blocks[ MAX_COLS_TO_ADD ][ BLOCK_SIZE ][ BLOCK_SIZE ];
+          for( IndexType j = 0; j < nCols; ++j )
+          {
+            for( int a = 0; a < BLOCK_SIZE; ++a )
+            {
+              for( int b = 0; b < BLOCK_SIZE; ++b )
+              { blocks[ j ][ a ][ b ] = value( row, cols[ j ], BLOCK_SIZE * a + b ); }
+            }
+          }
+
+          using AtomicPolicy = typename RAJAHelper< POLICY >::AtomicPolicy;
+          if( ADD_TYPE == AddType::BINARY_SEARCH )
+          { view.template addToRowBinarySearch< AtomicPolicy >( row, cols, blocks, nCols ); }
+          if( ADD_TYPE == AddType::LINEAR_SEARCH )
+          { view.template addToRowLinearSearch< AtomicPolicy >( row, cols, blocks, nCols ); }
+          if( ADD_TYPE == AddType::HYBRID )
+          { view.template addToRow< AtomicPolicy >( row, cols, blocks, nCols ); }
+          if( ADD_TYPE == AddType::UNSORTED_BINARY )
+          { view.template addToRowBinarySearchUnsorted< AtomicPolicy >( row, cols, blocks, nCols ); }
+        } );
+
+    compareToReference();
+  }
+
+  void multiply()
+  {
+    IndexType const nRows = m_matrix.numRows();
+    IndexType const nCols = m_matrix.numColumns();
+
+    Array1d x( BLOCK_SIZE * nCols );
+    for( IndexType i = 0; i < x.size(); ++i )
+    { x[ i ] = T( i % 11 ) - 5; }
+
+    Array1d y( BLOCK_SIZE * nRows );
+    m_matrix.template multiply< POLICY >( x.toViewConst(), y.toView() );
+    y.move( MemorySpace::host );
+    x.move( MemorySpace::host, false );
+    m_matrix.move( MemorySpace::host, false );
+
+    for( IndexType row = 0; row < nRows; ++row )
+    {
+      T expected[ BLOCK_SIZE ] = {};
+      for( IndexType i = 0; i < m_matrix.numNonZeros( row ); ++i )
+      {
+        IndexType const col = m_matrix.getColumns( row )[ i ];
+        T xBlock[ BLOCK_SIZE ];
+        for( int b = 0; b < BLOCK_SIZE; ++b )
+        { xBlock[ b ] = x[ BLOCK_SIZE * col + b ]; }
+
+        tensorOps::Ri_add_AijBj< BLOCK_SIZE, BLOCK_SIZE >( expected, m_matrix.getBlock( row, i ), xBlock );
+      }
+
+      for( int a = 0; a < BLOCK_SIZE; ++a )
+      { EXPECT_EQ( y[ BLOCK_SIZE * row + a ], expected[ a ] ); }
+    }
+  }
+
+  void compress()
+  {
+    m_matrix.move( MemorySpace::host );
+    m_matrix.compress();
+
+    IndexType const * const offsets = m_matrix.getOffsets();
+    for( IndexType row = 0; row < m_matrix.numRows(); ++row )
+    { EXPECT_EQ( offsets[ row + 1 ] - offsets[ row ], m_matrix.numNonZeros( row ) ); }
+
+    compareToReference();
+  }
+
+  void setValues()
+  {
+    m_matrix.template setValues< POLICY >( 3 );
+    for( auto & row : m_ref )
+    {
+      for( auto & colAndBlock : row )
+      { colAndBlock.second.fill( 3 ); }
+    }
+    compareToReference();
+
+    // The blocks can be passed directly to tensorOps.
+    for( IndexType row = 0; row < m_matrix.numRows(); ++row )
+    {
+      IndexType i = 0;
+      for( auto & colAndBlock : m_ref[ row ] )
+      {
+        tensorOps::scale< BLOCK_SIZE, BLOCK_SIZE >( m_matrix.getBlock( row, i++ ), row );
+        for( T & value : colAndBlock.second )
+        { value *= row; }
+      }
+    }
+    compareToReference();
+
+    m_matrix.zero();
+    for( auto & row : m_ref )
+    {
+      for( auto & colAndBlock : row )
+      { colAndBlock.second.fill( 0 ); }
+    }
+    compareToReference();
+  }
+
+  void deepCopy()
+  {
+    BLOCK_CRS copy( m_matrix );
+    ASSERT_EQ( copy.numRows(), m_matrix.numRows() );
+
+    copy.template setValues< serialPolicy >( 1 );
+    compareToReference();
+
+    m_matrix = std::move( copy );
+    for( auto & row : m_ref )
+    {
+      for( auto & colAndBlock : row )
+      { colAndBlock.second.fill( 1 ); }
+    }
+    compareToReference();
+  }
+
+  LVARRAY_HOST_DEVICE static T value( IndexType const row, IndexType const col, int const i )
+  { return T( ( row + 2 * col + 3 * i ) % 17 ); }
+
+protected:
+  std::mt19937_64 m_gen;
+  BLOCK_CRS m_matrix;
+  std::vector< std::map< ColType, Block > > m_ref;
+};
+
+using BlockCRSMatrixTestTypes = ::testing::Types<
+  std::pair< BlockCRSMatrix< double, 3, int, std::ptrdiff_t, DEFAULT_BUFFER >, serialPolicy >
+  , std::pair< BlockCRSMatrix< double, 1, int, std::ptrdiff_t, DEFAULT_BUFFER >, serialPolicy >
+  , std::pair< BlockCRSMatrix< float, 2, long, int, DEFAULT_BUFFER >, serialPolicy >
+#if defined(RAJA_ENABLE_OPENMP)
+  , std::pair< BlockCRSMatrix< double, 3, int, std::ptrdiff_t, DEFAULT_BUFFER >, parallelHostPolicy >
+#endif
+#if defined(LVARRAY_USE_CUDA) && defined(LVARRAY_USE_CHAI)
+  , std::pair< BlockCRSMatrix< double, 3, int, std::ptrdiff_t, ChaiBuffer >, parallelDevicePolicy< 32 > >
+#endif
+  >;
+
+TYPED_TEST_SUITE( BlockCRSMatrixTest, BlockCRSMatrixTestTypes, );
+
+TYPED_TEST( BlockCRSMatrixTest, assimilate )
+{
+  this->createMatrix( 50, 40, 20, 5 );
+}
+
+TYPED_TEST( BlockCRSMatrixTest, addToRowBinarySearch )
+{
+  this->createMatrix( 50, 40, 20, 5 );
+  this->template addToRow< AddType::BINARY_SEARCH >( 3 );
+}
+
+TYPED_TEST( BlockCRSMatrixTest, addToRowLinearSearch )
+{
+  this->createMatrix( 50, 40, 20, 5 );
+  this->template addToRow< AddType::LINEAR_SEARCH >( 3 );
+}
+
+TYPED_TEST( BlockCRSMatrixTest, addToRowHybridSearch )
+{
+  this->createMatrix( 50, 200, 150, 5 );
+  this->template addToRow< AddType::HYBRID >( 3 );
+}
+
+TYPED_TEST( BlockCRSMatrixTest, addToRowBinarySearchUnsorted )
+{
+  this->createMatrix( 50, 40, 20, 5 );
+  this->template addToRow< AddType::UNSORTED_BINARY >( 3 );
+}
+
+TYPED_TEST( BlockCRSMatrixTest, compress )
+{
+  this->createMatrix( 50, 40, 20, 5 );
+  this->template addToRow< AddType::HYBRID >( 2 );
+  this->compress();
+  this->multiply();
+}
+
+TYPED_TEST( BlockCRSMatrixTest, multiply )
+{
+  this->createMatrix( 60, 45, 25, 0 );
+  this->template addToRow< AddType::HYBRID >( 1 );
+  this->multiply();
+}
+
+TYPED_TEST( BlockCRSMatrixTest, setValues )
+{
+  this->createMatrix( 50, 40, 20, 5 );
+  this->setValues();
+}
+
+TYPED_TEST( BlockCRSMatrixTest, deepCopy )
+{
+  this->createMatrix( 50, 40, 20, 5 );
+  this->template addToRow< AddType::LINEAR_SEARCH >( 1 );
+  this->deepCopy();
+}
+
+} // namespace testing
+} // namespace LvArray
+
+// This is the default gtest main method. It is included for ease of debugging.
+int main( int argc, char * * argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  int const result = RUN_ALL_TESTS();
+  return result;
+}
@@ -39,10 +39,16 @@ template< typename U, typename T >
 struct ToArray
 {};
 
-template< typename U, typename T, typename COL_TYPE, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
-struct ToArray< U, CRSMatrix< T, COL_TYPE, INDEX_TYPE, BUFFER_TYPE > >
+template< typename U,
+          typename T,
+          typename COL_TYPE,
+          typename INDEX_TYPE,
+          template< typename > class BUFFER_TYPE,
+          typename OFFSET_TYPE >
+struct ToArray< U, CRSMatrix< T, COL_TYPE, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE > >
 {
-  using AoA = ArrayOfArrays< U, INDEX_TYPE, BUFFER_TYPE >;
+  using AoA = ArrayOfArrays< U, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE >;
+  using Array1D = Array< U, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE >;
 };
 
 template< typename CRS_MATRIX >
@@ -53,6 +59,7 @@ public:
   using T = typename CRS_MATRIX::EntryType;
   using ColType = typename CRS_MATRIX::ColType;
   using IndexType = typename CRS_MATRIX::IndexType;
+  using OffsetType = typename CRS_MATRIX::OffsetType;
 
   using ViewType = typeManipulation::ViewType< CRS_MATRIX >;
   using ViewTypeConstSizes = typeManipulation::ViewTypeConstSizes< CRS_MATRIX >;
@@ -61,6 +68,9 @@ public:
   template< typename U >
   using ArrayOfArraysT = typename ToArray< U, CRS_MATRIX >::AoA;
 
+  template< typename U >
+  using Array1DT = typename ToArray< U, CRS_MATRIX >::Array1D;
+
   template< typename U >
   using ArrayOfArraysViewT = typeManipulation::ViewTypeConst< ArrayOfArraysT< std::remove_const_t< U > > >;
 
@@ -146,6 +156,40 @@ public:
     COMPARE_TO_REFERENCE;
   }
 
+  template< typename POLICY >
+  void fromTriplets( IndexType const numRows, IndexType const numCols, IndexType const numTriplets )
+  {
+    Array1DT< IndexType > rows( numTriplets );
+    Array1DT< ColType > cols( numTriplets );
+    Array1DT< T > vals( numTriplets );
+
+    // Use few columns so that there are plenty of duplicates, they are summed in the order given.
+    m_ref.clear();
+    m_ref.resize( numRows );
+    for( IndexType i = 0; i < numTriplets; ++i )
+    {
+      rows[ i ] = rand( numRows - 1 );
+      cols[ i ] = rand( numCols - 1 );
+      vals[ i ] = T( rand( 100 ) );
+
+      auto const result = m_ref[ rows[ i ] ].emplace( cols[ i ], vals[ i ] );
+      if( !result.second )
+      { result.first->second += vals[ i ]; }
+    }
+
+    for( IndexType const numBlocks : { 1, 3, 64 } )
+    {
+      m_matrix.template fromTriplets< POLICY >( numRows, numCols, rows.toViewConst(), cols.toViewConst(), vals.toViewConst(), numBlocks );
+
+      EXPECT_EQ( m_matrix.numRows(), numRows );
+      EXPECT_EQ( m_matrix.numColumns(), numCols );
+      for( IndexType row = 0; row < numRows; ++row )
+      { EXPECT_EQ( m_matrix.nonZeroCapacity( row ), m_matrix.numNonZeros( row ) ); }
+
+      COMPARE_TO_REFERENCE;
+    }
+  }
+
   /**
    * @brief Test the insert multiple method of the CRSMatrix.
    * @param [in] maxInserts the number of entries to insert at a time.
@@ -397,9 +441,9 @@ public:
 
     T const * const entries = m_matrix.getEntries( 0 );
     ColType const * const columns = m_matrix.getColumns( 0 );
-    IndexType const * const offsets = m_matrix.getOffsets();
+    OffsetType const * const offsets = m_matrix.getOffsets();
 
-    IndexType curOffset = 0;
+    OffsetType curOffset = 0;
     for( IndexType row = 0; row < m_matrix.numRows(); ++row )
     {
       // The last row will have all the extra capacity.
@@ -421,6 +465,35 @@ public:
     COMPARE_TO_REFERENCE
   }
 
+  template< typename POLICY >
+  void compressParallel( bool const outOfPlace )
+  {
+    m_matrix.template compress< POLICY >( outOfPlace );
+
+    T const * const entries = m_matrix.getEntries( 0 );
+    ColType const * const columns = m_matrix.getColumns( 0 );
+    OffsetType const * const offsets = m_matrix.getOffsets();
+
+    OffsetType curOffset = 0;
+    for( IndexType row = 0; row < m_matrix.numRows(); ++row )
+    {
+      if( row != m_matrix.numRows() - 1 )
+      {
+        EXPECT_EQ( m_matrix.numNonZeros( row ), m_matrix.nonZeroCapacity( row ));
+      }
+
+      EXPECT_EQ( m_matrix.getColumns( row ).dataIfContiguous(), columns + curOffset );
+      EXPECT_EQ( m_matrix.getEntries( row ).dataIfContiguous(), entries + curOffset );
+      EXPECT_EQ( offsets[row], curOffset );
+      curOffset += m_matrix.numNonZeros( row );
+    }
+
+    if( outOfPlace )
+    { EXPECT_EQ( m_matrix.nonZeroCapacity(), curOffset ); }
+
+    COMPARE_TO_REFERENCE
+  }
+
 protected:
 
   ArrayOfArraysT< ColType > createArrayOfColumns( IndexType const maxCols, bool const oneAtATime )
@@ -495,6 +568,7 @@ using CRSMatrixTestTypes = ::testing::Types<
   CRSMatrix< int, int, std::ptrdiff_t, MallocBuffer >
   , CRSMatrix< Tensor, int, std::ptrdiff_t, MallocBuffer >
   , CRSMatrix< TestString, int, std::ptrdiff_t, MallocBuffer >
+  , CRSMatrix< int, int, int, MallocBuffer, std::ptrdiff_t >
 #if defined(LVARRAY_USE_CHAI)
   , CRSMatrix< int, int, std::ptrdiff_t, ChaiBuffer >
   , CRSMatrix< Tensor, int, std::ptrdiff_t, ChaiBuffer >
@@ -566,6 +640,15 @@ TYPED_TEST( CRSMatrixTest, resizeFromRowCapacities )
   }
 }
 
+TYPED_TEST( CRSMatrixTest, fromTriplets )
+{
+  this->template fromTriplets< serialPolicy >( DEFAULT_NROWS, DEFAULT_NCOLS / 4, 5 * DEFAULT_NROWS );
+
+#if defined( RAJA_ENABLE_OPENMP )
+  this->template fromTriplets< parallelHostPolicy >( 2 * DEFAULT_NROWS, DEFAULT_NCOLS / 4, 20 * DEFAULT_NROWS );
+#endif
+}
+
 TYPED_TEST( CRSMatrixTest, insert )
 {
   this->resize( DEFAULT_NROWS, DEFAULT_NCOLS );
@@ -619,6 +702,20 @@ TYPED_TEST( CRSMatrixTest, compress )
   this->compress();
 }
 
+TYPED_TEST( CRSMatrixTest, compressParallel )
+{
+  for( bool const outOfPlace : { false, true } )
+  {
+    this->resize( DEFAULT_NROWS, DEFAULT_NCOLS, 2 * DEFAULT_MAX_INSERTS );
+    this->insert( DEFAULT_MAX_INSERTS );
+    this->template compressParallel< serialPolicy >( outOfPlace );
+#if defined(RAJA_ENABLE_OPENMP)
+    this->insert( DEFAULT_MAX_INSERTS );
+    this->template compressParallel< parallelHostPolicy >( outOfPlace );
+#endif
+  }
+}
+
 // Sphinx start after CRSMatrixViewTest
 template< typename CRS_MATRIX_POLICY_PAIR >
 class CRSMatrixViewTest : public CRSMatrixTest< typename CRS_MATRIX_POLICY_PAIR::first_type >
@@ -1030,6 +1127,7 @@ using CRSMatrixViewTestTypes = ::testing::Types<
 // Sphinx end before CRSMatrixViewTestTypes
   , std::pair< CRSMatrix< Tensor, int, std::ptrdiff_t, MallocBuffer >, serialPolicy >
   , std::pair< CRSMatrix< TestString, int, std::ptrdiff_t, MallocBuffer >, serialPolicy >
+  , std::pair< CRSMatrix< int, int, int, MallocBuffer, std::ptrdiff_t >, serialPolicy >
 #if defined(LVARRAY_USE_CHAI)
   , std::pair< CRSMatrix< int, int, std::ptrdiff_t, ChaiBuffer >, serialPolicy >
   , std::pair< CRSMatrix< Tensor, int, std::ptrdiff_t, ChaiBuffer >, serialPolicy >
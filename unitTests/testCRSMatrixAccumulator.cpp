@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC and LvArray contributors.
+ * All rights reserved.
+ * See the LICENSE file for details.
+ * SPDX-License-Identifier: (BSD-3-Clause)
+ */
+
+// Source includes
+#include "CRSMatrixAccumulator.hpp"
+#include "CRSMatrix.hpp"
+#include "Array.hpp"
+#include "testUtils.hpp"
+#include "MallocBuffer.hpp"
+
+// TPL includes
+#include <gtest/gtest.h>
+
+// System includes
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace LvArray
+{
+namespace testing
+{
+
+template< typename CRS_POLICY_PAIR >
+class CRSMatrixAccumulatorTest : public ::testing::Test
+{
+public:
+  using CRS = typename CRS_POLICY_PAIR::first_type;
+  using POLICY = typename CRS_POLICY_PAIR::second_type;
+
+  using T = typename CRS::EntryType;
+  using ColType = typename CRS::ColType;
+  using IndexType = typename CRS::IndexType;
+
+  using Accumulator = CRSMatrixAccumulator< T, ColType, IndexType, DEFAULT_BUFFER >;
+
+  static constexpr IndexType NUM_DOFS = 4;
+
+  void createMesh( IndexType const numElems, IndexType const numNodes, T const scale )
+  {
+    m_elemToDof.resize( numElems, NUM_DOFS );
+    m_localMatrices.resize( numElems, NUM_DOFS, NUM_DOFS );
+
+    std::vector< ColType > nodes( numNodes );
+    std::iota( nodes.begin(), nodes.end(), ColType( 0 ) );
+    std::uniform_int_distribution< int > valueDist( -10, 10 );
+    for( IndexType elem = 0; elem < numElems; ++elem )
+    {
+      std::shuffle( nodes.begin(), nodes.end(), m_gen );
+      for( IndexType i = 0; i < NUM_DOFS; ++i )
+      {
+        m_elemToDof( elem, i ) = nodes[ i ];
+        for( IndexType j = 0; j < NUM_DOFS; ++j )
+        { m_localMatrices( elem, i, j ) = scale * T( valueDist( m_gen ) ); }
+      }
+    }
+
+    // The expected matrix, assembled serially.
+    m_expected = CRS( numNodes, numNodes );
+    for( IndexType elem = 0; elem < numElems; ++elem )
+    {
+      for( IndexType i = 0; i < NUM_DOFS; ++i )
+      {
+        for( IndexType j = 0; j < NUM_DOFS; ++j )
+        { m_expected.insertNonZero( m_elemToDof( elem, i ), m_elemToDof( elem, j ), T() ); }
+      }
+    }
+
+    m_expected.compress();
+    for( IndexType elem = 0; elem < numElems; ++elem )
+    {
+      for( IndexType i = 0; i < NUM_DOFS; ++i )
+      {
+        m_expected.template addToRowBinarySearchUnsorted< RAJA::seq_atomic >( m_elemToDof( elem, i ),
+                                                                              m_elemToDof[ elem ],
+                                                                              m_localMatrices[ elem ][ i ],
+                                                                              NUM_DOFS );
+      }
+    }
+  }
+
+  void accumulate( Accumulator & accumulator, IndexType const numBlocks )
+  {
+    ArrayView< ColType const, 2, 1, IndexType, DEFAULT_BUFFER > const elemToDof = m_elemToDof.toViewConst();
+    ArrayView< T const, 3, 2, IndexType, DEFAULT_BUFFER > const localMatrices = m_localMatrices.toViewConst();
+    accumulator.template forAll< POLICY >( elemToDof.size( 0 ),
+                                           [elemToDof, localMatrices] ( IndexType const elem, typename Accumulator::Block & block )
+      {
+        for( IndexType i = 0; i < NUM_DOFS; ++i )
+        { block.addToRow( elemToDof( elem, i ), elemToDof[ elem ], localMatrices[ elem ][ i ], NUM_DOFS ); }
+      }, numBlocks );
+
+    EXPECT_EQ( accumulator.numValues(), elemToDof.size( 0 ) * NUM_DOFS * NUM_DOFS );
+  }
+
+  void checkMatrix( CRS const & matrix ) const
+  {
+    ASSERT_EQ( matrix.numRows(), m_expected.numRows() );
+    ASSERT_EQ( matrix.numColumns(), m_expected.numColumns() );
+    for( IndexType row = 0; row < matrix.numRows(); ++row )
+    {
+      ASSERT_EQ( matrix.numNonZeros( row ), m_expected.numNonZeros( row ) );
+      for( IndexType i = 0; i < matrix.numNonZeros( row ); ++i )
+      {
+        EXPECT_EQ( matrix.getColumns( row )[ i ], m_expected.getColumns( row )[ i ] );
+        EXPECT_EQ( matrix.getEntries( row )[ i ], m_expected.getEntries( row )[ i ] );
+      }
+    }
+  }
+
+  void addTo()
+  {
+    createMesh( 300, 80, T( 1 ) );
+
+    CRS matrix( m_expected );
+    Accumulator accumulator;
+
+    // Assemble twice to check that the buffers are cleared between assemblies.
+    for( IndexType const numBlocks : { 1, 7 } )
+    {
+      matrix.template setValues< serialPolicy >( T() );
+      accumulate( accumulator, numBlocks );
+      accumulator.template addTo< POLICY >( matrix.toViewConstSizes() );
+      checkMatrix( matrix );
+    }
+  }
+
+  void buildMatrix()
+  {
+    createMesh( 250, 100, T( 1 ) );
+
+    Accumulator accumulator;
+    accumulate( accumulator, 5 );
+
+    CRS matrix;
+    accumulator.template buildMatrix< POLICY >( m_expected.numRows(), m_expected.numColumns(), matrix );
+    checkMatrix( matrix );
+
+    for( IndexType row = 0; row < matrix.numRows(); ++row )
+    { EXPECT_EQ( matrix.nonZeroCapacity( row ), matrix.numNonZeros( row ) ); }
+  }
+
+  void deterministic()
+  {
+    // With inexact values the sums are only reproducible if the order of the additions is.
+    createMesh( 400, 50, T( 0.1 ) );
+
+    Accumulator accumulator;
+    accumulate( accumulator, 1 );
+
+    CRS reference;
+    accumulator.template buildMatrix< POLICY >( m_expected.numRows(), m_expected.numColumns(), reference );
+
+    for( IndexType const numBlocks : { 2, 3, 16, 1000 } )
+    {
+      accumulate( accumulator, numBlocks );
+
+      CRS matrix;
+      accumulator.template buildMatrix< POLICY >( m_expected.numRows(), m_expected.numColumns(), matrix );
+
+      ASSERT_EQ( matrix.numNonZeros(), reference.numNonZeros() );
+      for( IndexType row = 0; row < matrix.numRows(); ++row )
+      {
+        ASSERT_EQ( matrix.numNonZeros( row ), reference.numNonZeros( row ) );
+        for( IndexType i = 0; i < matrix.numNonZeros( row ); ++i )
+        { EXPECT_EQ( matrix.getEntries( row )[ i ], reference.getEntries( row )[ i ] ); }
+      }
+    }
+  }
+
+protected:
+  std::mt19937_64 m_gen;
+  CRS m_expected;
+  Array< ColType, 2, RAJA::PERM_IJ, IndexType, DEFAULT_BUFFER > m_elemToDof;
+  Array< T, 3, RAJA::PERM_IJK, IndexType, DEFAULT_BUFFER > m_localMatrices;
+};
+
+using CRSMatrixAccumulatorTestTypes = ::testing::Types<
+  std::pair< CRSMatrix< double, int, std::ptrdiff_t, DEFAULT_BUFFER >, serialPolicy >
+  , std::pair< CRSMatrix< float, long, int, DEFAULT_BUFFER >, serialPolicy >
+#if defined(RAJA_ENABLE_OPENMP)
+  , std::pair< CRSMatrix< double, int, std::ptrdiff_t, DEFAULT_BUFFER >, parallelHostPolicy >
+#endif
+  >;
+
+TYPED_TEST_SUITE( CRSMatrixAccumulatorTest, CRSMatrixAccumulatorTestTypes, );
+
+TYPED_TEST( CRSMatrixAccumulatorTest, addTo )
+{
+  this->addTo();
+}
+
+TYPED_TEST( CRSMatrixAccumulatorTest, buildMatrix )
+{
+  this->buildMatrix();
+}
+
+TYPED_TEST( CRSMatrixAccumulatorTest, deterministic )
+{
+  this->deterministic();
+}
+
+} // namespace testing
+} // namespace LvArray
+
+// This is the default gtest main method. It is included for ease of debugging.
+int main( int argc, char * * argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  int const result = RUN_ALL_TESTS();
+  return result;
+}
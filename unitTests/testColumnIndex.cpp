@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC and LvArray contributors.
+ * All rights reserved.
+ * See the LICENSE file for details.
+ * SPDX-License-Identifier: (BSD-3-Clause)
+ */
+
+// Source includes
+#include "ColumnIndex.hpp"
+#include "CRSMatrix.hpp"
+#include "Array.hpp"
+#include "testUtils.hpp"
+#include "MallocBuffer.hpp"
+
+// TPL includes
+#include <gtest/gtest.h>
+
+// System includes
+#include <algorithm>
+#include <random>
+#include <set>
+
+namespace LvArray
+{
+namespace testing
+{
+
+template< typename CRS_POLICY_PAIR >
+class ColumnIndexTest : public ::testing::Test
+{
+public:
+  using CRS = typename CRS_POLICY_PAIR::first_type;
+  using POLICY = typename CRS_POLICY_PAIR::second_type;
+
+  using T = typename CRS::EntryType;
+  using ColType = typename CRS::ColType;
+  using IndexType = typename CRS::IndexType;
+  using OffsetType = typename CRS::OffsetType;
+
+  using Index = ColumnIndex< ColType, IndexType, DEFAULT_BUFFER, OffsetType >;
+  using AtomicPolicy = typename RAJAHelper< POLICY >::AtomicPolicy;
+
+  // The index can only be built on the host.
+  using BUILD_POLICY = std::conditional_t< RAJAHelper< POLICY >::space == MemorySpace::host, POLICY, serialPolicy >;
+
+  static constexpr IndexType MAX_BATCH_SIZE = 10;
+
+  void createMatrix( IndexType const nRows, IndexType const nCols, IndexType const maxRowLength )
+  {
+    m_matrix = CRS( nRows, nCols );
+
+    std::uniform_int_distribution< IndexType > lengthDist( 0, maxRowLength );
+    std::uniform_int_distribution< ColType > colDist( 0, nCols - 1 );
+    for( IndexType row = 0; row < nRows; ++row )
+    {
+      IndexType const length = lengthDist( m_gen );
+      for( IndexType i = 0; i < length; ++i )
+      { m_matrix.insertNonZero( row, colDist( m_gen ), T() ); }
+    }
+  }
+
+  void find()
+  {
+    createMatrix( 100, 1000, 200 );
+
+    Index index;
+    EXPECT_FALSE( index.isValidFor( m_matrix ) );
+
+    index.template setFrom< BUILD_POLICY >( m_matrix );
+    ASSERT_TRUE( index.isValidFor( m_matrix ) );
+    EXPECT_GT( index.tableSize(), 0 );
+
+    typename Index::ViewType const view = index.toView( m_matrix );
+    for( IndexType row = 0; row < m_matrix.numRows(); ++row )
+    {
+      IndexType const nnz = m_matrix.numNonZeros( row );
+      ColType const * const columns = m_matrix.getColumns( row );
+      for( ColType col = 0; col < m_matrix.numColumns(); ++col )
+      {
+        IndexType const expected = std::lower_bound( columns, columns + nnz, col ) - columns;
+        bool const present = expected < nnz && columns[ expected ] == col;
+        EXPECT_EQ( view.find( row, columns, nnz, col ), present ? expected : nnz );
+      }
+    }
+  }
+
+  void addToRow()
+  {
+    createMatrix( 150, 300, 100 );
+    m_matrix.compress();
+
+    // For each row pick a batch of existing columns, with repeats, to add to.
+    Array< ColType, 2, RAJA::PERM_IJ, IndexType, DEFAULT_BUFFER > cols( m_matrix.numRows(), MAX_BATCH_SIZE );
+    Array< T, 2, RAJA::PERM_IJ, IndexType, DEFAULT_BUFFER > vals( m_matrix.numRows(), MAX_BATCH_SIZE );
+    Array< IndexType, 1, RAJA::PERM_I, IndexType, DEFAULT_BUFFER > batchSizes( m_matrix.numRows() );
+
+    CRS expected( m_matrix );
+    std::uniform_int_distribution< int > valueDist( -10, 10 );
+    for( IndexType row = 0; row < m_matrix.numRows(); ++row )
+    {
+      IndexType const nnz = m_matrix.numNonZeros( row );
+      batchSizes[ row ] = nnz == 0 ? 0 : MAX_BATCH_SIZE;
+      for( IndexType i = 0; i < batchSizes[ row ]; ++i )
+      {
+        cols( row, i ) = m_matrix.getColumns( row )[ std::uniform_int_distribution< IndexType >( 0, nnz - 1 )( m_gen ) ];
+        vals( row, i ) = T( valueDist( m_gen ) );
+      }
+
+      expected.template addToRowBinarySearchUnsorted< RAJA::builtin_atomic >( row, cols[ row ], vals[ row ], batchSizes[ row ] );
+    }
+
+    Index index;
+    index.template setFrom< BUILD_POLICY >( m_matrix );
+
+    typename Index::ViewType const indexView = index.toView( m_matrix );
+    CRSMatrixView< T, ColType const, IndexType const, DEFAULT_BUFFER, OffsetType > const matrixView = m_matrix.toViewConstSizes();
+    ArrayView< ColType const, 2, 1, IndexType, DEFAULT_BUFFER > const colsView = cols.toViewConst();
+    ArrayView< T const, 2, 1, IndexType, DEFAULT_BUFFER > const valsView = vals.toViewConst();
+    ArrayView< IndexType const, 1, 0, IndexType, DEFAULT_BUFFER > const batchSizesView = batchSizes.toViewConst();
+    forall< POLICY >( m_matrix.numRows(), [indexView, matrixView, colsView, valsView, batchSizesView] LVARRAY_HOST_DEVICE ( IndexType const row )
+      {
+        indexView.template addToRow< AtomicPolicy >( matrixView, row, colsView[ row ], valsView[ row ], batchSizesView[ row ] );
+      } );
+
+    m_matrix.move( MemorySpace::host, false );
+    for( IndexType row = 0; row < m_matrix.numRows(); ++row )
+    {
+      for( IndexType j = 0; j < m_matrix.numNonZeros( row ); ++j )
+      { EXPECT_EQ( m_matrix.getEntries( row )[ j ], expected.getEntries( row )[ j ] ); }
+    }
+  }
+
+  void stridedColumns()
+  {
+    // The rows of a 27 point stencil on a 64^3 grid, the strides are multiples of the 64 slot tables.
+    IndexType const n = 64;
+    m_matrix = CRS( 8, n * n * n );
+    for( IndexType row = 0; row < m_matrix.numRows(); ++row )
+    {
+      ColType const center = ( 10 + row ) * n * n + 20 * n + 30;
+      for( IndexType dz = -1; dz <= 1; ++dz )
+      {
+        for( IndexType dy = -1; dy <= 1; ++dy )
+        {
+          for( IndexType dx = -1; dx <= 1; ++dx )
+          { m_matrix.insertNonZero( row, center + dz * n * n + dy * n + dx, T() ); }
+        }
+      }
+    }
+
+    Index index;
+    index.template setFrom< BUILD_POLICY >( m_matrix );
+    EXPECT_EQ( index.tableSize(), 64 * m_matrix.numRows() );
+
+    int const shift = Index::ViewType::hashShift( 64 );
+    typename Index::ViewType const view = index.toView( m_matrix );
+    for( IndexType row = 0; row < m_matrix.numRows(); ++row )
+    {
+      IndexType const nnz = m_matrix.numNonZeros( row );
+      ColType const * const columns = m_matrix.getColumns( row );
+      ASSERT_EQ( nnz, 27 );
+
+      // The columns must be spread over the table, not bunched into one slot per stride.
+      std::set< std::size_t > slots;
+      for( IndexType i = 0; i < nnz; ++i )
+      {
+        slots.insert( Index::ViewType::hash( columns[ i ], shift ) );
+        EXPECT_EQ( view.find( row, columns, nnz, columns[ i ] ), i );
+        EXPECT_EQ( view.find( row, columns, nnz, columns[ i ] + 1000 ), nnz );
+      }
+
+      EXPECT_GE( slots.size(), std::size_t( 20 ) );
+    }
+  }
+
+  void invalidation()
+  {
+    createMatrix( 20, 50, 40 );
+
+    Index index;
+    index.template setFrom< BUILD_POLICY >( m_matrix );
+    EXPECT_TRUE( index.isValidFor( m_matrix ) );
+
+    m_matrix.compress();
+    EXPECT_FALSE( index.isValidFor( m_matrix ) );
+
+    index.template setFrom< BUILD_POLICY >( m_matrix );
+    EXPECT_TRUE( index.isValidFor( m_matrix ) );
+
+    ColType col = 0;
+    while( m_matrix.insertNonZero( 0, col, T() ) == false )
+    { ++col; }
+
+    EXPECT_FALSE( index.isValidFor( m_matrix ) );
+  }
+
+protected:
+  std::mt19937_64 m_gen;
+  CRS m_matrix;
+};
+
+using ColumnIndexTestTypes = ::testing::Types<
+  std::pair< CRSMatrix< double, int, std::ptrdiff_t, DEFAULT_BUFFER >, serialPolicy >
+  , std::pair< CRSMatrix< int, long, int, DEFAULT_BUFFER, std::ptrdiff_t >, serialPolicy >
+#if defined(RAJA_ENABLE_OPENMP)
+  , std::pair< CRSMatrix< double, int, std::ptrdiff_t, DEFAULT_BUFFER >, parallelHostPolicy >
+#endif
+#if defined(LVARRAY_USE_CUDA) && defined(LVARRAY_USE_CHAI)
+  , std::pair< CRSMatrix< double, int, std::ptrdiff_t, DEFAULT_BUFFER >, parallelDevicePolicy< 32 > >
+#endif
+  >;
+
+TYPED_TEST_SUITE( ColumnIndexTest, ColumnIndexTestTypes, );
+
+TYPED_TEST( ColumnIndexTest, find )
+{
+  this->find();
+}
+
+TYPED_TEST( ColumnIndexTest, addToRow )
+{
+  this->addToRow();
+}
+
+TYPED_TEST( ColumnIndexTest, stridedColumns )
+{
+  this->stridedColumns();
+}
+
+TYPED_TEST( ColumnIndexTest, invalidation )
+{
+  this->invalidation();
+}
+
+} // namespace testing
+} // namespace LvArray
+
+// This is the default gtest main method. It is included for ease of debugging.
+int main( int argc, char * * argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  int const result = RUN_ALL_TESTS();
+  return result;
+}
@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC and LvArray contributors.
+ * All rights reserved.
+ * See the LICENSE file for details.
+ * SPDX-License-Identifier: (BSD-3-Clause)
+ */
+
+// Source includes
+#include "LevelSchedule.hpp"
+#include "CRSMatrix.hpp"
+#include "Array.hpp"
+#include "testUtils.hpp"
+#include "MallocBuffer.hpp"
+
+// TPL includes
+#include <gtest/gtest.h>
+
+// System includes
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace LvArray
+{
+namespace testing
+{
+
+template< typename CRS_POLICY_PAIR >
+class LevelScheduleTest : public ::testing::Test
+{
+public:
+  using CRS = typename CRS_POLICY_PAIR::first_type;
+  using POLICY = typename CRS_POLICY_PAIR::second_type;
+
+  using T = typename CRS::EntryType;
+  using ColType = typename CRS::ColType;
+  using IndexType = typename CRS::IndexType;
+  using OffsetType = typename CRS::OffsetType;
+
+  using Schedule = LevelSchedule< ColType, IndexType, DEFAULT_BUFFER, OffsetType >;
+  using Vector = Array< T, 1, RAJA::PERM_I, IndexType, DEFAULT_BUFFER >;
+
+  /**
+   * @brief Create a diagonally dominant matrix with an unsymmetric pattern, the off diagonal
+   *   columns of a row are within @p bandwidth of the diagonal.
+   */
+  void createMatrix( IndexType const nRows, IndexType const maxRowLength, IndexType const bandwidth )
+  {
+    m_matrix = CRS( nRows, nRows );
+
+    std::uniform_int_distribution< IndexType > lengthDist( 0, maxRowLength );
+    std::uniform_int_distribution< IndexType > offsetDist( -bandwidth, bandwidth );
+    std::uniform_real_distribution< double > valueDist( -1, 1 );
+    for( IndexType row = 0; row < nRows; ++row )
+    {
+      T diagonal = 1;
+      IndexType const length = lengthDist( m_gen );
+      for( IndexType i = 0; i < length; ++i )
+      {
+        IndexType const col = row + offsetDist( m_gen );
+        if( col < 0 || col >= nRows || col == row )
+        { continue; }
+
+        T const value = valueDist( m_gen );
+        if( m_matrix.insertNonZero( row, col, value ) )
+        { diagonal += std::abs( value ); }
+      }
+
+      m_matrix.insertNonZero( row, row, diagonal );
+    }
+
+    m_matrix.compress();
+  }
+
+  void fillVector( Vector & vector )
+  {
+    std::uniform_real_distribution< double > valueDist( -1, 1 );
+    vector.resize( m_matrix.numRows() );
+    for( IndexType i = 0; i < vector.size(); ++i )
+    { vector[ i ] = valueDist( m_gen ); }
+  }
+
+  /**
+   * @return The entry ( row, col ) of @p matrix, or zero if it isn't in the sparsity pattern.
+   */
+  static T getEntry( CRS const & matrix, IndexType const row, IndexType const col )
+  {
+    IndexType const nnz = matrix.numNonZeros( row );
+    ColType const * const columns = matrix.getColumns( row );
+    IndexType const pos = sortedArrayManipulation::find( columns, nnz, ColType( col ) );
+    return ( pos < nnz && columns[ pos ] == col ) ? matrix.getEntries( row )[ pos ] : T( 0 );
+  }
+
+  static void expectNear( T const value, T const expected )
+  { EXPECT_NEAR( value, expected, 1e-12 * ( 1 + std::abs( expected ) ) ); }
+
+  void levels()
+  {
+    createMatrix( 200, 6, 10 );
+
+    Schedule schedule;
+    EXPECT_FALSE( schedule.isValidFor( m_matrix ) );
+
+    schedule.setFrom( m_matrix );
+    ASSERT_TRUE( schedule.isValidFor( m_matrix ) );
+
+    // Every row is in exactly one level and the rows of a level are sorted.
+    ArrayOfArraysView< IndexType const, IndexType const, true, DEFAULT_BUFFER > const levelToRows = schedule.levelToRows();
+    ASSERT_EQ( levelToRows.size(), schedule.numLevels() );
+    std::vector< IndexType > rowLevels( m_matrix.numRows(), -1 );
+    for( IndexType level = 0; level < levelToRows.size(); ++level )
+    {
+      EXPECT_GT( levelToRows.sizeOfArray( level ), 0 );
+      for( IndexType i = 0; i < levelToRows.sizeOfArray( level ); ++i )
+      {
+        IndexType const row = levelToRows( level, i );
+        EXPECT_EQ( rowLevels[ row ], -1 );
+        rowLevels[ row ] = level;
+
+        if( i > 0 )
+        { EXPECT_LT( levelToRows( level, i - 1 ), row ); }
+      }
+    }
+
+    // A row comes after every row before it that it is coupled to in either direction.
+    for( IndexType row = 0; row < m_matrix.numRows(); ++row )
+    {
+      ASSERT_GE( rowLevels[ row ], 0 );
+      for( IndexType i = 0; i < m_matrix.numNonZeros( row ); ++i )
+      {
+        IndexType const col = m_matrix.getColumns( row )[ i ];
+        if( col < row )
+        { EXPECT_LT( rowLevels[ col ], rowLevels[ row ] ); }
+        if( col > row )
+        { EXPECT_GT( rowLevels[ col ], rowLevels[ row ] ); }
+      }
+    }
+
+    // A diagonal matrix has a single level and a tridiagonal matrix has one level per row.
+    CRS diagonal( 10, 10 );
+    CRS tridiagonal( 10, 10 );
+    for( IndexType row = 0; row < 10; ++row )
+    {
+      diagonal.insertNonZero( row, row, T( 1 ) );
+      tridiagonal.insertNonZero( row, row, T( 1 ) );
+      if( row > 0 )
+      { tridiagonal.insertNonZero( row, row - 1, T( 1 ) ); }
+    }
+
+    schedule.setFrom( diagonal );
+    EXPECT_EQ( schedule.numLevels(), 1 );
+
+    schedule.setFrom( tridiagonal );
+    EXPECT_EQ( schedule.numLevels(), 10 );
+  }
+
+  void gaussSeidel()
+  {
+    createMatrix( 300, 8, 20 );
+
+    Vector b;
+    Vector x;
+    fillVector( b );
+    fillVector( x );
+
+    // The reference sweeps, a serial loop over the rows.
+    std::vector< T > expected( x.begin(), x.end() );
+    auto const updateRow = [&] ( IndexType const row )
+    {
+      T sum = b[ row ];
+      for( IndexType i = 0; i < m_matrix.numNonZeros( row ); ++i )
+      {
+        IndexType const col = m_matrix.getColumns( row )[ i ];
+        if( col != row )
+        { sum -= m_matrix.getEntries( row )[ i ] * expected[ col ]; }
+      }
+
+      expected[ row ] = sum / getEntry( m_matrix, row, row );
+    };
+
+    Schedule schedule;
+    schedule.setFrom( m_matrix );
+
+    for( int iter = 0; iter < 2; ++iter )
+    {
+      for( IndexType row = 0; row < m_matrix.numRows(); ++row )
+      { updateRow( row ); }
+
+      for( IndexType row = m_matrix.numRows() - 1; row >= 0; --row )
+      { updateRow( row ); }
+
+      schedule.template gaussSeidelForward< POLICY >( m_matrix, b.toViewConst(), x.toView() );
+      schedule.template gaussSeidelBackward< POLICY >( m_matrix, b.toViewConst(), x.toView() );
+    }
+
+    x.move( MemorySpace::host );
+    for( IndexType row = 0; row < m_matrix.numRows(); ++row )
+    { expectNear( x[ row ], expected[ row ] ); }
+  }
+
+  void ilu0()
+  {
+    createMatrix( 250, 8, 15 );
+    CRS const original( m_matrix );
+
+    Schedule schedule;
+    schedule.setFrom( m_matrix );
+    schedule.template factorILU0< POLICY >( m_matrix );
+    m_matrix.move( MemorySpace::host );
+    EXPECT_TRUE( schedule.isValidFor( m_matrix ) );
+
+    // L U matches the original matrix on its sparsity pattern.
+    auto const getL = [this] ( IndexType const row, IndexType const col )
+    { return row == col ? T( 1 ) : getEntry( m_matrix, row, col ); };
+
+    for( IndexType row = 0; row < m_matrix.numRows(); ++row )
+    {
+      for( IndexType i = 0; i < m_matrix.numNonZeros( row ); ++i )
+      {
+        IndexType const col = m_matrix.getColumns( row )[ i ];
+        T product = 0;
+        for( IndexType k = 0; k <= std::min( row, col ); ++k )
+        { product += getL( row, k ) * getEntry( m_matrix, k, col ); }
+
+        expectNear( product, original.getEntries( row )[ i ] );
+      }
+    }
+
+    // L U x = b.
+    Vector b;
+    Vector x( m_matrix.numRows() );
+    fillVector( b );
+    schedule.template solveILU0< POLICY >( m_matrix, b.toViewConst(), x.toView() );
+    x.move( MemorySpace::host );
+
+    for( IndexType row = 0; row < m_matrix.numRows(); ++row )
+    {
+      T lux = 0;
+      for( IndexType k = 0; k <= row; ++k )
+      {
+        T const l = getL( row, k );
+        if( l == 0 )
+        { continue; }
+
+        T ux = 0;
+        for( IndexType i = 0; i < m_matrix.numNonZeros( k ); ++i )
+        {
+          IndexType const col = m_matrix.getColumns( k )[ i ];
+          if( col >= k )
+          { ux += m_matrix.getEntries( k )[ i ] * x[ col ]; }
+        }
+
+        lux += l * ux;
+      }
+
+      expectNear( lux, b[ row ] );
+    }
+  }
+
+  void invalidation()
+  {
+    createMatrix( 20, 4, 5 );
+
+    Schedule schedule;
+    schedule.setFrom( m_matrix );
+    EXPECT_TRUE( schedule.isValidFor( m_matrix ) );
+
+    ColType col = 0;
+    while( m_matrix.insertNonZero( 0, col, T() ) == false )
+    { ++col; }
+
+    EXPECT_FALSE( schedule.isValidFor( m_matrix ) );
+
+    schedule.setFrom( m_matrix );
+    EXPECT_TRUE( schedule.isValidFor( m_matrix ) );
+  }
+
+protected:
+  std::mt19937_64 m_gen;
+  CRS m_matrix;
+};
+
+using LevelScheduleTestTypes = ::testing::Types<
+  std::pair< CRSMatrix< double, int, std::ptrdiff_t, DEFAULT_BUFFER >, serialPolicy >
+  , std::pair< CRSMatrix< double, long, int, DEFAULT_BUFFER, std::ptrdiff_t >, serialPolicy >
+#if defined(RAJA_ENABLE_OPENMP)
+  , std::pair< CRSMatrix< double, int, std::ptrdiff_t, DEFAULT_BUFFER >, parallelHostPolicy >
+#endif
+#if defined(LVARRAY_USE_CUDA) && defined(LVARRAY_USE_CHAI)
+  , std::pair< CRSMatrix< double, int, std::ptrdiff_t, DEFAULT_BUFFER >, parallelDevicePolicy< 32 > >
+#endif
+  >;
+
+TYPED_TEST_SUITE( LevelScheduleTest, LevelScheduleTestTypes, );
+
+TYPED_TEST( LevelScheduleTest, levels )
+{
+  this->levels();
+}
+
+TYPED_TEST( LevelScheduleTest, gaussSeidel )
+{
+  this->gaussSeidel();
+}
+
+TYPED_TEST( LevelScheduleTest, ilu0 )
+{
+  this->ilu0();
+}
+
+TYPED_TEST( LevelScheduleTest, invalidation )
+{
+  this->invalidation();
+}
+
+} // namespace testing
+} // namespace LvArray
+
+// This is the default gtest main method. It is included for ease of debugging.
+int main( int argc, char * * argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  int const result = RUN_ALL_TESTS();
+  return result;
+}
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC and LvArray contributors.
+ * All rights reserved.
+ * See the LICENSE file for details.
+ * SPDX-License-Identifier: (BSD-3-Clause)
+ */
+
+// Source includes
+#include "MultiValueCRSMatrix.hpp"
+#include "SparsityPattern.hpp"
+#include "testUtils.hpp"
+#include "MallocBuffer.hpp"
+
+// TPL includes
+#include <gtest/gtest.h>
+
+// System includes
+#include <map>
+#include <random>
+#include <vector>
+
+namespace LvArray
+{
+namespace testing
+{
+
+template< typename MATRIX_POLICY_PAIR >
+class MultiValueCRSMatrixTest : public ::testing::Test
+{
+public:
+  using Matrix = typename MATRIX_POLICY_PAIR::first_type;
+  using POLICY = typename MATRIX_POLICY_PAIR::second_type;
+
+  using T = typename Matrix::EntryType;
+  using ColType = typename Matrix::ColType;
+  using IndexType = typename Matrix::IndexType;
+  using OffsetType = typename Matrix::OffsetType;
+
+  using Pattern = SparsityPattern< ColType, IndexType, DEFAULT_BUFFER, OffsetType >;
+
+  static constexpr IndexType NUM_VALUE_SETS = 3;
+
+  void createMatrix( IndexType const nRows, IndexType const nCols, IndexType const maxRowLength )
+  {
+    Pattern pattern( nRows, nCols );
+    std::uniform_int_distribution< IndexType > lengthDist( 0, maxRowLength );
+    for( IndexType row = 0; row < nRows; ++row )
+    {
+      IndexType const length = lengthDist( m_gen );
+      for( IndexType i = 0; i < length; ++i )
+      { pattern.insertNonZero( row, randomColumn( nCols ) ); }
+    }
+
+    m_matrix = Matrix( pattern, NUM_VALUE_SETS );
+
+    // Give every entry of every value set a distinct value.
+    m_ref.clear();
+    m_ref.resize( NUM_VALUE_SETS, std::vector< std::map< ColType, T > >( nRows ) );
+    for( IndexType valueSet = 0; valueSet < NUM_VALUE_SETS; ++valueSet )
+    {
+      typename Matrix::ViewTypeConstSizes const view = m_matrix.toViewConstSizes( valueSet );
+      for( IndexType row = 0; row < nRows; ++row )
+      {
+        for( IndexType i = 0; i < view.numNonZeros( row ); ++i )
+        {
+          T const value = T( 1000 * valueSet + 10 * row + i );
+          view.getEntries( row )[ i ] = value;
+          m_ref[ valueSet ][ row ][ view.getColumns( row )[ i ] ] = value;
+        }
+      }
+    }
+  }
+
+  void compareToReference() const
+  {
+    ASSERT_EQ( m_matrix.numValueSets(), m_ref.size() );
+    for( IndexType valueSet = 0; valueSet < m_matrix.numValueSets(); ++valueSet )
+    {
+      typename Matrix::ViewTypeConst const view = m_matrix.toViewConst( valueSet );
+      ASSERT_EQ( view.numRows(), m_ref[ valueSet ].size() );
+      for( IndexType row = 0; row < view.numRows(); ++row )
+      {
+        ASSERT_EQ( view.numNonZeros( row ), m_ref[ valueSet ][ row ].size() );
+
+        IndexType i = 0;
+        for( auto const & entry : m_ref[ valueSet ][ row ] )
+        {
+          EXPECT_EQ( view.getColumns( row )[ i ], entry.first );
+          EXPECT_EQ( view.getEntries( row )[ i ], entry.second );
+          ++i;
+        }
+      }
+    }
+  }
+
+  void sharedStructure()
+  {
+    createMatrix( 50, 60, 20 );
+    compareToReference();
+
+    // Every value set uses the same columns but has its own entries.
+    for( IndexType row = 0; row < m_matrix.numRows(); ++row )
+    {
+      for( IndexType valueSet = 1; valueSet < NUM_VALUE_SETS; ++valueSet )
+      {
+        EXPECT_EQ( m_matrix.toViewConst( valueSet ).getColumns( row ).dataIfContiguous(),
+                   m_matrix.toViewConst( 0 ).getColumns( row ).dataIfContiguous() );
+        EXPECT_NE( m_matrix.toViewConst( valueSet ).getEntries( row ).dataIfContiguous(),
+                   m_matrix.toViewConst( 0 ).getEntries( row ).dataIfContiguous() );
+      }
+    }
+
+    // Modify one value set in a kernel.
+    typename Matrix::ViewTypeConstSizes const view = m_matrix.toViewConstSizes( 1 );
+    forall< POLICY >( view.numRows(), [view] LVARRAY_HOST_DEVICE ( IndexType const row )
+      {
+        for( IndexType i = 0; i < view.numNonZeros( row ); ++i )
+        { view.getEntries( row )[ i ] = T( 2 ); }
+      } );
+
+    m_matrix.move( MemorySpace::host, false );
+    for( auto & row : m_ref[ 1 ] )
+    {
+      for( auto & entry : row )
+      { entry.second = T( 2 ); }
+    }
+
+    compareToReference();
+
+    m_matrix.setNumValueSets( NUM_VALUE_SETS + 1 );
+    m_ref.emplace_back( m_matrix.numRows() );
+    for( IndexType row = 0; row < m_matrix.numRows(); ++row )
+    {
+      for( IndexType i = 0; i < m_matrix.numNonZeros( row ); ++i )
+      { m_ref.back()[ row ][ m_matrix.getColumns( row )[ i ] ] = T(); }
+    }
+
+    compareToReference();
+  }
+
+  void modifySparsityPattern()
+  {
+    createMatrix( 40, 50, 15 );
+
+    // Insert and remove some entries from every row and add some rows.
+    IndexType const newNumRows = m_matrix.numRows() + 5;
+    std::vector< std::vector< ColType > > toInsert( newNumRows );
+    std::vector< std::vector< ColType > > toRemove( m_matrix.numRows() );
+    for( IndexType row = 0; row < newNumRows; ++row )
+    {
+      for( IndexType i = 0; i < 5; ++i )
+      { toInsert[ row ].push_back( randomColumn( m_matrix.numColumns() ) ); }
+    }
+
+    for( IndexType row = 0; row < m_matrix.numRows(); ++row )
+    {
+      for( IndexType i = 0; i < 3; ++i )
+      { toRemove[ row ].push_back( randomColumn( m_matrix.numColumns() ) ); }
+    }
+
+    m_matrix.template modifySparsityPattern< POLICY >( [&] ( Pattern & pattern )
+    {
+      pattern.resize( newNumRows, pattern.numColumns(), 0 );
+      for( IndexType row = 0; row < newNumRows; ++row )
+      {
+        for( ColType const col : toInsert[ row ] )
+        { pattern.insertNonZero( row, col ); }
+      }
+
+      for( std::size_t row = 0; row < toRemove.size(); ++row )
+      {
+        for( ColType const col : toRemove[ row ] )
+        { pattern.removeNonZero( row, col ); }
+      }
+    } );
+
+    for( auto & ref : m_ref )
+    {
+      ref.resize( newNumRows );
+      for( IndexType row = 0; row < newNumRows; ++row )
+      {
+        for( ColType const col : toInsert[ row ] )
+        { ref[ row ].emplace( col, T() ); }
+      }
+
+      for( std::size_t row = 0; row < toRemove.size(); ++row )
+      {
+        for( ColType const col : toRemove[ row ] )
+        { ref[ row ].erase( col ); }
+      }
+    }
+
+    compareToReference();
+
+    // Compressing moves every entry.
+    m_matrix.template modifySparsityPattern< POLICY >( [] ( Pattern & pattern ) { pattern.compress(); } );
+    for( IndexType row = 0; row < m_matrix.numRows() - 1; ++row )
+    { EXPECT_EQ( m_matrix.numNonZeros( row ), m_matrix.nonZeroCapacity( row ) ); }
+
+    compareToReference();
+  }
+
+protected:
+  ColType randomColumn( IndexType const nCols )
+  { return std::uniform_int_distribution< ColType >( 0, nCols - 1 )( m_gen ); }
+
+  std::mt19937_64 m_gen;
+  Matrix m_matrix;
+  std::vector< std::vector< std::map< ColType, T > > > m_ref;
+};
+
+using MultiValueCRSMatrixTestTypes = ::testing::Types<
+  std::pair< MultiValueCRSMatrix< double, int, std::ptrdiff_t, DEFAULT_BUFFER >, serialPolicy >
+  , std::pair< MultiValueCRSMatrix< int, long, int, DEFAULT_BUFFER, std::ptrdiff_t >, serialPolicy >
+#if defined(RAJA_ENABLE_OPENMP)
+  , std::pair< MultiValueCRSMatrix< double, int, std::ptrdiff_t, DEFAULT_BUFFER >, parallelHostPolicy >
+#endif
+  >;
+
+TYPED_TEST_SUITE( MultiValueCRSMatrixTest, MultiValueCRSMatrixTestTypes, );
+
+TYPED_TEST( MultiValueCRSMatrixTest, sharedStructure )
+{
+  this->sharedStructure();
+}
+
+TYPED_TEST( MultiValueCRSMatrixTest, modifySparsityPattern )
+{
+  this->modifySparsityPattern();
+}
+
+} // namespace testing
+} // namespace LvArray
+
+// This is the default gtest main method. It is included for ease of debugging.
+int main( int argc, char * * argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  int const result = RUN_ALL_TESTS();
+  return result;
+}
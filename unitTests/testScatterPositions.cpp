@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC and LvArray contributors.
+ * All rights reserved.
+ * See the LICENSE file for details.
+ * SPDX-License-Identifier: (BSD-3-Clause)
+ */
+
+// Source includes
+#include "ScatterPositions.hpp"
+#include "CRSMatrix.hpp"
+#include "Array.hpp"
+#include "testUtils.hpp"
+#include "MallocBuffer.hpp"
+
+// TPL includes
+#include <gtest/gtest.h>
+
+// System includes
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace LvArray
+{
+namespace testing
+{
+
+template< typename CRS_POLICY_PAIR >
+class ScatterPositionsTest : public ::testing::Test
+{
+public:
+  using CRS = typename CRS_POLICY_PAIR::first_type;
+  using POLICY = typename CRS_POLICY_PAIR::second_type;
+
+  using T = typename CRS::EntryType;
+  using ColType = typename CRS::ColType;
+  using IndexType = typename CRS::IndexType;
+  using OffsetType = typename CRS::OffsetType;
+
+  using Scatter = ScatterPositions< T, ColType, IndexType, DEFAULT_BUFFER, OffsetType >;
+  using AtomicPolicy = typename RAJAHelper< POLICY >::AtomicPolicy;
+
+  static constexpr IndexType NUM_DOFS = 4;
+
+  void createMesh( IndexType const numElems, IndexType const numNodes )
+  {
+    m_elemToDof.resize( numElems, NUM_DOFS );
+    m_localMatrices.resize( numElems, NUM_DOFS, NUM_DOFS );
+
+    std::vector< ColType > nodes( numNodes );
+    std::iota( nodes.begin(), nodes.end(), ColType( 0 ) );
+    std::uniform_int_distribution< int > valueDist( -10, 10 );
+    for( IndexType elem = 0; elem < numElems; ++elem )
+    {
+      std::shuffle( nodes.begin(), nodes.end(), m_gen );
+      for( IndexType i = 0; i < NUM_DOFS; ++i )
+      {
+        m_elemToDof( elem, i ) = nodes[ i ];
+        for( IndexType j = 0; j < NUM_DOFS; ++j )
+        { m_localMatrices( elem, i, j ) = T( valueDist( m_gen ) ); }
+      }
+    }
+
+    m_matrix = CRS( numNodes, numNodes );
+    for( IndexType elem = 0; elem < numElems; ++elem )
+    {
+      for( IndexType i = 0; i < NUM_DOFS; ++i )
+      {
+        for( IndexType j = 0; j < NUM_DOFS; ++j )
+        { m_matrix.insertNonZero( m_elemToDof( elem, i ), m_elemToDof( elem, j ), T() ); }
+      }
+    }
+
+    m_matrix.compress();
+  }
+
+  void assemble()
+  {
+    createMesh( 150, 60 );
+
+    Scatter scatter;
+    EXPECT_FALSE( scatter.isValidFor( m_matrix ) );
+
+    scatter.template setFrom< POLICY >( m_matrix, m_elemToDof.toViewConst() );
+    ASSERT_TRUE( scatter.isValidFor( m_matrix ) );
+
+    // Compute the expected matrix by searching for each entry.
+    m_matrix.move( MemorySpace::host, false );
+    m_elemToDof.move( MemorySpace::host, false );
+    CRS expected( m_matrix );
+    for( IndexType elem = 0; elem < m_elemToDof.size( 0 ); ++elem )
+    {
+      for( IndexType i = 0; i < NUM_DOFS; ++i )
+      {
+        expected.template addToRowBinarySearchUnsorted< RAJA::builtin_atomic >( m_elemToDof( elem, i ),
+                                                                                m_elemToDof[ elem ],
+                                                                                m_localMatrices[ elem ][ i ],
+                                                                                NUM_DOFS );
+      }
+    }
+
+    // Assemble twice to check that the positions can be reused.
+    for( int iter = 0; iter < 2; ++iter )
+    {
+      m_matrix.template setValues< POLICY >( T() );
+
+      ArrayView< OffsetType const, 3, 2, IndexType, DEFAULT_BUFFER > const positions = scatter.toViewConst( m_matrix );
+      ArrayView< T const, 3, 2, IndexType, DEFAULT_BUFFER > const localMatrices = m_localMatrices.toViewConst();
+      CRSMatrixView< T, ColType const, IndexType const, DEFAULT_BUFFER, OffsetType > const view = m_matrix.toViewConstSizes();
+      forall< POLICY >( m_elemToDof.size( 0 ), [positions, localMatrices, view] LVARRAY_HOST_DEVICE ( IndexType const elem )
+        {
+          for( IndexType i = 0; i < NUM_DOFS; ++i )
+          { view.template addToEntries< AtomicPolicy >( positions[ elem ][ i ], localMatrices[ elem ][ i ], NUM_DOFS ); }
+        } );
+
+      m_matrix.move( MemorySpace::host, false );
+      for( IndexType row = 0; row < m_matrix.numRows(); ++row )
+      {
+        ASSERT_EQ( m_matrix.numNonZeros( row ), expected.numNonZeros( row ) );
+        for( IndexType j = 0; j < m_matrix.numNonZeros( row ); ++j )
+        {
+          EXPECT_EQ( m_matrix.getColumns( row )[ j ], expected.getColumns( row )[ j ] );
+          EXPECT_EQ( m_matrix.getEntries( row )[ j ], expected.getEntries( row )[ j ] );
+        }
+      }
+    }
+  }
+
+  void invalidation()
+  {
+    createMesh( 40, 30 );
+
+    // This only checks the bookkeeping of the structure so everything is done on the host.
+    Scatter scatter;
+    scatter.template setFrom< serialPolicy >( m_matrix, m_elemToDof.toViewConst() );
+    EXPECT_TRUE( scatter.isValidFor( m_matrix ) );
+
+    // Modifying the entries doesn't change the structure.
+    m_matrix.template setValues< serialPolicy >( T( 1 ) );
+    EXPECT_TRUE( scatter.isValidFor( m_matrix ) );
+
+    // Neither does taking a view, structural changes made through a view must be marked explicitly.
+    m_matrix.toViewConstSizes();
+    m_matrix.toView();
+    EXPECT_TRUE( scatter.isValidFor( m_matrix ) );
+
+    m_matrix.markStructureModified();
+    EXPECT_FALSE( scatter.isValidFor( m_matrix ) );
+
+    scatter.template setFrom< serialPolicy >( m_matrix, m_elemToDof.toViewConst() );
+    EXPECT_TRUE( scatter.isValidFor( m_matrix ) );
+
+    // Inserting an existing entry doesn't change the structure.
+    m_matrix.insertNonZero( m_elemToDof( 0, 0 ), m_elemToDof( 0, 1 ), T( 1 ) );
+    EXPECT_TRUE( scatter.isValidFor( m_matrix ) );
+
+    // Neither does removing an entry that doesn't exist.
+    ColType const missing = findMissingColumn( 0 );
+    EXPECT_FALSE( m_matrix.removeNonZero( 0, missing ) );
+    EXPECT_TRUE( scatter.isValidFor( m_matrix ) );
+
+    m_matrix.insertNonZero( 0, missing, T( 1 ) );
+    EXPECT_FALSE( scatter.isValidFor( m_matrix ) );
+
+    scatter.template setFrom< serialPolicy >( m_matrix, m_elemToDof.toViewConst() );
+    EXPECT_TRUE( scatter.isValidFor( m_matrix ) );
+
+    EXPECT_TRUE( m_matrix.removeNonZero( 0, missing ) );
+    EXPECT_FALSE( scatter.isValidFor( m_matrix ) );
+
+    scatter.template setFrom< serialPolicy >( m_matrix, m_elemToDof.toViewConst() );
+    m_matrix.compress();
+    EXPECT_FALSE( scatter.isValidFor( m_matrix ) );
+
+    scatter.template setFrom< serialPolicy >( m_matrix, m_elemToDof.toViewConst() );
+    m_matrix.setRowCapacity( 0, m_matrix.nonZeroCapacity( 0 ) + 1 );
+    EXPECT_FALSE( scatter.isValidFor( m_matrix ) );
+
+    // A copy has a new structure, but moving keeps it.
+    scatter.template setFrom< serialPolicy >( m_matrix, m_elemToDof.toViewConst() );
+    CRS copy( m_matrix );
+    EXPECT_FALSE( scatter.isValidFor( copy ) );
+
+    CRS moved( std::move( m_matrix ) );
+    EXPECT_TRUE( scatter.isValidFor( moved ) );
+    EXPECT_FALSE( scatter.isValidFor( m_matrix ) );
+
+    m_matrix = std::move( moved );
+    EXPECT_TRUE( scatter.isValidFor( m_matrix ) );
+    EXPECT_FALSE( scatter.isValidFor( moved ) );
+
+    m_matrix = copy;
+    EXPECT_FALSE( scatter.isValidFor( m_matrix ) );
+  }
+
+private:
+  ColType findMissingColumn( IndexType const row ) const
+  {
+    for( ColType col = 0; col < m_matrix.numColumns(); ++col )
+    {
+      ColType const * const columns = m_matrix.getColumns( row );
+      if( !std::binary_search( columns, columns + m_matrix.numNonZeros( row ), col ) )
+      { return col; }
+    }
+
+    return m_matrix.numColumns() - 1;
+  }
+
+protected:
+  std::mt19937_64 m_gen;
+  CRS m_matrix;
+  Array< ColType, 2, RAJA::PERM_IJ, IndexType, DEFAULT_BUFFER > m_elemToDof;
+  Array< T, 3, RAJA::PERM_IJK, IndexType, DEFAULT_BUFFER > m_localMatrices;
+};
+
+using ScatterPositionsTestTypes = ::testing::Types<
+  std::pair< CRSMatrix< double, int, std::ptrdiff_t, DEFAULT_BUFFER >, serialPolicy >
+  , std::pair< CRSMatrix< int, long, int, DEFAULT_BUFFER, std::ptrdiff_t >, serialPolicy >
+#if defined(RAJA_ENABLE_OPENMP)
+  , std::pair< CRSMatrix< double, int, std::ptrdiff_t, DEFAULT_BUFFER >, parallelHostPolicy >
+#endif
+#if defined(LVARRAY_USE_CUDA) && defined(LVARRAY_USE_CHAI)
+  , std::pair< CRSMatrix< double, int, std::ptrdiff_t, DEFAULT_BUFFER >, parallelDevicePolicy< 32 > >
+#endif
+  >;
+
+TYPED_TEST_SUITE( ScatterPositionsTest, ScatterPositionsTestTypes, );
+
+TYPED_TEST( ScatterPositionsTest, assemble )
+{
+  this->assemble();
+}
+
+TYPED_TEST( ScatterPositionsTest, invalidation )
+{
+  this->invalidation();
+}
+
+} // namespace testing
+} // namespace LvArray
+
+// This is the default gtest main method. It is included for ease of debugging.
+int main( int argc, char * * argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  int const result = RUN_ALL_TESTS();
+  return result;
+}
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC and LvArray contributors.
+ * All rights reserved.
+ * See the LICENSE file for details.
+ * SPDX-License-Identifier: (BSD-3-Clause)
+ */
+
+// Source includes
+#include "SlicedEllMatrix.hpp"
+#include "CRSMatrix.hpp"
+#include "SparsityPattern.hpp"
+#include "Array.hpp"
+#include "testUtils.hpp"
+#include "MallocBuffer.hpp"
+
+// TPL includes
+#include <gtest/gtest.h>
+
+// System includes
+#include <random>
+#include <set>
+#include <vector>
+
+namespace LvArray
+{
+namespace testing
+{
+
+template< typename SELL_POLICY_PAIR >
+class SlicedEllMatrixTest : public ::testing::Test
+{
+public:
+  using SELL = typename SELL_POLICY_PAIR::first_type;
+  using POLICY = typename SELL_POLICY_PAIR::second_type;
+
+  using T = typename SELL::EntryType;
+  using ColType = typename SELL::ColType;
+  using IndexType = typename SELL::IndexType;
+
+  using CRS = CRSMatrix< T, ColType, IndexType, DEFAULT_BUFFER >;
+  using Array1d = Array< T, 1, RAJA::PERM_I, IndexType, DEFAULT_BUFFER >;
+
+  // The structure can only be built on the host.
+  using BUILD_POLICY = std::conditional_t< RAJAHelper< POLICY >::space == MemorySpace::host, POLICY, serialPolicy >;
+
+  static constexpr int CHUNK_SIZE = SELL::chunkSize;
+
+  void createMatrix( IndexType const nRows, IndexType const nCols, IndexType const maxRowLength )
+  {
+    m_matrix = CRS( nRows, nCols );
+
+    std::uniform_int_distribution< IndexType > lengthDist( 0, maxRowLength );
+    std::uniform_int_distribution< ColType > colDist( 0, nCols - 1 );
+    std::uniform_int_distribution< int > valueDist( -10, 10 );
+    for( IndexType row = 0; row < nRows; ++row )
+    {
+      IndexType const length = lengthDist( m_gen );
+      for( IndexType i = 0; i < length; ++i )
+      { m_matrix.insertNonZero( row, colDist( m_gen ), T( valueDist( m_gen ) ) ); }
+    }
+
+    m_matrix.compress();
+
+    m_x.resize( nCols );
+    for( IndexType i = 0; i < nCols; ++i )
+    { m_x[ i ] = T( valueDist( m_gen ) ); }
+  }
+
+  void checkStructure( SELL const & sell ) const
+  {
+    IndexType const nRows = m_matrix.numRows();
+    ASSERT_EQ( sell.numRows(), nRows );
+    ASSERT_EQ( sell.numColumns(), m_matrix.numColumns() );
+    ASSERT_EQ( sell.numChunks(), ( nRows + CHUNK_SIZE - 1 ) / CHUNK_SIZE );
+
+    auto const slotToRow = sell.getSlotToRow();
+    auto const rowToSlot = sell.getRowToSlot();
+
+    // The permutation must be a bijection that only reorders rows within a window.
+    std::set< IndexType > rows;
+    for( IndexType slot = 0; slot < nRows; ++slot )
+    {
+      IndexType const row = slotToRow[ slot ];
+      ASSERT_LT( row, nRows );
+      EXPECT_EQ( rowToSlot[ row ], slot );
+      EXPECT_EQ( row / sell.sigma(), slot / sell.sigma() );
+      rows.insert( row );
+
+      // Within a window the rows are sorted by decreasing length.
+      if( slot % sell.sigma() != 0 && sell.sigma() > 1 )
+      { EXPECT_GE( m_matrix.numNonZeros( slotToRow[ slot - 1 ] ), m_matrix.numNonZeros( row ) ); }
+    }
+    EXPECT_EQ( rows.size(), std::size_t( nRows ) );
+
+    for( IndexType slot = nRows; slot < sell.numChunks() * CHUNK_SIZE; ++slot )
+    { EXPECT_EQ( slotToRow[ slot ], nRows ); }
+
+    // Each chunk is padded to its longest row.
+    IndexType numStored = 0;
+    for( IndexType chunk = 0; chunk < sell.numChunks(); ++chunk )
+    {
+      IndexType width = 0;
+      for( IndexType slot = chunk * CHUNK_SIZE; slot < math::min( nRows, ( chunk + 1 ) * CHUNK_SIZE ); ++slot )
+      { width = math::max( width, m_matrix.numNonZeros( slotToRow[ slot ] ) ); }
+
+      EXPECT_EQ( sell.chunkWidth( chunk ), width );
+      numStored += CHUNK_SIZE * width;
+    }
+
+    EXPECT_EQ( sell.numStoredEntries(), numStored );
+  }
+
+  void checkMultiply( SELL const & sell, bool const zero=false )
+  {
+    IndexType const nRows = m_matrix.numRows();
+
+    Array1d y( nRows );
+    sell.template multiply< POLICY >( m_x.toViewConst(), y.toView() );
+    y.move( MemorySpace::host );
+    m_x.move( MemorySpace::host, false );
+    m_matrix.move( MemorySpace::host, false );
+
+    for( IndexType row = 0; row < nRows; ++row )
+    {
+      T expected = 0;
+      if( !zero )
+      {
+        for( IndexType j = 0; j < m_matrix.numNonZeros( row ); ++j )
+        { expected += m_matrix.getEntries( row )[ j ] * m_x[ m_matrix.getColumns( row )[ j ] ]; }
+      }
+
+      EXPECT_EQ( y[ row ], expected ) << "row = " << row;
+    }
+  }
+
+  void multiply( IndexType const sigma )
+  {
+    createMatrix( 203, 150, 40 );
+
+    SELL sell;
+    sell.template setFrom< BUILD_POLICY >( m_matrix.toViewConst(), sigma );
+
+    checkStructure( sell );
+    checkMultiply( sell );
+  }
+
+  void setValuesFrom()
+  {
+    createMatrix( 157, 157, 25 );
+
+    SELL sell;
+    sell.template setFrom< BUILD_POLICY >( m_matrix.toViewConst(), 4 * CHUNK_SIZE );
+    checkMultiply( sell );
+
+    // Change the values without touching the structure and scatter them into the SELL matrix.
+    for( IndexType row = 0; row < m_matrix.numRows(); ++row )
+    {
+      for( IndexType j = 0; j < m_matrix.numNonZeros( row ); ++j )
+      { m_matrix.getEntries( row )[ j ] = 3 * m_matrix.getEntries( row )[ j ] + T( row % 7 ); }
+    }
+
+    sell.template setValuesFrom< POLICY >( m_matrix.toViewConst() );
+    checkStructure( sell );
+    checkMultiply( sell );
+  }
+
+  void fromSparsityPattern()
+  {
+    createMatrix( 64, 100, 30 );
+
+    SELL sell;
+    sell.template setFrom< BUILD_POLICY >( m_matrix.toSparsityPatternView(), 2 * CHUNK_SIZE );
+    checkStructure( sell );
+    checkMultiply( sell, true );
+
+    sell.template setValuesFrom< POLICY >( m_matrix.toViewConst() );
+    checkMultiply( sell );
+  }
+
+  void setFromTwice()
+  {
+    createMatrix( 120, 120, 40 );
+
+    SELL sell;
+    sell.template setFrom< BUILD_POLICY >( m_matrix.toViewConst(), 4 * CHUNK_SIZE );
+    checkMultiply( sell );
+
+    // Rebuild the same object from a different pattern, none of the old values may survive.
+    createMatrix( 97, 120, 15 );
+    sell.template setFrom< BUILD_POLICY >( m_matrix.toSparsityPatternView(), CHUNK_SIZE );
+    checkStructure( sell );
+    checkMultiply( sell, true );
+
+    sell.template setValuesFrom< POLICY >( m_matrix.toViewConst() );
+    checkMultiply( sell );
+  }
+
+protected:
+  std::mt19937_64 m_gen;
+  CRS m_matrix;
+  Array1d m_x;
+};
+
+using SlicedEllMatrixTestTypes = ::testing::Types<
+  std::pair< SlicedEllMatrix< double, int, std::ptrdiff_t, DEFAULT_BUFFER >, serialPolicy >
+  , std::pair< SlicedEllMatrix< double, int, std::ptrdiff_t, DEFAULT_BUFFER, 4 >, serialPolicy >
+  , std::pair< SlicedEllMatrix< float, long, int, DEFAULT_BUFFER, 16 >, serialPolicy >
+#if defined(RAJA_ENABLE_OPENMP)
+  , std::pair< SlicedEllMatrix< double, int, std::ptrdiff_t, DEFAULT_BUFFER >, parallelHostPolicy >
+#endif
+#if defined(LVARRAY_USE_CUDA) && defined(LVARRAY_USE_CHAI)
+  , std::pair< SlicedEllMatrix< double, int, std::ptrdiff_t, DEFAULT_BUFFER, 32 >, parallelDevicePolicy< 32 > >
+#endif
+  >;
+
+TYPED_TEST_SUITE( SlicedEllMatrixTest, SlicedEllMatrixTestTypes, );
+
+TYPED_TEST( SlicedEllMatrixTest, multiplyNoSorting )
+{
+  this->multiply( 1 );
+}
+
+TYPED_TEST( SlicedEllMatrixTest, multiplySortWithinChunks )
+{
+  this->multiply( TestFixture::CHUNK_SIZE );
+}
+
+TYPED_TEST( SlicedEllMatrixTest, multiplySortWithinWindows )
+{
+  this->multiply( 8 * TestFixture::CHUNK_SIZE );
+}
+
+TYPED_TEST( SlicedEllMatrixTest, multiplySortAll )
+{
+  this->multiply( 1000 );
+}
+
+TYPED_TEST( SlicedEllMatrixTest, setValuesFrom )
+{
+  this->setValuesFrom();
+}
+
+TYPED_TEST( SlicedEllMatrixTest, fromSparsityPattern )
+{
+  this->fromSparsityPattern();
+}
+
+TYPED_TEST( SlicedEllMatrixTest, setFromTwice )
+{
+  this->setFromTwice();
+}
+
+} // namespace testing
+} // namespace LvArray
+
+// This is the default gtest main method. It is included for ease of debugging.
+int main( int argc, char * * argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  int const result = RUN_ALL_TESTS();
+  return result;
+}
@@ -18,6 +18,8 @@
 #include <vector>
 #include <set>
 #include <random>
+#include <algorithm>
+#include <iterator>
 
 namespace LvArray
 {
@@ -241,6 +243,52 @@ public:
     COMPARE_TO_REFERENCE
   }
 
+  /**
+   * @brief Test setToIntersection, setToUnion and setToDifference, including when an argument is m_set.
+   * @param [in] maxInserts the number of values to insert into the other set.
+   * @param [in] maxVal the largest value possibly generate.
+   */
+  void setAlgebraTest( INDEX_TYPE const maxInserts, INDEX_TYPE const maxVal )
+  {
+    SORTED_ARRAY other;
+    std::set< T > otherRef;
+    for( INDEX_TYPE i = 0; i < maxInserts; ++i )
+    {
+      T const value = randVal( maxVal );
+      other.insert( value );
+      otherRef.insert( value );
+    }
+
+    SORTED_ARRAY const original( m_set );
+    std::set< T > const originalRef( m_ref );
+
+    m_set.setToUnion( original.toViewConst(), other.toViewConst() );
+    m_ref.clear();
+    std::set_union( originalRef.begin(), originalRef.end(), otherRef.begin(), otherRef.end(),
+                    std::inserter( m_ref, m_ref.end() ) );
+    COMPARE_TO_REFERENCE
+
+    m_set.setToDifference( m_set.toViewConst(), other.toViewConst() );
+    std::set< T > difference;
+    std::set_difference( m_ref.begin(), m_ref.end(), otherRef.begin(), otherRef.end(),
+                         std::inserter( difference, difference.end() ) );
+    m_ref = difference;
+    COMPARE_TO_REFERENCE
+
+    m_set.setToIntersection( original.toViewConst(), other.toViewConst() );
+    m_ref.clear();
+    std::set_intersection( originalRef.begin(), originalRef.end(), otherRef.begin(), otherRef.end(),
+                           std::inserter( m_ref, m_ref.end() ) );
+    COMPARE_TO_REFERENCE
+
+    m_set.setToIntersection( m_set.toViewConst(), m_set.toViewConst() );
+    COMPARE_TO_REFERENCE
+
+    m_set.setToUnion( m_set.toViewConst(), original.toViewConst() );
+    m_ref = originalRef;
+    COMPARE_TO_REFERENCE
+  }
+
 protected:
 
   T randVal( INDEX_TYPE const max )
@@ -327,6 +375,15 @@ TYPED_TEST( SortedArrayTest, deepCopy )
   this->deepCopyTest();
 }
 
+TYPED_TEST( SortedArrayTest, setAlgebra )
+{
+  for( int i = 0; i < 2; ++i )
+  {
+    this->insertTest( DEFAULT_MAX_INSERTS, DEFAULT_MAX_VAL );
+    this->setAlgebraTest( DEFAULT_MAX_INSERTS, DEFAULT_MAX_VAL );
+  }
+}
+
 
 template< typename SORTED_ARRAY_POLICY_PAIR >
 class SortedArrayViewTest : public SortedArrayTest< typename SORTED_ARRAY_POLICY_PAIR::first_type >
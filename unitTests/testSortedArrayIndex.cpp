@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC and LvArray contributors.
+ * All rights reserved.
+ * See the LICENSE file for details.
+ * SPDX-License-Identifier: (BSD-3-Clause)
+ */
+
+// Source includes
+#include "SortedArrayIndex.hpp"
+#include "SortedArray.hpp"
+#include "Array.hpp"
+#include "testUtils.hpp"
+#include "MallocBuffer.hpp"
+
+// TPL includes
+#include <gtest/gtest.h>
+
+// System includes
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace LvArray
+{
+namespace testing
+{
+
+template< typename SORTED_ARRAY_POLICY_PAIR >
+class SortedArrayIndexTest : public ::testing::Test
+{
+public:
+  using SortedArrayType = typename SORTED_ARRAY_POLICY_PAIR::first_type;
+  using POLICY = typename SORTED_ARRAY_POLICY_PAIR::second_type;
+
+  using T = typename SortedArrayType::value_type;
+  using IndexType = typename SortedArrayType::IndexType;
+
+  using Index = SortedArrayIndex< T, IndexType, DEFAULT_BUFFER >;
+  using IndexView = typename Index::ViewTypeConst;
+
+  template< typename U >
+  using Array1D = Array< U, 1, RAJA::PERM_I, IndexType, DEFAULT_BUFFER >;
+
+  /**
+   * @brief Check find and contains of an index built from @p size random even values, the odd
+   *   values in between are never found.
+   */
+  void findAndContains( IndexType const size )
+  {
+    SortedArrayType sorted;
+    std::uniform_int_distribution< IndexType > dist( 0, 3 * size );
+    while( sorted.size() < size )
+    {
+      std::vector< T > values( size - sorted.size() );
+      for( T & value : values )
+      { value = T( 2 * dist( m_gen ) ); }
+
+      values.resize( sortedArrayManipulation::makeSortedUnique( values.begin(), values.end() ) );
+      sorted.insert( values.begin(), values.end() );
+    }
+
+    Index const index( sorted.toViewConst() );
+    EXPECT_EQ( index.size(), size );
+
+    IndexType const numQueries = 2 * size + 10;
+    Array1D< T > queries( numQueries );
+    for( IndexType i = 0; i < numQueries; ++i )
+    { queries[ i ] = T( std::uniform_int_distribution< IndexType >( -1, 6 * size + 2 )( m_gen ) ); }
+
+    Array1D< IndexType > positions( numQueries );
+    Array1D< bool > found( numQueries );
+
+    IndexView const view = index.toViewConst();
+    ArrayView< T const, 1, 0, IndexType, DEFAULT_BUFFER > const queriesView = queries.toViewConst();
+    ArrayView< IndexType, 1, 0, IndexType, DEFAULT_BUFFER > const positionsView = positions.toView();
+    ArrayView< bool, 1, 0, IndexType, DEFAULT_BUFFER > const foundView = found.toView();
+    forall< POLICY >( numQueries, [view, queriesView, positionsView, foundView] LVARRAY_HOST_DEVICE ( IndexType const i )
+        {
+          positionsView[ i ] = view.find( queriesView[ i ] );
+          foundView[ i ] = view.contains( queriesView[ i ] );
+        } );
+
+    positions.move( MemorySpace::host );
+    found.move( MemorySpace::host );
+    for( IndexType i = 0; i < numQueries; ++i )
+    {
+      IndexType const expected = std::lower_bound( sorted.begin(), sorted.end(), queries[ i ] ) - sorted.begin();
+      EXPECT_EQ( positions[ i ], expected );
+      EXPECT_EQ( found[ i ], std::binary_search( sorted.begin(), sorted.end(), queries[ i ] ) );
+    }
+  }
+
+  void rebuild()
+  {
+    SortedArrayType sorted;
+    for( IndexType i = 0; i < 100; ++i )
+    { sorted.insert( T( i ) ); }
+
+    Index index;
+    EXPECT_EQ( index.size(), 0 );
+    EXPECT_EQ( index.toViewConst().find( T( 5 ) ), 0 );
+    EXPECT_FALSE( index.toViewConst().contains( T( 5 ) ) );
+
+    index.setFrom( sorted.toViewConst() );
+    EXPECT_EQ( index.toViewConst().find( T( 5 ) ), 5 );
+    EXPECT_TRUE( index.toViewConst().contains( T( 5 ) ) );
+
+    sorted.remove( T( 5 ) );
+    index.setFrom( sorted.toViewConst() );
+    EXPECT_EQ( index.size(), 99 );
+    EXPECT_EQ( index.toViewConst().find( T( 5 ) ), 5 );
+    EXPECT_FALSE( index.toViewConst().contains( T( 5 ) ) );
+  }
+
+protected:
+  std::mt19937_64 m_gen;
+};
+
+using SortedArrayIndexTestTypes = ::testing::Types<
+  std::pair< SortedArray< int, std::ptrdiff_t, DEFAULT_BUFFER >, serialPolicy >
+  , std::pair< SortedArray< long, int, DEFAULT_BUFFER >, serialPolicy >
+  , std::pair< SortedArray< double, std::ptrdiff_t, DEFAULT_BUFFER >, serialPolicy >
+#if defined(RAJA_ENABLE_OPENMP)
+  , std::pair< SortedArray< int, std::ptrdiff_t, DEFAULT_BUFFER >, parallelHostPolicy >
+#endif
+#if defined(LVARRAY_USE_CUDA) && defined(LVARRAY_USE_CHAI)
+  , std::pair< SortedArray< int, std::ptrdiff_t, DEFAULT_BUFFER >, parallelDevicePolicy< 32 > >
+  , std::pair< SortedArray< double, std::ptrdiff_t, DEFAULT_BUFFER >, parallelDevicePolicy< 32 > >
+#endif
+  >;
+
+TYPED_TEST_SUITE( SortedArrayIndexTest, SortedArrayIndexTestTypes, );
+
+TYPED_TEST( SortedArrayIndexTest, findAndContains )
+{
+  // Complete trees, trees with a partially filled last level and a large index.
+  for( std::ptrdiff_t const size : { 0, 1, 2, 3, 7, 8, 15, 16, 17, 100, 1023, 1024, 1025, 50000 } )
+  {
+    this->findAndContains( size );
+  }
+}
+
+TYPED_TEST( SortedArrayIndexTest, rebuild )
+{
+  this->rebuild();
+}
+
+} // namespace testing
+} // namespace LvArray
+
+// This is the default gtest main method. It is included for ease of debugging.
+int main( int argc, char * * argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  int const result = RUN_ALL_TESTS();
+  return result;
+}
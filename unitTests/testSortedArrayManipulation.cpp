@@ -18,6 +18,8 @@
 #include <random>
 #include <algorithm>
 #include <iomanip>
+#include <iterator>
+#include <limits>
 #include <vector>
 #include <set>
 
@@ -302,6 +304,159 @@ TYPED_TEST( DualArrayTest, makeSorted )
   this->testMakeSorted( 250 );
 }
 
+template< typename T >
+class RadixSortTest : public ::testing::Test
+{
+public:
+  void radixSort( INDEX_TYPE const maxSize )
+  {
+    for( INDEX_TYPE size = 0; size < maxSize; size = INDEX_TYPE( size * 1.5 + 1 ) )
+    {
+      // Values over the whole range of T, and values that only differ in the low byte.
+      for( T const maxValue : { std::numeric_limits< T >::max(), T( 100 ) } )
+      {
+        T const minValue = std::is_signed< T >::value ? T( -maxValue ) : T( 0 );
+        std::uniform_int_distribution< long long > dist( minValue, maxValue );
+
+        std::vector< T > values( size );
+        for( T & value : values )
+        { value = T( dist( m_gen ) ); }
+
+        std::vector< T > expected( values );
+        std::sort( expected.begin(), expected.end() );
+
+        std::vector< T > scratch( size );
+        sortedArrayManipulation::radixSort( values.data(), size, scratch.data() );
+        EXPECT_EQ( values, expected );
+      }
+    }
+  }
+
+private:
+  std::mt19937_64 m_gen;
+};
+
+using RadixSortTestTypes = ::testing::Types<
+  signed char
+  , unsigned short
+  , int
+  , unsigned int
+  , long long
+  >;
+TYPED_TEST_SUITE( RadixSortTest, RadixSortTestTypes, );
+
+TYPED_TEST( RadixSortTest, radixSort )
+{
+  this->radixSort( 5000 );
+}
+
+template< typename T_COMP_PAIR >
+class SetAlgebraTest : public ::testing::Test
+{
+public:
+  using T = typename T_COMP_PAIR::first_type;
+  using Compare = typename T_COMP_PAIR::second_type;
+
+  void setAlgebra( INDEX_TYPE const maxSize )
+  {
+    // Sizes that differ by a lot so that both the merge and the galloping kernels are used.
+    for( INDEX_TYPE sizeA = 0; sizeA < maxSize; sizeA = INDEX_TYPE( sizeA * 3 + 1 ) )
+    {
+      for( INDEX_TYPE sizeB = 0; sizeB < maxSize; sizeB = INDEX_TYPE( sizeB * 3 + 1 ) )
+      {
+        std::vector< T > const a = createSet( sizeA, 2 * maxSize );
+        std::vector< T > const b = createSet( sizeB, 2 * maxSize );
+        check( a, b );
+        check( a, a );
+      }
+    }
+  }
+
+private:
+  std::vector< T > createSet( INDEX_TYPE const size, INDEX_TYPE const maxValue )
+  {
+    std::uniform_int_distribution< INDEX_TYPE > dist( 0, maxValue );
+    std::vector< T > values( size );
+    for( T & value : values )
+    { value = T( dist( m_gen ) ); }
+
+    INDEX_TYPE const numUnique = sortedArrayManipulation::makeSortedUnique( values.begin(), values.end(), Compare() );
+    values.resize( numUnique );
+    return values;
+  }
+
+  void check( std::vector< T > const & a, std::vector< T > const & b ) const
+  {
+    std::vector< T > expected;
+    std::vector< T > output( a.size() + b.size() );
+    INDEX_TYPE const sizeA = a.size();
+    INDEX_TYPE const sizeB = b.size();
+
+    std::set_intersection( a.begin(), a.end(), b.begin(), b.end(), std::back_inserter( expected ), Compare() );
+    EXPECT_EQ( sortedArrayManipulation::setIntersectionSize( a.data(), sizeA, b.data(), sizeB, Compare() ), INDEX_TYPE( expected.size() ) );
+    INDEX_TYPE size = sortedArrayManipulation::setIntersection( a.data(), sizeA, b.data(), sizeB, output.data(), Compare() );
+    EXPECT_EQ( std::vector< T >( output.begin(), output.begin() + size ), expected );
+
+    expected.clear();
+    std::set_union( a.begin(), a.end(), b.begin(), b.end(), std::back_inserter( expected ), Compare() );
+    size = sortedArrayManipulation::setUnion( a.data(), sizeA, b.data(), sizeB, output.data(), Compare() );
+    EXPECT_EQ( std::vector< T >( output.begin(), output.begin() + size ), expected );
+
+    expected.clear();
+    std::set_difference( a.begin(), a.end(), b.begin(), b.end(), std::back_inserter( expected ), Compare() );
+    size = sortedArrayManipulation::setDifference( a.data(), sizeA, b.data(), sizeB, output.data(), Compare() );
+    EXPECT_EQ( std::vector< T >( output.begin(), output.begin() + size ), expected );
+  }
+
+  std::mt19937_64 m_gen;
+};
+
+using SetAlgebraTestTypes = ::testing::Types<
+  std::pair< int, sortedArrayManipulation::less< int > >
+  , std::pair< int, sortedArrayManipulation::greater< int > >
+  , std::pair< long long, sortedArrayManipulation::less< long long > >
+  >;
+TYPED_TEST_SUITE( SetAlgebraTest, SetAlgebraTestTypes, );
+
+TYPED_TEST( SetAlgebraTest, setAlgebra )
+{
+  this->setAlgebra( 3000 );
+}
+
+template< typename T_COMP_PAIR >
+class FindTest : public ::testing::Test
+{
+public:
+  using T = typename T_COMP_PAIR::first_type;
+  using Compare = typename T_COMP_PAIR::second_type;
+
+  void find( INDEX_TYPE const maxSize )
+  {
+    // Sizes on either side of LVARRAY_FIND_PREFETCH_MIN_SIZE.
+    for( INDEX_TYPE size = 0; size < maxSize; size = INDEX_TYPE( size * 1.5 + 1 ) )
+    {
+      std::vector< T > values( size );
+      for( INDEX_TYPE i = 0; i < size; ++i )
+      { values[ i ] = T( 2 * i ); }
+
+      std::sort( values.begin(), values.end(), Compare() );
+
+      for( INDEX_TYPE value = -1; value <= 2 * size; ++value )
+      {
+        INDEX_TYPE const expected = std::lower_bound( values.begin(), values.end(), T( value ), Compare() ) - values.begin();
+        EXPECT_EQ( sortedArrayManipulation::find( values.data(), size, T( value ), Compare() ), expected );
+      }
+    }
+  }
+};
+
+TYPED_TEST_SUITE( FindTest, SetAlgebraTestTypes, );
+
+TYPED_TEST( FindTest, find )
+{
+  this->find( 5000 );
+}
+
 } // namespace testing
 } // namespace LvArray
 
@@ -0,0 +1,851 @@
+/*
+ * Copyright (c) 2021, Lawrence Livermore National Security, LLC and LvArray contributors.
+ * All rights reserved.
+ * See the LICENSE file for details.
+ * SPDX-License-Identifier: (BSD-3-Clause)
+ */
+
+// Source includes
+#include "sparseMatrixOps.hpp"
+#include "CRSMatrix.hpp"
+#include "SparsityPattern.hpp"
+#include "ArrayOfArrays.hpp"
+#include "testUtils.hpp"
+
+// TPL includes
+#include <gtest/gtest.h>
+
+// System includes
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace LvArray
+{
+namespace testing
+{
+
+template< typename CRS_POLICY_PAIR >
+class SparseMatrixOpsTest : public ::testing::Test
+{
+public:
+  using CRS = typename CRS_POLICY_PAIR::first_type;
+  using POLICY = typename CRS_POLICY_PAIR::second_type;
+
+  using T = typename CRS::EntryType;
+  using ColType = typename CRS::ColType;
+  using IndexType = typename CRS::IndexType;
+
+  using REF_TYPE = std::vector< std::map< ColType, T > >;
+  using Pattern = SparsityPattern< ColType, IndexType, DEFAULT_BUFFER >;
+  using Permutation = Array< IndexType, 1, RAJA::PERM_I, IndexType, DEFAULT_BUFFER >;
+
+  // The symbolic phase can only be run on the host.
+  using BUILD_POLICY = std::conditional_t< RAJAHelper< POLICY >::space == MemorySpace::host, POLICY, serialPolicy >;
+
+  static constexpr IndexType NODES_PER_ELEM = 4;
+
+  void createMatrix( CRS & matrix, IndexType const nRows, IndexType const nCols, IndexType const maxRowLength )
+  {
+    matrix = CRS( nRows, nCols );
+
+    std::uniform_int_distribution< IndexType > lengthDist( 0, maxRowLength );
+    std::uniform_int_distribution< ColType > colDist( 0, nCols - 1 );
+    std::uniform_int_distribution< int > valueDist( -10, 10 );
+    for( IndexType row = 0; row < nRows; ++row )
+    {
+      IndexType const length = lengthDist( m_gen );
+      for( IndexType i = 0; i < length; ++i )
+      { matrix.insertNonZero( row, colDist( m_gen ), T( valueDist( m_gen ) ) ); }
+    }
+  }
+
+  REF_TYPE referenceProduct() const
+  {
+    REF_TYPE ref( m_a.numRows() );
+    for( IndexType row = 0; row < m_a.numRows(); ++row )
+    {
+      for( IndexType i = 0; i < m_a.numNonZeros( row ); ++i )
+      {
+        ColType const k = m_a.getColumns( row )[ i ];
+        T const aik = m_a.getEntries( row )[ i ];
+        for( IndexType j = 0; j < m_b.numNonZeros( k ); ++j )
+        { ref[ row ][ m_b.getColumns( k )[ j ] ] += aik * m_b.getEntries( k )[ j ]; }
+      }
+    }
+
+    return ref;
+  }
+
+  void checkProduct( CRS & c ) const
+  {
+    c.move( MemorySpace::host, false );
+
+    REF_TYPE const ref = referenceProduct();
+    ASSERT_EQ( c.numRows(), m_a.numRows() );
+    ASSERT_EQ( c.numColumns(), m_b.numColumns() );
+
+    for( IndexType row = 0; row < c.numRows(); ++row )
+    {
+      ASSERT_EQ( c.numNonZeros( row ), IndexType( ref[ row ].size() ) );
+      EXPECT_EQ( c.nonZeroCapacity( row ), c.numNonZeros( row ) );
+
+      IndexType i = 0;
+      for( auto const & colAndValue : ref[ row ] )
+      {
+        EXPECT_EQ( c.getColumns( row )[ i ], colAndValue.first );
+        EXPECT_EQ( c.getEntries( row )[ i ], colAndValue.second );
+        ++i;
+      }
+    }
+  }
+
+  void multiply( IndexType const n, IndexType const m, IndexType const k, IndexType const maxRowLength )
+  {
+    createMatrix( m_a, n, k, maxRowLength );
+    createMatrix( m_b, k, m, maxRowLength );
+
+    CRS c;
+    sparseMatrixOps::multiply< BUILD_POLICY >( m_a.toViewConst(), m_b.toViewConst(), c );
+    checkProduct( c );
+  }
+
+  void reuseSymbolic()
+  {
+    createMatrix( m_a, 120, 90, 12 );
+    createMatrix( m_b, 90, 110, 12 );
+
+    Pattern pattern;
+    sparseMatrixOps::multiplySymbolic< BUILD_POLICY >( m_a.toSparsityPatternView(), m_b.toSparsityPatternView(), pattern );
+
+    CRS c;
+    c.template assimilate< BUILD_POLICY >( std::move( pattern ) );
+
+    // Poison the values, they should all be overwritten.
+    c.template setValues< BUILD_POLICY >( T( 1000 ) );
+
+    for( int iter = 0; iter < 3; ++iter )
+    {
+      sparseMatrixOps::multiplyNumeric< POLICY >( m_a.toViewConst(), m_b.toViewConst(), c.toViewConstSizes() );
+      checkProduct( c );
+
+      // Change the values of the operands without changing their structure.
+      m_a.move( MemorySpace::host );
+      m_b.move( MemorySpace::host );
+      for( IndexType row = 0; row < m_a.numRows(); ++row )
+      {
+        for( IndexType i = 0; i < m_a.numNonZeros( row ); ++i )
+        { m_a.getEntries( row )[ i ] = 2 * m_a.getEntries( row )[ i ] - T( row % 5 ); }
+      }
+
+      for( IndexType row = 0; row < m_b.numRows(); ++row )
+      {
+        for( IndexType i = 0; i < m_b.numNonZeros( row ); ++i )
+        { m_b.getEntries( row )[ i ] += T( iter + 1 ); }
+      }
+    }
+  }
+
+  void graphProduct()
+  {
+    IndexType const numNodes = 97;
+    IndexType const numElems = 64;
+    IndexType const nodesPerElem = 8;
+
+    // Build an element to node map and the corresponding node to element map.
+    ArrayOfArrays< ColType, IndexType, DEFAULT_BUFFER > elemToNode( numElems, nodesPerElem );
+    ArrayOfArrays< ColType, IndexType, DEFAULT_BUFFER > nodeToElem( numNodes, 4 );
+
+    std::uniform_int_distribution< ColType > nodeDist( 0, numNodes - 1 );
+    for( IndexType elem = 0; elem < numElems; ++elem )
+    {
+      for( IndexType i = 0; i < nodesPerElem; ++i )
+      {
+        ColType const node = nodeDist( m_gen );
+        elemToNode.emplaceBack( elem, node );
+        nodeToElem.emplaceBack( node, ColType( elem ) );
+      }
+    }
+
+    Pattern nodeToNode;
+    sparseMatrixOps::multiplySymbolic< BUILD_POLICY >( nodeToElem.toViewConst(), elemToNode.toViewConst(), numNodes, nodeToNode );
+
+    ASSERT_EQ( nodeToNode.numRows(), numNodes );
+    ASSERT_EQ( nodeToNode.numColumns(), numNodes );
+    for( IndexType node = 0; node < numNodes; ++node )
+    {
+      std::set< ColType > expected;
+      for( ColType const elem : nodeToElem[ node ] )
+      {
+        for( ColType const neighbor : elemToNode[ elem ] )
+        { expected.insert( neighbor ); }
+      }
+
+      ASSERT_EQ( nodeToNode.numNonZeros( node ), IndexType( expected.size() ) );
+      EXPECT_EQ( nodeToNode.nonZeroCapacity( node ), nodeToNode.numNonZeros( node ) );
+
+      IndexType i = 0;
+      for( ColType const neighbor : expected )
+      {
+        EXPECT_EQ( nodeToNode.getColumns( node )[ i ], neighbor );
+        ++i;
+      }
+    }
+  }
+
+  void transposeMatrix( IndexType const numBlocks )
+  {
+    createMatrix( m_a, 87, 131, 25 );
+
+    CRS transpose;
+    sparseMatrixOps::transpose< BUILD_POLICY >( m_a.toViewConst(), transpose, numBlocks );
+    transpose.move( MemorySpace::host, false );
+
+    ASSERT_EQ( transpose.numRows(), m_a.numColumns() );
+    ASSERT_EQ( transpose.numColumns(), m_a.numRows() );
+    ASSERT_EQ( transpose.numNonZeros(), m_a.numNonZeros() );
+
+    REF_TYPE ref( m_a.numColumns() );
+    for( IndexType row = 0; row < m_a.numRows(); ++row )
+    {
+      for( IndexType i = 0; i < m_a.numNonZeros( row ); ++i )
+      { ref[ m_a.getColumns( row )[ i ] ][ row ] = m_a.getEntries( row )[ i ]; }
+    }
+
+    for( IndexType row = 0; row < transpose.numRows(); ++row )
+    {
+      ASSERT_EQ( transpose.numNonZeros( row ), IndexType( ref[ row ].size() ) );
+      EXPECT_EQ( transpose.nonZeroCapacity( row ), transpose.numNonZeros( row ) );
+
+      IndexType i = 0;
+      for( auto const & colAndValue : ref[ row ] )
+      {
+        EXPECT_EQ( transpose.getColumns( row )[ i ], colAndValue.first );
+        EXPECT_EQ( transpose.getEntries( row )[ i ], colAndValue.second );
+        ++i;
+      }
+    }
+
+    // Transposing the sparsity pattern gives the same structure.
+    Pattern pattern;
+    sparseMatrixOps::transpose< BUILD_POLICY >( m_a.toSparsityPatternView(), pattern, numBlocks );
+    ASSERT_EQ( pattern.numRows(), transpose.numRows() );
+    ASSERT_EQ( pattern.numColumns(), transpose.numColumns() );
+    for( IndexType row = 0; row < pattern.numRows(); ++row )
+    {
+      ASSERT_EQ( pattern.numNonZeros( row ), transpose.numNonZeros( row ) );
+      for( IndexType i = 0; i < pattern.numNonZeros( row ); ++i )
+      { EXPECT_EQ( pattern.getColumns( row )[ i ], transpose.getColumns( row )[ i ] ); }
+    }
+  }
+
+  void transposeArrayOfArrays( IndexType const numBlocks )
+  {
+    IndexType const numNodes = 97;
+    IndexType const numElems = 64;
+    IndexType const nodesPerElem = 8;
+
+    // Nodes may be repeated within an element.
+    ArrayOfArrays< ColType, IndexType, DEFAULT_BUFFER > elemToNode( numElems, nodesPerElem );
+    std::uniform_int_distribution< ColType > nodeDist( 0, numNodes - 1 );
+    for( IndexType elem = 0; elem < numElems; ++elem )
+    {
+      for( IndexType i = 0; i < nodesPerElem; ++i )
+      { elemToNode.emplaceBack( elem, nodeDist( m_gen ) ); }
+    }
+
+    ArrayOfArrays< ColType, IndexType, DEFAULT_BUFFER > nodeToElem;
+    sparseMatrixOps::transpose< BUILD_POLICY >( elemToNode.toViewConst(), numNodes, nodeToElem, numBlocks );
+
+    std::vector< std::vector< ColType > > ref( numNodes );
+    for( IndexType elem = 0; elem < numElems; ++elem )
+    {
+      for( ColType const node : elemToNode[ elem ] )
+      { ref[ node ].push_back( ColType( elem ) ); }
+    }
+
+    ASSERT_EQ( nodeToElem.size(), numNodes );
+    for( IndexType node = 0; node < numNodes; ++node )
+    {
+      ASSERT_EQ( nodeToElem.sizeOfArray( node ), IndexType( ref[ node ].size() ) );
+      EXPECT_EQ( nodeToElem.capacityOfArray( node ), nodeToElem.sizeOfArray( node ) );
+      for( IndexType i = 0; i < nodeToElem.sizeOfArray( node ); ++i )
+      { EXPECT_EQ( nodeToElem( node, i ), ref[ node ][ i ] ); }
+    }
+
+    // The same map stored in a two dimensional array gives the same transpose.
+    Array< ColType, 2, RAJA::PERM_JI, IndexType, DEFAULT_BUFFER > elemToNode2D( numElems, nodesPerElem );
+    for( IndexType elem = 0; elem < numElems; ++elem )
+    {
+      for( IndexType i = 0; i < nodesPerElem; ++i )
+      { elemToNode2D( elem, i ) = elemToNode( elem, i ); }
+    }
+
+    ArrayOfArrays< ColType, IndexType, DEFAULT_BUFFER > nodeToElem2D;
+    sparseMatrixOps::transpose< BUILD_POLICY >( elemToNode2D.toViewConst(), numNodes, nodeToElem2D, numBlocks );
+
+    ASSERT_EQ( nodeToElem2D.size(), numNodes );
+    for( IndexType node = 0; node < numNodes; ++node )
+    {
+      ASSERT_EQ( nodeToElem2D.sizeOfArray( node ), nodeToElem.sizeOfArray( node ) );
+      for( IndexType i = 0; i < nodeToElem.sizeOfArray( node ); ++i )
+      { EXPECT_EQ( nodeToElem2D( node, i ), nodeToElem( node, i ) ); }
+    }
+  }
+
+  static IndexType bandwidth( Pattern const & pattern )
+  {
+    IndexType result = 0;
+    for( IndexType row = 0; row < pattern.numRows(); ++row )
+    {
+      for( ColType const col : pattern.getColumns( row ) )
+      { result = math::max( result, IndexType( math::abs( col - row ) ) ); }
+    }
+
+    return result;
+  }
+
+  Permutation randomPermutation( IndexType const n )
+  {
+    std::vector< IndexType > values( n );
+    std::iota( values.begin(), values.end(), IndexType( 0 ) );
+    std::shuffle( values.begin(), values.end(), m_gen );
+
+    Permutation permutation( n );
+    for( IndexType i = 0; i < n; ++i )
+    { permutation[ i ] = values[ i ]; }
+
+    return permutation;
+  }
+
+  static void checkIsPermutation( Permutation const & permutation )
+  {
+    std::vector< bool > found( permutation.size(), false );
+    for( IndexType const newIndex : permutation )
+    {
+      ASSERT_GE( newIndex, 0 );
+      ASSERT_LT( newIndex, permutation.size() );
+      EXPECT_FALSE( found[ newIndex ] );
+      found[ newIndex ] = true;
+    }
+  }
+
+  void reverseCuthillMcKee()
+  {
+    // Two disconnected grids with a five point stencil, numbered randomly.
+    IndexType const sizes[ 2 ][ 2 ] = { { 30, 12 }, { 7, 7 } };
+    IndexType const numNodes = sizes[ 0 ][ 0 ] * sizes[ 0 ][ 1 ] + sizes[ 1 ][ 0 ] * sizes[ 1 ][ 1 ];
+    Permutation const numbering = randomPermutation( numNodes );
+
+    Pattern grid( numNodes, numNodes, 5 );
+    IndexType firstNode = 0;
+    for( auto const & size : sizes )
+    {
+      IndexType const nx = size[ 0 ];
+      IndexType const ny = size[ 1 ];
+      for( IndexType j = 0; j < ny; ++j )
+      {
+        for( IndexType i = 0; i < nx; ++i )
+        {
+          IndexType const node = numbering[ firstNode + i + nx * j ];
+          grid.insertNonZero( node, ColType( node ) );
+          if( i > 0 ) grid.insertNonZero( node, ColType( numbering[ firstNode + i - 1 + nx * j ] ) );
+          if( i < nx - 1 ) grid.insertNonZero( node, ColType( numbering[ firstNode + i + 1 + nx * j ] ) );
+          if( j > 0 ) grid.insertNonZero( node, ColType( numbering[ firstNode + i + nx * ( j - 1 ) ] ) );
+          if( j < ny - 1 ) grid.insertNonZero( node, ColType( numbering[ firstNode + i + nx * ( j + 1 ) ] ) );
+        }
+      }
+
+      firstNode += nx * ny;
+    }
+
+    Permutation permutation( numNodes );
+    sparseMatrixOps::reverseCuthillMcKee( grid.toViewConst(), permutation.toView() );
+    checkIsPermutation( permutation );
+
+    Pattern reordered;
+    sparseMatrixOps::permute< BUILD_POLICY >( grid.toViewConst(), permutation.toViewConst(), reordered );
+
+    EXPECT_GT( bandwidth( grid ), 4 * sizes[ 0 ][ 1 ] );
+    EXPECT_LE( bandwidth( reordered ), sizes[ 0 ][ 1 ] + 1 );
+
+    // The ArrayOfArrays version gives the same ordering.
+    ArrayOfArrays< ColType, IndexType, DEFAULT_BUFFER > adjacency( numNodes, 5 );
+    for( IndexType node = 0; node < numNodes; ++node )
+    { adjacency.appendToArray( node, grid.getColumns( node ).begin(), grid.getColumns( node ).end() ); }
+
+    Permutation permutationFromArrays( numNodes );
+    sparseMatrixOps::reverseCuthillMcKee( adjacency.toViewConst(), permutationFromArrays.toView() );
+    for( IndexType node = 0; node < numNodes; ++node )
+    { EXPECT_EQ( permutationFromArrays[ node ], permutation[ node ] ); }
+  }
+
+  void permute()
+  {
+    IndexType const n = 113;
+    createMatrix( m_a, n, n, 20 );
+    Permutation const permutation = randomPermutation( n );
+
+    CRS permuted;
+    sparseMatrixOps::permute< BUILD_POLICY >( m_a.toViewConst(), permutation.toViewConst(), permuted );
+    permuted.move( MemorySpace::host, false );
+
+    ASSERT_EQ( permuted.numRows(), n );
+    ASSERT_EQ( permuted.numColumns(), n );
+    ASSERT_EQ( permuted.numNonZeros(), m_a.numNonZeros() );
+    for( IndexType row = 0; row < n; ++row )
+    {
+      IndexType const newRow = permutation[ row ];
+      ASSERT_EQ( permuted.numNonZeros( newRow ), m_a.numNonZeros( row ) );
+      EXPECT_EQ( permuted.nonZeroCapacity( newRow ), permuted.numNonZeros( newRow ) );
+      EXPECT_TRUE( sortedArrayManipulation::isSorted( permuted.getColumns( newRow ).begin(), permuted.getColumns( newRow ).end() ) );
+
+      for( IndexType i = 0; i < m_a.numNonZeros( row ); ++i )
+      {
+        ColType const newCol = permutation[ m_a.getColumns( row )[ i ] ];
+        IndexType const pos = sortedArrayManipulation::find( permuted.getColumns( newRow ).begin(), permuted.numNonZeros( newRow ), newCol );
+        ASSERT_LT( pos, permuted.numNonZeros( newRow ) );
+        EXPECT_EQ( permuted.getColumns( newRow )[ pos ], newCol );
+        EXPECT_EQ( permuted.getEntries( newRow )[ pos ], m_a.getEntries( row )[ i ] );
+      }
+    }
+
+    // Permute a vector and the rows of an ArrayOfArrays.
+    Array< T, 1, RAJA::PERM_I, IndexType, DEFAULT_BUFFER > x( n );
+    Array< T, 1, RAJA::PERM_I, IndexType, DEFAULT_BUFFER > y( n );
+    ArrayOfArrays< T, IndexType, DEFAULT_BUFFER > rows( n );
+    for( IndexType row = 0; row < n; ++row )
+    {
+      x[ row ] = T( 2 * row + 1 );
+      rows.appendToArray( row, m_a.getEntries( row ).begin(), m_a.getEntries( row ).end() );
+    }
+
+    sparseMatrixOps::permute< POLICY >( x.toViewConst(), permutation.toViewConst(), y.toView() );
+    y.move( MemorySpace::host, false );
+
+    ArrayOfArrays< T, IndexType, DEFAULT_BUFFER > permutedRows;
+    sparseMatrixOps::permute< BUILD_POLICY >( rows.toViewConst(), permutation.toViewConst(), permutedRows );
+
+    ASSERT_EQ( permutedRows.size(), n );
+    for( IndexType row = 0; row < n; ++row )
+    {
+      IndexType const newRow = permutation[ row ];
+      EXPECT_EQ( y[ newRow ], x[ row ] );
+
+      ASSERT_EQ( permutedRows.sizeOfArray( newRow ), rows.sizeOfArray( row ) );
+      for( IndexType i = 0; i < rows.sizeOfArray( row ); ++i )
+      { EXPECT_EQ( permutedRows( newRow, i ), rows( row, i ) ); }
+    }
+  }
+
+  void colorElements()
+  {
+    IndexType const numNodes = 97;
+    IndexType const numElems = 200;
+
+    // Nodes may be repeated within an element.
+    ArrayOfArrays< ColType, IndexType, DEFAULT_BUFFER > elemToNode( numElems, NODES_PER_ELEM );
+    std::uniform_int_distribution< ColType > nodeDist( 0, numNodes - 1 );
+    for( IndexType elem = 0; elem < numElems; ++elem )
+    {
+      for( IndexType i = 0; i < NODES_PER_ELEM; ++i )
+      { elemToNode.emplaceBack( elem, nodeDist( m_gen ) ); }
+    }
+
+    ArrayOfArrays< IndexType, IndexType, DEFAULT_BUFFER > colorToElems;
+    sparseMatrixOps::colorElements( elemToNode.toViewConst(), numNodes, colorToElems );
+    checkColoring( elemToNode, numNodes, colorToElems );
+
+    // Assemble a matrix one color at a time without atomics and compare with a serial assembly.
+    CRS matrix( numNodes, numNodes );
+    for( IndexType elem = 0; elem < numElems; ++elem )
+    {
+      for( ColType const row : elemToNode[ elem ] )
+      {
+        for( ColType const col : elemToNode[ elem ] )
+        { matrix.insertNonZero( row, col, T() ); }
+      }
+    }
+
+    CRS expected( matrix );
+    for( IndexType elem = 0; elem < numElems; ++elem )
+    {
+      T const values[ NODES_PER_ELEM ] = { T( 1 ), T( 2 ), T( elem % 5 ), T( -3 ) };
+      for( ColType const row : elemToNode[ elem ] )
+      { expected.template addToRowBinarySearchUnsorted< RAJA::seq_atomic >( row, elemToNode[ elem ].dataIfContiguous(), values, NODES_PER_ELEM ); }
+    }
+
+    ArrayOfArraysView< ColType const, IndexType const, true, DEFAULT_BUFFER > const elemToNodeView = elemToNode.toViewConst();
+    CRSMatrixView< T, ColType const, IndexType const, DEFAULT_BUFFER > const view = matrix.toViewConstSizes();
+    sparseMatrixOps::forAllByColor< POLICY >( colorToElems.toViewConst(),
+                                              [elemToNodeView, view] LVARRAY_HOST_DEVICE ( IndexType const elem )
+        {
+          T const values[ NODES_PER_ELEM ] = { T( 1 ), T( 2 ), T( elem % 5 ), T( -3 ) };
+          for( IndexType i = 0; i < NODES_PER_ELEM; ++i )
+          {
+            view.template addToRowBinarySearchUnsorted< RAJA::seq_atomic >( elemToNodeView( elem, i ),
+                                                                             &elemToNodeView( elem, 0 ),
+                                                                             values,
+                                                                             NODES_PER_ELEM );
+          }
+        } );
+
+    matrix.move( MemorySpace::host, false );
+    for( IndexType row = 0; row < numNodes; ++row )
+    {
+      ASSERT_EQ( matrix.numNonZeros( row ), expected.numNonZeros( row ) );
+      for( IndexType i = 0; i < matrix.numNonZeros( row ); ++i )
+      { EXPECT_EQ( matrix.getEntries( row )[ i ], expected.getEntries( row )[ i ] ); }
+    }
+  }
+
+  void colorStructuredMesh()
+  {
+    // A grid of quadrilaterals, greedily colored in order this takes four colors.
+    IndexType const nx = 13;
+    IndexType const ny = 9;
+    IndexType const numNodes = ( nx + 1 ) * ( ny + 1 );
+    Array< ColType, 2, RAJA::PERM_JI, IndexType, DEFAULT_BUFFER > elemToNode( nx * ny, 4 );
+    for( IndexType j = 0; j < ny; ++j )
+    {
+      for( IndexType i = 0; i < nx; ++i )
+      {
+        IndexType const elem = i + nx * j;
+        IndexType const node = i + ( nx + 1 ) * j;
+        elemToNode( elem, 0 ) = node;
+        elemToNode( elem, 1 ) = node + 1;
+        elemToNode( elem, 2 ) = node + nx + 1;
+        elemToNode( elem, 3 ) = node + nx + 2;
+      }
+    }
+
+    ArrayOfArrays< IndexType, IndexType, DEFAULT_BUFFER > colorToElems;
+    sparseMatrixOps::colorElements( elemToNode.toViewConst(), numNodes, colorToElems );
+    ASSERT_EQ( colorToElems.size(), 4 );
+
+    ArrayOfArrays< ColType, IndexType, DEFAULT_BUFFER > elemToNodeArrays( nx * ny, 4 );
+    for( IndexType elem = 0; elem < nx * ny; ++elem )
+    {
+      for( IndexType i = 0; i < 4; ++i )
+      { elemToNodeArrays.emplaceBack( elem, elemToNode( elem, i ) ); }
+    }
+
+    checkColoring( elemToNodeArrays, numNodes, colorToElems );
+  }
+
+  static void checkColoring( ArrayOfArrays< ColType, IndexType, DEFAULT_BUFFER > const & elemToNode,
+                             IndexType const numNodes,
+                             ArrayOfArrays< IndexType, IndexType, DEFAULT_BUFFER > const & colorToElems )
+  {
+    // Every element has exactly one color and no node is shared within a color.
+    std::vector< IndexType > numTimesColored( elemToNode.size() );
+    for( IndexType color = 0; color < colorToElems.size(); ++color )
+    {
+      EXPECT_GT( colorToElems.sizeOfArray( color ), 0 );
+      EXPECT_TRUE( sortedArrayManipulation::isSorted( colorToElems[ color ].begin(), colorToElems[ color ].end() ) );
+
+      std::vector< IndexType > owner( numNodes, -1 );
+      for( IndexType const elem : colorToElems[ color ] )
+      {
+        ++numTimesColored[ elem ];
+        for( ColType const node : elemToNode[ elem ] )
+        {
+          EXPECT_TRUE( owner[ node ] == -1 || owner[ node ] == elem );
+          owner[ node ] = elem;
+        }
+      }
+    }
+
+    for( IndexType const count : numTimesColored )
+    { EXPECT_EQ( count, 1 ); }
+  }
+
+  void mixedPrecision()
+  {
+    using NarrowMatrix = CRSMatrix< float, ColType, IndexType, DEFAULT_BUFFER >;
+    using AtomicPolicy = typename RAJAHelper< POLICY >::AtomicPolicy;
+
+    IndexType const n = 97;
+    IndexType const m = 61;
+    createMatrix( m_a, n, m, 15 );
+
+    NarrowMatrix narrow;
+    sparseMatrixOps::convert< BUILD_POLICY >( m_a.toViewConst(), narrow );
+
+    ASSERT_EQ( narrow.numRows(), n );
+    ASSERT_EQ( narrow.numColumns(), m );
+    ASSERT_EQ( narrow.numNonZeros(), m_a.numNonZeros() );
+    for( IndexType row = 0; row < n; ++row )
+    {
+      ASSERT_EQ( narrow.numNonZeros( row ), m_a.numNonZeros( row ) );
+      EXPECT_EQ( narrow.nonZeroCapacity( row ), narrow.numNonZeros( row ) );
+      for( IndexType i = 0; i < m_a.numNonZeros( row ); ++i )
+      {
+        EXPECT_EQ( narrow.getColumns( row )[ i ], m_a.getColumns( row )[ i ] );
+        EXPECT_EQ( narrow.getEntries( row )[ i ], float( m_a.getEntries( row )[ i ] ) );
+      }
+    }
+
+    // Multiply the float matrix by a double vector, the products are exact so the result must match.
+    Array< double, 1, RAJA::PERM_I, IndexType, DEFAULT_BUFFER > x( m );
+    Array< double, 1, RAJA::PERM_I, IndexType, DEFAULT_BUFFER > y( n );
+    for( IndexType col = 0; col < m; ++col )
+    { x[ col ] = 0.5 * col - 3; }
+
+    sparseMatrixOps::multiply< POLICY >( narrow.toViewConst(), x.toViewConst(), y.toView() );
+    y.move( MemorySpace::host, false );
+
+    for( IndexType row = 0; row < n; ++row )
+    {
+      double expected = 0;
+      for( IndexType i = 0; i < m_a.numNonZeros( row ); ++i )
+      { expected += double( m_a.getEntries( row )[ i ] ) * x[ m_a.getColumns( row )[ i ] ]; }
+
+      EXPECT_EQ( y[ row ], expected );
+    }
+
+    // Add double values to the float entries.
+    CRSMatrixView< float, ColType const, IndexType const, DEFAULT_BUFFER > const view = narrow.toViewConstSizes();
+    forall< POLICY >( n, [view] LVARRAY_HOST_DEVICE ( IndexType const row )
+        {
+          if( view.numNonZeros( row ) > 0 )
+          {
+            ColType const column = view.getColumns( row )[ 0 ];
+            double const value = 0.25 + row;
+            view.template addToRow< AtomicPolicy, double >( row, &column, &value, 1 );
+          }
+        } );
+
+    narrow.move( MemorySpace::host, false );
+    for( IndexType row = 0; row < n; ++row )
+    {
+      if( m_a.numNonZeros( row ) > 0 )
+      { EXPECT_EQ( narrow.getEntries( row )[ 0 ], float( m_a.getEntries( row )[ 0 ] + 0.25 + row ) ); }
+    }
+  }
+
+  void symmetric()
+  {
+    using AtomicPolicy = typename RAJAHelper< POLICY >::AtomicPolicy;
+
+    IndexType const numNodes = 83;
+    IndexType const numElems = 150;
+
+    // Elements with distinct nodes in a random order, each with a symmetric element matrix.
+    Array< ColType, 2, RAJA::PERM_IJ, IndexType, DEFAULT_BUFFER > elemToNode( numElems, NODES_PER_ELEM );
+    Array< T, 3, RAJA::PERM_IJK, IndexType, DEFAULT_BUFFER > localMatrices( numElems, NODES_PER_ELEM, NODES_PER_ELEM );
+    std::vector< ColType > nodes( numNodes );
+    std::iota( nodes.begin(), nodes.end(), ColType( 0 ) );
+    std::uniform_int_distribution< int > valueDist( -10, 10 );
+    for( IndexType elem = 0; elem < numElems; ++elem )
+    {
+      std::shuffle( nodes.begin(), nodes.end(), m_gen );
+      for( IndexType i = 0; i < NODES_PER_ELEM; ++i )
+      {
+        elemToNode( elem, i ) = nodes[ i ];
+        for( IndexType j = i; j < NODES_PER_ELEM; ++j )
+        {
+          localMatrices( elem, i, j ) = T( valueDist( m_gen ) );
+          localMatrices( elem, j, i ) = localMatrices( elem, i, j );
+        }
+      }
+    }
+
+    // Assemble the full matrix serially.
+    CRS full( numNodes, numNodes );
+    for( IndexType elem = 0; elem < numElems; ++elem )
+    {
+      for( IndexType i = 0; i < NODES_PER_ELEM; ++i )
+      {
+        for( IndexType j = 0; j < NODES_PER_ELEM; ++j )
+        { full.insertNonZero( elemToNode( elem, i ), elemToNode( elem, j ), T() ); }
+      }
+    }
+
+    for( IndexType elem = 0; elem < numElems; ++elem )
+    {
+      for( IndexType i = 0; i < NODES_PER_ELEM; ++i )
+      {
+        full.template addToRowBinarySearchUnsorted< RAJA::seq_atomic >( elemToNode( elem, i ),
+                                                                         elemToNode[ elem ],
+                                                                         localMatrices[ elem ][ i ],
+                                                                         NODES_PER_ELEM );
+      }
+    }
+
+    CRS upper;
+    sparseMatrixOps::upperTriangle< BUILD_POLICY >( full.toViewConst(), upper );
+
+    IndexType numDiagonal = 0;
+    for( IndexType row = 0; row < numNodes; ++row )
+    {
+      EXPECT_EQ( upper.nonZeroCapacity( row ), upper.numNonZeros( row ) );
+      for( IndexType i = 0; i < upper.numNonZeros( row ); ++i )
+      {
+        EXPECT_GE( upper.getColumns( row )[ i ], row );
+        numDiagonal += upper.getColumns( row )[ i ] == row;
+      }
+    }
+
+    EXPECT_EQ( 2 * upper.numNonZeros(), full.numNonZeros() + numDiagonal );
+
+    // Converting back gives the full matrix.
+    CRS expanded;
+    sparseMatrixOps::symmetricToFull< BUILD_POLICY >( upper.toViewConst(), expanded, IndexType( 3 ) );
+    ASSERT_EQ( expanded.numRows(), numNodes );
+    for( IndexType row = 0; row < numNodes; ++row )
+    {
+      ASSERT_EQ( expanded.numNonZeros( row ), full.numNonZeros( row ) );
+      EXPECT_EQ( expanded.nonZeroCapacity( row ), expanded.numNonZeros( row ) );
+      for( IndexType i = 0; i < full.numNonZeros( row ); ++i )
+      {
+        EXPECT_EQ( expanded.getColumns( row )[ i ], full.getColumns( row )[ i ] );
+        EXPECT_EQ( expanded.getEntries( row )[ i ], full.getEntries( row )[ i ] );
+      }
+    }
+
+    // The products are exact so the symmetric and full products must match.
+    Array< T, 1, RAJA::PERM_I, IndexType, DEFAULT_BUFFER > x( numNodes );
+    Array< T, 1, RAJA::PERM_I, IndexType, DEFAULT_BUFFER > yFull( numNodes );
+    Array< T, 1, RAJA::PERM_I, IndexType, DEFAULT_BUFFER > ySymmetric( numNodes );
+    for( IndexType i = 0; i < numNodes; ++i )
+    { x[ i ] = T( valueDist( m_gen ) ); }
+
+    sparseMatrixOps::multiply< POLICY >( full.toViewConst(), x.toViewConst(), yFull.toView() );
+    sparseMatrixOps::multiplySymmetric< POLICY, AtomicPolicy >( upper.toViewConst(), x.toViewConst(), ySymmetric.toView() );
+    yFull.move( MemorySpace::host, false );
+    ySymmetric.move( MemorySpace::host, false );
+    for( IndexType i = 0; i < numNodes; ++i )
+    { EXPECT_EQ( ySymmetric[ i ], yFull[ i ] ); }
+
+    // Assemble the upper triangle of each element matrix directly into the symmetric storage.
+    upper.template setValues< BUILD_POLICY >( T() );
+    ArrayView< ColType const, 2, 1, IndexType, DEFAULT_BUFFER > const elemToNodeView = elemToNode.toViewConst();
+    ArrayView< T const, 3, 2, IndexType, DEFAULT_BUFFER > const localMatricesView = localMatrices.toViewConst();
+    CRSMatrixView< T, ColType const, IndexType const, DEFAULT_BUFFER > const upperView = upper.toViewConstSizes();
+    forall< POLICY >( numElems, [elemToNodeView, localMatricesView, upperView] LVARRAY_HOST_DEVICE ( IndexType const elem )
+        {
+          for( IndexType i = 0; i < NODES_PER_ELEM; ++i )
+          {
+            sparseMatrixOps::addToRowSymmetric< AtomicPolicy >( upperView,
+                                                                IndexType( elemToNodeView( elem, i ) ),
+                                                                &elemToNodeView( elem, i ),
+                                                                &localMatricesView( elem, i, i ),
+                                                                NODES_PER_ELEM - i );
+          }
+        } );
+
+    upper.move( MemorySpace::host, false );
+    CRS expected;
+    sparseMatrixOps::upperTriangle< serialPolicy >( full.toViewConst(), expected );
+    for( IndexType row = 0; row < numNodes; ++row )
+    {
+      ASSERT_EQ( upper.numNonZeros( row ), expected.numNonZeros( row ) );
+      for( IndexType i = 0; i < upper.numNonZeros( row ); ++i )
+      { EXPECT_EQ( upper.getEntries( row )[ i ], expected.getEntries( row )[ i ] ); }
+    }
+  }
+
+protected:
+  std::mt19937_64 m_gen;
+  CRS m_a;
+  CRS m_b;
+};
+
+using SparseMatrixOpsTestTypes = ::testing::Types<
+  std::pair< CRSMatrix< double, int, std::ptrdiff_t, DEFAULT_BUFFER >, serialPolicy >
+  , std::pair< CRSMatrix< float, long, int, DEFAULT_BUFFER >, serialPolicy >
+#if defined(RAJA_ENABLE_OPENMP)
+  , std::pair< CRSMatrix< double, int, std::ptrdiff_t, DEFAULT_BUFFER >, parallelHostPolicy >
+#endif
+#if defined(LVARRAY_USE_CUDA) && defined(LVARRAY_USE_CHAI)
+  , std::pair< CRSMatrix< double, int, std::ptrdiff_t, DEFAULT_BUFFER >, parallelDevicePolicy< 32 > >
+#endif
+  >;
+
+TYPED_TEST_SUITE( SparseMatrixOpsTest, SparseMatrixOpsTestTypes, );
+
+TYPED_TEST( SparseMatrixOpsTest, multiplySquare )
+{
+  this->multiply( 100, 100, 100, 10 );
+}
+
+TYPED_TEST( SparseMatrixOpsTest, multiplyRectangular )
+{
+  this->multiply( 73, 151, 40, 20 );
+}
+
+TYPED_TEST( SparseMatrixOpsTest, multiplyManyProducts )
+{
+  // The rows of the product are nearly dense and each column is reached many times.
+  this->multiply( 40, 30, 50, 60 );
+}
+
+TYPED_TEST( SparseMatrixOpsTest, multiplyEmpty )
+{
+  this->multiply( 50, 60, 70, 0 );
+}
+
+TYPED_TEST( SparseMatrixOpsTest, reuseSymbolic )
+{
+  this->reuseSymbolic();
+}
+
+TYPED_TEST( SparseMatrixOpsTest, graphProduct )
+{
+  this->graphProduct();
+}
+
+TYPED_TEST( SparseMatrixOpsTest, transpose )
+{
+  this->transposeMatrix( 1 );
+  this->transposeMatrix( 3 );
+  this->transposeMatrix( 1000 );
+}
+
+TYPED_TEST( SparseMatrixOpsTest, transposeArrayOfArrays )
+{
+  this->transposeArrayOfArrays( 1 );
+  this->transposeArrayOfArrays( 5 );
+  this->transposeArrayOfArrays( 1000 );
+}
+
+TYPED_TEST( SparseMatrixOpsTest, reverseCuthillMcKee )
+{
+  this->reverseCuthillMcKee();
+}
+
+TYPED_TEST( SparseMatrixOpsTest, permute )
+{
+  this->permute();
+}
+
+TYPED_TEST( SparseMatrixOpsTest, colorElements )
+{
+  this->colorElements();
+  this->colorStructuredMesh();
+}
+
+TYPED_TEST( SparseMatrixOpsTest, mixedPrecision )
+{
+  this->mixedPrecision();
+}
+
+TYPED_TEST( SparseMatrixOpsTest, symmetric )
+{
+  this->symmetric();
+}
+
+} // namespace testing
+} // namespace LvArray
+
+// This is the default gtest main method. It is included for ease of debugging.
+int main( int argc, char * * argv )
+{
+  ::testing::InitGoogleTest( &argc, argv );
+  int const result = RUN_ALL_TESTS();
+  return result;
+}
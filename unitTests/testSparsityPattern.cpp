@@ -10,6 +10,7 @@
 #include "CRSMatrix.hpp"
 #include "testUtils.hpp"
 #include "Array.hpp"
+#include "ArrayOfArrays.hpp"
 #include "MallocBuffer.hpp"
 
 // TPL includes
@@ -21,6 +22,7 @@
 #include <iterator>
 #include <random>
 #include <climits>
+#include <algorithm>
 
 namespace LvArray
 {
@@ -31,19 +33,41 @@ template< typename U, typename T >
 struct ToArray1D
 {};
 
-template< typename U, typename T, typename INDEX_TYPE, template< typename > class BUFFER_TYPE >
-struct ToArray1D< U, SparsityPattern< T, INDEX_TYPE, BUFFER_TYPE > >
+template< typename U, typename T, typename INDEX_TYPE, template< typename > class BUFFER_TYPE, typename OFFSET_TYPE >
+struct ToArray1D< U, SparsityPattern< T, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE > >
 {
   using array = Array< U, 1, RAJA::PERM_I, INDEX_TYPE, BUFFER_TYPE >;
   using view = ArrayView< U, 1, 0, INDEX_TYPE, BUFFER_TYPE >;
 };
 
+template< typename U, typename T >
+struct ToArrayOfArrays
+{};
+
+template< typename U, typename T, typename INDEX_TYPE, template< typename > class BUFFER_TYPE, typename OFFSET_TYPE >
+struct ToArrayOfArrays< U, SparsityPattern< T, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE > >
+{
+  using type = ArrayOfArrays< U, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE >;
+};
+
+template< typename U, typename T >
+struct ToConnectivity
+{};
+
+template< typename U, typename T, typename INDEX_TYPE, template< typename > class BUFFER_TYPE, typename OFFSET_TYPE >
+struct ToConnectivity< U, SparsityPattern< T, INDEX_TYPE, BUFFER_TYPE, OFFSET_TYPE > >
+{
+  using elemToNode = Array< U, 2, RAJA::PERM_JI, INDEX_TYPE, BUFFER_TYPE >;
+  using nodeToElem = ArrayOfArrays< U, INDEX_TYPE, BUFFER_TYPE >;
+};
+
 template< typename SPARSITY_PATTERN >
 class SparsityPatternTest : public ::testing::Test
 {
 public:
   using ColType = typename SPARSITY_PATTERN::ColType;
   using IndexType = typename SPARSITY_PATTERN::IndexType;
+  using OffsetType = typename SPARSITY_PATTERN::OffsetType;
 
   using ViewType = typeManipulation::ViewType< SPARSITY_PATTERN >;
   using ViewTypeConst = typeManipulation::ViewTypeConst< SPARSITY_PATTERN >;
@@ -397,9 +421,9 @@ public:
     m_sp.compress();
 
     ColType const * const columns = m_sp.getColumns( 0 );
-    IndexType const * const offsets = m_sp.getOffsets();
+    OffsetType const * const offsets = m_sp.getOffsets();
 
-    IndexType curOffset = 0;
+    OffsetType curOffset = 0;
     for( IndexType row = 0; row < m_sp.numRows(); ++row )
     {
       // The last row will have all the extra capacity.
@@ -418,6 +442,89 @@ public:
     COMPARE_TO_REFERENCE
   }
 
+  template< typename POLICY >
+  void assimilateArrayOfArraysTest( IndexType const numRows, IndexType const numCols, IndexType const maxInserts )
+  {
+    using AtomicPolicy = typename RAJAHelper< POLICY >::AtomicPolicy;
+
+    std::vector< IndexType > capacities( numRows );
+    std::vector< IndexType > rows;
+    std::vector< ColType > columns;
+
+    m_ref.clear();
+    m_ref.resize( numRows );
+    for( IndexType row = 0; row < numRows; ++row )
+    {
+      capacities[ row ] = rand( maxInserts );
+      for( IndexType i = 0; i < capacities[ row ]; ++i )
+      {
+        // Draw from a narrow range of columns so that there are many duplicates.
+        ColType const column = rand( std::min( numCols - 1, maxInserts / 2 ) );
+        rows.push_back( row );
+        columns.push_back( column );
+        m_ref[ row ].insert( column );
+      }
+    }
+
+    typename ToArrayOfArrays< ColType, SPARSITY_PATTERN >::type arrays;
+    arrays.template resizeFromCapacities< serialPolicy >( numRows, capacities.data() );
+
+    auto const arraysView = arrays.toView();
+    forall< POLICY >( IndexType( rows.size() ), [&rows, &columns, arraysView] ( IndexType const i )
+        { arraysView.template emplaceBackAtomic< AtomicPolicy >( rows[ i ], columns[ i ] ); } );
+
+    m_sp.template assimilate< POLICY >( std::move( arrays ), numCols, sortedArrayManipulation::UNSORTED_WITH_DUPLICATES );
+
+    EXPECT_EQ( m_sp.numColumns(), numCols );
+    EXPECT_EQ( arrays.size(), 0 );
+    for( IndexType row = 0; row < numRows; ++row )
+    { EXPECT_EQ( m_sp.nonZeroCapacity( row ), capacities[ row ] ); }
+
+    COMPARE_TO_REFERENCE
+  }
+
+  template< typename POLICY >
+  void fromConnectivityTest( IndexType const numNodes, IndexType const numElems, IndexType const nodesPerElem, IndexType const dofsPerNode )
+  {
+    typename ToConnectivity< IndexType, SPARSITY_PATTERN >::elemToNode elemToNode( numElems, nodesPerElem );
+    typename ToConnectivity< IndexType, SPARSITY_PATTERN >::nodeToElem nodeToElem( numNodes );
+
+    // Nodes may be repeated within an element and appear more than once in the node to element map.
+    for( IndexType elem = 0; elem < numElems; ++elem )
+    {
+      for( IndexType i = 0; i < nodesPerElem; ++i )
+      {
+        elemToNode( elem, i ) = rand( numNodes - 1 );
+        nodeToElem.emplaceBack( elemToNode( elem, i ), elem );
+      }
+    }
+
+    m_sp.template fromConnectivity< POLICY >( elemToNode.toViewConst(), nodeToElem.toViewConst(), dofsPerNode );
+
+    m_ref.clear();
+    m_ref.resize( dofsPerNode * numNodes );
+    for( IndexType elem = 0; elem < numElems; ++elem )
+    {
+      for( IndexType i = 0; i < nodesPerElem; ++i )
+      {
+        for( IndexType j = 0; j < nodesPerElem; ++j )
+        {
+          for( IndexType dof0 = 0; dof0 < dofsPerNode; ++dof0 )
+          {
+            for( IndexType dof1 = 0; dof1 < dofsPerNode; ++dof1 )
+            { m_ref[ dofsPerNode * elemToNode( elem, i ) + dof0 ].insert( ColType( dofsPerNode * elemToNode( elem, j ) + dof1 ) ); }
+          }
+        }
+      }
+    }
+
+    EXPECT_EQ( m_sp.numColumns(), dofsPerNode * numNodes );
+    for( IndexType row = 0; row < m_sp.numRows(); ++row )
+    { EXPECT_EQ( m_sp.nonZeroCapacity( row ), m_sp.numNonZeros( row ) ); }
+
+    COMPARE_TO_REFERENCE
+  }
+
   /**
    * @brief Test the copy constructor of the SparsityPattern.
    */
@@ -534,6 +641,7 @@ using SparsityPatternTestTypes = ::testing::Types<
 #if !defined( __ibmxl__ )
   , SparsityPattern< uint, std::ptrdiff_t, MallocBuffer >
 #endif
+  , SparsityPattern< int, int, MallocBuffer, std::ptrdiff_t >
 
 #if defined(LVARRAY_USE_CHAI)
   , SparsityPattern< int, std::ptrdiff_t, ChaiBuffer >
@@ -693,6 +801,27 @@ TYPED_TEST( SparsityPatternTest, compress )
   this->compressTest();
 }
 
+TYPED_TEST( SparsityPatternTest, assimilateArrayOfArrays )
+{
+  this->template assimilateArrayOfArraysTest< serialPolicy >( NROWS, NCOLS, MAX_INSERTS );
+  this->insertTest( MAX_INSERTS );
+
+#if defined( RAJA_ENABLE_OPENMP )
+  this->template assimilateArrayOfArraysTest< parallelHostPolicy >( NROWS, NCOLS, MAX_INSERTS );
+  this->insertTest( MAX_INSERTS );
+#endif
+}
+
+TYPED_TEST( SparsityPatternTest, fromConnectivity )
+{
+  this->template fromConnectivityTest< serialPolicy >( 100, 60, 8, 3 );
+  this->template fromConnectivityTest< serialPolicy >( 50, 0, 4, 1 );
+
+#if defined( RAJA_ENABLE_OPENMP )
+  this->template fromConnectivityTest< parallelHostPolicy >( 150, 90, 4, 2 );
+#endif
+}
+
 TYPED_TEST( SparsityPatternTest, deepCopy )
 {
   this->resize( NROWS, NCOLS );
@@ -1009,6 +1138,7 @@ using SparsityPatternViewTestTypes = ::testing::Types<
 #if !defined( __ibmxl__ )
   , std::pair< SparsityPattern< uint, std::ptrdiff_t, MallocBuffer >, serialPolicy >
 #endif
+  , std::pair< SparsityPattern< int, int, MallocBuffer, std::ptrdiff_t >, serialPolicy >
 #if defined(LVARRAY_USE_CHAI)
   , std::pair< SparsityPattern< int, std::ptrdiff_t, ChaiBuffer >, serialPolicy >
 #if !defined( __ibmxl__ )
@@ -1103,10 +1233,11 @@ struct CRSMatrixToSparsityPattern;
 template< typename T,
           typename ColType,
           typename IndexType,
-          template< typename > class BUFFER_TYPE >
-struct CRSMatrixToSparsityPattern< CRSMatrix< T, ColType, IndexType, BUFFER_TYPE > >
+          template< typename > class BUFFER_TYPE,
+          typename OffsetType >
+struct CRSMatrixToSparsityPattern< CRSMatrix< T, ColType, IndexType, BUFFER_TYPE, OffsetType > >
 {
-  using type = SparsityPattern< ColType, IndexType, BUFFER_TYPE >;
+  using type = SparsityPattern< ColType, IndexType, BUFFER_TYPE, OffsetType >;
 };
 
 template< typename CRS_MATRIX_POLICY_PAIR >
@@ -1171,6 +1302,7 @@ using CRSMatrixTestTypes = ::testing::Types<
   std::pair< CRSMatrix< int, int, std::ptrdiff_t, MallocBuffer >, serialPolicy >
   , std::pair< CRSMatrix< Tensor, int, std::ptrdiff_t, MallocBuffer >, serialPolicy >
   , std::pair< CRSMatrix< TestString, int, std::ptrdiff_t, MallocBuffer >, serialPolicy >
+  , std::pair< CRSMatrix< int, int, int, MallocBuffer, std::ptrdiff_t >, serialPolicy >
 #if defined(LVARRAY_USE_CUDA) && defined(LVARRAY_USE_CHAI)
   , std::pair< CRSMatrix< int, int, std::ptrdiff_t, ChaiBuffer >, parallelDevicePolicy< 32 > >
   , std::pair< CRSMatrix< Tensor, int, std::ptrdiff_t, ChaiBuffer >, parallelDevicePolicy< 32 > >